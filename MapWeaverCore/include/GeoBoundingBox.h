@@ -3,6 +3,7 @@
 
 #include "MapWeaverPort.h"
 #include "Geometry/GB_Rectangle.h"
+#include <cstdint>
 #include <string>
 
 #ifdef _MSC_VER
@@ -10,10 +11,15 @@
 #  pragma warning(disable: 4251)
 #endif
 
+// GeoBoundingBox 的坐标系有两种表示方式：
+// - wktUtf8 非空时以 wktUtf8 为准；
+// - wktUtf8 为空时以 crsId（GeoCrsManager::InternCrs 分配的驻留 id）为准。
+//   大量 bbox 共享少数 CRS 时，只携带 id 可避免每个对象复制/哈希完整的 WKT；需要 WKT 时调用 GetWktUtf8()。
 class MAPWEAVERCORE_PORT GeoBoundingBox
 {
 public:
 	std::string wktUtf8 = "";
+	std::uint32_t crsId = 0;
 	GB_Rectangle rect;
 
 	static const GeoBoundingBox Invalid;
@@ -21,6 +27,7 @@ public:
 	GeoBoundingBox();
 	explicit GeoBoundingBox(const std::string& wktUtf8);
 	GeoBoundingBox(const std::string& wktUtf8, const GB_Rectangle& rect);
+	GeoBoundingBox(std::uint32_t crsId, const GB_Rectangle& rect);
 	virtual ~GeoBoundingBox();
 
 	bool operator==(const GeoBoundingBox& other) const;
@@ -32,6 +39,21 @@ public:
 
 	void Set(const std::string& wktUtf8, const GB_Rectangle& rect);
 
+	// 以驻留 id 表示坐标系（同时清空 wktUtf8）。
+	void Set(std::uint32_t crsId, const GB_Rectangle& rect);
+
+	// 坐标系的 WKT：wktUtf8 非空时直接返回，否则按 crsId 取规范化 WKT（WKT2_2018）。
+	// 返回引用：前者在本对象修改或析构前有效，后者在进程生命周期内有效。
+	const std::string& GetWktUtf8() const;
+
+	// 坐标系的驻留 id：wktUtf8 非空时查找该 WKT 已分配的 id（不会驻留新的 CRS），否则返回 crsId；
+	// 未驻留或无效时返回 0。需要分配 id 时显式调用 GeoCrsManager::InternCrs。
+	std::uint32_t GetCrsId() const;
+
+	// 是否只以驻留 id 表示坐标系。
+	bool UsesCrsId() const;
+
+	// 序列化总是写出 WKT（驻留 id 只在当前进程内有效），反序列化得到以 wktUtf8 表示的对象。
 	std::string SerializeToString() const;
 	GB_ByteBuffer SerializeToBinary() const;
 
@@ -43,6 +65,14 @@ public:
 
 	// 返回 ClampRectToCrsValidArea() 的结果副本（当前对象不变）。
 	GeoBoundingBox ClampedRectToCrsValidArea() const;
+
+	// 当前 rect 是否与坐标系有效范围的足迹多边形相交。比与外包矩形相交更严格，
+	// 可用于剔除只落在有效范围外包矩形角落的瓦片。无法获得足迹时退化为与外包矩形相交的判断。
+	bool IntersectsCrsValidFootprint() const;
+
+	// 将 rect 收紧为“rect 与足迹交集”的外包矩形；无交集时置为 Invalid 并返回 false。
+	// 无法获得足迹时退化为 ClampRectToCrsValidArea()。
+	bool ClampRectToCrsValidFootprint();
 };
 
 #ifdef _MSC_VER
@@ -10,6 +10,7 @@
 #include <vector>
 
 class GeoBoundingBox;
+class GeoCrsFootprint;
 class OGRSpatialReference;
 class GB_Point2d;
 class GB_Rectangle;
@@ -51,7 +52,50 @@ public:
     // - 注意：该 UID 不会触发 AutoIdentifyEPSG/FindBestMatch 推断，避免依赖外部 proj.db 状态而导致 UID 不稳定。
     std::string GetUidUtf8() const;
 
+    // 与 GetUidUtf8() 一一对应的 128 位数值 UID，比较与哈希只需整数运算：
+    // - EPSG：high = 0，low = EPSG code；
+    // - WKT2_2018 哈希：high = fnv1a64（最高位置 1，以与 EPSG 区分），low = 另一个独立的 64 位哈希；
+    // - 空/不可用：high = low = 0（IsValid() 为 false）。
+    struct Uid128
+    {
+        std::uint64_t high = 0;
+        std::uint64_t low = 0;
+
+        bool IsValid() const
+        {
+            return high != 0 || low != 0;
+        }
+
+        bool operator==(const Uid128& other) const
+        {
+            return high == other.high && low == other.low;
+        }
+
+        bool operator!=(const Uid128& other) const
+        {
+            return !(*this == other);
+        }
+
+        bool operator<(const Uid128& other) const
+        {
+            return high != other.high ? high < other.high : low < other.low;
+        }
+    };
+
+    Uid128 GetUid128() const;
+
+    // 按内容（WKT2_2018 单行导出文本）计算的 128 位哈希：与 GetUid128() 不同，带 EPSG 权威码时也按内容计算，
+    // 改动过参数但保留根权威码的 WKT 得到与原坐标系不同的值。为空或导出失败时无效。计算一次后无锁读取。
+    Uid128 GetContentHash128() const;
+
+    // 内容是否与 CreateFromEpsgCode(epsgCode) 一致：内容哈希相同，或 IsSame（忽略轴映射）。结果随内部核心缓存。
+    // 用于确认根权威码确实可信（例如按 EPSG code 选择的专用算法或预生成的表）。
+    bool MatchesEpsgDefinition(int epsgCode) const;
+
     // 判断两个坐标系是否相同
+    // - 共享同一内部核心、或内容哈希（WKT2_2018 导出文本）与轴顺序均相同时直接返回 true；
+    // - 否则调用 OGRSpatialReference::IsSame()，结果按内容哈希对缓存在进程级结果表中。
+    // - 不以 UID 判定：EPSG UID 只取自根 AUTHORITY，改动过参数但保留权威码的 WKT 与原坐标系 UID 相同。
     bool operator==(const GeoCrs& other) const;
 
     bool operator!=(const GeoCrs& other) const;
@@ -136,20 +180,46 @@ public:
     // 本函数会返回保守的全球经度范围 [-180, 180]；如需更精确的分段范围，请使用 GetValidAreaLonLatSegments()。
     GeoBoundingBox GetValidAreaLonLat() const;
 
+    // 获取有效范围在本坐标系下的足迹多边形：把经纬度有效范围的每条边加密为 pointsPerEdge 段后投影得到，
+    // 比 GetValidArea() 的外包矩形更贴合弯曲的有效区域。失败时（包括任一边界采样点投影失败）返回无效足迹。
+    GeoCrsFootprint GetValidAreaFootprint(int pointsPerEdge = 64) const;
+
     const OGRSpatialReference* GetConst() const;
 
     // 更安全的只读访问：返回内部对象的引用。
     const OGRSpatialReference& GetConstRef() const;
 
     // 注意：返回的引用为内部对象，修改会直接影响 GeoCrs。
-    // 本类对 const 接口提供内部互斥保护，允许并发只读；但通过 GetRef()/Get() 取得的可写引用/指针
-    // 不提供跨线程安全保证，且不应在多个线程中长期持有并同时读写。
+    // 本类对 const 接口提供内部互斥保护，允许并发只读；修改操作（包括赋值）需要独占该对象，与标准容器相同。
+    // 通过 GetRef()/Get() 取得的可写引用/指针不提供跨线程安全保证，且不应在多个线程中长期持有并同时读写。
+    // 借出过可写引用的对象在之后被拷贝时会深拷贝，不与副本共享内部对象。
+    // 引用/指针在下一次 SetFrom*/Reset 或对象析构前有效（与容器迭代器失效规则类似）：
+    // 这些操作会换成全新的内部对象并清除“已借出”状态，之后的拷贝恢复为共享。
+    // 缓存（EPSG、UID 等）在借出时清空；借出后经引用的修改不会再使其失效。
     OGRSpatialReference& GetRef();
 
     // 注意：返回的指针为内部对象（借用，不转移所有权）。不要对返回指针调用 Release()/delete。
     // 若需要可写访问，更推荐使用 GetRef()。
     OGRSpatialReference* Get();
 
+    // 由上层模块注入的查询钩子（GeoCrs 不依赖 GeoCrsManager，GeoCrsManager 初始化时注册）：
+    // - ValidAreaTableHook：按 EPSG code 查有效范围表；selfArea=false 取经纬度范围，true 取自身范围（传统 GIS 轴序）。
+    //   返回 false 表示表中没有该 code（需实时计算）；返回 true 且 outHasArea=false 表示该 CRS 没有有效范围；
+    // - EpsgIdentifyHook：TryGetEpsgCode() 推断 EPSG 前先调用的快速识别，返回 0 表示未识别。
+    // 传入 nullptr 取消注册；Get* 返回当前注册的钩子（便于临时替换后恢复）。
+    // 查表前会确认本坐标系的内容与该 EPSG 定义一致（内容哈希相同或 IsSame），不依赖识别钩子：
+    // 改动过参数但保留根权威码的 WKT 不会用到该 code 的表项。
+    using ValidAreaTableHook = bool (*)(int epsgCode, bool selfArea, bool& outHasArea, GB_Rectangle& outRect);
+    using EpsgIdentifyHook = int (*)(const OGRSpatialReference& srs);
+
+    static void SetValidAreaTableHook(ValidAreaTableHook hook);
+
+    static void SetEpsgIdentifyHook(EpsgIdentifyHook hook);
+
+    static ValidAreaTableHook GetValidAreaTableHook();
+
+    static EpsgIdentifyHook GetEpsgIdentifyHook();
+
 private:
     void InvalidateCaches() const;
     void InvalidateCachesNoLock() const;
@@ -160,6 +230,17 @@ private:
 
     bool IsValidNoLock() const;
 
+    void EnsureUidCachedNoLock() const;
+
+    Uid128 GetUid128NoLock() const;
+
+    // 取 UID 与轴顺序：已发布快照时无锁读取，否则加锁计算并发布。
+    void GetUidAndAxisOrder(Uid128& outUid, bool& outTraditionalGisAxisOrder) const;
+
+    // 取内容哈希（WKT2_2018 导出的 128 位哈希，带 EPSG 权威码时也按内容计算）与轴顺序，供 operator== 使用；
+    // 已发布快照时无锁读取。为空或导出失败时哈希无效。
+    void GetContentHashAndAxisOrder(Uid128& outHash, bool& outTraditionalGisAxisOrder) const;
+
     OGRSpatialReference* EnsureSpatialReferenceNoLock();
 
     int TryGetEpsgCodeNoLock(bool tryAutoIdentify, bool tryFindBestMatch, int minMatchConfidence) const;
@@ -172,29 +253,90 @@ private:
 
     GeoBoundingBox GetValidAreaNoLock() const;
 
+    // 若本坐标系带 EPSG 权威码且已注册有效范围表钩子（见 SetValidAreaTableHook），则查表得到有效范围。
+    // selfArea=false 取经纬度范围，true 取自身范围。返回 false 表示需要实时计算。
+    bool TryGetTabulatedValidAreaNoLock(bool selfArea, GeoBoundingBox& outArea) const;
+
+    // 本坐标系的内容是否与 CreateFromEpsgCode(epsgCode) 一致：先比较内容哈希，不同时再用 IsSame 确认。结果按核心缓存。
+    bool MatchesEpsgDefinitionNoLock(int epsgCode) const;
+
+private:
+    // 共享核心：OGRSpatialReference、轴顺序、互斥与各项缓存。
+    // 拷贝构造/拷贝赋值只复制 shared_ptr（O(1)，不分配内存），多个 GeoCrs 可共享同一核心；
+    // 第一次修改（SetFrom*/Reset/SetTraditionalGisAxisOrder/GetRef/Get）时若核心被共享，才克隆出独占的核心。
+    // 共享核心的副本调用 OGR 时在核心的互斥上串行；UID/轴顺序与默认 TryGetEpsgCode() 结果算出后无锁读取。
+    // 需要完全无锁的并发只读时使用 FrozenGeoCrs。
+    struct SharedCore;
+
+    static const std::shared_ptr<SharedCore>& GetEmptyCore();
+
+    static std::shared_ptr<SharedCore> CloneCore(const SharedCore& source, bool keepContent);
+
+    // 修改前调用：核心被共享时换成独占的副本。keepContent=false 时新核心为空（随后会被整体重置）。
+    void DetachCore(bool keepContent);
+
+    std::shared_ptr<SharedCore> core;
+};
+
+// FrozenGeoCrs
+// - GeoCrs 的不可变快照：名称、类型标志、EPSG、UID、单位以及 WKT2_2018/PROJJSON 导出在 Create() 时一次性计算，
+//   此后所有读取都只是读成员，不加锁；
+// - GeoCrsManager 的 GetFrozen*Cached() 返回共享的快照，适合在多线程热路径中频繁读取上述属性；
+// - 需要其它导出格式、有效范围或 OGR 对象时，通过 GetCrs() 访问底层 GeoCrs（仍走其内部互斥）。
+class MAPWEAVERCORE_PORT FrozenGeoCrs
+{
+public:
+    // crs 为空时得到一个空快照（IsEmpty() 为 true）。
+    static std::shared_ptr<const FrozenGeoCrs> Create(const std::shared_ptr<const GeoCrs>& crs);
+
+    const std::shared_ptr<const GeoCrs>& GetCrs() const;
+
+    bool IsEmpty() const;
+
+    bool IsValid() const;
+
+    const std::string& GetNameUtf8() const;
+
+    bool IsGeographic() const;
+
+    bool IsProjected() const;
+
+    bool IsLocal() const;
+
+    // 等价于 GeoCrs::TryGetEpsgCode()（默认参数）；未能得到时为 0。
+    int GetEpsgCode() const;
+
+    // "EPSG:<code>"；未能得到 EPSG 时为空串。
+    const std::string& GetEpsgStringUtf8() const;
+
+    const std::string& GetUidUtf8() const;
+
+    const GeoCrs::UnitsInfo& GetLinearUnits() const;
+
+    const GeoCrs::UnitsInfo& GetAngularUnits() const;
+
+    // 等价于 GeoCrs::ExportToWktUtf8(WktFormat::Wkt2_2018, false)。
+    const std::string& GetWktUtf8() const;
+
+    const std::string& GetProjJsonUtf8() const;
+
 private:
-    std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> spatialReference;
-
-    // GDAL 3.0+ 起坐标轴顺序默认遵循 CRS 定义（例如 EPSG:4326 为纬度/经度）。
-    // 本类默认使用传统 GIS 顺序以减少“经纬度顺序”踩坑。
-    bool useTraditionalGisAxisOrder = true;
-
-    // 互斥：保护 spatialReference 与所有缓存字段，使 const 接口在并发读场景下安全。
-    mutable std::recursive_mutex mutex;
-
-    // ---- 缓存：避免重复进行 AutoIdentifyEPSG / FindBestMatch 等可能较重的逻辑 ----
-    // 默认参数（tryAutoIdentify=true, tryFindBestMatch=false, minMatchConfidence=90）下的 EPSG 结果缓存
-    mutable bool hasCachedDefaultEpsgCode = false;
-    mutable int cachedDefaultEpsgCode = 0; // 0 表示未能得到 EPSG code 或者为空
-
-    // GetUidUtf8() 的缓存：
-    //  cachedUidKind:
-    //      -2：未计算
-    //      -1：空/不可用
-    //       0：使用 cachedUidWktHash (WKT2_2018 的哈希)
-    //     > 0：EPSG code
-    mutable int cachedUidKind = -2;
-    mutable std::uint64_t cachedUidWktHash = 0;
+    FrozenGeoCrs() = default;
+
+    std::shared_ptr<const GeoCrs> crs;
+    bool isEmpty = true;
+    bool isValid = false;
+    bool isGeographic = false;
+    bool isProjected = false;
+    bool isLocal = false;
+    int epsgCode = 0;
+    std::string nameUtf8 = "";
+    std::string epsgStringUtf8 = "";
+    std::string uidUtf8 = "";
+    GeoCrs::UnitsInfo linearUnits;
+    GeoCrs::UnitsInfo angularUnits;
+    std::string wktUtf8 = "";
+    std::string projJsonUtf8 = "";
 };
 
 #ifdef _MSC_VER
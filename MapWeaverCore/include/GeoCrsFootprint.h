@@ -0,0 +1,57 @@
+﻿#ifndef MAP_WEAVER_GEO_CRS_FOOTPRINT_H
+#define MAP_WEAVER_GEO_CRS_FOOTPRINT_H
+
+#include "MapWeaverPort.h"
+#include "Geometry/GB_Point2d.h"
+#include "Geometry/GB_Rectangle.h"
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+
+// GeoCrsFootprint
+// - 坐标系有效范围在其自身坐标下的“足迹”多边形（由经纬度有效范围的边界加密后投影得到）；
+// - 对圆锥、横轴墨卡托等投影，有效区域是弯曲的四边形，其外包矩形（GetValidArea）会明显多覆盖，
+//   用足迹判断可剔除只落在外包矩形角落的瓦片；
+// - 跨日期变更线时可能包含两个环；环首尾不重复，按环的并集理解。
+// 对象构造后不可修改，可在多线程间共享只读。
+class MAPWEAVERCORE_PORT GeoCrsFootprint
+{
+public:
+	GeoCrsFootprint();
+	GeoCrsFootprint(const std::string& wktUtf8, const std::vector<std::vector<GB_Point2d>>& rings);
+
+	// 至少有一个环（不少于 3 个点）时有效。
+	bool IsValid() const;
+
+	const std::string& GetWktUtf8() const;
+	const std::vector<std::vector<GB_Point2d>>& GetRings() const;
+
+	// 所有环的外包矩形；无效时为 GB_Rectangle::Invalid。
+	const GB_Rectangle& GetBoundingRect() const;
+
+	// 点是否位于足迹内（奇偶规则；先用外包矩形快速排除）。落在环边界上的点视为在内，
+	// 与 GetBoundingRect() 的闭区间语义一致（例如跨日期变更线拆分后正好位于 ±180° 的点）。
+	bool ContainsPoint(double x, double y) const;
+
+	// 矩形是否与足迹相交（包含“矩形在足迹内”与“足迹在矩形内”）。
+	bool IntersectsRect(const GB_Rectangle& rect) const;
+
+	// rect 与足迹交集的外包矩形；无交集时返回 GB_Rectangle::Invalid。
+	GB_Rectangle ClipRect(const GB_Rectangle& rect) const;
+
+private:
+	std::string wktUtf8 = "";
+	std::vector<std::vector<GB_Point2d>> rings;
+	std::vector<GB_Rectangle> ringBounds;
+	GB_Rectangle boundingRect;
+};
+
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+
+#endif
@@ -2,27 +2,60 @@
 #define MAP_WEAVER_GEO_CRS_MANAGER_H
 
 #include "MapWeaverPort.h"
+#include "GeoBoundingBox.h"
 #include "GeoCrs.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
-class GeoBoundingBox;
 class GeoCrs;
+class GeoCrsFootprint;
+class OGRSpatialReference;
 
 // GeoCrsManager
 // - 静态 CRS 管理器：
 //   1) 自动定位并初始化 PROJ 数据库（proj.db）搜索路径；
 //   2) 基于缓存的 CRS 获取/解析；
 //   3) 基于缓存的 WKT 有效性判断；
-//   4) 基于缓存的 CRS 有效范围（自身范围、以及 EPSG:4326 范围）计算。
+//   4) 基于缓存的 CRS 有效范围（自身范围、以及 EPSG:4326 范围）计算；
+//   5) CRS 驻留（interning）：为每个不同的 CRS 分配紧凑的 32 位 id，供 GeoBoundingBox 等对象代替完整 WKT 携带；
+//   6) 可选的持久化元数据缓存：把解析结果（UID、EPSG、规范化 WKT、两种有效范围）保存到文件，供后续进程冷启动时直接映射使用。
 class MAPWEAVERCORE_PORT GeoCrsManager
 {
 public:
-	// 是否已完成（自动或手动）初始化。
+	// 是否已完成（自动或手动）初始化。只读取一个原子标志，不会等待正在进行的初始化。
 	static bool IsInitialized();
 
+	// 在后台线程上执行自动初始化（定位 proj.db 并加载预生成的表），调用方立即返回。
+	// 初始化完成前调用其它接口的线程会等待其完成；可用 IsInitialized() 非阻塞地探测。
+	// 返回 false 表示已初始化、后台初始化已启动过或无法创建线程（此时在首次调用其它接口时同步初始化）。
+	// 不会在库加载时自动启动；需要时由程序在启动阶段显式调用。
+	//
+	// 自动初始化找到的 proj.db 目录会记录到每用户的状态文件（默认位于用户缓存目录，
+	// 可用 MAPWEAVER_PROJ_DB_STATE_FILE 指定路径，设为 NO 则禁用）；下次以相同工作目录/程序目录启动时，
+	// 只需确认 proj.db 仍存在即可跳过目录搜索。
+	static bool StartBackgroundInitialization();
+
+	// 等待 StartBackgroundInitialization() 启动的后台线程结束并回收；未启动时立即返回。
+	// 库不会在静态析构时等待（Windows 下此时持有加载器锁，join 可能死锁）：启动过后台初始化的程序
+	// 须在退出 main 或卸载动态库（FreeLibrary/dlclose）之前调用本函数，以免后台线程访问已析构的全局对象。
+	static void WaitForBackgroundInitialization();
+
+	// 自动初始化的统计（不等待初始化完成；未完成时 isInitialized 为 false，其余字段为默认值）。
+	// 通过 SetProjDbDirectoryUtf8() 手动初始化时不计入。
+	struct InitializationStatistics
+	{
+		bool isInitialized = false;
+		bool ranInBackground = false;       // 由 StartBackgroundInitialization() 的后台线程完成
+		bool restoredFromStateFile = false; // 通过状态文件跳过了目录搜索
+		double milliseconds = 0;            // 自动初始化耗时（含加载持久化缓存与预生成表）
+	};
+
+	static InitializationStatistics GetInitializationStatistics();
+
 	// 获取当前生效的 PROJ 数据库目录（UTF-8，统一用'/'，并保证以'/'结尾）。
 	// 若未初始化或未能确定目录，返回空串。
 	static std::string GetProjDbDirectoryUtf8();
@@ -68,21 +101,208 @@ public:
 
 	// 带缓存地获取一个 GeoCrs（WKT 解析）。
 	// 注意：返回的是共享只读对象；如需可写对象，请拷贝一份。
+	// 同一坐标系的不同写法（WKT1 / WKT2 / PROJJSON / "EPSG:xxxx" 等）返回同一个对象。
 	static std::shared_ptr<const GeoCrs> GetFromWktCached(const std::string& wktUtf8);
 
+	// 批量获取（带缓存）：与逐个调用 GetFromWktCached / GetFromEpsgCached 等价，返回值与输入一一对应，但
+	// - 输入先去重，再只对缓存未命中的项在 threadCount 个线程（<= 0 时取硬件并发数）上并行解析；
+	// - 未命中项在解析前登记为“在途”：同时到达的单项请求或其它批量请求等待本次解析的结果，不会重复解析；
+	// - 解析结果在全部完成后一次性写入缓存（每个缓存分片只加一次锁）；期间调用过 ClearCaches() / SetProjDbDirectoryUtf8() 时不写入。
+	// 适合加载含大量图层的工程时一次性解析全部 CRS。空 WKT / 非正 EPSG code 对应空坐标系。
+	static std::vector<std::shared_ptr<const GeoCrs>> GetFromWktBatch(const std::vector<std::string>& wktsUtf8, int threadCount = 0);
+	static std::vector<std::shared_ptr<const GeoCrs>> GetFromEpsgBatch(const std::vector<int>& epsgCodes, int threadCount = 0);
+
+	// 与 GetFromEpsgCached / GetFromWktCached 相同，但返回预先计算好常用属性的不可变快照（读取不加锁）。
+	// 首次获取时会一次性计算 EPSG（含 AutoIdentifyEPSG）、UID、WKT、PROJJSON 等，之后直接复用。
+	static std::shared_ptr<const FrozenGeoCrs> GetFrozenFromEpsgCached(int epsgCode);
+	static std::shared_ptr<const FrozenGeoCrs> GetFrozenFromWktCached(const std::string& wktUtf8);
+
 	// 带缓存地获取 WKT 对应坐标系的：
 	//  1) EPSG:4326 下的有效范围（经纬度），以及
 	//  2) 该坐标系自身坐标系下的有效范围。
 	// 返回 true 表示两者都有效；若任一无效则返回 false，但 out 参数仍会被赋值（可能为 Invalid）。
 	static bool TryGetValidAreasCached(const std::string& wktUtf8, GeoBoundingBox& outLonLatArea, GeoBoundingBox& outSelfArea);
+	// 同上，按驻留 id 取（见 InternCrs），不导出、不哈希 WKT；id 无效时返回 false，out 参数为 Invalid。
+	static bool TryGetValidAreasCached(std::uint32_t crsId, GeoBoundingBox& outLonLatArea, GeoBoundingBox& outSelfArea);
+
+	// 带缓存地获取 WKT 对应坐标系的有效范围足迹（GeoCrs::GetValidAreaFootprint() 的默认加密密度）。
+	// 始终返回非空指针；失败时足迹无效（IsValid() 为 false）。
+	static std::shared_ptr<const GeoCrsFootprint> GetValidAreaFootprintCached(const std::string& wktUtf8);
+	// 同上，按驻留 id 取；id 无效时足迹无效。
+	static std::shared_ptr<const GeoCrsFootprint> GetValidAreaFootprintCached(std::uint32_t crsId);
+
+	// 启动预热：在 threadCount 个线程（<= 0 时取硬件并发数）上并行填充各层缓存
+	// （解析结果、有效性、EPSG 识别、有效范围、足迹、不可变快照；不会驻留 CRS），避免首个请求承担这些开销。
+	// 返回值与输入一一对应，记录每个条目是否成功及耗时。
+	// - EPSG 版本同时以该坐标系的规范 WKT 预热按 WKT 索引的缓存；
+	// - 坐标转换的预热见 GeoCrsTransform::Warmup()。
+	struct WarmupResult
+	{
+		bool success = false;
+		double milliseconds = 0;
+	};
+
+	static std::vector<WarmupResult> Warmup(const std::vector<int>& epsgCodes, int threadCount = 0);
+	static std::vector<WarmupResult> Warmup(const std::vector<std::string>& wktsUtf8, int threadCount = 0);
+
+	// WKT 对应坐标系解析后的元数据。
+	struct CrsMetadata
+	{
+		bool isValid = false;
+		std::string uidUtf8 = "";
+		int epsgCode = 0;                    // 未能识别时为 0
+		std::string canonicalWktUtf8 = "";   // WKT2_2018，单行
+		GeoBoundingBox lonLatArea;           // 同 GeoCrs::GetValidAreaLonLat()
+		GeoBoundingBox selfArea;             // 同 GeoCrs::GetValidArea()
+	};
+
+	// 带缓存地获取 WKT 的元数据；启用持久化缓存且文件中存在该 WKT 时不解析 WKT。
+	// 返回 outMetadata.isValid。
+	static bool TryGetCrsMetadataCached(const std::string& wktUtf8, CrsMetadata& outMetadata);
+
+	// 持久化元数据缓存：
+	// - 文件按裁剪后的 WKT 的哈希索引，记录 proj.db（路径/大小/修改时间）与 PROJ 版本；加载时任一不符即整体失效；
+	// - 加载只校验文件头并做内存映射（Windows 上整体读入内存，以便保存时可以替换文件），查询时二分查找；
+	// - 启用后，WktToEpsgCodeUtf8 / TryGetValidAreasCached 未命中内存缓存时会先查询该文件，
+	//   再未命中时会计算完整元数据（包括 EPSG 识别），以便 SavePersistentCache() 写出；
+	//   IsWktValidCached 只读取文件中已有的结果，未命中时按普通路径校验，不计算也不写出元数据；
+	// - 也可在初始化前通过 GDAL 配置项（或环境变量）MAPWEAVER_CRS_METADATA_CACHE 指定文件，初始化时自动加载。
+	// 文件不存在或已失效时仍返回 true（以空缓存启用）；仅路径为空时返回 false。
+	static bool EnablePersistentCache(const std::string& cacheFilePathUtf8);
+	static void DisablePersistentCache();
+
+	// 将已加载的条目与本进程解析过的条目合并后写回文件（先写同目录下带进程 id 与随机数的临时文件，再替换）。
+	static bool SavePersistentCache();
+
+	// 当前映射的持久化文件中的条目数；未加载或已失效时为 0。
+	static size_t GetPersistentCacheEntryCount();
+
+	// EPSG 有效范围表中的一条记录。矩形按传统 GIS 轴序（X=经度/Easting）。
+	struct EpsgValidArea
+	{
+		bool hasLonLatArea = false;
+		GB_Rectangle lonLatRect;   // 同 GeoCrs::GetValidAreaLonLat().rect
+		bool hasSelfArea = false;
+		GB_Rectangle selfRect;     // 同 GeoCrs::GetValidArea().rect
+	};
+
+	// EPSG 有效范围表：
+	// - BuildEpsgValidAreaTable：并行计算 proj.db 中全部 EPSG 地理/投影坐标系的两种有效范围，写入紧凑的二进制文件并立即启用；
+	// - LoadEpsgValidAreaTable：加载已生成的表；表记录了 proj.db 的签名，proj.db 变化后自动失效（返回 false）；
+	// - 也可通过 GDAL 配置项（或环境变量）MAPWEAVER_EPSG_VALID_AREA_TABLE 指定文件，初始化时自动加载（不会自动生成）。
+	// 启用后，带 EPSG 权威码且内容与该 EPSG 定义一致（不依赖指纹索引）的 GeoCrs 的 GetValidArea()/GetValidAreaLonLat()（以及 TryGetValidAreasCached）直接查表，
+	// 结果与实时计算一致；已废弃的 code 不入表，仍按实时计算。
+	static bool BuildEpsgValidAreaTable(const std::string& tableFilePathUtf8, bool enableOpenMP = true);
+	static bool LoadEpsgValidAreaTable(const std::string& tableFilePathUtf8);
+
+	// 查表（哈希查找，不触发初始化）；表未加载或不含该 code 时返回 false。
+	static bool TryGetTabulatedEpsgValidArea(int epsgCode, EpsgValidArea& outArea);
+
+	static size_t GetEpsgValidAreaTableSize();
+
+	// EPSG 指纹索引：把“类型 + 椭球 + 本初子午线 + 单位 + 投影方法 + 取整后的投影参数”的指纹映射到候选 EPSG code，
+	// 用于在 AutoIdentifyEPSG/FindBestMatch（需扫描 proj.db）之前快速识别没有权威码的 WKT（如 ESRI 风格 WKT）。
+	// - BuildEpsgFingerprintIndex：并行计算 proj.db 中全部 EPSG 地理/投影坐标系的指纹，写入文件并立即启用；
+	// - LoadEpsgFingerprintIndex：加载已生成的索引；proj.db 变化后自动失效（返回 false）；
+	// - 也可通过 GDAL 配置项（或环境变量）MAPWEAVER_EPSG_FINGERPRINT_INDEX 指定文件，初始化时自动加载（不会自动生成）。
+	// 启用后，GeoCrs::TryGetEpsgCode()（tryAutoIdentify 或 tryFindBestMatch 为 true 时）以及 WktToEpsgCodeUtf8 先查索引。
+	static bool BuildEpsgFingerprintIndex(const std::string& indexFilePathUtf8, bool enableOpenMP = true);
+	static bool LoadEpsgFingerprintIndex(const std::string& indexFilePathUtf8);
+
+	// 按指纹识别 EPSG code：候选经 IsSame 精确校验后才返回，同一定义有多个 code 时现行 code 优先于已废弃的 code；
+	// 索引未加载或无匹配时返回 0（不触发初始化）。
+	static int IdentifyEpsgByFingerprint(const OGRSpatialReference& srs);
+
+	// 索引中不同指纹的个数。
+	static size_t GetEpsgFingerprintIndexSize();
+
+	// CRS 驻留：返回 CRS 在进程内唯一且稳定的 id（按 UID 去重并以 GeoCrs::operator== 确认，同一 CRS 的不同 WKT 写法得到同一 id）。
+	// - 0 表示无效（输入为空、CRS 无效或驻留表已满）；
+	// - id 仅在当前进程内有意义，不要持久化；ClearCaches() 不会使已分配的 id 失效；
+	// - 驻留的 CRS 与其规范化 WKT 在进程生命周期内不释放，驻留表最多容纳 65536 个 CRS。
+	//   只有显式调用本函数（或以 id 表示坐标系的 bbox 做转换时驻留目标 CRS）才会新增条目，查询类接口不会。
+	static std::uint32_t InternCrs(const std::string& wktUtf8);
+	static std::uint32_t InternCrs(const std::shared_ptr<const GeoCrs>& crs);
+
+	// 查找 WKT 已分配的驻留 id，不会驻留新的 CRS；未驻留或无效时返回 0。
+	static std::uint32_t FindCrsId(const std::string& wktUtf8);
+
+	// 按 id 获取共享只读 CRS；id 无效时返回 nullptr。读取不加锁。
+	static std::shared_ptr<const GeoCrs> GetFromCrsId(std::uint32_t crsId);
+
+	// 按 id 获取规范化 WKT（WKT2_2018，单行）；id 无效时返回空串。
+	// 返回的引用在进程生命周期内有效。
+	static const std::string& GetCrsIdWktUtf8(std::uint32_t crsId);
+
+	static size_t GetInternedCrsCount();
+
+	// 缓存访问计数（进程累计，ClearCaches() 不清零）：
+	// - hitCount：直接命中；
+	// - missCount：未命中且由本线程负责解析/计算；
+	// - coalescedCount：未命中，但同一 key 已有其它线程在计算，于是等待其结果而未重复计算；
+	// - evictionCount：因超出内存预算被淘汰的条目数（见 SetCacheMemoryBudget()）。
+	struct CacheCounters
+	{
+		std::uint64_t hitCount = 0;
+		std::uint64_t missCount = 0;
+		std::uint64_t coalescedCount = 0;
+		std::uint64_t evictionCount = 0;
+	};
 
 	static size_t GetCachedEpsgCount();
+	static CacheCounters GetEpsgCacheCounters();
 
 	static size_t GetCachedWktCount();
+	static CacheCounters GetWktCacheCounters();
 
 	static size_t GetCachedDefinitionCount();
+	static CacheCounters GetDefinitionCacheCounters();
 
 	static size_t GetCachedValidAreaCount();
+	static CacheCounters GetValidAreaCacheCounters();
+
+	// 按 UID 去重后的不同坐标系个数。EPSG / WKT / 用户定义缓存中等价的条目共享同一个 GeoCrs 对象，
+	// 有效范围、足迹、不可变快照也按 UID 只计算一次；上面各缓存的条目数仍按输入字符串计。
+	static size_t GetCachedCanonicalCrsCount();
+
+	// 缓存内存预算：限制全部 CRS 缓存（解析结果、有效性、有效范围、元数据、快照、足迹、驻留 id 及按 UID 的第二级缓存）
+	// 的近似总字节数（0 表示不限制，默认）。
+	// - 总预算按固定比例分给各缓存（WKT 20%、用户定义 14%、元数据 10%、EPSG 8%，其余各 4%~8%）；
+	//   各缓存整体计算预算（hash 分布不均时不会提前淘汰），插入后超出时按分段 LRU 淘汰：只被访问过一次的条目先于反复访问的条目被淘汰。
+	// - 字节数按键、值与固定开销估算，只适合作数量级控制；GeoCrs 按其内部 OGR/PROJ 对象的数量级计入持有它的每个缓存。
+	//   按 UID 合并等价坐标系的登记表只保存弱引用，不持有 GeoCrs。
+	// - 各线程另有容量有限的私有视图，其引用的条目（包括已被淘汰、尚未被视图丢弃的条目）单独统计，见 CacheMemoryGauge。
+	// - EPSG:4326 / EPSG:3857 不会被淘汰。被淘汰的条目若仍被调用方持有，不会失效；再次请求时重新解析。
+	// 也可通过 GDAL 配置项（或环境变量）MAPWEAVER_CRS_CACHE_BUDGET_MB（单位 MB）在自动初始化时设置。
+	static void SetCacheMemoryBudget(size_t bytes);
+	static size_t GetCacheMemoryBudget();
+
+	// 缓存内存占用（近似值）：
+	// - entryCount / approximateBytes：全局表中的条目数与估算字节数（含不可淘汰的条目，不含各线程私有视图中的引用）；
+	// - pinnedBytes：其中不参与淘汰的条目的字节数；
+	// - budgetBytes：分给该缓存的预算（0 表示不限制）；
+	// - evictionCount：进程累计的淘汰条目数（ClearCaches() 不清零）；
+	// - localViewEntryCount / localViewBytes：各线程私有视图合计引用的条目数与字节数。多数条目同时在全局表中计入；
+	//   已被淘汰的条目在被视图丢弃（视图写满、缓存清空或线程退出）之前仍占用内存，只体现在这里。
+	struct CacheMemoryGauge
+	{
+		size_t entryCount = 0;
+		size_t approximateBytes = 0;
+		size_t pinnedBytes = 0;
+		size_t budgetBytes = 0;
+		std::uint64_t evictionCount = 0;
+		size_t localViewEntryCount = 0;
+		size_t localViewBytes = 0;
+	};
+
+	static CacheMemoryGauge GetEpsgCacheMemoryGauge();
+	static CacheMemoryGauge GetWktCacheMemoryGauge();
+	static CacheMemoryGauge GetWktValidityCacheMemoryGauge();
+	static CacheMemoryGauge GetDefinitionCacheMemoryGauge();
+	static CacheMemoryGauge GetValidAreaCacheMemoryGauge();
+
+	// 全部 CRS 缓存的合计（含上面五个缓存与其它内部缓存，以及按 UID 合并的登记表）。
+	static CacheMemoryGauge GetTotalCacheMemoryGauge();
 
 private:
 	static void EnsureInitializedInternal();
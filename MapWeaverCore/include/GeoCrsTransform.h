@@ -2,25 +2,143 @@
 #define MAP_WEAVER_GEO_CRS_TRANSFORM_H
 
 #include "MapWeaverPort.h"
+#include "GeoCrsManager.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 class GB_Point2d;
+class GB_Rectangle;
 class GeoBoundingBox;
 
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+
+// GeoCrsPreparedTransform
+// - 由 GeoCrsTransform::Prepare() 创建的“预解析”转换句柄：
+//   1) 源/目标 WKT 的裁剪、CRS 缓存查找与内容哈希计算只在 Prepare() 时进行一次，之后每次调用不再处理 WKT 字符串；
+//   2) 句柄创建后不可变，拷贝为浅拷贝，可在多个线程间共享；每个线程内部仍使用各自的 OGRCoordinateTransformation；
+//   3) 各接口的语义（轴顺序、经度归一化、失败时的输出约定）与 GeoCrsTransform 的同名静态函数一致。
+class MAPWEAVERCORE_PORT GeoCrsPreparedTransform
+{
+public:
+    // 默认构造为无效句柄。
+    GeoCrsPreparedTransform();
+
+    // 源/目标 CRS 均有效，且（在 Prepare 的调用线程上）能够创建坐标转换时返回 true。
+    bool IsValid() const;
+
+    bool TransformPoint(const GB_Point2d& sourcePoint, GB_Point2d& outPoint) const;
+
+    bool TransformPoint(GB_Point2d& inOutPoint) const;
+
+    // outStatus / outInvalidCount 的语义同 GeoCrsTransform::TransformPoints。
+    bool TransformPoints(const std::vector<GB_Point2d>& sourcePoints, std::vector<GB_Point2d>& outPoints, bool enableOpenMP = false, std::vector<std::uint8_t>* outStatus = nullptr, size_t* outInvalidCount = nullptr) const;
+
+    bool TransformPoints(std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP = false, std::vector<std::uint8_t>* outStatus = nullptr, size_t* outInvalidCount = nullptr) const;
+
+    // 语义同 GeoCrsTransform::TransformXYArrays。
+    bool TransformXYArrays(double* x, double* y, double* z, size_t count, size_t stride = 1, std::uint8_t* outStatus = nullptr, bool enableOpenMP = false) const;
+
+    bool TransformXY(double x, double y, double& outX, double& outY) const;
+
+    bool TransformXYZ(double x, double y, double z, double& outX, double& outY, double& outZ) const;
+
+    // 语义同 GeoCrsTransform::TransformXYZPoints。
+    bool TransformXYZPoints(std::vector<double>& x, std::vector<double>& y, std::vector<double>& z, std::vector<std::uint8_t>* outStatus = nullptr, bool enableOpenMP = false, double epoch = 0.0) const;
+
+    // 语义同 GeoCrsTransform::TransformXYZTArrays。
+    bool TransformXYZTArrays(double* x, double* y, double* z, double* t, size_t count, size_t stride = 1, std::uint8_t* outStatus = nullptr, bool enableOpenMP = false) const;
+
+    // sourceRect 位于源 CRS 下；输出的 outBox.wktUtf8 为目标 CRS 的规范化 WKT（WKT2_2018）。
+    bool TransformBoundingBox(const GB_Rectangle& sourceRect, GeoBoundingBox& outBox, int sampleGridCount = 11) const;
+
+    // 语义同 GeoCrsTransform::TransformBoundingBoxParts。
+    bool TransformBoundingBoxParts(const GB_Rectangle& sourceRect, std::vector<GeoBoundingBox>& outParts, int sampleGridCount = 11) const;
+
+private:
+    friend class GeoCrsTransform;
+
+    struct Impl;
+    std::shared_ptr<const Impl> impl;
+};
+
+// GeoCrsApproxTransform
+// - 由 GeoCrsTransform::PrepareApprox() 创建的近似（插值）转换，面向栅格重投影等“大量密集点”的场景：
+//   1) 在源 CRS 的矩形范围上自适应地采样精确转换：每个格子检查边中点与中心点的插值误差，超过容差则四分，直至最大深度；
+//   2) 查询时定位到叶子格子，用 4 个角点做双线性插值；
+//   3) 范围外的点、采样失败或达到最大深度仍超差的格子（如跨反经线、投影奇点附近）自动回退到精确转换；
+//   4) 构建后不可变，拷贝为浅拷贝，可在多个线程间共享。
+// - 误差为插值结果与精确结果之差的欧氏距离，单位为目标 CRS 的单位；栅格重投影通常取目标像元大小的 1/8 左右。
+class MAPWEAVERCORE_PORT GeoCrsApproxTransform
+{
+public:
+    // 默认构造为无效对象。
+    GeoCrsApproxTransform();
+
+    bool IsValid() const;
+
+    // 构建时指定的误差容差。
+    double GetTolerance() const;
+
+    // 可插值格子在检查点上实际达到的最大误差（<= GetTolerance()）。
+    double GetMaxError() const;
+
+    // 可插值的叶子格子数量 / 回退到精确转换的叶子格子数量。
+    size_t GetInterpolatedCellCount() const;
+    size_t GetExactCellCount() const;
+
+    bool TransformXY(double x, double y, double& outX, double& outY) const;
+
+    // 原地转换 count 个点（x[i], y[i]）；outStatus 非空时需至少有 count 个元素，逐点写入 1（成功）/ 0（失败）。
+    // - 返回值：所有点均成功变换返回 true；任一失败返回 false（失败点保持原值）。
+    bool TransformXYArrays(double* x, double* y, size_t count, std::uint8_t* outStatus = nullptr, bool enableOpenMP = false) const;
+
+    bool TransformPoints(std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP = false) const;
+
+private:
+    friend class GeoCrsTransform;
+
+    struct Impl;
+    std::shared_ptr<const Impl> impl;
+};
+
 // GeoCrsTransform
 // - 静态坐标系转换工具类（线程安全设计）：
-//   1) 内部为每个线程维护一份 OGRCoordinateTransformation 缓存（避免跨线程共享 CT 对象）；
+//   1) 每个 CRS 对在进程级创建一次“原型”OGRCoordinateTransformation（保存在有界的原型缓存中），
+//      各线程从原型 Clone() 出私有实例，保存在线程级有界 LRU 缓存中（避免跨线程共享 CT 对象，也避免每个线程重复查询 proj.db）；
 //   2) 全程采用传统 GIS 轴顺序（X=经度/Easting, Y=纬度/Northing），以与 GB_Point2d/GB_Rectangle 的语义一致；
 //   3) 对 GeoBoundingBox 会先与源 CRS 的“自身有效范围”求交，再计算目标空间的 AABB：
 //      - GDAL >= 3.4 优先使用 TransformBounds(densify_pts=sampleGridCount) 以更好地覆盖非线性投影边界；
 //      - 其它版本/失败情况则退化为网格采样；
-//      - 若目标为经纬度坐标系且跨越反经线（日期变更线），由于单个矩形无法表达两段经度，这里会保守返回 [-180,180]。
+//      - 若目标为经纬度坐标系且跨越反经线（日期变更线），由于单个矩形无法表达两段经度，这里会保守返回 [-180,180]；
+//        需要精确范围时使用 TransformBoundingBoxParts()（返回 1~2 段）。
 //   4) 变换失败时返回 false，并尽量保持输出/原地数据不被破坏。
+//   GeoBoundingBox 输入只以驻留 id 表示坐标系（UsesCrsId()）时，输出同样只携带目标 CRS 的 id，否则输出规范化 WKT。
+//   5) EPSG:4326 / EPSG:3857 / WGS84 UTM（EPSG:326xx、327xx）两两之间的点转换走闭式快速路径（不经 PROJ 管线），
+//      与 PROJ 结果之差：WebMercator 为浮点舍入级，UTM 在距中央经线 30° 以内 < 1 mm；
+//      超出定义域的点（极区、远离中央经线等）以及 bbox 计算仍使用 PROJ。
 class MAPWEAVERCORE_PORT GeoCrsTransform
 {
 public:
+    // （0）预解析一对 CRS，返回可复用的转换句柄（见 GeoCrsPreparedTransform）。
+    // - 适用于对同一 CRS 对反复调用的场景（例如逐要素转换），避免每次调用都重新解析/查找 WKT。
+    // - 失败时返回无效句柄（IsValid() == false）。
+    static GeoCrsPreparedTransform Prepare(const std::string& sourceWktUtf8, const std::string& targetWktUtf8);
+
+    // （0）在源 CRS 的矩形 sourceRect 上构建近似（插值）转换（见 GeoCrsApproxTransform）。
+    // - maxError：允许的插值误差（目标 CRS 单位），必须 > 0；maxDepth：四叉树最大深度（0~16，叶子最小边长为 sourceRect 的 1/2^maxDepth）。
+    // - 四叉树节点总数另有上限（约 26 万个），达到后剩余超差的格子回退到精确转换。
+    // - 失败时返回无效对象（IsValid() == false）。
+    static GeoCrsApproxTransform PrepareApprox(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const GB_Rectangle& sourceRect, double maxError, int maxDepth = 8);
+
     // （1）把单个 GB_Point2d 从一个 WKT 转到另一个 WKT（输出到 outPoint）。
     static bool TransformPoint(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const GB_Point2d& sourcePoint, GB_Point2d& outPoint);
 
@@ -30,11 +148,21 @@ public:
     // （2）将多个 GB_Point2d 从一个 WKT 转到另一个 WKT（输出到 outPoints）。
     // - enableOpenMp=true 时，若编译器支持 OpenMP，则并行处理。
     // - 返回值：所有点均成功变换返回 true；任一失败返回 false（但成功点仍会写入 outPoints）。
-    static bool TransformPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const std::vector<GB_Point2d>& sourcePoints, std::vector<GB_Point2d>& outPoints, bool enableOpenMP = false);
+    // - outStatus 非空时会被调整为与输入等长，逐点写入 1（成功）/ 0（失败，点保持原值），可据此一次性过滤失败点；
+    //   outInvalidCount 非空时写入失败点数量。
+    static bool TransformPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const std::vector<GB_Point2d>& sourcePoints, std::vector<GB_Point2d>& outPoints, bool enableOpenMP = false, std::vector<std::uint8_t>* outStatus = nullptr, size_t* outInvalidCount = nullptr);
 
     // （2）将多个 GB_Point2d 从一个 WKT 转到另一个 WKT（原地修改）。
-    // - 返回值语义同上。
-    static bool TransformPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP = false);
+    // - 返回值与 outStatus / outInvalidCount 语义同上。
+    static bool TransformPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP = false, std::vector<std::uint8_t>* outStatus = nullptr, size_t* outInvalidCount = nullptr);
+
+    // （2）以结构数组（SoA）形式原地转换 count 个点：第 i 个点为 (x[i*stride], y[i*stride], z[i*stride])。
+    // - z 可为 nullptr（仅转换平面坐标）；stride 以 double 个数计，必须 >= 1。
+    // - stride == 1 时直接在调用方数组上转换（不做收集/分散，也不备份原值），失败点的 x/y/z 写为 HUGE_VAL；
+    //   stride > 1 时按块收集转换，只写回成功点，失败点保持原值。需要区分失败点时请传入 outStatus。
+    // - outStatus 非空时需至少有 count 个元素，逐点写入 1（成功）/ 0（失败）。
+    // - 返回值：所有点均成功变换返回 true；任一失败返回 false。
+    static bool TransformXYArrays(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double* x, double* y, double* z, size_t count, size_t stride = 1, std::uint8_t* outStatus = nullptr, bool enableOpenMP = false);
 
     // （3）传入 x、y 坐标从一个 WKT 转到另一个 WKT。
     static bool TransformXY(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double x, double y, double& outX, double& outY);
@@ -42,19 +170,99 @@ public:
     // （4）传入 x、y、z 坐标从一个 WKT 转到另一个 WKT。
     static bool TransformXYZ(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double x, double y, double z, double& outX, double& outY, double& outZ);
 
+    // （4）批量转换三维坐标（x、y、z 三个等长数组，原地修改），按块处理，enableOpenMP=true 时按块并行。
+    // - epoch > 0 时作为所有点的坐标历元（十进制年，如 2020.5），用于与时间相关的动态基准转换；<= 0 表示不指定。
+    // - outStatus 非空时会被调整为与输入等长，逐点写入 1（成功）/ 0（失败）；失败点写为 HUGE_VAL（同 stride == 1 的 TransformXYArrays）。
+    // - 返回值：所有点均成功变换返回 true；任一失败（或数组长度不一致）返回 false。
+    static bool TransformXYZPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, std::vector<double>& x, std::vector<double>& y, std::vector<double>& z, std::vector<std::uint8_t>* outStatus = nullptr, bool enableOpenMP = false, double epoch = 0.0);
+
+    // （4）以结构数组形式原地转换 count 个四维点：第 i 个点为 (x[i*stride], y[i*stride], z[i*stride], t[i*stride])。
+    // - t 为逐点的坐标历元（十进制年）；z、t 可为 nullptr。
+    // - stride、outStatus 以及失败点的约定同 TransformXYArrays。
+    static bool TransformXYZTArrays(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double* x, double* y, double* z, double* t, size_t count, size_t stride = 1, std::uint8_t* outStatus = nullptr, bool enableOpenMP = false);
+
     // （5）把单个 GeoBoundingBox 从当前 wkt 转到另一个 wkt（输出到 outBox）。
     static bool TransformBoundingBox(const GeoBoundingBox& sourceBox, const std::string& targetWktUtf8, GeoBoundingBox& outBox, int sampleGridCount = 11);
 
     // （5）把单个 GeoBoundingBox 从当前 wkt 转到另一个 wkt（原地修改）。
     static bool TransformBoundingBox(GeoBoundingBox& inOutBox, const std::string& targetWktUtf8, int sampleGridCount = 11);
 
+    // （5）把单个 GeoBoundingBox 转到另一个 wkt，结果以 1~2 段表示（输出到 outParts）。
+    // - 目标为经纬度坐标系且结果跨越反经线时，返回 [west, 180] 与 [-180, east] 两段
+    //   （分段规则同 GeoCrs::GetValidAreaLonLatSegments），而不是保守的 [-180, 180]；
+    // - 包含极点等无法拆分的情况仍返回 1 段 [-180, 180]；其它情况返回 1 段，与 TransformBoundingBox 的结果相同。
+    static bool TransformBoundingBoxParts(const GeoBoundingBox& sourceBox, const std::string& targetWktUtf8, std::vector<GeoBoundingBox>& outParts, int sampleGridCount = 11);
+
     // （6）把多个 GeoBoundingBox 从各自的 wkt 转到另一个 wkt（输出到 outBoxes）。
     // - 返回值：所有 bbox 均成功变换返回 true；任一失败返回 false（失败项会被写成 Invalid）。
+    // - 内部按源 CRS 分桶：同一桶内的 bbox 共用一个已解析的转换对象（只解析一次 CRS 对），
+    //   每个 bbox 的算法与 TransformBoundingBox 相同（含反经线、极点处理），结果与逐个调用完全一致。
     static bool TransformBoundingBoxes(const std::vector<GeoBoundingBox>& sourceBoxes, const std::string& targetWktUtf8, std::vector<GeoBoundingBox>& outBoxes, bool enableOpenMP = false, int sampleGridCount = 11);
 
     // （6）把多个 GeoBoundingBox 从各自的 wkt 转到另一个 wkt（原地修改）。
     static bool TryTransformBoundingBoxes(std::vector<GeoBoundingBox>& inOutBoxes, const std::string& targetWktUtf8, bool enableOpenMP = false, int sampleGridCount = 11);
 
+    // （2）流式点转换：数据分块流经“读取 -> 并行转换 -> 按序写出”的流水线，驻留内存与总点数无关。
+    // - reader(buffer, capacity)：向 buffer 写入至多 capacity 个点并返回实际数量；返回 0 表示数据结束。
+    //   只在一个内部读取线程上被串行调用。
+    // - writer(points, status, count)：按读取顺序接收转换后的块；status[i] 为 1（成功）/ 0（失败，点保持原值）。
+    //   只在调用线程上被串行调用；返回 false 时中止整个流水线。
+    // - chunkSize：每块点数（0 时取默认值 65536）；workerCount：转换线程数（<= 0 时取硬件并发数）。
+    //   同时在途的块数为 workerCount + 2，驻留内存约为 (workerCount + 2) * chunkSize * 33 字节。
+    // - 返回值：所有点均成功变换且 writer 未中止时返回 true。
+    // - reader / writer 抛出的异常（以及内部转换中的异常）会中止流水线，待所有内部线程结束后在调用线程上重新抛出。
+    struct StreamStatistics
+    {
+        std::uint64_t pointCount = 0;  // 已写出的点数
+        std::uint64_t failedCount = 0; // 其中转换失败的点数
+        std::uint64_t chunkCount = 0;  // 已写出的块数
+        double seconds = 0;            // 流水线总耗时（可据此计算吞吐量）
+    };
+
+    using PointChunkReader = std::function<size_t(GB_Point2d* buffer, size_t capacity)>;
+    using PointChunkWriter = std::function<bool(const GB_Point2d* points, const std::uint8_t* status, size_t count)>;
+
+    static bool TransformPointStream(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const PointChunkReader& reader, const PointChunkWriter& writer, size_t chunkSize = 0, int workerCount = 0, StreamStatistics* outStatistics = nullptr);
+
+    // （7）缓存统计与控制。
+    struct CacheStatistics
+    {
+        std::uint64_t hitCount = 0;             // 线程缓存命中次数（所有线程累计）
+        std::uint64_t missCount = 0;            // 线程缓存未命中次数
+        std::uint64_t evictionCount = 0;        // 因容量上限被淘汰的线程缓存项数
+        std::uint64_t prototypeCreateCount = 0; // 进程级原型创建次数
+        double prototypeCreateMilliseconds = 0; // 原型创建累计耗时
+        std::uint64_t cloneCount = 0;           // 从原型 Clone() 线程实例的次数
+        double cloneMilliseconds = 0;           // Clone() 累计耗时
+        size_t prototypeCount = 0;              // 当前缓存的原型数量
+        std::uint64_t prototypeEvictionCount = 0; // 因容量上限被淘汰的原型数量
+    };
+
+    // 启动预热：在 threadCount 个线程（<= 0 时取硬件并发数）上并行解析各 CRS 对（源 WKT, 目标 WKT），
+    // 计算两端有效范围并创建进程级转换原型（含快速路径校验），使首次请求只需从原型 Clone()。
+    // 返回值与输入一一对应，记录每对是否成功及耗时。CRS 自身各层缓存的预热见 GeoCrsManager::Warmup()。
+    // CRS 对多于原型缓存容量（SetPrototypeCacheCapacity）时，较早预热的原型会被淘汰。
+    // 结果类型与 GeoCrsManager::Warmup() 共用。
+    using WarmupResult = GeoCrsManager::WarmupResult;
+
+    static std::vector<WarmupResult> Warmup(const std::vector<std::pair<std::string, std::string>>& wktPairsUtf8, int threadCount = 0);
+
+    // 设置/获取每个线程最多缓存的 CRS 对数量（默认 64，最小 1）；对已存在的线程在下一次插入时生效。
+    static void SetThreadCacheCapacity(size_t capacity);
+    static size_t GetThreadCacheCapacity();
+
+    // 设置/获取进程级原型缓存最多保留的 CRS 对数量（默认 256，最小 1）；超出时淘汰最久未使用的原型，在下一次插入时生效。
+    // 每个原型持有一个 OGRCoordinateTransformation 与两份 SRS，被淘汰后如再次请求会重新创建。
+    static void SetPrototypeCacheCapacity(size_t capacity);
+    static size_t GetPrototypeCacheCapacity();
+
+    static CacheStatistics GetCacheStatistics();
+    static void ResetCacheStatistics();
+
+    // 清空进程级原型缓存；各线程缓存在其下一次查询时自动清空。
+    // - 已创建的 GeoCrsPreparedTransform 句柄仍然有效（会按需重新创建）。
+    static void ClearCaches();
+
 private:
     GeoCrsTransform() = delete;
     ~GeoCrsTransform() = delete;
@@ -62,4 +270,8 @@ private:
     GeoCrsTransform& operator=(const GeoCrsTransform&) = delete;
 };
 
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+
 #endif
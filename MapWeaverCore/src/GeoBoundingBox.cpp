@@ -2,6 +2,7 @@
 
 #include "GeoCrsManager.h"
 #include "GeoCrs.h"
+#include "GeoCrsFootprint.h"
 #include "GB_Crypto.h"
 #include "GB_IO.h"
 #include "GB_Utf8String.h"
@@ -228,6 +229,29 @@ namespace
 			return 0;
 		}
 	}
+
+	// 以下按坐标系取有效范围/足迹：以驻留 id 表示时直接按 id 取（不导出、不哈希 WKT），
+	// 否则按 wktUtf8 取（GeoCrsManager 内部会裁剪）。
+	static bool HasCrs(const GeoBoundingBox& box)
+	{
+		return box.UsesCrsId() || !GB_Utf8Trim(box.wktUtf8).empty();
+	}
+
+	static void GetCrsValidAreas(const GeoBoundingBox& box, GeoBoundingBox& outLonLatArea, GeoBoundingBox& outSelfArea)
+	{
+		if (box.UsesCrsId())
+		{
+			GeoCrsManager::TryGetValidAreasCached(box.crsId, outLonLatArea, outSelfArea);
+			return;
+		}
+
+		GeoCrsManager::TryGetValidAreasCached(box.wktUtf8, outLonLatArea, outSelfArea);
+	}
+
+	static std::shared_ptr<const GeoCrsFootprint> GetCrsValidFootprint(const GeoBoundingBox& box)
+	{
+		return box.UsesCrsId() ? GeoCrsManager::GetValidAreaFootprintCached(box.crsId) : GeoCrsManager::GetValidAreaFootprintCached(box.wktUtf8);
+	}
 }
 
 const GeoBoundingBox GeoBoundingBox::Invalid = GeoBoundingBox();
@@ -249,11 +273,17 @@ GeoBoundingBox::GeoBoundingBox(const std::string& wktUtf8, const GB_Rectangle& r
 	Set(wktUtf8, rect);
 }
 
+GeoBoundingBox::GeoBoundingBox(std::uint32_t crsId, const GB_Rectangle& rect)
+{
+	Reset();
+	Set(crsId, rect);
+}
+
 GeoBoundingBox::~GeoBoundingBox() = default;
 
 bool GeoBoundingBox::operator==(const GeoBoundingBox& other) const
 {
-	if (wktUtf8 == other.wktUtf8)
+	if (UsesCrsId() == other.UsesCrsId() && (UsesCrsId() ? crsId == other.crsId : wktUtf8 == other.wktUtf8))
 	{
 		return (rect == other.rect);
 	}
@@ -263,8 +293,8 @@ bool GeoBoundingBox::operator==(const GeoBoundingBox& other) const
 		return false;
 	}
 
-	std::shared_ptr<const GeoCrs> thisCrs = GeoCrsManager::GetFromWktCached(wktUtf8);
-	std::shared_ptr<const GeoCrs> otherCrs = GeoCrsManager::GetFromWktCached(other.wktUtf8);
+	std::shared_ptr<const GeoCrs> thisCrs = UsesCrsId() ? GeoCrsManager::GetFromCrsId(crsId) : GeoCrsManager::GetFromWktCached(wktUtf8);
+	std::shared_ptr<const GeoCrs> otherCrs = other.UsesCrsId() ? GeoCrsManager::GetFromCrsId(other.crsId) : GeoCrsManager::GetFromWktCached(other.wktUtf8);
 	if (thisCrs == nullptr || otherCrs == nullptr)
 	{
 		return false;
@@ -285,25 +315,66 @@ bool GeoBoundingBox::IsValid() const
 		return false;
 	}
 
+	if (UsesCrsId())
+	{
+		// 驻留表只收录有效的 CRS。
+		return GeoCrsManager::GetFromCrsId(crsId) != nullptr;
+	}
+
 	return GeoCrsManager::IsWktValidCached(wktUtf8);
 }
 
 void GeoBoundingBox::Reset()
 {
 	wktUtf8.clear();
+	crsId = 0;
 	rect.Reset();
 }
 
 void GeoBoundingBox::Set(const std::string& wktUtf8, const GB_Rectangle& rect)
 {
 	this->wktUtf8 = wktUtf8;
+	this->crsId = 0;
 	this->rect = rect;
 	this->rect.Normalize();
 }
 
+void GeoBoundingBox::Set(std::uint32_t crsId, const GB_Rectangle& rect)
+{
+	this->wktUtf8.clear();
+	this->crsId = crsId;
+	this->rect = rect;
+	this->rect.Normalize();
+}
+
+const std::string& GeoBoundingBox::GetWktUtf8() const
+{
+	if (UsesCrsId())
+	{
+		return GeoCrsManager::GetCrsIdWktUtf8(crsId);
+	}
+
+	return wktUtf8;
+}
+
+std::uint32_t GeoBoundingBox::GetCrsId() const
+{
+	if (UsesCrsId())
+	{
+		return crsId;
+	}
+
+	return GeoCrsManager::FindCrsId(wktUtf8);
+}
+
+bool GeoBoundingBox::UsesCrsId() const
+{
+	return wktUtf8.empty() && crsId != 0;
+}
+
 std::string GeoBoundingBox::SerializeToString() const
 {
-	const std::string trimmedWkt = GB_Utf8Trim(wktUtf8);
+	const std::string trimmedWkt = GB_Utf8Trim(GetWktUtf8());
 	std::string wktField = trimmedWkt;
 
 	if (!trimmedWkt.empty() && GeoCrsManager::IsWktValidCached(trimmedWkt))
@@ -333,15 +404,16 @@ std::string GeoBoundingBox::SerializeToString() const
 
 GB_ByteBuffer GeoBoundingBox::SerializeToBinary() const
 {
+	const std::string trimmedWkt = GB_Utf8Trim(GetWktUtf8());
+
 	GB_ByteBuffer buffer;
-	buffer.reserve(32 + wktUtf8.size());
+	buffer.reserve(32 + trimmedWkt.size());
 
 	GB_ByteBufferIO::AppendUInt32LE(buffer, GB_ClassMagicNumber);
 	GB_ByteBufferIO::AppendUInt32LE(buffer, kGeoBoundingBoxBinaryTag);
 	GB_ByteBufferIO::AppendUInt16LE(buffer, kGeoBoundingBoxBinaryVersion);
 	GB_ByteBufferIO::AppendUInt16LE(buffer, 0);
 
-	const std::string trimmedWkt = GB_Utf8Trim(wktUtf8);
 	const size_t wktSize = trimmedWkt.size();
 	const uint32_t wktSizeU32 = (wktSize <= static_cast<size_t>(std::numeric_limits<uint32_t>::max()))
 		? static_cast<uint32_t>(wktSize)
@@ -512,20 +584,14 @@ bool GeoBoundingBox::Deserialize(const std::string& data)
 
 bool GeoBoundingBox::ClampRectToCrsValidArea()
 {
-	const std::string trimmedWkt = GB_Utf8Trim(wktUtf8);
-	if (trimmedWkt.empty())
-	{
-		return false;
-	}
-
-	if (!IsFiniteRectangle(rect))
+	if (!HasCrs(*this) || !IsFiniteRectangle(rect))
 	{
 		return false;
 	}
 
 	GeoBoundingBox lonLatArea;
 	GeoBoundingBox selfArea;
-	GeoCrsManager::TryGetValidAreasCached(trimmedWkt, lonLatArea, selfArea);
+	GetCrsValidAreas(*this, lonLatArea, selfArea);
 
 	if (!selfArea.rect.IsValid())
 	{
@@ -558,3 +624,52 @@ GeoBoundingBox GeoBoundingBox::ClampedRectToCrsValidArea() const
 	result.ClampRectToCrsValidArea();
 	return result;
 }
+
+bool GeoBoundingBox::IntersectsCrsValidFootprint() const
+{
+	if (!HasCrs(*this) || !IsFiniteRectangle(rect))
+	{
+		return false;
+	}
+
+	const std::shared_ptr<const GeoCrsFootprint> footprint = GetCrsValidFootprint(*this);
+	if (footprint->IsValid())
+	{
+		return footprint->IntersectsRect(rect);
+	}
+
+	GeoBoundingBox lonLatArea;
+	GeoBoundingBox selfArea;
+	GetCrsValidAreas(*this, lonLatArea, selfArea);
+	if (!selfArea.rect.IsValid())
+	{
+		return false;
+	}
+
+	return rect.minX <= selfArea.rect.maxX && selfArea.rect.minX <= rect.maxX &&
+		rect.minY <= selfArea.rect.maxY && selfArea.rect.minY <= rect.maxY;
+}
+
+bool GeoBoundingBox::ClampRectToCrsValidFootprint()
+{
+	if (!HasCrs(*this) || !IsFiniteRectangle(rect))
+	{
+		return false;
+	}
+
+	const std::shared_ptr<const GeoCrsFootprint> footprint = GetCrsValidFootprint(*this);
+	if (!footprint->IsValid())
+	{
+		return ClampRectToCrsValidArea();
+	}
+
+	const GB_Rectangle clipped = footprint->ClipRect(rect);
+	if (!clipped.IsValid() || clipped.Area() == 0)
+	{
+		*this = Invalid;
+		return false;
+	}
+
+	rect = clipped;
+	return true;
+}
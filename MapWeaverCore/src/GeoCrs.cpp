@@ -1,5 +1,6 @@
 ﻿#include "GeoCrs.h"
 #include "GeoBoundingBox.h"
+#include "GeoCrsFootprint.h"
 #include "Geometry/GB_Point2d.h"
 #include "Geometry/GB_Rectangle.h"
 #include "GB_Logger.h"
@@ -10,6 +11,7 @@
 #include "ogr_srs_api.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -19,6 +21,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace
@@ -150,6 +153,26 @@ namespace
 		return hashValue;
 	}
 
+	// 与 Fnv1a64 相互独立的第二个 64 位哈希（逐字节乘加 + MurmurHash3 fmix64 收尾），二者拼成 128 位 UID。
+	static uint64_t Mix64Hash(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		uint64_t hashValue = 0x9e3779b97f4a7c15ull ^ static_cast<uint64_t>(size);
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hashValue = (hashValue + bytes[i]) * 0xff51afd7ed558ccdull;
+			hashValue ^= hashValue >> 29;
+		}
+
+		hashValue ^= hashValue >> 33;
+		hashValue *= 0xff51afd7ed558ccdull;
+		hashValue ^= hashValue >> 33;
+		hashValue *= 0xc4ceb9fe1a85ec53ull;
+		hashValue ^= hashValue >> 33;
+		return hashValue;
+	}
+
 	static std::string ToHex64(uint64_t value)
 	{
 		static const char* const hexChars = "0123456789abcdef";
@@ -240,6 +263,99 @@ namespace
 		return std::string(wkt.get());
 	}
 
+	// GetValidAreaLonLat() 结果所用的 EPSG:4326 WKT。只计算一次；proj.db 不可用时为空串（调用方需回退）。
+	static const std::string& GetLonLatAreaWktUtf8()
+	{
+		static const std::string wkt = []() -> std::string {
+			OGRSpatialReference epsg4326;
+			if (epsg4326.importFromEPSG(4326) != OGRERR_NONE)
+			{
+				return "";
+			}
+			EnsureTraditionalGisAxisOrder(epsg4326);
+
+			const char* const options[] = { "FORMAT=WKT2_2018", "MULTILINE=NO", nullptr };
+			return ExportSrsToWktUtf8(epsg4326, options);
+		}();
+		return wkt;
+	}
+
+	// operator== 的 IsSame 结果表：key 为两侧的 128 位内容哈希（按大小排序，IsSame 对称）及各自的轴顺序。
+	// 不能用 UID 作 key：EPSG UID 只取自根 AUTHORITY，改动过参数但保留权威码的 WKT 与原坐标系 UID 相同。
+	struct IsSameKey
+	{
+		GeoCrs::Uid128 first;
+		GeoCrs::Uid128 second;
+		unsigned int axisFlags = 0;
+
+		bool operator==(const IsSameKey& other) const
+		{
+			return first == other.first && second == other.second && axisFlags == other.axisFlags;
+		}
+	};
+
+	struct IsSameKeyHasher
+	{
+		size_t operator()(const IsSameKey& key) const
+		{
+			uint64_t hashValue = key.first.high ^ (key.first.low * 0x9e3779b97f4a7c15ull);
+			hashValue ^= (key.second.high + 0x9e3779b97f4a7c15ull + (hashValue << 6) + (hashValue >> 2));
+			hashValue ^= (key.second.low * 0xff51afd7ed558ccdull) + key.axisFlags;
+			return static_cast<size_t>(hashValue ^ (hashValue >> 32));
+		}
+	};
+
+	// 条目数达到上限时整体清空，避免大量一次性 CRS 对无限增长。
+	constexpr size_t kIsSameTableMaxEntries = 65536;
+
+	std::mutex g_isSameTableMutex;
+	std::unordered_map<IsSameKey, bool, IsSameKeyHasher> g_isSameTable;
+
+	static IsSameKey MakeIsSameKey(const GeoCrs::Uid128& firstHash, bool firstTraditional, const GeoCrs::Uid128& secondHash, bool secondTraditional)
+	{
+		IsSameKey key;
+		const bool swapped = secondHash < firstHash;
+		key.first = swapped ? secondHash : firstHash;
+		key.second = swapped ? firstHash : secondHash;
+		const bool keyFirstTraditional = swapped ? secondTraditional : firstTraditional;
+		const bool keySecondTraditional = swapped ? firstTraditional : secondTraditional;
+		key.axisFlags = (keyFirstTraditional ? 1u : 0u) | (keySecondTraditional ? 2u : 0u);
+		return key;
+	}
+
+	// 上层注入的查询钩子（见 GeoCrs::SetValidAreaTableHook / SetEpsgIdentifyHook）。
+	std::atomic<GeoCrs::ValidAreaTableHook> g_validAreaTableHook(nullptr);
+	std::atomic<GeoCrs::EpsgIdentifyHook> g_epsgIdentifyHook(nullptr);
+
+	// 查有效范围表前用于内容校验的 EPSG 参照坐标系（CreateFromEpsgCode 的结果，只在本文件内使用，从不借出）。
+	// 条目数达到上限时整体清空。
+	constexpr size_t kEpsgReferenceCrsMaxEntries = 4096;
+
+	std::mutex g_epsgReferenceCrsMutex;
+	std::unordered_map<int, std::shared_ptr<const GeoCrs>> g_epsgReferenceCrs;
+
+	static std::shared_ptr<const GeoCrs> GetEpsgReferenceCrs(int epsgCode)
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_epsgReferenceCrsMutex);
+			const auto it = g_epsgReferenceCrs.find(epsgCode);
+			if (it != g_epsgReferenceCrs.end())
+			{
+				return it->second;
+			}
+		}
+
+		// 解析较慢，在锁外完成；并发时以先插入者为准。
+		std::shared_ptr<const GeoCrs> created = std::make_shared<GeoCrs>(GeoCrs::CreateFromEpsgCode(epsgCode));
+
+		std::lock_guard<std::mutex> lock(g_epsgReferenceCrsMutex);
+		if (g_epsgReferenceCrs.size() >= kEpsgReferenceCrsMaxEntries)
+		{
+			g_epsgReferenceCrs.clear();
+		}
+		return g_epsgReferenceCrs.emplace(epsgCode, std::move(created)).first->second;
+	}
+
 }
 
 void GeoCrsOgrSrsDeleter::operator()(OGRSpatialReference* srs) const noexcept
@@ -253,92 +369,171 @@ void GeoCrsOgrSrsDeleter::operator()(OGRSpatialReference* srs) const noexcept
 	srs->Release();
 }
 
-GeoCrs::GeoCrs() : spatialReference(nullptr)
+struct GeoCrs::SharedCore
 {
-	spatialReference.reset(CreateOgrSpatialReference());
-	if (spatialReference)
-	{
-		ApplyAxisOrderStrategy(*spatialReference, useTraditionalGisAxisOrder);
-	}
-
-	InvalidateCachesNoLock();
+	std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> spatialReference;
+
+	// GDAL 3.0+ 起坐标轴顺序默认遵循 CRS 定义（例如 EPSG:4326 为纬度/经度）。
+	// 本类默认使用传统 GIS 顺序以减少“经纬度顺序”踩坑。
+	bool useTraditionalGisAxisOrder = true;
+
+	// 曾通过 GetRef()/Get() 借出可写引用：外部仍可能经该引用修改，拷贝时不能再共享，必须克隆。
+	// 借出的引用在下一次 SetFrom*/Reset 时失效：这些操作会换成全新的核心，标志随之清除。
+	// 拷贝构造/赋值可能在其它线程读取该标志，因此为原子变量。
+	std::atomic_bool isExposed{ false };
+
+	// 互斥：保护 spatialReference 与所有缓存字段，使共享本核心的各 GeoCrs 的 const 接口在并发读场景下安全。
+	// 共享核心的副本在调用 OGR 时仍会在这里串行（OGRSpatialReference 的 const 接口并非线程安全），
+	// 但 UID/轴顺序与默认 EPSG 结果计算一次后即发布为无锁快照（见下方 published* 字段）。
+	mutable std::recursive_mutex mutex;
+
+	// 无锁快照：只在核心未共享时才会失效（InvalidateCachesNoLock 只在 DetachCore 之后调用）。
+	// hasPublishedUid 为 true 时 publishedUid、publishedTraditionalGisAxisOrder 与 cachedUid* 不再变化，可不加锁读取。
+	mutable std::atomic_bool hasPublishedUid{ false };
+	mutable GeoCrs::Uid128 publishedUid;
+	mutable bool publishedTraditionalGisAxisOrder = true;
+	mutable std::atomic<int> publishedDefaultEpsgCode{ -1 }; // -1 表示未发布
+
+	// operator== 使用的内容哈希（WKT2_2018 单行导出的 128 位哈希，与是否带 EPSG 权威码无关），发布规则同 publishedUid。
+	mutable std::atomic_bool hasPublishedContentHash{ false };
+	mutable GeoCrs::Uid128 publishedContentHash;
+	mutable bool publishedContentTraditionalGisAxisOrder = true;
+
+	// ---- 缓存：避免重复进行 AutoIdentifyEPSG / FindBestMatch 等可能较重的逻辑 ----
+	// 缓存只取决于 spatialReference 与轴顺序，因此随核心一起共享：一个副本算过，其它副本直接复用。
+	// 默认参数（tryAutoIdentify=true, tryFindBestMatch=false, minMatchConfidence=90）下的 EPSG 结果缓存
+	mutable bool hasCachedDefaultEpsgCode = false;
+	mutable int cachedDefaultEpsgCode = 0; // 0 表示未能得到 EPSG code 或者为空
+
+	// GetUidUtf8() 的缓存：
+	//  cachedUidKind:
+	//      -2：未计算
+	//      -1：空/不可用
+	//       0：使用 cachedUidWktHash (WKT2_2018 的哈希)
+	//     > 0：EPSG code
+	mutable int cachedUidKind = -2;
+	mutable std::uint64_t cachedUidWktHash = 0;
+	mutable std::uint64_t cachedUidWktHash2 = 0; // 仅用于 GetUid128()
+
+	// MatchesEpsgDefinitionNoLock() 的缓存：0 表示未校验；否则为已校验的 EPSG code，正数表示一致，负数表示不一致。
+	mutable int cachedEpsgDefinitionMatch = 0;
+};
+
+const std::shared_ptr<GeoCrs::SharedCore>& GeoCrs::GetEmptyCore()
+{
+	// 所有空 GeoCrs 共享同一个核心；静态变量本身持有一个引用，因此任何修改都会先克隆，该核心始终为空。
+	static const std::shared_ptr<SharedCore> emptyCore = []() -> std::shared_ptr<SharedCore> {
+		std::shared_ptr<SharedCore> created = std::make_shared<SharedCore>();
+		created->spatialReference.reset(CreateOgrSpatialReference());
+		if (created->spatialReference)
+		{
+			ApplyAxisOrderStrategy(*created->spatialReference, created->useTraditionalGisAxisOrder);
+		}
+		return created;
+	}();
+	return emptyCore;
 }
 
-
-GeoCrs::GeoCrs(const GeoCrs& other) : spatialReference(nullptr)
+std::shared_ptr<GeoCrs::SharedCore> GeoCrs::CloneCore(const SharedCore& source, bool keepContent)
 {
-	std::lock_guard<std::recursive_mutex> otherLock(other.mutex);
-	if (other.spatialReference)
+	std::shared_ptr<SharedCore> cloned = std::make_shared<SharedCore>();
+
+	std::lock_guard<std::recursive_mutex> sourceLock(source.mutex);
+	cloned->useTraditionalGisAxisOrder = source.useTraditionalGisAxisOrder;
+	if (keepContent && source.spatialReference)
 	{
-		spatialReference.reset(other.spatialReference->Clone());
+		cloned->spatialReference.reset(source.spatialReference->Clone());
+		cloned->hasCachedDefaultEpsgCode = source.hasCachedDefaultEpsgCode;
+		cloned->cachedDefaultEpsgCode = source.cachedDefaultEpsgCode;
+		if (source.hasCachedDefaultEpsgCode)
+		{
+			cloned->publishedDefaultEpsgCode.store(source.cachedDefaultEpsgCode, std::memory_order_relaxed);
+		}
+		cloned->cachedUidKind = source.cachedUidKind;
+		cloned->cachedUidWktHash = source.cachedUidWktHash;
+		cloned->cachedUidWktHash2 = source.cachedUidWktHash2;
 	}
 	else
 	{
-		spatialReference.reset(CreateOgrSpatialReference());
+		cloned->spatialReference.reset(CreateOgrSpatialReference());
 	}
 
-	useTraditionalGisAxisOrder = other.useTraditionalGisAxisOrder;
-
-	if (spatialReference)
+	if (cloned->spatialReference)
 	{
-		ApplyAxisOrderStrategy(*spatialReference, useTraditionalGisAxisOrder);
+		ApplyAxisOrderStrategy(*cloned->spatialReference, cloned->useTraditionalGisAxisOrder);
 	}
-
-	InvalidateCachesNoLock();
+	return cloned;
 }
 
+void GeoCrs::DetachCore(bool keepContent)
+{
+	// use_count() 是宽松读取，本身不建立同步：看到只剩本对象（加上局部的 previous）后再加一道 acquire 栅栏，
+	// 与其它副本释放核心时引用计数递减的 release 配对，保证它们对核心的读取都先于本对象随后的修改。
+	// 借出过可写引用且将被整体重置（keepContent=false）时，换成全新的核心以清除 isExposed。
+	const std::shared_ptr<SharedCore> previous = core;
+	std::lock_guard<std::recursive_mutex> lock(previous->mutex);
+	if (previous.use_count() == 2)
+	{
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (keepContent || !previous->isExposed.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+	}
+
+	// 在旧核心的锁内替换：正持有旧核心锁的读取先完成，之后的读取看到新核心。
+	core = CloneCore(*previous, keepContent);
+}
 
-GeoCrs::GeoCrs(GeoCrs&& other) noexcept : spatialReference(nullptr)
+GeoCrs::GeoCrs() : core(GetEmptyCore())
 {
-	std::lock_guard<std::recursive_mutex> otherLock(other.mutex);
+}
 
-	spatialReference = std::move(other.spatialReference);
-	useTraditionalGisAxisOrder = other.useTraditionalGisAxisOrder;
 
-	if (spatialReference)
+GeoCrs::GeoCrs(const GeoCrs& other) : core(other.core)
+{
+	if (core->isExposed.load(std::memory_order_acquire))
 	{
-		ApplyAxisOrderStrategy(*spatialReference, useTraditionalGisAxisOrder);
+		core = CloneCore(*other.core, true);
 	}
+}
 
-	InvalidateCachesNoLock();
 
-	// 保持被移动对象处于可用状态：确保其内部指针非空，且缓存失效。
-	other.useTraditionalGisAxisOrder = true;
-	if (other.spatialReference == nullptr)
-	{
-		other.spatialReference.reset(CreateOgrSpatialReference());
-		if (other.spatialReference)
-		{
-			ApplyAxisOrderStrategy(*other.spatialReference, other.useTraditionalGisAxisOrder);
-		}
-	}
-	other.InvalidateCachesNoLock();
+GeoCrs::GeoCrs(GeoCrs&& other) noexcept : core(std::move(other.core))
+{
+	// 保持被移动对象处于可用状态（空 CRS）。
+	other.core = GetEmptyCore();
 }
 
 
 void GeoCrs::InvalidateCachesNoLock() const
 {
-	hasCachedDefaultEpsgCode = false;
-	cachedDefaultEpsgCode = 0;
+	core->hasCachedDefaultEpsgCode = false;
+	core->cachedDefaultEpsgCode = 0;
+
+	core->cachedUidKind = -2;
+	core->cachedUidWktHash = 0;
 
-	cachedUidKind = -2;
-	cachedUidWktHash = 0;
+	core->hasPublishedUid.store(false, std::memory_order_relaxed);
+	core->hasPublishedContentHash.store(false, std::memory_order_relaxed);
+	core->cachedEpsgDefinitionMatch = 0;
+	core->publishedDefaultEpsgCode.store(-1, std::memory_order_relaxed);
 }
 
 void GeoCrs::InvalidateCaches() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	InvalidateCachesNoLock();
 }
 
 bool GeoCrs::IsEmptyNoLock() const
 {
-	if (spatialReference == nullptr)
+	if (core->spatialReference == nullptr)
 	{
 		return true;
 	}
 
-	return spatialReference->IsEmpty();
+	return core->spatialReference->IsEmpty();
 }
 
 bool GeoCrs::IsValidNoLock() const
@@ -348,22 +543,22 @@ bool GeoCrs::IsValidNoLock() const
 		return false;
 	}
 
-	return spatialReference->Validate() == OGRERR_NONE;
+	return core->spatialReference->Validate() == OGRERR_NONE;
 }
 
 OGRSpatialReference* GeoCrs::EnsureSpatialReferenceNoLock()
 {
-	const bool needCreate = (spatialReference == nullptr);
+	const bool needCreate = (core->spatialReference == nullptr);
 	if (needCreate)
 	{
-		spatialReference.reset(CreateOgrSpatialReference());
-		if (spatialReference)
+		core->spatialReference.reset(CreateOgrSpatialReference());
+		if (core->spatialReference)
 		{
-			ApplyAxisOrderStrategy(*spatialReference, useTraditionalGisAxisOrder);
+			ApplyAxisOrderStrategy(*core->spatialReference, core->useTraditionalGisAxisOrder);
 		}
 	}
 
-	return spatialReference.get();
+	return core->spatialReference.get();
 }
 
 bool GeoCrs::ResetNoLock()
@@ -377,7 +572,7 @@ bool GeoCrs::ResetNoLock()
 	}
 
 	srs->Clear();
-	ApplyAxisOrderStrategy(*srs, useTraditionalGisAxisOrder);
+	ApplyAxisOrderStrategy(*srs, core->useTraditionalGisAxisOrder);
 	InvalidateCachesNoLock();
 	return true;
 }
@@ -394,25 +589,43 @@ int GeoCrs::TryGetEpsgCodeNoLock(bool tryAutoIdentify, bool tryFindBestMatch, in
 	minMatchConfidence = std::max(0, std::min(100, minMatchConfidence));
 
 	const bool isDefaultQuery = (tryAutoIdentify && !tryFindBestMatch && minMatchConfidence == 90);
-	if (isDefaultQuery && hasCachedDefaultEpsgCode)
+	if (isDefaultQuery && core->hasCachedDefaultEpsgCode)
 	{
-		return cachedDefaultEpsgCode;
+		return core->cachedDefaultEpsgCode;
 	}
 
-	int epsgCode = ExtractEpsgCodeFromSrs(*spatialReference);
+	int epsgCode = ExtractEpsgCodeFromSrs(*core->spatialReference);
 	if (epsgCode > 0)
 	{
 		if (isDefaultQuery)
 		{
-			cachedDefaultEpsgCode = epsgCode;
-			hasCachedDefaultEpsgCode = true;
+			core->cachedDefaultEpsgCode = epsgCode;
+			core->hasCachedDefaultEpsgCode = true;
+			core->publishedDefaultEpsgCode.store(core->cachedDefaultEpsgCode, std::memory_order_release);
 		}
 		return epsgCode;
 	}
 
+	// 推断前先调用注册的快速识别钩子（GeoCrsManager 注册为 EPSG 指纹索引）：命中已经过 IsSame 校验，可省去扫描 proj.db。
+	if (tryAutoIdentify || tryFindBestMatch)
+	{
+		const EpsgIdentifyHook identifyHook = g_epsgIdentifyHook.load(std::memory_order_acquire);
+		epsgCode = (identifyHook != nullptr) ? identifyHook(*core->spatialReference) : 0;
+		if (epsgCode > 0)
+		{
+			if (isDefaultQuery)
+			{
+				core->cachedDefaultEpsgCode = epsgCode;
+				core->hasCachedDefaultEpsgCode = true;
+				core->publishedDefaultEpsgCode.store(core->cachedDefaultEpsgCode, std::memory_order_release);
+			}
+			return epsgCode;
+		}
+	}
+
 	if (tryAutoIdentify)
 	{
-		std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> cloned(spatialReference->Clone());
+		std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> cloned(core->spatialReference->Clone());
 		if (cloned)
 		{
 			const OGRErr err = cloned->AutoIdentifyEPSG();
@@ -423,8 +636,9 @@ int GeoCrs::TryGetEpsgCodeNoLock(bool tryAutoIdentify, bool tryFindBestMatch, in
 				{
 					if (isDefaultQuery)
 					{
-						cachedDefaultEpsgCode = epsgCode;
-						hasCachedDefaultEpsgCode = true;
+						core->cachedDefaultEpsgCode = epsgCode;
+						core->hasCachedDefaultEpsgCode = true;
+						core->publishedDefaultEpsgCode.store(core->cachedDefaultEpsgCode, std::memory_order_release);
 					}
 					return epsgCode;
 				}
@@ -434,7 +648,7 @@ int GeoCrs::TryGetEpsgCodeNoLock(bool tryAutoIdentify, bool tryFindBestMatch, in
 
 	if (tryFindBestMatch)
 	{
-		OGRSpatialReference* bestMatch = spatialReference->FindBestMatch(minMatchConfidence, "EPSG", nullptr);
+		OGRSpatialReference* bestMatch = core->spatialReference->FindBestMatch(minMatchConfidence, "EPSG", nullptr);
 		std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> bestMatchHolder(bestMatch);
 		if (bestMatchHolder)
 		{
@@ -448,8 +662,9 @@ int GeoCrs::TryGetEpsgCodeNoLock(bool tryAutoIdentify, bool tryFindBestMatch, in
 
 	if (isDefaultQuery)
 	{
-		cachedDefaultEpsgCode = 0;
-		hasCachedDefaultEpsgCode = true;
+		core->cachedDefaultEpsgCode = 0;
+		core->hasCachedDefaultEpsgCode = true;
+		core->publishedDefaultEpsgCode.store(core->cachedDefaultEpsgCode, std::memory_order_release);
 	}
 
 	return 0;
@@ -494,11 +709,11 @@ std::string GeoCrs::ExportToWktUtf8NoLock(WktFormat format, bool multiline) cons
 	if (formatOption == nullptr)
 	{
 		const char* const options[] = { multilineOption, nullptr };
-		return ExportSrsToWktUtf8(*spatialReference, options);
+		return ExportSrsToWktUtf8(*core->spatialReference, options);
 	}
 
 	const char* const options[] = { formatOption, multilineOption, nullptr };
-	return ExportSrsToWktUtf8(*spatialReference, options);
+	return ExportSrsToWktUtf8(*core->spatialReference, options);
 }
 
 std::vector<GeoCrs::LonLatAreaSegment> GeoCrs::GetValidAreaLonLatSegmentsNoLock() const
@@ -517,7 +732,7 @@ std::vector<GeoCrs::LonLatAreaSegment> GeoCrs::GetValidAreaLonLatSegmentsNoLock(
 	double north = 0;
 	const char* areaName = nullptr;
 
-	const bool ok = spatialReference->GetAreaOfUse(&west, &south, &east, &north, &areaName);
+	const bool ok = core->spatialReference->GetAreaOfUse(&west, &south, &east, &north, &areaName);
 	if (!ok)
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::GetValidAreaLonLatSegments】GetAreaOfUse 失败。"));
@@ -578,6 +793,125 @@ std::vector<GeoCrs::LonLatAreaSegment> GeoCrs::GetValidAreaLonLatSegmentsNoLock(
 	return segments;
 }
 
+void GeoCrs::SetValidAreaTableHook(ValidAreaTableHook hook)
+{
+	g_validAreaTableHook.store(hook, std::memory_order_release);
+}
+
+void GeoCrs::SetEpsgIdentifyHook(EpsgIdentifyHook hook)
+{
+	g_epsgIdentifyHook.store(hook, std::memory_order_release);
+}
+
+GeoCrs::ValidAreaTableHook GeoCrs::GetValidAreaTableHook()
+{
+	return g_validAreaTableHook.load(std::memory_order_acquire);
+}
+
+GeoCrs::EpsgIdentifyHook GeoCrs::GetEpsgIdentifyHook()
+{
+	return g_epsgIdentifyHook.load(std::memory_order_acquire);
+}
+
+bool GeoCrs::MatchesEpsgDefinitionNoLock(int epsgCode) const
+{
+	if (core->cachedEpsgDefinitionMatch == epsgCode || core->cachedEpsgDefinitionMatch == -epsgCode)
+	{
+		return core->cachedEpsgDefinitionMatch > 0;
+	}
+
+	bool matches = false;
+	const std::shared_ptr<const GeoCrs> reference = GetEpsgReferenceCrs(epsgCode);
+	if (reference && !reference->IsEmpty())
+	{
+		// 参照坐标系从不借出，持有本核心的锁再锁它不会与其它路径形成环。
+		Uid128 ownHash;
+		Uid128 referenceHash;
+		bool ownTraditional = true;
+		bool referenceTraditional = true;
+		GetContentHashAndAxisOrder(ownHash, ownTraditional);
+		reference->GetContentHashAndAxisOrder(referenceHash, referenceTraditional);
+		if (ownHash.IsValid() && ownHash == referenceHash)
+		{
+			matches = true;
+		}
+		else
+		{
+			// 内容哈希只在导出文本完全相同时一致；WKT1 等其它写法再用 IsSame 确认（表按传统 GIS 轴序保存，忽略轴映射）。
+			const char* const isSameOptions[] = { "IGNORE_DATA_AXIS_TO_SRS_AXIS_MAPPING=YES", nullptr };
+			std::lock_guard<std::recursive_mutex> referenceLock(reference->core->mutex);
+			matches = core->spatialReference->IsSame(reference->core->spatialReference.get(), isSameOptions) != 0;
+		}
+	}
+
+	core->cachedEpsgDefinitionMatch = matches ? epsgCode : -epsgCode;
+	return matches;
+}
+
+bool GeoCrs::TryGetTabulatedValidAreaNoLock(bool selfArea, GeoBoundingBox& outArea) const
+{
+	// 只认 WKT 自带的 EPSG 权威码（与 GetUidUtf8 一致），不做 AutoIdentifyEPSG 推断。
+	const int epsgCode = TryGetEpsgCodeNoLock(false, false, 0);
+	if (epsgCode <= 0)
+	{
+		return false;
+	}
+
+	const ValidAreaTableHook tableHook = g_validAreaTableHook.load(std::memory_order_acquire);
+	bool hasArea = false;
+	GB_Rectangle tabulatedRect;
+	if (tableHook == nullptr || !tableHook(epsgCode, selfArea, hasArea, tabulatedRect))
+	{
+		return false;
+	}
+
+	// 权威码只取自根 AUTHORITY：改动过参数但保留权威码的 WKT 不能用该 code 的表项，
+	// 确认内容与该 EPSG 定义一致（结果按核心缓存）后才使用，否则交给实时路径。
+	if (!MatchesEpsgDefinitionNoLock(epsgCode))
+	{
+		return false;
+	}
+
+	if (!selfArea)
+	{
+		if (!hasArea)
+		{
+			outArea = MakeInvalidGeoBoundingBox();
+			return true;
+		}
+
+		const std::string& lonLatWkt = GetLonLatAreaWktUtf8();
+		if (lonLatWkt.empty())
+		{
+			return false;
+		}
+
+		outArea = GeoBoundingBox(lonLatWkt, tabulatedRect);
+		return true;
+	}
+
+	// 地理坐标系没有经纬度范围时，实时路径返回全球范围（见 GetValidAreaNoLock），这里交给实时路径以保持一致。
+	if (!hasArea)
+	{
+		if (core->spatialReference->IsGeographic() != 0)
+		{
+			return false;
+		}
+
+		outArea = MakeInvalidGeoBoundingBox();
+		return true;
+	}
+
+	outArea = GeoBoundingBox(ExportToWktUtf8NoLock(WktFormat::Wkt2_2018, false), tabulatedRect);
+
+	// 表中按传统 GIS 轴序保存；权威轴序下与 GetValidAreaNoLock() 一样交换 X/Y。
+	if (!core->useTraditionalGisAxisOrder && (core->spatialReference->IsGeographic() != 0 || core->spatialReference->EPSGTreatsAsNorthingEasting() != 0))
+	{
+		outArea.rect = GB_Rectangle(tabulatedRect.minY, tabulatedRect.minX, tabulatedRect.maxY, tabulatedRect.maxX);
+	}
+	return true;
+}
+
 GeoBoundingBox GeoCrs::GetValidAreaLonLatNoLock() const
 {
 	if (IsEmptyNoLock())
@@ -586,6 +920,12 @@ GeoBoundingBox GeoCrs::GetValidAreaLonLatNoLock() const
 		return MakeInvalidGeoBoundingBox();
 	}
 
+	GeoBoundingBox tabulatedArea;
+	if (TryGetTabulatedValidAreaNoLock(false, tabulatedArea))
+	{
+		return tabulatedArea;
+	}
+
 	const std::vector<LonLatAreaSegment> segments = GetValidAreaLonLatSegmentsNoLock();
 	if (segments.empty())
 	{
@@ -635,8 +975,14 @@ GeoBoundingBox GeoCrs::GetValidAreaNoLock() const
 		return MakeInvalidGeoBoundingBox();
 	}
 
+	GeoBoundingBox tabulatedArea;
+	if (TryGetTabulatedValidAreaNoLock(true, tabulatedArea))
+	{
+		return tabulatedArea;
+	}
+
 	// ---- Geographic CRS：直接返回经纬度范围（注意：跨日期线时 GetValidAreaLonLat() 会返回保守的全球经度范围）----
-	if (spatialReference->IsGeographic() != 0)
+	if (core->spatialReference->IsGeographic() != 0)
 	{
 		GeoBoundingBox lonLatArea = GetValidAreaLonLatNoLock();
 		const std::string selfWkt = ExportToWktUtf8NoLock(WktFormat::Wkt2_2018, false);
@@ -645,7 +991,7 @@ GeoBoundingBox GeoCrs::GetValidAreaNoLock() const
 		{
 			GeoBoundingBox fallback;
 			fallback.wktUtf8 = selfWkt;
-			fallback.rect = useTraditionalGisAxisOrder
+			fallback.rect = core->useTraditionalGisAxisOrder
 				? GB_Rectangle(-180.0, -90.0, 180.0, 90.0)   // X=经度, Y=纬度
 				: GB_Rectangle(-90.0, -180.0, 90.0, 180.0);  // X=纬度, Y=经度（权威机构顺序）
 			GBLOG_WARNING(GB_STR("【GeoCrs::GetValidArea】GetValidAreaLonLat无效，返回全球范围。"));
@@ -655,9 +1001,9 @@ GeoBoundingBox GeoCrs::GetValidAreaNoLock() const
 		GeoBoundingBox result = lonLatArea;
 		result.wktUtf8 = selfWkt;
 
-		if (!useTraditionalGisAxisOrder)
+		if (!core->useTraditionalGisAxisOrder)
 		{
-			// useTraditionalGisAxisOrder=false 时，数据轴顺序为“纬度/经度”，因此将 (lon,lat) 转为 (lat,lon)。
+			// core->useTraditionalGisAxisOrder=false 时，数据轴顺序为“纬度/经度”，因此将 (lon,lat) 转为 (lat,lon)。
 			result.rect = GB_Rectangle(lonLatArea.rect.minY, lonLatArea.rect.minX, lonLatArea.rect.maxY, lonLatArea.rect.maxX);
 		}
 
@@ -680,7 +1026,7 @@ GeoBoundingBox GeoCrs::GetValidAreaNoLock() const
 	}
 	EnsureTraditionalGisAxisOrder(sourceSrs);
 
-	std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> targetSrs(spatialReference->Clone());
+	std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> targetSrs(core->spatialReference->Clone());
 	if (!targetSrs)
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::GetValidArea】坐标系克隆失败。"));
@@ -688,7 +1034,7 @@ GeoBoundingBox GeoCrs::GetValidAreaNoLock() const
 	}
 
 	// 计算 BoundingBox 时，为避免“权威轴序”导致 X/Y 含义混淆，这里统一用传统 GIS 顺序进行转换。
-	// 然后再根据 useTraditionalGisAxisOrder 的配置，决定是否需要把结果交换为 northing/easting 顺序。
+	// 然后再根据 core->useTraditionalGisAxisOrder 的配置，决定是否需要把结果交换为 northing/easting 顺序。
 	EnsureTraditionalGisAxisOrder(*targetSrs);
 
 	CoordinateTransformationPtr transform(OGRCreateCoordinateTransformation(&sourceSrs, targetSrs.get()));
@@ -773,7 +1119,7 @@ GeoBoundingBox GeoCrs::GetValidAreaNoLock() const
 	result.rect = GB_Rectangle(minX, minY, maxX, maxY);
 
 	// 若采用权威轴序，且该投影 CRS 定义为 northing/easting，则交换 X/Y。
-	if (!useTraditionalGisAxisOrder && spatialReference->EPSGTreatsAsNorthingEasting() != 0)
+	if (!core->useTraditionalGisAxisOrder && core->spatialReference->EPSGTreatsAsNorthingEasting() != 0)
 	{
 		result.rect = GB_Rectangle(result.rect.minY, result.rect.minX, result.rect.maxY, result.rect.maxX);
 	}
@@ -791,56 +1137,7 @@ GeoCrs& GeoCrs::operator=(const GeoCrs& other)
 		return *this;
 	}
 
-	// 先在 other 的锁保护下克隆数据，尽量缩短双对象同时被锁住的时间，规避死锁风险。
-	std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> clonedSrs(nullptr);
-	bool otherUseTraditionalGisAxisOrder = true;
-	bool otherHasCachedDefaultEpsgCode = false;
-	int otherCachedDefaultEpsgCode = 0;
-	int otherCachedUidKind = -2;
-	std::uint64_t otherCachedUidWktHash = 0;
-
-	{
-		std::lock_guard<std::recursive_mutex> otherLock(other.mutex);
-
-		otherUseTraditionalGisAxisOrder = other.useTraditionalGisAxisOrder;
-		otherHasCachedDefaultEpsgCode = other.hasCachedDefaultEpsgCode;
-		otherCachedDefaultEpsgCode = other.cachedDefaultEpsgCode;
-		otherCachedUidKind = other.cachedUidKind;
-		otherCachedUidWktHash = other.cachedUidWktHash;
-
-		if (other.spatialReference)
-		{
-			clonedSrs.reset(other.spatialReference->Clone());
-		}
-		else
-		{
-			clonedSrs.reset(CreateOgrSpatialReference());
-		}
-	}
-
-	{
-		std::lock_guard<std::recursive_mutex> lock(mutex);
-
-		spatialReference.swap(clonedSrs);
-		if (spatialReference == nullptr)
-		{
-			useTraditionalGisAxisOrder = true;
-			InvalidateCachesNoLock();
-			return *this;
-		}
-		useTraditionalGisAxisOrder = otherUseTraditionalGisAxisOrder;
-
-		if (spatialReference)
-		{
-			ApplyAxisOrderStrategy(*spatialReference, useTraditionalGisAxisOrder);
-		}
-
-		hasCachedDefaultEpsgCode = otherHasCachedDefaultEpsgCode;
-		cachedDefaultEpsgCode = otherCachedDefaultEpsgCode;
-		cachedUidKind = otherCachedUidKind;
-		cachedUidWktHash = otherCachedUidWktHash;
-	}
-
+	core = other.core->isExposed.load(std::memory_order_acquire) ? CloneCore(*other.core, true) : other.core;
 	return *this;
 }
 
@@ -852,48 +1149,10 @@ GeoCrs& GeoCrs::operator=(GeoCrs&& other) noexcept
 		return *this;
 	}
 
-	// 使用 std::lock 同时获取两把锁，规避死锁。
-	std::unique_lock<std::recursive_mutex> lock(mutex, std::defer_lock);
-	std::unique_lock<std::recursive_mutex> otherLock(other.mutex, std::defer_lock);
-	std::lock(lock, otherLock);
-
-	spatialReference = std::move(other.spatialReference);
-	useTraditionalGisAxisOrder = other.useTraditionalGisAxisOrder;
-
-	hasCachedDefaultEpsgCode = other.hasCachedDefaultEpsgCode;
-	cachedDefaultEpsgCode = other.cachedDefaultEpsgCode;
-	cachedUidKind = other.cachedUidKind;
-	cachedUidWktHash = other.cachedUidWktHash;
-
-	if (spatialReference)
-	{
-		ApplyAxisOrderStrategy(*spatialReference, useTraditionalGisAxisOrder);
-	}
-	else
-	{
-		useTraditionalGisAxisOrder = true;
-		hasCachedDefaultEpsgCode = false;
-		cachedDefaultEpsgCode = 0;
-		cachedUidKind = -2;
-		cachedUidWktHash = 0;
-	}
+	core = std::move(other.core);
 
 	// 保持被移动对象可用（置为空 CRS）
-	other.useTraditionalGisAxisOrder = true;
-	other.hasCachedDefaultEpsgCode = false;
-	other.cachedDefaultEpsgCode = 0;
-	other.cachedUidKind = -2;
-	other.cachedUidWktHash = 0;
-
-	if (other.spatialReference == nullptr)
-	{
-		other.spatialReference.reset(CreateOgrSpatialReference());
-		if (other.spatialReference)
-		{
-			ApplyAxisOrderStrategy(*other.spatialReference, other.useTraditionalGisAxisOrder);
-		}
-	}
-
+	other.core = GetEmptyCore();
 	return *this;
 }
 
@@ -921,14 +1180,16 @@ GeoCrs GeoCrs::CreateFromUserInput(const std::string& definitionUtf8, bool allow
 
 bool GeoCrs::Reset()
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	DetachCore(false);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	return ResetNoLock();
 }
 
 
 bool GeoCrs::SetFromWkt(const std::string& wktUtf8)
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	DetachCore(false);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 
 	ResetNoLock();
 
@@ -955,7 +1216,7 @@ bool GeoCrs::SetFromWkt(const std::string& wktUtf8)
 		return false;
 	}
 
-	ApplyAxisOrderStrategy(*srs, useTraditionalGisAxisOrder);
+	ApplyAxisOrderStrategy(*srs, core->useTraditionalGisAxisOrder);
 	InvalidateCachesNoLock();
 	return IsValidNoLock();
 }
@@ -963,7 +1224,8 @@ bool GeoCrs::SetFromWkt(const std::string& wktUtf8)
 
 bool GeoCrs::SetFromEpsgCode(int epsgCode)
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	DetachCore(false);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 
 	ResetNoLock();
 
@@ -988,7 +1250,7 @@ bool GeoCrs::SetFromEpsgCode(int epsgCode)
 		return false;
 	}
 
-	ApplyAxisOrderStrategy(*srs, useTraditionalGisAxisOrder);
+	ApplyAxisOrderStrategy(*srs, core->useTraditionalGisAxisOrder);
 	InvalidateCachesNoLock();
 	return IsValidNoLock();
 }
@@ -996,7 +1258,8 @@ bool GeoCrs::SetFromEpsgCode(int epsgCode)
 
 bool GeoCrs::SetFromUserInput(const std::string& definitionUtf8, bool allowNetworkAccess, bool allowFileAccess)
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	DetachCore(false);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 
 	ResetNoLock();
 
@@ -1030,7 +1293,7 @@ bool GeoCrs::SetFromUserInput(const std::string& definitionUtf8, bool allowNetwo
 		return false;
 	}
 
-	ApplyAxisOrderStrategy(*srs, useTraditionalGisAxisOrder);
+	ApplyAxisOrderStrategy(*srs, core->useTraditionalGisAxisOrder);
 	InvalidateCachesNoLock();
 	return IsValidNoLock();
 }
@@ -1038,77 +1301,194 @@ bool GeoCrs::SetFromUserInput(const std::string& definitionUtf8, bool allowNetwo
 
 bool GeoCrs::IsEmpty() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	return IsEmptyNoLock();
 }
 
 
 bool GeoCrs::IsValid() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	return IsValidNoLock();
 }
 
 
 std::string GeoCrs::GetNameUtf8() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	if (IsEmptyNoLock())
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::GetNameUtf8】变量为空。"));
 		return "";
 	}
 
-	const char* name = spatialReference->GetName();
+	const char* name = core->spatialReference->GetName();
 	return name ? std::string(name) : std::string();
 }
 
 
-std::string GeoCrs::GetUidUtf8() const
+void GeoCrs::EnsureUidCachedNoLock() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	if (core->cachedUidKind != -2)
+	{
+		return;
+	}
+
+	const int epsgCode = TryGetEpsgCodeNoLock(false, false, 0);
+	if (epsgCode > 0)
+	{
+		core->cachedUidKind = epsgCode;
+		core->cachedUidWktHash = 0;
+		core->cachedUidWktHash2 = 0;
+		return;
+	}
 
+	const std::string wkt = ExportToWktUtf8NoLock(WktFormat::Wkt2_2018, false);
+	if (wkt.empty())
+	{
+		core->cachedUidKind = -1;
+		core->cachedUidWktHash = 0;
+		core->cachedUidWktHash2 = 0;
+		return;
+	}
+
+	core->cachedUidKind = 0;
+	core->cachedUidWktHash = Fnv1a64(wkt.data(), wkt.size());
+	core->cachedUidWktHash2 = Mix64Hash(wkt.data(), wkt.size());
+}
+
+GeoCrs::Uid128 GeoCrs::GetUid128NoLock() const
+{
+	Uid128 uid;
 	if (IsEmptyNoLock())
 	{
-		GBLOG_WARNING(GB_STR("【GeoCrs::GetUidUtf8】变量为空。"));
-		return "";
+		return uid;
 	}
 
-	// 命中缓存
-	if (cachedUidKind != -2)
+	EnsureUidCachedNoLock();
+	if (core->cachedUidKind > 0)
 	{
-		if (cachedUidKind < 0)
-		{
-			return "";
-		}
-		if (cachedUidKind > 0)
+		uid.low = static_cast<std::uint64_t>(core->cachedUidKind);
+	}
+	else if (core->cachedUidKind == 0)
+	{
+		uid.high = core->cachedUidWktHash | (1ull << 63);
+		uid.low = core->cachedUidWktHash2;
+	}
+
+	if (!core->hasPublishedUid.load(std::memory_order_relaxed))
+	{
+		core->publishedUid = uid;
+		core->publishedTraditionalGisAxisOrder = core->useTraditionalGisAxisOrder;
+		core->hasPublishedUid.store(true, std::memory_order_release);
+	}
+	return uid;
+}
+
+void GeoCrs::GetUidAndAxisOrder(Uid128& outUid, bool& outTraditionalGisAxisOrder) const
+{
+	if (!core->hasPublishedUid.load(std::memory_order_acquire))
+	{
+		std::lock_guard<std::recursive_mutex> lock(core->mutex);
+		GetUid128NoLock();
+	}
+
+	outUid = core->publishedUid;
+	outTraditionalGisAxisOrder = core->publishedTraditionalGisAxisOrder;
+}
+
+void GeoCrs::GetContentHashAndAxisOrder(Uid128& outHash, bool& outTraditionalGisAxisOrder) const
+{
+	if (!core->hasPublishedContentHash.load(std::memory_order_acquire))
+	{
+		std::lock_guard<std::recursive_mutex> lock(core->mutex);
+		if (!core->hasPublishedContentHash.load(std::memory_order_relaxed))
 		{
-			return "EPSG:" + std::to_string(cachedUidKind);
+			Uid128 hash;
+			if (!IsEmptyNoLock())
+			{
+				EnsureUidCachedNoLock();
+				if (core->cachedUidKind == 0)
+				{
+					// 无权威码时 UID 本身就是内容哈希。
+					hash.high = core->cachedUidWktHash | (1ull << 63);
+					hash.low = core->cachedUidWktHash2;
+				}
+				else if (core->cachedUidKind > 0)
+				{
+					const std::string wkt = ExportToWktUtf8NoLock(WktFormat::Wkt2_2018, false);
+					if (!wkt.empty())
+					{
+						hash.high = Fnv1a64(wkt.data(), wkt.size()) | (1ull << 63);
+						hash.low = Mix64Hash(wkt.data(), wkt.size());
+					}
+				}
+			}
+
+			core->publishedContentHash = hash;
+			core->publishedContentTraditionalGisAxisOrder = core->useTraditionalGisAxisOrder;
+			core->hasPublishedContentHash.store(true, std::memory_order_release);
 		}
+	}
 
-		return "WKT2_2018_HASH:" + ToHex64(cachedUidWktHash);
+	outHash = core->publishedContentHash;
+	outTraditionalGisAxisOrder = core->publishedContentTraditionalGisAxisOrder;
+}
+
+GeoCrs::Uid128 GeoCrs::GetContentHash128() const
+{
+	Uid128 hash;
+	bool traditionalGisAxisOrder = true;
+	GetContentHashAndAxisOrder(hash, traditionalGisAxisOrder);
+	return hash;
+}
+
+bool GeoCrs::MatchesEpsgDefinition(int epsgCode) const
+{
+	if (epsgCode <= 0)
+	{
+		return false;
 	}
 
-	const int epsgCode = TryGetEpsgCodeNoLock(false, false, 0);
-	if (epsgCode > 0)
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
+	if (IsEmptyNoLock())
 	{
-		cachedUidKind = epsgCode;
-		cachedUidWktHash = 0;
-		return "EPSG:" + std::to_string(epsgCode);
+		return false;
 	}
+	return MatchesEpsgDefinitionNoLock(epsgCode);
+}
 
-	const std::string wkt = ExportToWktUtf8NoLock(WktFormat::Wkt2_2018, false);
-	if (wkt.empty())
+std::string GeoCrs::GetUidUtf8() const
+{
+	Uid128 uid;
+	bool traditionalGisAxisOrder = true;
+	GetUidAndAxisOrder(uid, traditionalGisAxisOrder);
+
+	if (!uid.IsValid())
 	{
-		cachedUidKind = -1;
-		cachedUidWktHash = 0;
+		std::lock_guard<std::recursive_mutex> lock(core->mutex);
+		if (IsEmptyNoLock())
+		{
+			GBLOG_WARNING(GB_STR("【GeoCrs::GetUidUtf8】变量为空。"));
+		}
 		return "";
 	}
 
-	const std::uint64_t wktHash = Fnv1a64(wkt.data(), wkt.size());
-	cachedUidKind = 0;
-	cachedUidWktHash = wktHash;
-	return "WKT2_2018_HASH:" + ToHex64(wktHash);
+	// 快照已发布：cachedUid* 不再变化。
+	if (core->cachedUidKind > 0)
+	{
+		return "EPSG:" + std::to_string(core->cachedUidKind);
+	}
+
+	return "WKT2_2018_HASH:" + ToHex64(core->cachedUidWktHash);
+}
+
+GeoCrs::Uid128 GeoCrs::GetUid128() const
+{
+	Uid128 uid;
+	bool traditionalGisAxisOrder = true;
+	GetUidAndAxisOrder(uid, traditionalGisAxisOrder);
+	return uid;
 }
 
 
@@ -1119,11 +1499,44 @@ bool GeoCrs::operator==(const GeoCrs& other) const
 		return true;
 	}
 
-	const GeoCrs* first = this;
-	const GeoCrs* second = &other;
+	// 共享同一核心的副本必然相同。
+	if (core == other.core)
+	{
+		return true;
+	}
+
+	// 内容哈希优先：内容哈希与轴顺序都相同即视为相同；否则查 IsSame 结果表。
+	// 不用 UID 判定：EPSG UID 只取自根 AUTHORITY，改动过参数但保留权威码的 WKT 与原坐标系 UID 相同。
+	Uid128 thisHash;
+	Uid128 otherHash;
+	bool thisTraditional = true;
+	bool otherTraditional = true;
+	GetContentHashAndAxisOrder(thisHash, thisTraditional);
+	other.GetContentHashAndAxisOrder(otherHash, otherTraditional);
+
+	const bool useTable = thisHash.IsValid() && otherHash.IsValid();
+	IsSameKey tableKey;
+	if (useTable)
+	{
+		if (thisHash == otherHash && thisTraditional == otherTraditional)
+		{
+			return true;
+		}
+
+		tableKey = MakeIsSameKey(thisHash, thisTraditional, otherHash, otherTraditional);
+		std::lock_guard<std::mutex> tableLock(g_isSameTableMutex);
+		const auto it = g_isSameTable.find(tableKey);
+		if (it != g_isSameTable.end())
+		{
+			return it->second;
+		}
+	}
+
+	const SharedCore* first = core.get();
+	const SharedCore* second = other.core.get();
 
 	// 规避死锁：按地址顺序加锁
-	if (std::less<const GeoCrs*>()(second, first))
+	if (std::less<const SharedCore*>()(second, first))
 	{
 		std::swap(first, second);
 	}
@@ -1142,7 +1555,17 @@ bool GeoCrs::operator==(const GeoCrs& other) const
 		return false;
 	}
 
-	return spatialReference->IsSame(other.spatialReference.get());
+	const bool isSame = core->spatialReference->IsSame(other.core->spatialReference.get()) != 0;
+	if (useTable)
+	{
+		std::lock_guard<std::mutex> tableLock(g_isSameTableMutex);
+		if (g_isSameTable.size() >= kIsSameTableMaxEntries)
+		{
+			g_isSameTable.clear();
+		}
+		g_isSameTable.emplace(tableKey, isSame);
+	}
+	return isSame;
 }
 
 
@@ -1153,51 +1576,52 @@ bool GeoCrs::operator!=(const GeoCrs& other) const
 
 bool GeoCrs::IsGeographic() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	if (IsEmptyNoLock())
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::IsGeographic】变量为空。"));
 		return false;
 	}
 
-	return spatialReference->IsGeographic() != 0;
+	return core->spatialReference->IsGeographic() != 0;
 }
 
 
 bool GeoCrs::IsProjected() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	if (IsEmptyNoLock())
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::IsProjected】变量为空。"));
 		return false;
 	}
 
-	return spatialReference->IsProjected() != 0;
+	return core->spatialReference->IsProjected() != 0;
 }
 
 
 bool GeoCrs::IsLocal() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	if (IsEmptyNoLock())
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::IsLocal】变量为空。"));
 		return false;
 	}
 
-	return spatialReference->IsLocal() != 0;
+	return core->spatialReference->IsLocal() != 0;
 }
 
 
 void GeoCrs::SetTraditionalGisAxisOrder(bool enable)
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
-	useTraditionalGisAxisOrder = enable;
+	DetachCore(true);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
+	core->useTraditionalGisAxisOrder = enable;
 
-	if (spatialReference)
+	if (core->spatialReference)
 	{
-		ApplyAxisOrderStrategy(*spatialReference, useTraditionalGisAxisOrder);
+		ApplyAxisOrderStrategy(*core->spatialReference, core->useTraditionalGisAxisOrder);
 	}
 
 	InvalidateCachesNoLock();
@@ -1206,14 +1630,14 @@ void GeoCrs::SetTraditionalGisAxisOrder(bool enable)
 
 std::string GeoCrs::ExportToWktUtf8(WktFormat format, bool multiline) const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	return ExportToWktUtf8NoLock(format, multiline);
 }
 
 
 std::string GeoCrs::ExportToPrettyWktUtf8(bool simplify) const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	if (IsEmptyNoLock())
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::ExportToPrettyWktUtf8】变量为空。"));
@@ -1221,7 +1645,7 @@ std::string GeoCrs::ExportToPrettyWktUtf8(bool simplify) const
 	}
 
 	char* wktRaw = nullptr;
-	const OGRErr err = spatialReference->exportToPrettyWkt(&wktRaw, simplify ? TRUE : FALSE);
+	const OGRErr err = core->spatialReference->exportToPrettyWkt(&wktRaw, simplify ? TRUE : FALSE);
 	CplCharPtr wkt(wktRaw);
 
 	if (err != OGRERR_NONE || wkt == nullptr)
@@ -1238,7 +1662,7 @@ std::string GeoCrs::ExportToPrettyWktUtf8(bool simplify) const
 
 std::string GeoCrs::ExportToProj4Utf8() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	if (IsEmptyNoLock())
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::ExportToProj4Utf8】变量为空。"));
@@ -1246,7 +1670,7 @@ std::string GeoCrs::ExportToProj4Utf8() const
 	}
 
 	char* proj4Raw = nullptr;
-	const OGRErr err = spatialReference->exportToProj4(&proj4Raw);
+	const OGRErr err = core->spatialReference->exportToProj4(&proj4Raw);
 	CplCharPtr proj4(proj4Raw);
 
 	if (err != OGRERR_NONE || proj4 == nullptr)
@@ -1263,7 +1687,7 @@ std::string GeoCrs::ExportToProj4Utf8() const
 
 std::string GeoCrs::ExportToProjJsonUtf8() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	if (IsEmptyNoLock())
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::ExportToProjJsonUtf8】变量为空。"));
@@ -1271,7 +1695,7 @@ std::string GeoCrs::ExportToProjJsonUtf8() const
 	}
 
 	char* projJsonRaw = nullptr;
-	const OGRErr err = spatialReference->exportToPROJJSON(&projJsonRaw, nullptr);
+	const OGRErr err = core->spatialReference->exportToPROJJSON(&projJsonRaw, nullptr);
 	CplCharPtr projJson(projJsonRaw);
 
 	if (err != OGRERR_NONE || projJson == nullptr)
@@ -1288,7 +1712,16 @@ std::string GeoCrs::ExportToProjJsonUtf8() const
 
 int GeoCrs::TryGetEpsgCode(bool tryAutoIdentify, bool tryFindBestMatch, int minMatchConfidence) const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	if (tryAutoIdentify && !tryFindBestMatch && minMatchConfidence == 90)
+	{
+		const int publishedEpsgCode = core->publishedDefaultEpsgCode.load(std::memory_order_acquire);
+		if (publishedEpsgCode >= 0)
+		{
+			return publishedEpsgCode;
+		}
+	}
+
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	return TryGetEpsgCodeNoLock(tryAutoIdentify, tryFindBestMatch, minMatchConfidence);
 }
 
@@ -1305,14 +1738,14 @@ std::string GeoCrs::ToEpsgStringUtf8() const
 
 std::string GeoCrs::ToOgcUrnStringUtf8() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	if (IsEmptyNoLock())
 	{
 		GBLOG_WARNING(GB_STR("【GeoCrs::ToOgcUrnStringUtf8】对象为空。"));
 		return "";
 	}
 
-	char* urnRaw = spatialReference->GetOGCURN();
+	char* urnRaw = core->spatialReference->GetOGCURN();
 	CplCharPtr urn(urnRaw);
 	if (urn == nullptr)
 	{
@@ -1325,7 +1758,7 @@ std::string GeoCrs::ToOgcUrnStringUtf8() const
 
 GeoCrs::UnitsInfo GeoCrs::GetLinearUnits() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	UnitsInfo info;
 	if (IsEmptyNoLock())
 	{
@@ -1334,7 +1767,7 @@ GeoCrs::UnitsInfo GeoCrs::GetLinearUnits() const
 	}
 
 	const char* unitName = nullptr;
-	const double toMeters = spatialReference->GetLinearUnits(&unitName);
+	const double toMeters = core->spatialReference->GetLinearUnits(&unitName);
 	info.toSI = toMeters;
 	info.nameUtf8 = unitName ? std::string(unitName) : std::string();
 	return info;
@@ -1342,7 +1775,7 @@ GeoCrs::UnitsInfo GeoCrs::GetLinearUnits() const
 
 GeoCrs::UnitsInfo GeoCrs::GetAngularUnits() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	UnitsInfo info;
 	if (IsEmptyNoLock())
 	{
@@ -1351,7 +1784,7 @@ GeoCrs::UnitsInfo GeoCrs::GetAngularUnits() const
 	}
 
 	const char* unitName = nullptr;
-	const double toRadians = spatialReference->GetAngularUnits(&unitName);
+	const double toRadians = core->spatialReference->GetAngularUnits(&unitName);
 	info.toSI = toRadians;
 	info.nameUtf8 = unitName ? std::string(unitName) : std::string();
 	return info;
@@ -1359,44 +1792,159 @@ GeoCrs::UnitsInfo GeoCrs::GetAngularUnits() const
 
 std::vector<GeoCrs::LonLatAreaSegment> GeoCrs::GetValidAreaLonLatSegments() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	return GetValidAreaLonLatSegmentsNoLock();
 }
 
 GeoBoundingBox GeoCrs::GetValidArea() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	return GetValidAreaNoLock();
 }
 
 GeoBoundingBox GeoCrs::GetValidAreaLonLat() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
 	return GetValidAreaLonLatNoLock();
 }
 
+GeoCrsFootprint GeoCrs::GetValidAreaFootprint(int pointsPerEdge) const
+{
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
+	if (IsEmptyNoLock())
+	{
+		GBLOG_WARNING(GB_STR("【GeoCrs::GetValidAreaFootprint】对象为空。"));
+		return GeoCrsFootprint();
+	}
+
+	const std::vector<LonLatAreaSegment> lonLatSegments = GetValidAreaLonLatSegmentsNoLock();
+	if (lonLatSegments.empty())
+	{
+		GBLOG_WARNING(GB_STR("【GeoCrs::GetValidAreaFootprint】lonLatSegments为空。"));
+		return GeoCrsFootprint();
+	}
+
+	pointsPerEdge = std::max(1, std::min(1024, pointsPerEdge));
+	const bool isGeographic = core->spatialReference->IsGeographic() != 0;
+
+	// 与 GetValidAreaNoLock() 一致：以传统 GIS 轴序从 EPSG:4326 转到本坐标系，最后再按需交换 X/Y。
+	CoordinateTransformationPtr transform(nullptr);
+	if (!isGeographic)
+	{
+		OGRSpatialReference sourceSrs;
+		if (sourceSrs.importFromEPSG(4326) != OGRERR_NONE)
+		{
+			GBLOG_WARNING(GB_STR("【GeoCrs::GetValidAreaFootprint】WGS 84 坐标系导入失败。"));
+			return GeoCrsFootprint();
+		}
+		EnsureTraditionalGisAxisOrder(sourceSrs);
+
+		std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> targetSrs(core->spatialReference->Clone());
+		if (!targetSrs)
+		{
+			GBLOG_WARNING(GB_STR("【GeoCrs::GetValidAreaFootprint】坐标系克隆失败。"));
+			return GeoCrsFootprint();
+		}
+		EnsureTraditionalGisAxisOrder(*targetSrs);
+
+		transform.reset(OGRCreateCoordinateTransformation(&sourceSrs, targetSrs.get()));
+		if (transform == nullptr)
+		{
+			GBLOG_WARNING(GB_STR("【GeoCrs::GetValidAreaFootprint】OGRCreateCoordinateTransformation 失败。"));
+			return GeoCrsFootprint();
+		}
+	}
+
+	const bool swapXY = !core->useTraditionalGisAxisOrder && (isGeographic || core->spatialReference->EPSGTreatsAsNorthingEasting() != 0);
+
+	std::vector<std::vector<GB_Point2d>> rings;
+	std::vector<double> xs;
+	std::vector<double> ys;
+	std::vector<int> successFlags;
+	for (const LonLatAreaSegment& seg : lonLatSegments)
+	{
+		if (!IsFinite(seg.west) || !IsFinite(seg.south) || !IsFinite(seg.east) || !IsFinite(seg.north) ||
+			seg.south > seg.north || seg.west > seg.east)
+		{
+			GBLOG_WARNING(GB_STR("【GeoCrs::GetValidAreaFootprint】经纬度范围无效。"));
+			return GeoCrsFootprint();
+		}
+
+		// 逆时针绕行：下边（西->东）、右边（南->北）、上边（东->西）、左边（北->南），每边不含终点。
+		xs.clear();
+		ys.clear();
+		const double corners[5][2] =
+		{
+			{ seg.west, seg.south }, { seg.east, seg.south }, { seg.east, seg.north }, { seg.west, seg.north }, { seg.west, seg.south }
+		};
+		for (int edge = 0; edge < 4; edge++)
+		{
+			for (int i = 0; i < pointsPerEdge; i++)
+			{
+				const double t = static_cast<double>(i) / static_cast<double>(pointsPerEdge);
+				xs.push_back(corners[edge][0] + (corners[edge + 1][0] - corners[edge][0]) * t);
+				ys.push_back(corners[edge][1] + (corners[edge + 1][1] - corners[edge][1]) * t);
+			}
+		}
+
+		successFlags.assign(xs.size(), TRUE);
+		if (transform != nullptr)
+		{
+			transform->Transform(static_cast<int>(xs.size()), xs.data(), ys.data(), nullptr, successFlags.data());
+		}
+
+		// 任一采样点投影失败都返回无效足迹：跳过失败点会把多边形裁成比真实有效范围更小（或自相交）的形状。
+		std::vector<GB_Point2d> ring;
+		ring.reserve(xs.size());
+		for (size_t i = 0; i < xs.size(); i++)
+		{
+			if (successFlags[i] == FALSE || !IsFinite(xs[i]) || !IsFinite(ys[i]))
+			{
+				GBLOG_WARNING(GB_STR("【GeoCrs::GetValidAreaFootprint】边界采样点投影失败。"));
+				return GeoCrsFootprint();
+			}
+			ring.push_back(swapXY ? GB_Point2d(ys[i], xs[i]) : GB_Point2d(xs[i], ys[i]));
+		}
+
+		if (ring.size() >= 3)
+		{
+			rings.push_back(std::move(ring));
+		}
+	}
+
+	if (rings.empty())
+	{
+		GBLOG_WARNING(GB_STR("【GeoCrs::GetValidAreaFootprint】边界投影失败。"));
+		return GeoCrsFootprint();
+	}
+
+	return GeoCrsFootprint(ExportToWktUtf8NoLock(WktFormat::Wkt2_2018, false), rings);
+}
+
 const OGRSpatialReference* GeoCrs::GetConst() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
-	return spatialReference.get();
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
+	return core->spatialReference.get();
 }
 
 const OGRSpatialReference& GeoCrs::GetConstRef() const
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
-	// 约定上 spatialReference 在构造/Reset 后都应存在；此处仍做兜底，避免空指针解引用。
-	if (spatialReference == nullptr)
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
+	// 约定上 core->spatialReference 在构造/Reset 后都应存在；此处仍做兜底，避免空指针解引用。
+	if (core->spatialReference == nullptr)
 	{
 		static const OGRSpatialReference emptySrs;
 		return emptySrs;
 	}
 
-	return *spatialReference;
+	return *core->spatialReference;
 }
 
 OGRSpatialReference& GeoCrs::GetRef()
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	DetachCore(true);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
+	core->isExposed.store(true, std::memory_order_release);
 
 	OGRSpatialReference* srs = EnsureSpatialReferenceNoLock();
 	if (srs == nullptr)
@@ -1413,7 +1961,9 @@ OGRSpatialReference& GeoCrs::GetRef()
 
 OGRSpatialReference* GeoCrs::Get()
 {
-	std::lock_guard<std::recursive_mutex> lock(mutex);
+	DetachCore(true);
+	std::lock_guard<std::recursive_mutex> lock(core->mutex);
+	core->isExposed.store(true, std::memory_order_release);
 
 	OGRSpatialReference* srs = EnsureSpatialReferenceNoLock();
 	if (srs == nullptr)
@@ -1425,3 +1975,104 @@ OGRSpatialReference* GeoCrs::Get()
 	InvalidateCachesNoLock();
 	return srs;
 }
+
+std::shared_ptr<const FrozenGeoCrs> FrozenGeoCrs::Create(const std::shared_ptr<const GeoCrs>& crs)
+{
+	std::shared_ptr<FrozenGeoCrs> frozen(new FrozenGeoCrs());
+	frozen->crs = crs;
+	if (!crs || crs->IsEmpty())
+	{
+		return frozen;
+	}
+
+	frozen->isEmpty = false;
+	frozen->isValid = crs->IsValid();
+	frozen->nameUtf8 = crs->GetNameUtf8();
+	frozen->isGeographic = crs->IsGeographic();
+	frozen->isProjected = crs->IsProjected();
+	frozen->isLocal = crs->IsLocal();
+	frozen->linearUnits = crs->GetLinearUnits();
+	frozen->angularUnits = crs->GetAngularUnits();
+	frozen->uidUtf8 = crs->GetUidUtf8();
+	frozen->wktUtf8 = crs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+	frozen->projJsonUtf8 = crs->ExportToProjJsonUtf8();
+
+	// 不调用 ToEpsgStringUtf8()：未能识别 EPSG 是正常情况，不应在创建快照时记录警告。
+	frozen->epsgCode = std::max(0, crs->TryGetEpsgCode(true));
+	if (frozen->epsgCode > 0)
+	{
+		frozen->epsgStringUtf8 = "EPSG:" + std::to_string(frozen->epsgCode);
+	}
+
+	return frozen;
+}
+
+const std::shared_ptr<const GeoCrs>& FrozenGeoCrs::GetCrs() const
+{
+	return crs;
+}
+
+bool FrozenGeoCrs::IsEmpty() const
+{
+	return isEmpty;
+}
+
+bool FrozenGeoCrs::IsValid() const
+{
+	return isValid;
+}
+
+const std::string& FrozenGeoCrs::GetNameUtf8() const
+{
+	return nameUtf8;
+}
+
+bool FrozenGeoCrs::IsGeographic() const
+{
+	return isGeographic;
+}
+
+bool FrozenGeoCrs::IsProjected() const
+{
+	return isProjected;
+}
+
+bool FrozenGeoCrs::IsLocal() const
+{
+	return isLocal;
+}
+
+int FrozenGeoCrs::GetEpsgCode() const
+{
+	return epsgCode;
+}
+
+const std::string& FrozenGeoCrs::GetEpsgStringUtf8() const
+{
+	return epsgStringUtf8;
+}
+
+const std::string& FrozenGeoCrs::GetUidUtf8() const
+{
+	return uidUtf8;
+}
+
+const GeoCrs::UnitsInfo& FrozenGeoCrs::GetLinearUnits() const
+{
+	return linearUnits;
+}
+
+const GeoCrs::UnitsInfo& FrozenGeoCrs::GetAngularUnits() const
+{
+	return angularUnits;
+}
+
+const std::string& FrozenGeoCrs::GetWktUtf8() const
+{
+	return wktUtf8;
+}
+
+const std::string& FrozenGeoCrs::GetProjJsonUtf8() const
+{
+	return projJsonUtf8;
+}
@@ -0,0 +1,303 @@
+﻿#include "GeoCrsFootprint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+	static bool RectanglesOverlap(const GB_Rectangle& a, const GB_Rectangle& b)
+	{
+		return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+	}
+
+	static bool RectangleContainsPoint(const GB_Rectangle& rect, double x, double y)
+	{
+		return x >= rect.minX && x <= rect.maxX && y >= rect.minY && y <= rect.maxY;
+	}
+
+	static bool RingContainsPoint(const std::vector<GB_Point2d>& ring, double x, double y)
+	{
+		bool inside = false;
+		const size_t count = ring.size();
+		for (size_t i = 0, j = count - 1; i < count; j = i++)
+		{
+			const GB_Point2d& a = ring[i];
+			const GB_Point2d& b = ring[j];
+			if ((a.y > y) != (b.y > y))
+			{
+				const double crossX = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+				if (x < crossX)
+				{
+					inside = !inside;
+				}
+			}
+		}
+		return inside;
+	}
+
+	// 点是否落在环的某条边上（含端点）。容差按边长的相对比例给出，避免投影坐标（米）与经纬度（度）量级不同时失效。
+	static bool RingBoundaryContainsPoint(const std::vector<GB_Point2d>& ring, double x, double y)
+	{
+		const size_t count = ring.size();
+		for (size_t i = 0, j = count - 1; i < count; j = i++)
+		{
+			const GB_Point2d& a = ring[j];
+			const GB_Point2d& b = ring[i];
+			if (x < std::min(a.x, b.x) || x > std::max(a.x, b.x) || y < std::min(a.y, b.y) || y > std::max(a.y, b.y))
+			{
+				continue;
+			}
+
+			const double dx = b.x - a.x;
+			const double dy = b.y - a.y;
+			const double cross = dx * (y - a.y) - dy * (x - a.x);
+			if (std::abs(cross) <= 1e-12 * (dx * dx + dy * dy))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Liang-Barsky：线段 ab 是否与矩形相交。
+	static bool SegmentIntersectsRectangle(const GB_Point2d& a, const GB_Point2d& b, const GB_Rectangle& rect)
+	{
+		const double dx = b.x - a.x;
+		const double dy = b.y - a.y;
+		const double p[4] = { -dx, dx, -dy, dy };
+		const double q[4] = { a.x - rect.minX, rect.maxX - a.x, a.y - rect.minY, rect.maxY - a.y };
+
+		double t0 = 0.0;
+		double t1 = 1.0;
+		for (int i = 0; i < 4; i++)
+		{
+			if (p[i] == 0.0)
+			{
+				if (q[i] < 0.0)
+				{
+					return false;
+				}
+				continue;
+			}
+
+			const double t = q[i] / p[i];
+			if (p[i] < 0.0)
+			{
+				t0 = std::max(t0, t);
+			}
+			else
+			{
+				t1 = std::min(t1, t);
+			}
+			if (t0 > t1)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Sutherland-Hodgman：用矩形的一条边（axis=0 为 X，1 为 Y；keepGreater 表示保留 >= bound 的一侧）裁剪多边形。
+	static void ClipRingByBound(const std::vector<GB_Point2d>& input, int axis, double bound, bool keepGreater, std::vector<GB_Point2d>& output)
+	{
+		output.clear();
+		const size_t count = input.size();
+		if (count == 0)
+		{
+			return;
+		}
+
+		auto coordinate = [axis](const GB_Point2d& point) {
+			return axis == 0 ? point.x : point.y;
+		};
+		auto isInside = [&](const GB_Point2d& point) {
+			return keepGreater ? coordinate(point) >= bound : coordinate(point) <= bound;
+		};
+		auto intersect = [&](const GB_Point2d& a, const GB_Point2d& b) {
+			const double t = (bound - coordinate(a)) / (coordinate(b) - coordinate(a));
+			return axis == 0
+				? GB_Point2d(bound, a.y + (b.y - a.y) * t)
+				: GB_Point2d(a.x + (b.x - a.x) * t, bound);
+		};
+
+		GB_Point2d previous = input[count - 1];
+		bool previousInside = isInside(previous);
+		for (size_t i = 0; i < count; i++)
+		{
+			const GB_Point2d& current = input[i];
+			const bool currentInside = isInside(current);
+			if (currentInside != previousInside)
+			{
+				output.push_back(intersect(previous, current));
+			}
+			if (currentInside)
+			{
+				output.push_back(current);
+			}
+			previous = current;
+			previousInside = currentInside;
+		}
+	}
+}
+
+GeoCrsFootprint::GeoCrsFootprint() : boundingRect(GB_Rectangle::Invalid)
+{
+}
+
+GeoCrsFootprint::GeoCrsFootprint(const std::string& wktUtf8, const std::vector<std::vector<GB_Point2d>>& rings) : wktUtf8(wktUtf8), boundingRect(GB_Rectangle::Invalid)
+{
+	double minX = std::numeric_limits<double>::infinity();
+	double minY = std::numeric_limits<double>::infinity();
+	double maxX = -std::numeric_limits<double>::infinity();
+	double maxY = -std::numeric_limits<double>::infinity();
+
+	for (const std::vector<GB_Point2d>& ring : rings)
+	{
+		if (ring.size() < 3)
+		{
+			continue;
+		}
+
+		GB_Rectangle ringRect(ring[0].x, ring[0].y, ring[0].x, ring[0].y);
+		for (const GB_Point2d& point : ring)
+		{
+			ringRect.minX = std::min(ringRect.minX, point.x);
+			ringRect.minY = std::min(ringRect.minY, point.y);
+			ringRect.maxX = std::max(ringRect.maxX, point.x);
+			ringRect.maxY = std::max(ringRect.maxY, point.y);
+		}
+
+		minX = std::min(minX, ringRect.minX);
+		minY = std::min(minY, ringRect.minY);
+		maxX = std::max(maxX, ringRect.maxX);
+		maxY = std::max(maxY, ringRect.maxY);
+
+		this->rings.push_back(ring);
+		ringBounds.push_back(ringRect);
+	}
+
+	if (!this->rings.empty())
+	{
+		boundingRect.Set(minX, minY, maxX, maxY);
+	}
+}
+
+bool GeoCrsFootprint::IsValid() const
+{
+	return !rings.empty();
+}
+
+const std::string& GeoCrsFootprint::GetWktUtf8() const
+{
+	return wktUtf8;
+}
+
+const std::vector<std::vector<GB_Point2d>>& GeoCrsFootprint::GetRings() const
+{
+	return rings;
+}
+
+const GB_Rectangle& GeoCrsFootprint::GetBoundingRect() const
+{
+	return boundingRect;
+}
+
+bool GeoCrsFootprint::ContainsPoint(double x, double y) const
+{
+	if (!IsValid() || !RectangleContainsPoint(boundingRect, x, y))
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < rings.size(); i++)
+	{
+		if (RectangleContainsPoint(ringBounds[i], x, y) &&
+			(RingContainsPoint(rings[i], x, y) || RingBoundaryContainsPoint(rings[i], x, y)))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool GeoCrsFootprint::IntersectsRect(const GB_Rectangle& rect) const
+{
+	if (!IsValid() || !rect.IsValid() || !RectanglesOverlap(boundingRect, rect))
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < rings.size(); i++)
+	{
+		if (!RectanglesOverlap(ringBounds[i], rect))
+		{
+			continue;
+		}
+
+		const std::vector<GB_Point2d>& ring = rings[i];
+
+		// 矩形完全落在环内：任取一角判断即可（其余情况必有边相交或环顶点落在矩形内）。
+		if (RingContainsPoint(ring, rect.minX, rect.minY))
+		{
+			return true;
+		}
+
+		const size_t count = ring.size();
+		for (size_t j = 0, k = count - 1; j < count; k = j++)
+		{
+			if (RectangleContainsPoint(rect, ring[j].x, ring[j].y) || SegmentIntersectsRectangle(ring[k], ring[j], rect))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+GB_Rectangle GeoCrsFootprint::ClipRect(const GB_Rectangle& rect) const
+{
+	if (!IsValid() || !rect.IsValid() || !RectanglesOverlap(boundingRect, rect))
+	{
+		return GB_Rectangle::Invalid;
+	}
+
+	double minX = std::numeric_limits<double>::infinity();
+	double minY = std::numeric_limits<double>::infinity();
+	double maxX = -std::numeric_limits<double>::infinity();
+	double maxY = -std::numeric_limits<double>::infinity();
+	bool hasAnyPoint = false;
+
+	std::vector<GB_Point2d> clipped;
+	std::vector<GB_Point2d> buffer;
+	for (size_t i = 0; i < rings.size(); i++)
+	{
+		if (!RectanglesOverlap(ringBounds[i], rect))
+		{
+			continue;
+		}
+
+		// 凸多边形（矩形）裁剪任意简单多边形，结果的外包矩形即交集的外包矩形。
+		ClipRingByBound(rings[i], 0, rect.minX, true, clipped);
+		ClipRingByBound(clipped, 0, rect.maxX, false, buffer);
+		ClipRingByBound(buffer, 1, rect.minY, true, clipped);
+		ClipRingByBound(clipped, 1, rect.maxY, false, buffer);
+
+		for (const GB_Point2d& point : buffer)
+		{
+			hasAnyPoint = true;
+			minX = std::min(minX, point.x);
+			minY = std::min(minY, point.y);
+			maxX = std::max(maxX, point.x);
+			maxY = std::max(maxY, point.y);
+		}
+	}
+
+	if (!hasAnyPoint)
+	{
+		return GB_Rectangle::Invalid;
+	}
+	return GB_Rectangle(minX, minY, maxX, maxY);
+}
@@ -1,35 +1,64 @@
 ﻿#include "GeoCrsManager.h"
 
 #include "GB_FileSystem.h"
+#include "GB_IO.h"
 #include "GB_Logger.h"
 #include "GB_ReadWriteLock.h"
 #include "GB_Utf8String.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <deque>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iterator>
 #include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // GDAL
 #include <cpl_conv.h>
 #include <cpl_string.h>
 #include <gdal.h>
+#include <ogr_spatialref.h>
 #include <ogr_srs_api.h>
 
 #ifdef _WIN32
 #  include <Windows.h>
 #else
 #  include <dirent.h>
+#  include <fcntl.h>
 #  include <limits.h>
+#  include <sys/mman.h>
 #  include <sys/stat.h>
 #  include <unistd.h>
 #endif
 
 #include "GeoBoundingBox.h"
+#include "GeoCrsFootprint.h"
+#include "MapWeaverParallel.h"
 
 namespace
 {
@@ -67,958 +96,4460 @@ namespace
         GeoBoundingBox selfArea;
     };
 
-    // -------------------- 全局状态与缓存 --------------------
-
-    std::atomic_bool g_isInitialized(false);
-    std::string g_projDatabaseDirUtf8 = "";
-    GB_ReadWriteLock g_initLock;
-
-    GB_ReadWriteLock g_epsgCacheLock;
-    std::unordered_map<int, std::shared_ptr<const GeoCrs>> g_epsgCache;
+    // 查找缓存用的裁剪：首尾均为 ASCII 可见字符（WKT / PROJJSON 的常见情形）时 GB_Utf8Trim 不会改变文本，
+    // 直接引用输入，命中路径上不再复制整段 WKT；否则裁剪结果写入 storage 并返回其引用。
+    const std::string& TrimForLookupUtf8(const std::string& textUtf8, std::string& storage)
+    {
+        const auto isVisibleAscii = [](char c) { return c > 0x20 && c < 0x7f; };
+        if (!textUtf8.empty() && isVisibleAscii(textUtf8.front()) && isVisibleAscii(textUtf8.back()))
+        {
+            return textUtf8;
+        }
 
-    GB_ReadWriteLock g_wktCacheLock;
-    std::unordered_map<std::string, std::shared_ptr<const GeoCrs>> g_wktCache;
+        storage = GB_Utf8Trim(textUtf8);
+        return storage;
+    }
 
-    GB_ReadWriteLock g_wktValidityCacheLock;
-    std::unordered_map<std::string, bool> g_wktValidityCache;
+    // -------------------- 缓存条目的近似内存占用 --------------------
 
-    GB_ReadWriteLock g_definitionCacheLock;
-    std::unordered_map<DefinitionKey, std::shared_ptr<const GeoCrs>, DefinitionKeyHasher> g_definitionCache;
+    // 仅用于内存预算：按对象本身大小 + 字符串/数组堆内存 + 固定开销估算，不追求精确。
+    // 缓存值中的共享对象（GeoCrs、快照、足迹）按完整大小计入持有它的每个缓存：
+    // 被淘汰的条目只有在所有缓存都不再持有时才真正释放，按完整大小计入各缓存使估算偏保守（总量只会高估）。
+    constexpr size_t kApproximateEntryOverheadBytes = 128; // 哈希表节点、SLRU 链表节点与条目控制块
 
-    GB_ReadWriteLock g_validAreaCacheLock;
-    std::unordered_map<std::string, ValidAreas> g_validAreaCache;
+    // GeoCrs 的大头是其内部的 OGRSpatialReference 与 PROJ 对象树，无法从外部精确得到；
+    // 按常见投影坐标系的数量级取固定值，另加 WKT 等缓存字符串（每种导出格式一份）。
+    constexpr size_t kApproximateGeoCrsBytes = 24 * 1024;
 
-    std::shared_ptr<const GeoCrs> GetEmptyCrsShared()
+    template <typename T>
+    size_t ApproximateBytes(const T& value)
     {
-        static const std::shared_ptr<const GeoCrs> emptyCrs = std::make_shared<GeoCrs>();
-        return emptyCrs;
+        return sizeof(value);
     }
 
-    // -------------------- 工具函数 --------------------
-
-    bool IsWindowsDriveRootUtf8(const std::string& dirPathUtf8)
+    size_t ApproximateBytes(const std::string& text)
     {
-        return dirPathUtf8.size() == 3 &&
-            std::isalpha(static_cast<unsigned char>(dirPathUtf8[0])) &&
-            dirPathUtf8[1] == ':' &&
-            dirPathUtf8[2] == '/';
+        // 短字符串存放在对象内部（SSO），不额外占用堆内存。
+        return sizeof(text) + (text.capacity() > 15 ? text.capacity() + 1 : 0);
     }
 
-    bool IsUncShareRootUtf8(const std::string& dirPathUtf8)
+    size_t ApproximateBytes(const DefinitionKey& key)
     {
-        if (dirPathUtf8.rfind("//", 0) != 0)
-        {
-            return false;
-        }
-
-        // 形如：//server/share/   —— 认为是 UNC share 根目录，不允许再向上
-        const size_t firstSlash = dirPathUtf8.find('/', 2);
-        if (firstSlash == std::string::npos)
-        {
-            return true;
-        }
-
-        const size_t secondSlash = dirPathUtf8.find('/', firstSlash + 1);
-        if (secondSlash == std::string::npos)
-        {
-            return true;
-        }
-
-        const size_t thirdSlash = dirPathUtf8.find('/', secondSlash + 1);
-        return thirdSlash == std::string::npos;
+        return sizeof(key) - sizeof(key.definitionUtf8) + ApproximateBytes(key.definitionUtf8);
     }
 
-    bool IsRootedPathUtf8(const std::string& pathUtf8)
+    size_t ApproximateBytes(const GeoBoundingBox& box)
     {
-        if (pathUtf8.empty())
-        {
-            return false;
-        }
-
-        // POSIX: 以 '/' 开头；UNC: 以 '//' 开头；两者都属于“有根路径”
-        if (pathUtf8[0] == '/')
-        {
-            return true;
-        }
-
-        // Windows: 盘符 "C:/" / "D:/" ...
-        // 注意："C:foo" 属于“驱动器相对路径”（相对于该驱动器的当前工作目录），这里不视为 rooted。
-        if (pathUtf8.size() >= 3 &&
-            std::isalpha(static_cast<unsigned char>(pathUtf8[0])) &&
-            pathUtf8[1] == ':' &&
-            (pathUtf8[2] == '/' || pathUtf8[2] == '\\'))
-        {
-            return true;
-        }
-
-        return false;
+        return sizeof(box) - sizeof(box.wktUtf8) + ApproximateBytes(box.wktUtf8);
     }
 
-    std::string NormalizeDirPathUtf8(const std::string& inputPathUtf8)
+    size_t ApproximateBytes(const ValidAreas& areas)
     {
-        if (inputPathUtf8.empty())
-        {
-            return "";
-        }
-
-        // 使用 GB_JoinPath 做统一分隔符、消解 "."/".." 等 lexical 规范化，并强制视为“目录”路径。
-        // 右侧传入 "." 可确保返回结果末尾带 "/"（即使该目录并不存在）。
-        std::string normalized = GB_JoinPath(inputPathUtf8, ".");
-        if (!normalized.empty() && normalized.back() != '/')
-        {
-            normalized.push_back('/');
-        }
-
-        return normalized;
+        return ApproximateBytes(areas.lonLatArea) + ApproximateBytes(areas.selfArea);
     }
 
-    std::string GetParentDirectoryUtf8(const std::string& dirPathUtf8)
+    size_t ApproximateBytes(const std::shared_ptr<const GeoCrs>& crs)
     {
-        const std::string currentDir = NormalizeDirPathUtf8(dirPathUtf8);
-        if (currentDir.empty())
-        {
-            return "";
-        }
-
-        // 对于相对路径，保持“无法继续向上”的语义，避免出现 "./" -> "../" 的漂移。
-        if (!IsRootedPathUtf8(currentDir))
-        {
-            return "";
-        }
-
-        // 根目录："/" or "C:/" or "//server/share/"
-        if (currentDir == "/" || IsWindowsDriveRootUtf8(currentDir) || IsUncShareRootUtf8(currentDir))
-        {
-            return "";
-        }
-
-        const std::string parentDir = NormalizeDirPathUtf8(GB_JoinPath(currentDir, ".."));
-        if (parentDir.empty() || parentDir == currentDir)
-        {
-            return "";
-        }
-
-        return parentDir;
+        return sizeof(crs) + (crs ? sizeof(GeoCrs) + kApproximateGeoCrsBytes : 0);
     }
 
-    bool EndsWithIgnoreCaseAscii(const std::string& text, const std::string& suffix)
+    size_t ApproximateBytes(const std::shared_ptr<const FrozenGeoCrs>& frozen)
     {
-        if (suffix.size() > text.size())
+        if (!frozen)
         {
-            return false;
+            return sizeof(frozen);
         }
 
-        const size_t offset = text.size() - suffix.size();
-        for (size_t i = 0; i < suffix.size(); i++)
-        {
-            const unsigned char a = static_cast<unsigned char>(text[offset + i]);
-            const unsigned char b = static_cast<unsigned char>(suffix[i]);
-            if (std::tolower(a) != std::tolower(b))
-            {
-                return false;
-            }
-        }
-        return true;
+        return sizeof(frozen) + sizeof(FrozenGeoCrs) + ApproximateBytes(frozen->GetCrs()) +
+            ApproximateBytes(frozen->GetNameUtf8()) + ApproximateBytes(frozen->GetEpsgStringUtf8()) + ApproximateBytes(frozen->GetUidUtf8()) +
+            ApproximateBytes(frozen->GetWktUtf8()) + ApproximateBytes(frozen->GetProjJsonUtf8());
     }
 
-    std::string GetCurrentWorkingDirectoryUtf8()
+    size_t ApproximateBytes(const std::shared_ptr<const GeoCrsFootprint>& footprint)
     {
-#ifdef _WIN32
-        DWORD requiredChars = GetCurrentDirectoryW(0, nullptr);
-        if (requiredChars == 0)
+        if (!footprint)
         {
-            return "";
+            return sizeof(footprint);
         }
 
-        std::wstring buffer;
-        buffer.resize(static_cast<size_t>(requiredChars));
-        const DWORD written = GetCurrentDirectoryW(requiredChars, &buffer[0]);
-        if (written == 0)
+        size_t bytes = sizeof(footprint) + sizeof(GeoCrsFootprint) + ApproximateBytes(footprint->GetWktUtf8());
+        for (const std::vector<GB_Point2d>& ring : footprint->GetRings())
         {
-            return "";
+            bytes += sizeof(ring) + ring.capacity() * sizeof(GB_Point2d) + sizeof(GB_Rectangle);
         }
+        return bytes;
+    }
 
-        // written 不包含 '\0'，但 buffer 可能包含
-        buffer.resize(static_cast<size_t>(written));
-        std::string cwdUtf8 = GB_WStringToUtf8(buffer);
-        cwdUtf8 = NormalizeDirPathUtf8(cwdUtf8);
-        return cwdUtf8;
-#else
-        char buffer[PATH_MAX + 1];
-        if (getcwd(buffer, sizeof(buffer)) == nullptr)
+    size_t ApproximateBytes(const std::shared_ptr<const GeoCrsManager::CrsMetadata>& metadata)
+    {
+        if (!metadata)
         {
-            return "";
+            return sizeof(metadata);
         }
 
-        std::string cwdUtf8(buffer);
-        cwdUtf8 = NormalizeDirPathUtf8(cwdUtf8);
-        return cwdUtf8;
-#endif
+        return sizeof(metadata) + sizeof(GeoCrsManager::CrsMetadata) -
+            sizeof(metadata->uidUtf8) - sizeof(metadata->canonicalWktUtf8) - sizeof(metadata->lonLatArea) - sizeof(metadata->selfArea) +
+            ApproximateBytes(metadata->uidUtf8) + ApproximateBytes(metadata->canonicalWktUtf8) +
+            ApproximateBytes(metadata->lonLatArea) + ApproximateBytes(metadata->selfArea);
     }
 
-    std::string FindProjDatabaseDirByExistingProjPaths()
+    // -------------------- 并发缓存 --------------------
+
+    // 两级缓存：
+    //  1) 线程私有的 L1 视图：命中时只读本线程的数据，以及一个极少被写入的代数计数器（不加锁、不写共享内存）；
+    //  2) 分片的全局表：L1 未命中时按 key 的 hash 选择分片，只在该分片上加读/写锁，降低不同 key 之间的争用。
+    // - 每次访问只计算一次 key 的 hash，L1 与分片共用；L1 以 hash 为键并引用全局条目中保存的 key，
+    //   命中时比较一次 key，不在各线程中复制 key（WKT 可能有数 KB）。
+    // - 条目一旦插入便不会被修改，因此 L1 中缓存的值始终与全局表一致；
+    // - Clear() 清空全局表与在途表并递增代数，各线程的 L1 在下一次访问时发现代数变化后自行清空。
+    //   写入 L1 前会再次核对代数，Clear() 之前读到的条目不会混入新一代的视图；
+    //   Clear() 之前开始的计算完成后也不会写入全局表（结果只返回给调用方与等待者）。
+    // - Tag 用于区分 Key/Value 类型相同的不同缓存（thread_local 视图按模板实例区分）。
+    // - GetOrCompute() 对同一 key 的并发未命中做合并（single-flight）：第一个未命中者负责计算，
+    //   其余线程等待它的 shared_future，而不是各自重复解析。compute 内不得再次请求同一缓存的同一 key。
+    // - 可选的字节预算（SetByteBudget）：按整个缓存计，插入后超出时按分段 LRU 淘汰，见 Shard 与 EvictNoLock 的说明。
+    //   isPinned 返回 true 的 key 不参与淘汰，也不计入预算。L1 有容量上限，其引用的字节数单独统计。
+    template <typename Tag, typename Key, typename Value, typename Hasher = std::hash<Key>>
+    class ConcurrentCache
     {
-        char** paths = OSRGetPROJSearchPaths();
-        if (paths == nullptr)
+    public:
+        using PinPredicate = bool (*)(const Key&);
+
+        explicit ConcurrentCache(PinPredicate isPinned = nullptr) : isPinned(isPinned)
         {
-            return "";
         }
 
-        std::string found;
-        for (int i = 0; paths[i] != nullptr; i++)
+        bool TryGet(const Key& key, Value& outValue) const
         {
-            const std::string dir = NormalizeDirPathUtf8(paths[i]);
-            if (dir.empty())
+            const size_t hash = Hasher()(key);
+            LocalView& view = GetLocalView();
+            const std::uint64_t observedGeneration = view.generation;
+            if (const EntryPtr* localEntry = FindLocal(view, key, hash))
             {
-                continue;
+                outValue = Touch(*localEntry);
+                return true;
             }
 
-            const std::string projDbPath = GB_JoinPath(dir, "proj.db");
-            if (GB_IsFileExists(projDbPath))
+            const Shard& shard = GetShard(hash);
+            EntryPtr entry;
             {
-                found = dir;
-                break;
+                GB_ReadLockGuard readGuard(shard.lock);
+                const auto it = shard.map.find(KeyRef{ &key, hash });
+                if (it == shard.map.end())
+                {
+                    return false;
+                }
+                entry = it->second.entry;
             }
-        }
-
-        CSLDestroy(paths);
-        return found;
-    }
-
-    struct ProjDbSearchNode
-    {
-        std::string dirUtf8;
-        int depth = 0;
-    };
 
-    // 有界深度/数量的“兜底”搜索：用于覆盖少数非典型目录布局，但避免递归扫描整个磁盘导致启动抖动。
-    std::string LimitedSearchProjDbUnderDirUtf8(const std::string& startDirUtf8, int maxDepth, size_t maxVisitedDirs)
-    {
-        const std::string rootDir = NormalizeDirPathUtf8(startDirUtf8);
-        if (rootDir.empty())
-        {
-            return "";
+            outValue = Touch(entry);
+            InsertLocal(view, hash, std::move(entry), observedGeneration);
+            return true;
         }
 
-        std::deque<ProjDbSearchNode> queue;
-        queue.push_back({ rootDir, 0 });
-
-        size_t visitedDirs = 0;
-
-        while (!queue.empty() && visitedDirs < maxVisitedDirs)
+        // 命中则返回缓存值；否则由第一个未命中的线程执行 compute() 并写入，同时到达的其它线程等待其结果。
+        // compute() 抛出的异常会传递给所有等待者，且不会写入缓存。
+        template <typename Compute>
+        Value GetOrCompute(const Key& key, Compute&& compute)
         {
-            ProjDbSearchNode node = std::move(queue.front());
-            queue.pop_front();
-            ++visitedDirs;
+            const size_t hash = Hasher()(key);
+            LocalView& view = GetLocalView();
+            const std::uint64_t observedGeneration = view.generation;
+            if (const EntryPtr* localEntry = FindLocal(view, key, hash))
+            {
+                view.hitCount->fetch_add(1, std::memory_order_relaxed);
+                return Touch(*localEntry);
+            }
 
-            const std::string projDbPath = GB_JoinPath(node.dirUtf8, "proj.db");
-            if (GB_IsFileExists(projDbPath))
+            const KeyRef keyRef{ &key, hash };
+            Shard& shard = GetShard(hash);
+            EntryPtr entry;
             {
-                return NormalizeDirPathUtf8(node.dirUtf8);
+                GB_ReadLockGuard readGuard(shard.lock);
+                const auto it = shard.map.find(keyRef);
+                if (it != shard.map.end())
+                {
+                    entry = it->second.entry;
+                }
             }
 
-            if (node.depth >= maxDepth)
+            std::promise<Value> promise;
+            std::shared_future<Value> pending;
+            bool isOwner = false;
+            std::uint64_t ownerGeneration = 0;
+            if (!entry)
             {
-                continue;
+                GB_WriteLockGuard writeGuard(shard.lock);
+                const auto it = shard.map.find(keyRef);
+                if (it != shard.map.end())
+                {
+                    entry = it->second.entry;
+                }
+                else
+                {
+                    // 在途表的 key 引用计算者的参数：计算者在返回前总会移除该条目。
+                    const auto inFlightIt = shard.inFlight.find(keyRef);
+                    if (inFlightIt != shard.inFlight.end())
+                    {
+                        pending = inFlightIt->second.result;
+                    }
+                    else
+                    {
+                        pending = promise.get_future().share();
+                        shard.inFlight.emplace(keyRef, InFlight{ pending, &promise });
+                        isOwner = true;
+                        ownerGeneration = generation.load(std::memory_order_acquire);
+                    }
+                }
             }
 
-#ifdef _WIN32
-            std::wstring pattern = GB_Utf8ToWString(node.dirUtf8);
-            if (pattern.empty())
+            if (entry)
             {
-                continue;
+                view.hitCount->fetch_add(1, std::memory_order_relaxed);
+                const Value result = Touch(entry);
+                InsertLocal(view, hash, std::move(entry), observedGeneration);
+                return result;
             }
 
-            // Win32 枚举 API 对 '/' 通常也能工作，但为避免边缘场景（以及与 reparse point 有关的路径解析差异），
-            // 这里统一改为 "\\"。
-            for (wchar_t& ch : pattern)
+            if (!isOwner)
+            {
+                // 等待到的值不写入 L1：计算者插入的条目可能已被淘汰，下次访问再从全局表读取。
+                coalescedCount.fetch_add(1, std::memory_order_relaxed);
+                return pending.get();
+            }
+
+            missCount.fetch_add(1, std::memory_order_relaxed);
+            Value result = Value();
+            try
+            {
+                result = compute();
+            }
+            catch (...)
             {
-                if (ch == L'/')
                 {
-                    ch = L'\\';
+                    GB_WriteLockGuard writeGuard(shard.lock);
+                    EraseInFlightNoLock(shard, keyRef, &promise);
                 }
+                promise.set_exception(std::current_exception());
+                throw;
             }
 
-            if (pattern.back() != L'\\')
             {
-                pattern.push_back(L'\\');
+                GB_WriteLockGuard writeGuard(shard.lock);
+                if (generation.load(std::memory_order_acquire) == ownerGeneration)
+                {
+                    entry = InsertNoLock(shard, key, hash, result);
+                }
+                EraseInFlightNoLock(shard, keyRef, &promise);
             }
-            pattern += L"*";
+            promise.set_value(result);
+            TrimToBudget();
 
-            WIN32_FIND_DATAW findData;
-            HANDLE findHandle = FindFirstFileW(pattern.c_str(), &findData);
-            if (findHandle == INVALID_HANDLE_VALUE)
+            // compute() 期间可能发生过 Clear()：重新取视图（使其与当前代数同步），InsertLocal 再按代数决定是否写入。
+            if (entry)
             {
-                continue;
+                InsertLocal(GetLocalView(), hash, std::move(entry), observedGeneration);
             }
+            return result;
+        }
 
-            do
+        // 插入 value；若其它线程已先插入，则返回已有值（调用方应使用返回值）。
+        Value GetOrInsert(const Key& key, const Value& value)
+        {
+            return GetOrInsert(key, value, GetGeneration());
+        }
+
+        // 同上，但 computeGeneration 为开始计算 value 之前 GetGeneration() 的返回值：
+        // 期间发生过 Clear() 时 value 可能基于旧的状态（例如切换 proj.db 之前），不写入缓存，直接返回 value。
+        Value GetOrInsert(const Key& key, const Value& value, std::uint64_t computeGeneration)
+        {
+            const size_t hash = Hasher()(key);
+            LocalView& view = GetLocalView();
+            const std::uint64_t observedGeneration = view.generation;
+
+            Shard& shard = GetShard(hash);
+            EntryPtr entry;
             {
-                const std::wstring entryNameW = findData.cFileName;
-                if (entryNameW == L"." || entryNameW == L"..")
+                GB_WriteLockGuard writeGuard(shard.lock);
+                if (generation.load(std::memory_order_acquire) != computeGeneration)
                 {
-                    continue;
+                    return value;
                 }
+                entry = InsertNoLock(shard, key, hash, value);
+            }
+            TrimToBudget();
 
-                if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+            const Value result = entry->value;
+            InsertLocal(view, hash, std::move(entry), observedGeneration);
+            return result;
+        }
+
+        std::uint64_t GetGeneration() const
+        {
+            return generation.load(std::memory_order_acquire);
+        }
+
+        // 批量版 GetOrCompute（keys 须已去重）：
+        // - 命中的 key 直接返回；其它调用正在计算的 key 等待其结果；
+        // - 其余 key 先登记为在途（同时到达的 GetOrCompute / GetOrComputeBatch 会等待本次的结果，而不是重复计算），
+        //   再调用一次 computeMisses(missIndices, outValues)，由其按 keys[missIndices[i]] 填充 outValues[i]（可在内部并行）；
+        // - 计算结果按分片各加一次写锁写入；计算期间发生过 Clear() 时不写入。
+        // computeMisses 抛出的异常会传递给本调用与所有等待者，且不会写入缓存。
+        template <typename ComputeMisses>
+        std::vector<Value> GetOrComputeBatch(const std::vector<Key>& keys, ComputeMisses&& computeMisses)
+        {
+            std::vector<Value> results(keys.size());
+            LocalView& view = GetLocalView();
+            const std::uint64_t observedGeneration = view.generation;
+
+            std::vector<size_t> hashes(keys.size());
+            std::vector<size_t> keyIndicesByShard[kShardCount];
+            std::uint64_t hitCount = 0;
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                hashes[i] = Hasher()(keys[i]);
+                if (const EntryPtr* localEntry = FindLocal(view, keys[i], hashes[i]))
                 {
+                    results[i] = Touch(*localEntry);
+                    hitCount++;
                     continue;
                 }
+                keyIndicesByShard[GetShardIndex(hashes[i])].push_back(i);
+            }
 
-                // 跳过重解析点（符号链接/目录联接等），避免出现循环或跨盘扫描。
-                if ((findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+            // 未命中的 key：登记为在途并由本调用计算（owned），或等待其它调用的结果（pending）。
+            std::vector<EntryPtr> entries(keys.size());
+            std::vector<size_t> ownedIndices;
+            std::vector<std::unique_ptr<std::promise<Value>>> promises;
+            std::vector<std::pair<size_t, std::shared_future<Value>>> pending;
+            const std::uint64_t ownerGeneration = GetGeneration();
+            for (size_t shardIndex = 0; shardIndex < kShardCount; shardIndex++)
+            {
+                if (keyIndicesByShard[shardIndex].empty())
                 {
                     continue;
                 }
 
-                const std::string entryNameUtf8 = GB_WStringToUtf8(entryNameW);
-                if (entryNameUtf8.empty())
+                Shard& shard = shards[shardIndex];
+                GB_WriteLockGuard writeGuard(shard.lock);
+                for (const size_t keyIndex : keyIndicesByShard[shardIndex])
                 {
-                    continue;
-                }
+                    const KeyRef keyRef{ &keys[keyIndex], hashes[keyIndex] };
+                    const auto it = shard.map.find(keyRef);
+                    if (it != shard.map.end())
+                    {
+                        entries[keyIndex] = it->second.entry;
+                        results[keyIndex] = Touch(entries[keyIndex]);
+                        hitCount++;
+                        continue;
+                    }
 
-                const std::string childDir = NormalizeDirPathUtf8(GB_JoinPath(node.dirUtf8, entryNameUtf8 + "/"));
-                if (!childDir.empty())
-                {
-                    if (visitedDirs + queue.size() >= maxVisitedDirs)
+                    const auto inFlightIt = shard.inFlight.find(keyRef);
+                    if (inFlightIt != shard.inFlight.end())
                     {
-                        break;
+                        pending.emplace_back(keyIndex, inFlightIt->second.result);
+                        continue;
                     }
-                    queue.push_back({ childDir, node.depth + 1 });
-                }
-            } while (FindNextFileW(findHandle, &findData));
 
-            FindClose(findHandle);
-#else
-            DIR* dir = opendir(node.dirUtf8.c_str());
-            if (dir == nullptr)
-            {
-                continue;
+                    promises.emplace_back(new std::promise<Value>());
+                    shard.inFlight.emplace(keyRef, InFlight{ promises.back()->get_future().share(), promises.back().get() });
+                    ownedIndices.push_back(keyIndex);
+                }
             }
 
-            while (true)
+            view.hitCount->fetch_add(hitCount, std::memory_order_relaxed);
+
+            if (!ownedIndices.empty())
             {
-                dirent* entry = readdir(dir);
-                if (entry == nullptr)
+                missCount.fetch_add(ownedIndices.size(), std::memory_order_relaxed);
+
+                std::vector<Value> ownedValues(ownedIndices.size());
+                try
                 {
-                    break;
+                    computeMisses(static_cast<const std::vector<size_t>&>(ownedIndices), ownedValues);
                 }
-
-                const std::string entryName = entry->d_name ? entry->d_name : "";
-                if (entryName.empty() || entryName == "." || entryName == "..")
+                catch (...)
                 {
-                    continue;
+                    const std::exception_ptr exception = std::current_exception();
+                    for (size_t i = 0; i < ownedIndices.size(); i++)
+                    {
+                        const size_t keyIndex = ownedIndices[i];
+                        Shard& shard = GetShard(hashes[keyIndex]);
+                        {
+                            GB_WriteLockGuard writeGuard(shard.lock);
+                            EraseInFlightNoLock(shard, KeyRef{ &keys[keyIndex], hashes[keyIndex] }, promises[i].get());
+                        }
+                        promises[i]->set_exception(exception);
+                    }
+                    throw;
                 }
 
-                const std::string childPath = GB_JoinPath(node.dirUtf8, entryName);
-
-                struct stat st;
-                if (lstat(childPath.c_str(), &st) != 0)
+                std::vector<size_t> ownedByShard[kShardCount];
+                for (size_t i = 0; i < ownedIndices.size(); i++)
                 {
-                    continue;
+                    ownedByShard[GetShardIndex(hashes[ownedIndices[i]])].push_back(i);
                 }
-
-                // 跳过符号链接，避免循环与意外跨目录树。
-                if (S_ISLNK(st.st_mode))
+                for (size_t shardIndex = 0; shardIndex < kShardCount; shardIndex++)
                 {
-                    continue;
+                    if (ownedByShard[shardIndex].empty())
+                    {
+                        continue;
+                    }
+
+                    Shard& shard = shards[shardIndex];
+                    GB_WriteLockGuard writeGuard(shard.lock);
+                    const bool isCurrent = generation.load(std::memory_order_acquire) == ownerGeneration;
+                    for (const size_t i : ownedByShard[shardIndex])
+                    {
+                        const size_t keyIndex = ownedIndices[i];
+                        if (isCurrent)
+                        {
+                            entries[keyIndex] = InsertNoLock(shard, keys[keyIndex], hashes[keyIndex], ownedValues[i]);
+                            ownedValues[i] = entries[keyIndex]->value;
+                        }
+                        EraseInFlightNoLock(shard, KeyRef{ &keys[keyIndex], hashes[keyIndex] }, promises[i].get());
+                    }
                 }
 
-                if (!S_ISDIR(st.st_mode))
+                for (size_t i = 0; i < ownedIndices.size(); i++)
                 {
-                    continue;
+                    promises[i]->set_value(ownedValues[i]);
+                    results[ownedIndices[i]] = std::move(ownedValues[i]);
                 }
+                TrimToBudget();
+            }
 
-                const std::string childDir = NormalizeDirPathUtf8(childPath);
-                if (!childDir.empty())
+            // 等待其它调用负责的 key；本调用的 promise 均已完成，不会与对方相互等待。
+            coalescedCount.fetch_add(pending.size(), std::memory_order_relaxed);
+            for (const auto& item : pending)
+            {
+                results[item.first] = item.second.get();
+            }
+
+            LocalView& currentView = GetLocalView();
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                if (entries[i])
                 {
-                    if (visitedDirs + queue.size() >= maxVisitedDirs)
-                    {
-                        break;
-                    }
-                    queue.push_back({ childDir, node.depth + 1 });
+                    InsertLocal(currentView, hashes[i], std::move(entries[i]), observedGeneration);
                 }
             }
+            return results;
+        }
 
-            closedir(dir);
-#endif
+        // 代数在清空前后各递增一次：清空前递增使进行中的计算在插入时发现代数变化而放弃写入；
+        // 清空后递增使清空期间写入 L1 的条目在下一次访问时失效。
+        void Clear()
+        {
+            generation.fetch_add(1, std::memory_order_acq_rel);
+            for (Shard& shard : shards)
+            {
+                GB_WriteLockGuard writeGuard(shard.lock);
+                evictableBytes.fetch_sub(shard.bytes, std::memory_order_relaxed);
+                shard.map.clear();
+                shard.inFlight.clear();
+                shard.probation.clear();
+                shard.protectedList.clear();
+                shard.bytes = 0;
+                shard.protectedBytes = 0;
+                shard.pinnedBytes = 0;
+            }
+            generation.fetch_add(1, std::memory_order_acq_rel);
         }
 
-        return "";
-    }
+        // 遍历全局表中的全部条目（逐分片加读锁，仅用于导出等低频操作）。
+        template <typename Func>
+        void ForEach(Func&& func) const
+        {
+            for (const Shard& shard : shards)
+            {
+                GB_ReadLockGuard readGuard(shard.lock);
+                for (const auto& item : shard.map)
+                {
+                    func(item.second.entry->key, item.second.entry->value);
+                }
+            }
+        }
 
-    std::string FindProjDatabaseDirBySearching(const std::string& startDirUtf8)
-    {
-        std::string currentDir = NormalizeDirPathUtf8(startDirUtf8);
-        if (currentDir.empty())
+        size_t Size() const
         {
-            return "";
+            size_t size = 0;
+            for (const Shard& shard : shards)
+            {
+                GB_ReadLockGuard readGuard(shard.lock);
+                size += shard.map.size();
+            }
+            return size;
         }
 
-        // 只做“轻量探测”：在每一级目录中尝试若干常见的 PROJ 资源布局，而不是递归扫描整个子树。
-        // 典型布局示例：
-        //  - <dir>/proj.db
-        //  - <dir>/share/proj/proj.db
-        //  - <dir>/proj/proj.db
-        //  - <dir>/Library/share/proj/proj.db   (Windows/Conda 常见)
-        while (!currentDir.empty())
+        // 设置字节预算（0 表示不限制）并立即把缓存压回预算内。
+        void SetByteBudget(size_t bytes)
         {
-            const std::string candidates[] =
+            budgetBytes.store(bytes, std::memory_order_relaxed);
+            if (bytes == 0)
             {
-                currentDir,
-                NormalizeDirPathUtf8(GB_JoinPath(currentDir, "share/proj/")),
-                NormalizeDirPathUtf8(GB_JoinPath(currentDir, "proj/")),
-                NormalizeDirPathUtf8(GB_JoinPath(currentDir, "Library/share/proj/"))
-            };
+                return;
+            }
 
-            for (const std::string& candidateDir : candidates)
+            const std::uint64_t evictionsBefore = evictionCount.load(std::memory_order_relaxed);
+            TrimToBudget();
+
+            // 预算收紧时一次性让各线程 L1 失效，使被淘汰的条目尽快释放。
+            if (evictionCount.load(std::memory_order_relaxed) != evictionsBefore)
             {
-                if (candidateDir.empty())
+                evictedBytesSinceReset.store(0, std::memory_order_relaxed);
+                generation.fetch_add(1, std::memory_order_acq_rel);
+            }
+        }
+
+        GeoCrsManager::CacheMemoryGauge GetMemoryGauge() const
+        {
+            GeoCrsManager::CacheMemoryGauge gauge;
+            gauge.budgetBytes = budgetBytes.load(std::memory_order_relaxed);
+            gauge.evictionCount = evictionCount.load(std::memory_order_relaxed);
+            gauge.localViewEntryCount = localViewUsage->entryCount.load(std::memory_order_relaxed);
+            gauge.localViewBytes = localViewUsage->bytes.load(std::memory_order_relaxed);
+            for (const Shard& shard : shards)
+            {
+                GB_ReadLockGuard readGuard(shard.lock);
+                gauge.entryCount += shard.map.size();
+                gauge.approximateBytes += shard.bytes + shard.pinnedBytes;
+                gauge.pinnedBytes += shard.pinnedBytes;
+            }
+            return gauge;
+        }
+
+        // 命中数按线程累计（命中路径只写本线程的计数器），读取时汇总；已退出线程的计数并入 retiredHitCount。
+        GeoCrsManager::CacheCounters GetCounters() const
+        {
+            GeoCrsManager::CacheCounters counters;
+            counters.missCount = missCount.load(std::memory_order_relaxed);
+            counters.coalescedCount = coalescedCount.load(std::memory_order_relaxed);
+            counters.evictionCount = evictionCount.load(std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(hitCountRegistryMutex);
+            for (auto it = hitCountRegistry.begin(); it != hitCountRegistry.end();)
+            {
+                const std::uint64_t threadHits = (*it)->load(std::memory_order_relaxed);
+                if (it->use_count() == 1)
                 {
-                    continue;
+                    retiredHitCount += threadHits;
+                    it = hitCountRegistry.erase(it);
                 }
-
-                const std::string projDbPath = GB_JoinPath(candidateDir, "proj.db");
-                if (GB_IsFileExists(projDbPath))
+                else
                 {
-                    return NormalizeDirPathUtf8(candidateDir);
+                    counters.hitCount += threadHits;
+                    ++it;
                 }
             }
+            counters.hitCount += retiredHitCount;
+            return counters;
+        }
 
-            const std::string parent = GetParentDirectoryUtf8(currentDir);
-            if (parent.empty() || parent == currentDir)
+    private:
+        static constexpr size_t kShardCount = 16;
+        static constexpr size_t kLocalViewCapacity = 128;
+
+        // 条目内容插入后只读；referenced 记录自上次被淘汰扫描经过以来是否被访问过（L1/L2 命中均会置位）。
+        // key 只在条目中保存一份，分片表与淘汰链表都以 KeyRef 引用它。
+        struct Entry
+        {
+            Entry(const Key& key, const Value& value, size_t bytes) : key(key), value(value), bytes(bytes)
             {
-                break;
             }
 
-            currentDir = parent;
-        }
+            const Key key;
+            const Value value;
+            const size_t bytes;
+            mutable std::atomic_bool referenced{ false };
+        };
 
-        // 兜底：在 startDir 下做一次有界深度搜索，覆盖少数“非典型安装布局”。
-        return LimitedSearchProjDbUnderDirUtf8(startDirUtf8, 5, 5000);
-    }
+        using EntryPtr = std::shared_ptr<const Entry>;
 
-    bool ApplyProjDatabaseDirectoryUtf8Internal(const std::string& projDatabaseDirUtf8)
-    {
-        const std::string dir = NormalizeDirPathUtf8(projDatabaseDirUtf8);
-        if (dir.empty())
+        // 引用 key 并携带其 hash：分片表、在途表与淘汰链表不复制 key，查找与重新哈希时也不重复计算 hash。
+        // 表中的 KeyRef 指向条目内的 key（条目由 Slot 持有，地址稳定）；查找时临时指向调用方的参数。
+        struct KeyRef
         {
-            return false;
-        }
+            const Key* key;
+            size_t hash;
 
-        const std::string projDbPath = GB_JoinPath(dir, "proj.db");
-        if (!GB_IsFileExists(projDbPath))
+            bool operator==(const KeyRef& other) const
+            {
+                return hash == other.hash && *key == *other.key;
+            }
+        };
+
+        struct KeyRefHasher
         {
-            return false;
-        }
+            size_t operator()(const KeyRef& keyRef) const
+            {
+                return keyRef.hash;
+            }
+        };
 
-        // 兼容：PROJ_DATA 是新变量名，但很多环境仍依赖 PROJ_LIB（PROJ >= 9.1 引入 PROJ_DATA，PROJ_LIB 作为兼容回退）。
-        CPLSetConfigOption("PROJ_LIB", dir.c_str());
-        CPLSetConfigOption("PROJ_DATA", dir.c_str());
+        struct PrehashedHasher
+        {
+            size_t operator()(size_t hash) const
+            {
+                return hash;
+            }
+        };
 
-        const char* const paths[] = { dir.c_str(), nullptr };
-        OSRSetPROJSearchPaths(paths);
+        enum class Segment
+        {
+            Pinned,
+            Probation,
+            Protected
+        };
 
-        return true;
-    }
+        struct Slot
+        {
+            EntryPtr entry;
+            Segment segment = Segment::Pinned;
+            typename std::list<KeyRef>::iterator position;
+        };
 
-    void ClearCachesInternal()
-    {
+        // 在途的计算；owner 标识负责计算的调用（其 promise 的地址），Clear() 之后同一 key 可能已由新的调用登记。
+        struct InFlight
+        {
+            std::shared_future<Value> result;
+            const void* owner;
+        };
+
+        // 分段 LRU（SLRU）：
+        // - 新条目进入试用段（probation）头部；淘汰时从试用段尾部扫描：
+        //   被访问过的条目晋升到保护段（protected）头部，未被访问过的条目被淘汰；
+        // - 保护段超出本分片可淘汰字节数的 80% 时，其尾部条目降级回试用段头部（并清除访问标记）。
+        // 因而只访问过一次的条目（例如一次性的 WKT）先于反复访问的条目被淘汰。
+        // 访问只置位标记、不移动链表，命中路径无需写锁。
+        struct Shard
+        {
+            mutable GB_ReadWriteLock lock;
+            std::unordered_map<KeyRef, Slot, KeyRefHasher> map;
+            std::unordered_map<KeyRef, InFlight, KeyRefHasher> inFlight;
+            std::list<KeyRef> probation;
+            std::list<KeyRef> protectedList;
+            size_t bytes = 0;          // 可淘汰条目的近似字节数
+            size_t protectedBytes = 0;
+            size_t pinnedBytes = 0;
+        };
+
+        using HitCounter = std::shared_ptr<std::atomic<std::uint64_t>>;
+
+        // 各线程 L1 视图合计引用的条目数与字节数（条目被淘汰后仍由视图引用时，其内存只在这里体现）。
+        // 由缓存与各视图共同持有，线程退出时视图在析构中扣除自己的份额。
+        struct LocalViewUsage
+        {
+            std::atomic<size_t> entryCount{ 0 };
+            std::atomic<size_t> bytes{ 0 };
+        };
+
+        // L1 以 hash 为键；hash 冲突时后写入的条目覆盖先前的条目（只影响命中率）。
+        // 至多保存 kLocalViewCapacity 个条目，写满时整体清空后重新从全局表填充：
+        // 已被全局表淘汰的条目在每个线程中最多再保留这么多个，且计入内存统计。
+        struct LocalView
+        {
+            LocalView() = default;
+            LocalView(const LocalView&) = delete;
+            LocalView& operator=(const LocalView&) = delete;
+
+            ~LocalView()
+            {
+                Reset();
+            }
+
+            void Reset()
+            {
+                if (usage)
+                {
+                    usage->entryCount.fetch_sub(map.size(), std::memory_order_relaxed);
+                    usage->bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                }
+                map.clear();
+                bytes = 0;
+            }
+
+            std::uint64_t generation = 0;
+            std::unordered_map<size_t, EntryPtr, PrehashedHasher> map;
+            size_t bytes = 0;
+            HitCounter hitCount;
+            std::shared_ptr<LocalViewUsage> usage;
+        };
+
+        static const EntryPtr* FindLocal(const LocalView& view, const Key& key, size_t hash)
         {
-            GB_WriteLockGuard guard(g_epsgCacheLock);
-            g_epsgCache.clear();
+            const auto it = view.map.find(hash);
+            return (it != view.map.end() && it->second->key == key) ? &it->second : nullptr;
         }
+
+        // observedGeneration 为读取全局表之前的视图代数；期间发生过 Clear() 时不写入，避免旧条目混入新一代视图。
+        void InsertLocal(LocalView& view, size_t hash, EntryPtr entry, std::uint64_t observedGeneration) const
         {
-            GB_WriteLockGuard guard(g_wktCacheLock);
-            g_wktCache.clear();
+            if (generation.load(std::memory_order_acquire) != observedGeneration)
+            {
+                return;
+            }
+
+            const size_t entryBytes = entry->bytes;
+            const auto existing = view.map.find(hash);
+            if (existing != view.map.end())
+            {
+                view.bytes -= existing->second->bytes;
+                view.usage->bytes.fetch_sub(existing->second->bytes, std::memory_order_relaxed);
+                existing->second = std::move(entry);
+            }
+            else
+            {
+                if (view.map.size() >= kLocalViewCapacity)
+                {
+                    view.Reset();
+                }
+                view.map.emplace(hash, std::move(entry));
+                view.usage->entryCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            view.bytes += entryBytes;
+            view.usage->bytes.fetch_add(entryBytes, std::memory_order_relaxed);
         }
+
+        static const Value& Touch(const EntryPtr& entry)
         {
-            GB_WriteLockGuard guard(g_wktValidityCacheLock);
-            g_wktValidityCache.clear();
+            // 先读后写：已置位时不写共享内存，避免热点条目的缓存行在线程间来回失效。
+            if (!entry->referenced.load(std::memory_order_relaxed))
+            {
+                entry->referenced.store(true, std::memory_order_relaxed);
+            }
+            return entry->value;
         }
+
+        // 须持有分片写锁。key 已存在时返回已有条目；否则插入并在超出预算时淘汰（新条目本身也可能被淘汰，但返回值仍有效）。
+        EntryPtr InsertNoLock(Shard& shard, const Key& key, size_t hash, const Value& value)
         {
-            GB_WriteLockGuard guard(g_definitionCacheLock);
-            g_definitionCache.clear();
+            const auto existing = shard.map.find(KeyRef{ &key, hash });
+            if (existing != shard.map.end())
+            {
+                return existing->second.entry;
+            }
+
+            const size_t bytes = kApproximateEntryOverheadBytes + ApproximateBytes(key) + ApproximateBytes(value);
+            const EntryPtr entry = std::make_shared<Entry>(key, value, bytes);
+            const auto inserted = shard.map.emplace(KeyRef{ &entry->key, hash }, Slot());
+            Slot& slot = inserted.first->second;
+            slot.entry = entry;
+
+            if (isPinned != nullptr && isPinned(key))
+            {
+                shard.pinnedBytes += bytes;
+                return entry;
+            }
+
+            shard.probation.push_front(inserted.first->first);
+            slot.position = shard.probation.begin();
+            slot.segment = Segment::Probation;
+            shard.bytes += bytes;
+            evictableBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+            // 本分片超出均分份额时先淘汰本分片；仍超出预算时由调用方在释放锁后调用 TrimToBudget()。
+            EvictNoLock(shard, budgetBytes.load(std::memory_order_relaxed) / kShardCount);
+            return entry;
         }
+
+        // 须持有分片写锁。只移除 owner 自己登记的在途条目。
+        static void EraseInFlightNoLock(Shard& shard, const KeyRef& keyRef, const void* owner)
         {
-            GB_WriteLockGuard guard(g_validAreaCacheLock);
-            g_validAreaCache.clear();
+            const auto it = shard.inFlight.find(keyRef);
+            if (it != shard.inFlight.end() && it->second.owner == owner)
+            {
+                shard.inFlight.erase(it);
+            }
         }
-    }
 
-    int ParseEpsgCodeFromStringUtf8(const std::string& epsgCodeUtf8)
-    {
-        const std::string trimmed = GB_Utf8Trim(epsgCodeUtf8);
-        if (trimmed.empty())
+        // 须持有分片写锁。
+        void DemoteNoLock(Shard& shard)
         {
-            return 0;
+            Slot& slot = shard.map.find(shard.protectedList.back())->second;
+            slot.entry->referenced.store(false, std::memory_order_relaxed);
+            shard.probation.splice(shard.probation.begin(), shard.protectedList, slot.position);
+            slot.segment = Segment::Probation;
+            shard.protectedBytes -= slot.entry->bytes;
         }
 
-        // 允许："EPSG:4326" / "epsg:4326" / "4326"。
-        std::string codePart = trimmed;
-        if (trimmed.size() >= 5)
+        // 须持有分片写锁。缓存总量超出预算时从本分片淘汰，直到总量回到预算内或本分片降到 floorBytes。
+        // 预算按整个缓存计，而不是按分片均分：hash 分布不均时热点分片可以多占，只要总量不超出预算。
+        void EvictNoLock(Shard& shard, size_t floorBytes)
         {
-            const char e0 = static_cast<char>(std::tolower(static_cast<unsigned char>(trimmed[0])));
-            const char e1 = static_cast<char>(std::tolower(static_cast<unsigned char>(trimmed[1])));
-            const char e2 = static_cast<char>(std::tolower(static_cast<unsigned char>(trimmed[2])));
-            const char e3 = static_cast<char>(std::tolower(static_cast<unsigned char>(trimmed[3])));
-            if (e0 == 'e' && e1 == 'p' && e2 == 's' && e3 == 'g')
+            const size_t budget = budgetBytes.load(std::memory_order_relaxed);
+            if (budget == 0 || shard.bytes <= floorBytes || evictableBytes.load(std::memory_order_relaxed) <= budget)
             {
-                const size_t colonPos = trimmed.find(':');
-                if (colonPos != std::string::npos)
+                return;
+            }
+
+            const size_t protectedBudget = shard.bytes / 5 * 4;
+            size_t evictedBytes = 0;
+
+            // 其它线程可能在无锁的命中路径上并发置位访问标记，故限定扫描步数；未压回预算时留给下一次插入。
+            size_t remainingSteps = 2 * (shard.probation.size() + shard.protectedList.size()) + 1;
+            while (shard.bytes > floorBytes && evictableBytes.load(std::memory_order_relaxed) > budget && remainingSteps-- > 0)
+            {
+                if (shard.protectedBytes > protectedBudget || shard.probation.empty())
                 {
-                    codePart = GB_Utf8Trim(trimmed.substr(colonPos + 1));
+                    if (shard.protectedList.empty())
+                    {
+                        break;
+                    }
+                    DemoteNoLock(shard);
+                    continue;
                 }
-                else
+
+                const auto it = shard.map.find(shard.probation.back());
+                Slot& slot = it->second;
+                if (slot.entry->referenced.exchange(false, std::memory_order_relaxed))
                 {
-                    return 0;
+                    shard.protectedList.splice(shard.protectedList.begin(), shard.probation, slot.position);
+                    slot.segment = Segment::Protected;
+                    shard.protectedBytes += slot.entry->bytes;
+                    continue;
+                }
+
+                shard.probation.pop_back();
+                shard.bytes -= slot.entry->bytes;
+                evictableBytes.fetch_sub(slot.entry->bytes, std::memory_order_relaxed);
+                evictedBytes += slot.entry->bytes;
+                shard.map.erase(it);
+                evictionCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // 被淘汰的条目仍可能留在各线程的 L1 视图中。累计淘汰量达到预算的 1/4 时递增代数，
+            // 让各线程的 L1 在下次访问时清空以真正释放内存；不每次淘汰都清空，以免 L1 反复重建。
+            if (evictedBytes > 0)
+            {
+                const size_t pendingBytes = evictedBytesSinceReset.fetch_add(evictedBytes, std::memory_order_relaxed) + evictedBytes;
+                if (pendingBytes >= budget / 4)
+                {
+                    evictedBytesSinceReset.store(0, std::memory_order_relaxed);
+                    generation.fetch_add(1, std::memory_order_acq_rel);
                 }
             }
         }
 
-        if (codePart.empty())
+        // 不得持有任何分片锁。插入所在的分片未能把总量压回预算内时（例如它本身占用很少），
+        // 从轮转的起始分片开始，依次淘汰各分片超出均分份额的部分；总量超出预算时必有分片超出均分份额。
+        void TrimToBudget()
         {
-            return 0;
+            const size_t budget = budgetBytes.load(std::memory_order_relaxed);
+            if (budget == 0 || evictableBytes.load(std::memory_order_relaxed) <= budget)
+            {
+                return;
+            }
+
+            const size_t startIndex = nextTrimShard.fetch_add(1, std::memory_order_relaxed);
+            for (size_t i = 0; i < kShardCount && evictableBytes.load(std::memory_order_relaxed) > budget; i++)
+            {
+                Shard& shard = shards[(startIndex + i) % kShardCount];
+                GB_WriteLockGuard writeGuard(shard.lock);
+                EvictNoLock(shard, budget / kShardCount);
+            }
         }
 
-        // 纯数字检查
-        for (const char ch : codePart)
+        LocalView& GetLocalView() const
         {
-            if (ch < '0' || ch > '9')
+            static thread_local LocalView view;
+
+            if (!view.hitCount)
             {
-                return 0;
+                view.hitCount = std::make_shared<std::atomic<std::uint64_t>>(0);
+                view.usage = localViewUsage;
+                std::lock_guard<std::mutex> lock(hitCountRegistryMutex);
+                hitCountRegistry.push_back(view.hitCount);
             }
+
+            const std::uint64_t currentGeneration = generation.load(std::memory_order_acquire);
+            if (view.generation != currentGeneration)
+            {
+                view.Reset();
+                view.generation = currentGeneration;
+            }
+            return view;
         }
 
-        errno = 0;
-        char* endPtr = nullptr;
-        const long long value = std::strtoll(codePart.c_str(), &endPtr, 10);
-        if (endPtr == nullptr || endPtr == codePart.c_str() || *endPtr != '\0')
+        // 分片取混合后 hash 的高位：unordered_map 按低位分桶，若分片也取低位，同一分片内的 key 只会落入少数桶；
+        // 且部分标准库对整数的 hash 是恒等映射，直接取高位会使小整数全部落入同一分片。
+        static size_t GetShardIndex(size_t hash)
         {
-            return 0;
+            return static_cast<size_t>((static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL) >> 60) % kShardCount;
         }
-        if (errno == ERANGE)
+
+        Shard& GetShard(size_t hash)
         {
-            return 0;
+            return shards[GetShardIndex(hash)];
         }
-        if (value <= 0 || value > static_cast<long long>(std::numeric_limits<int>::max()))
+
+        const Shard& GetShard(size_t hash) const
         {
-            return 0;
+            return shards[GetShardIndex(hash)];
         }
 
-        return static_cast<int>(value);
-    }
+        const PinPredicate isPinned;
+
+        // 从 1 开始，使线程视图的初始代数（0）必然失配，避免首次访问时误用未初始化的视图。
+        std::atomic<std::uint64_t> generation{ 1 };
+        Shard shards[kShardCount];
+
+        std::atomic<size_t> budgetBytes{ 0 };
+        std::atomic<size_t> evictableBytes{ 0 }; // 各分片 bytes 之和
+        std::atomic<size_t> evictedBytesSinceReset{ 0 };
+        std::atomic<size_t> nextTrimShard{ 0 };
+        const std::shared_ptr<LocalViewUsage> localViewUsage = std::make_shared<LocalViewUsage>();
+
+        std::atomic<std::uint64_t> missCount{ 0 };
+        std::atomic<std::uint64_t> coalescedCount{ 0 };
+        std::atomic<std::uint64_t> evictionCount{ 0 };
+        mutable std::mutex hitCountRegistryMutex;
+        mutable std::vector<HitCounter> hitCountRegistry;
+        mutable std::uint64_t retiredHitCount = 0;
+    };
+
+    struct EpsgCacheTag {};
+    struct WktCacheTag {};
+    struct WktValidityCacheTag {};
+    struct DefinitionCacheTag {};
+    struct ValidAreaCacheTag {};
+    struct InternWktCacheTag {};
+    struct MetadataCacheTag {};
+    struct FrozenEpsgCacheTag {};
+    struct FrozenWktCacheTag {};
+    struct FootprintCacheTag {};
+    struct CanonicalValidAreaCacheTag {};
+    struct CanonicalFrozenCacheTag {};
+    struct CanonicalFootprintCacheTag {};
+
+    // -------------------- 全局状态与缓存 --------------------
+
+    std::atomic_bool g_isInitialized(false);
+    std::string g_projDatabaseDirUtf8 = "";
+    GB_ReadWriteLock g_initLock;
+
+    // 自动初始化的统计（原子量：查询时不等待 g_initLock）。
+    std::atomic<std::uint64_t> g_initNanoseconds(0);
+    std::atomic_bool g_initRestoredFromState(false);
+    std::atomic_bool g_initInBackground(false);
+    std::atomic_bool g_backgroundInitStarted(false);
+    thread_local bool t_isBackgroundInitThread = false;
+
+    // 内置的 WGS84 / WebMercator（GetWgs84() / GetWebMercator()）不参与预算淘汰。
+    bool IsBuiltinEpsgCode(const int& epsgCode)
+    {
+        return epsgCode == 4326 || epsgCode == 3857;
+    }
+
+    ConcurrentCache<EpsgCacheTag, int, std::shared_ptr<const GeoCrs>> g_epsgCache(IsBuiltinEpsgCode);
+    ConcurrentCache<WktCacheTag, std::string, std::shared_ptr<const GeoCrs>> g_wktCache;
+    ConcurrentCache<WktValidityCacheTag, std::string, bool> g_wktValidityCache;
+    ConcurrentCache<DefinitionCacheTag, DefinitionKey, std::shared_ptr<const GeoCrs>, DefinitionKeyHasher> g_definitionCache;
+    ConcurrentCache<ValidAreaCacheTag, std::string, ValidAreas> g_validAreaCache;
+    ConcurrentCache<MetadataCacheTag, std::string, std::shared_ptr<const GeoCrsManager::CrsMetadata>> g_metadataCache;
+    ConcurrentCache<FrozenEpsgCacheTag, int, std::shared_ptr<const FrozenGeoCrs>> g_frozenEpsgCache;
+    ConcurrentCache<FrozenWktCacheTag, std::string, std::shared_ptr<const FrozenGeoCrs>> g_frozenWktCache;
+    ConcurrentCache<FootprintCacheTag, std::string, std::shared_ptr<const GeoCrsFootprint>> g_footprintCache;
+
+    // 按 GeoCrs::GetUidUtf8() 合并等价坐标系的登记表：同一坐标系的不同写法
+    // （WKT1 / WKT1_ESRI / WKT2 / PROJJSON / "EPSG:xxxx" 等）在上面各缓存中共享同一个 GeoCrs 对象。
+    // 只保存弱引用，不延长 GeoCrs 的生命周期：GeoCrs 由按输入字符串索引的缓存（受内存预算约束）与调用方持有，
+    // 都释放后登记项失效，下次遇到同一 UID 时重新登记。只在解析新坐标系时访问，用一把互斥锁即可。
+    class CanonicalCrsRegistry
+    {
+    public:
+        // 返回同 UID 的现存实例；不存在或已失效时登记 crs 并返回 crs。
+        std::shared_ptr<const GeoCrs> GetOrInsert(const std::string& uid, const std::shared_ptr<const GeoCrs>& crs)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::weak_ptr<const GeoCrs>& registered = crsByUid[uid];
+            std::shared_ptr<const GeoCrs> existing = registered.lock();
+            if (existing)
+            {
+                return existing;
+            }
+
+            registered = crs;
+            PurgeExpiredNoLock();
+            return crs;
+        }
+
+        std::shared_ptr<const GeoCrs> Find(const std::string& uid) const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto it = crsByUid.find(uid);
+            return (it != crsByUid.end()) ? it->second.lock() : nullptr;
+        }
+
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            crsByUid.clear();
+            purgeThreshold = kMinPurgeThreshold;
+        }
+
+        // 现存（未失效）的坐标系个数。
+        size_t Size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            size_t count = 0;
+            for (const auto& item : crsByUid)
+            {
+                if (!item.second.expired())
+                {
+                    count++;
+                }
+            }
+            return count;
+        }
+
+        // 登记表自身的近似字节数（GeoCrs 由其它缓存计入）。
+        size_t GetApproximateBytes() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            size_t bytes = 0;
+            for (const auto& item : crsByUid)
+            {
+                bytes += kApproximateEntryOverheadBytes + ApproximateBytes(item.first) + sizeof(item.second);
+            }
+            return bytes;
+        }
+
+    private:
+        static constexpr size_t kMinPurgeThreshold = 64;
+
+        // 登记数翻倍时清理一次失效项，均摊开销为常数。
+        void PurgeExpiredNoLock()
+        {
+            if (crsByUid.size() < purgeThreshold)
+            {
+                return;
+            }
+
+            for (auto it = crsByUid.begin(); it != crsByUid.end();)
+            {
+                it = it->second.expired() ? crsByUid.erase(it) : std::next(it);
+            }
+            const size_t liveThreshold = crsByUid.size() * 2;
+            purgeThreshold = (liveThreshold > kMinPurgeThreshold) ? liveThreshold : kMinPurgeThreshold;
+        }
+
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, std::weak_ptr<const GeoCrs>> crsByUid;
+        size_t purgeThreshold = kMinPurgeThreshold;
+    };
+
+    CanonicalCrsRegistry g_canonicalCrsRegistry;
+
+    // 第二级缓存：以规范实例的 UID 加内容哈希为 key（见 GetCanonicalKeyInternal），有效范围、不可变快照与足迹对同一坐标系的不同写法只计算一次。
+    ConcurrentCache<CanonicalValidAreaCacheTag, std::string, ValidAreas> g_canonicalValidAreaCache;
+    ConcurrentCache<CanonicalFrozenCacheTag, std::string, std::shared_ptr<const FrozenGeoCrs>> g_canonicalFrozenCache;
+    ConcurrentCache<CanonicalFootprintCacheTag, std::string, std::shared_ptr<const GeoCrsFootprint>> g_canonicalFootprintCache;
+
+    // -------------------- CRS 驻留表 --------------------
+
+    // id 与 CRS 的对应关系在进程生命周期内不变（ClearCaches() 不会清空驻留表），
+    // 因此 GeoBoundingBox 等对象可以长期持有 id。条目从不释放，只由显式的 InternCrs 调用新增。
+    struct InternedCrs
+    {
+        std::shared_ptr<const GeoCrs> crs;
+        std::string canonicalWktUtf8 = "";
+        // 第二级缓存 key（见 BuildCanonicalKeyInternal），驻留时算好，按 id 查有效范围/足迹时无需再哈希。
+        std::string canonicalKey = "";
+    };
+
+    // 条目按块分配，块一经分配不再移动：读取 id 对应的条目只需两次原子读，无需加锁。
+    constexpr size_t kInternBlockSize = 4096;
+    constexpr size_t kInternMaxBlocks = 16;
+
+    std::atomic<InternedCrs*> g_internBlocks[kInternMaxBlocks];
+    std::atomic<std::uint32_t> g_internCount(0);
+
+    // 仅用于串行化“分配新 id”，读取路径不使用。
+    std::mutex g_internMutex;
+    std::vector<std::unique_ptr<InternedCrs[]>> g_internBlockStorage;
+    // UID -> id。EPSG UID 只取自根 AUTHORITY，改动过参数但保留权威码的 WKT 与原坐标系 UID 相同，
+    // 因此一个 UID 可能对应多个 id，命中后还须用 GeoCrs::operator== 确认。
+    std::unordered_multimap<std::string, std::uint32_t> g_internIdByUid;
+
+    // 裁剪后的 WKT -> id，只缓存已驻留的 WKT。受缓存预算约束，淘汰后重新按 UID 查找即可。
+    ConcurrentCache<InternWktCacheTag, std::string, std::uint32_t> g_internWktCache;
+
+    const InternedCrs* GetInternedCrs(std::uint32_t crsId)
+    {
+        if (crsId == 0 || crsId > g_internCount.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        const size_t index = static_cast<size_t>(crsId - 1);
+        const InternedCrs* block = g_internBlocks[index / kInternBlockSize].load(std::memory_order_acquire);
+        return (block != nullptr) ? &block[index % kInternBlockSize] : nullptr;
+    }
+
+    // 在 UID 相同的已驻留条目中找与 crs 相等的一个；调用方需持有 g_internMutex。未找到返回 0。
+    std::uint32_t FindInternedIdNoLock(const std::string& uid, const GeoCrs& crs)
+    {
+        const auto range = g_internIdByUid.equal_range(uid);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            const InternedCrs* entry = GetInternedCrs(it->second);
+            if (entry != nullptr && entry->crs && *entry->crs == crs)
+            {
+                return it->second;
+            }
+        }
+        return 0;
+    }
+
+    std::shared_ptr<const GeoCrs> GetEmptyCrsShared()
+    {
+        static const std::shared_ptr<const GeoCrs> emptyCrs = std::make_shared<GeoCrs>();
+        return emptyCrs;
+    }
+
+    // -------------------- 持久化元数据缓存 --------------------
+
+    // 文件布局（全部小端序）：
+    //  [文件头 64 字节][条目表 entryCount * 120 字节（按 keyHash 升序）][字符串区]
+    // - 文件头：magic(8) | version(u32) | entryCount(u32) | proj.db 路径哈希(u64) | proj.db 大小(u64) | proj.db 修改时间(u64)
+    //           | PROJ 版本(u32) | 字符串区偏移(u32) | 字符串区大小(u32) | 保留(3 * u32)
+    // - 条目：keyHash(u64) | key/uid/canonicalWkt/lonLatWkt/selfWkt 各自的 (偏移 u32, 长度 u32) | epsgCode(i32) | flags(u32)
+    //         | lonLatRect(4 * f64) | selfRect(4 * f64)
+    // - 字符串以 (偏移, 长度) 引用字符串区，相同字符串（如 EPSG:4326 的 WKT）只存一份。
+    // 加载时只校验文件头并映射文件，查找直接在映射内存上二分，不做任何解析。
+    // 布局变化时必须递增 kMetadataFileVersion。
+    const char kMetadataFileMagic[8] = { 'M', 'W', 'C', 'R', 'S', 'M', 'D', '\0' };
+    constexpr std::uint32_t kMetadataFileVersion = 1;
+    constexpr size_t kMetadataHeaderSize = 64;
+    constexpr size_t kMetadataEntrySize = 120;
+    constexpr std::uint32_t kMetadataFlagValid = 1u;
+
+    // 可通过 GDAL 配置项（或同名环境变量）指定缓存文件，初始化时自动加载。
+    const char* const kMetadataCacheConfigOption = "MAPWEAVER_CRS_METADATA_CACHE";
+
+    // proj.db 的身份：路径、大小、修改时间及 PROJ 版本任一变化，都视为缓存失效。
+    struct ProjDbSignature
+    {
+        std::uint64_t pathHash = 0;
+        std::uint64_t fileSize = 0;
+        std::uint64_t modifiedTime = 0;
+        std::uint32_t projVersion = 0;
+
+        bool operator==(const ProjDbSignature& other) const
+        {
+            return pathHash == other.pathHash && fileSize == other.fileSize &&
+                modifiedTime == other.modifiedTime && projVersion == other.projVersion;
+        }
+    };
+
+    std::uint64_t HashBytesFnv1a64(const char* data, size_t size)
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    std::uint64_t HashWktKey(const std::string& trimmedWktUtf8)
+    {
+        return HashBytesFnv1a64(trimmedWktUtf8.data(), trimmedWktUtf8.size());
+    }
+
+    bool TryGetProjDbSignature(const std::string& projDbDirUtf8, ProjDbSignature& outSignature)
+    {
+        if (projDbDirUtf8.empty())
+        {
+            return false;
+        }
+
+        const std::string projDbPath = GB_JoinPath(projDbDirUtf8, "proj.db");
+
+        ProjDbSignature signature;
+        signature.pathHash = HashBytesFnv1a64(projDbPath.data(), projDbPath.size());
+
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA attributes;
+        if (!GetFileAttributesExW(GB_Utf8ToWString(projDbPath).c_str(), GetFileExInfoStandard, &attributes))
+        {
+            return false;
+        }
+        signature.fileSize = (static_cast<std::uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+        signature.modifiedTime = (static_cast<std::uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+#else
+        struct stat st;
+        if (stat(projDbPath.c_str(), &st) != 0)
+        {
+            return false;
+        }
+        signature.fileSize = static_cast<std::uint64_t>(st.st_size);
+        signature.modifiedTime = static_cast<std::uint64_t>(st.st_mtime);
+#endif
+
+        int major = 0;
+        int minor = 0;
+        int patch = 0;
+        OSRGetPROJVersion(&major, &minor, &patch);
+        signature.projVersion = static_cast<std::uint32_t>(major * 10000 + minor * 100 + patch);
+
+        outSignature = signature;
+        return true;
+    }
+
+    std::uint32_t LoadUInt32LE(const unsigned char* data)
+    {
+        return static_cast<std::uint32_t>(data[0]) |
+            (static_cast<std::uint32_t>(data[1]) << 8) |
+            (static_cast<std::uint32_t>(data[2]) << 16) |
+            (static_cast<std::uint32_t>(data[3]) << 24);
+    }
+
+    std::uint64_t LoadUInt64LE(const unsigned char* data)
+    {
+        return static_cast<std::uint64_t>(LoadUInt32LE(data)) | (static_cast<std::uint64_t>(LoadUInt32LE(data + 4)) << 32);
+    }
+
+    double LoadDoubleLE(const unsigned char* data)
+    {
+        const std::uint64_t bits = LoadUInt64LE(data);
+        double value = 0.0;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    void AppendUInt64LE(GB_ByteBuffer& buffer, std::uint64_t value)
+    {
+        GB_ByteBufferIO::AppendUInt32LE(buffer, static_cast<std::uint32_t>(value & 0xFFFFFFFFu));
+        GB_ByteBufferIO::AppendUInt32LE(buffer, static_cast<std::uint32_t>(value >> 32));
+    }
+
+    void AppendRectangleLE(GB_ByteBuffer& buffer, const GB_Rectangle& rect)
+    {
+        GB_ByteBufferIO::AppendDoubleLE(buffer, rect.minX);
+        GB_ByteBufferIO::AppendDoubleLE(buffer, rect.minY);
+        GB_ByteBufferIO::AppendDoubleLE(buffer, rect.maxX);
+        GB_ByteBufferIO::AppendDoubleLE(buffer, rect.maxY);
+    }
+
+    // 只读的缓存文件。对象析构时解除映射；查找方持有 shared_ptr 期间数据保持有效。
+    // Windows 上被映射的文件无法被 MoveFileExW 替换（其它线程或进程可能仍持有映射），
+    // 因此整体读入内存后立即关闭文件；其它平台使用内存映射（rename 不受映射影响）。
+    class MappedMetadataFile
+    {
+    public:
+        MappedMetadataFile() = default;
+        MappedMetadataFile(const MappedMetadataFile&) = delete;
+        MappedMetadataFile& operator=(const MappedMetadataFile&) = delete;
+
+        ~MappedMetadataFile()
+        {
+#ifndef _WIN32
+            if (data != nullptr)
+            {
+                munmap(const_cast<unsigned char*>(data), size);
+            }
+#endif
+        }
+
+        bool Map(const std::string& pathUtf8)
+        {
+#ifdef _WIN32
+            std::ifstream stream(GB_Utf8ToWString(pathUtf8).c_str(), std::ios::binary);
+            if (!stream)
+            {
+                return false;
+            }
+
+            content.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+            if (stream.bad() || content.empty())
+            {
+                return false;
+            }
+
+            data = content.data();
+            size = content.size();
+            return true;
+#else
+            const int fd = open(pathUtf8.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                return false;
+            }
+
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size <= 0)
+            {
+                close(fd);
+                return false;
+            }
+
+            void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (mapped == MAP_FAILED)
+            {
+                return false;
+            }
+
+            data = static_cast<const unsigned char*>(mapped);
+            size = static_cast<size_t>(st.st_size);
+            return true;
+#endif
+        }
+
+        // 校验文件头与各区段边界；不访问条目内容。
+        bool ValidateHeader()
+        {
+            if (data == nullptr || size < kMetadataHeaderSize)
+            {
+                return false;
+            }
+            if (std::memcmp(data, kMetadataFileMagic, sizeof(kMetadataFileMagic)) != 0)
+            {
+                return false;
+            }
+            if (LoadUInt32LE(data + 8) != kMetadataFileVersion)
+            {
+                return false;
+            }
+
+            entryCount = LoadUInt32LE(data + 12);
+            signature.pathHash = LoadUInt64LE(data + 16);
+            signature.fileSize = LoadUInt64LE(data + 24);
+            signature.modifiedTime = LoadUInt64LE(data + 32);
+            signature.projVersion = LoadUInt32LE(data + 40);
+
+            const std::uint64_t blobOffset = LoadUInt32LE(data + 44);
+            blobSize = LoadUInt32LE(data + 48);
+
+            const std::uint64_t entriesEnd = kMetadataHeaderSize + static_cast<std::uint64_t>(entryCount) * kMetadataEntrySize;
+            if (entriesEnd > blobOffset || blobOffset + blobSize > size)
+            {
+                return false;
+            }
+
+            entries = data + kMetadataHeaderSize;
+            blob = data + blobOffset;
+            return true;
+        }
+
+        bool TryFind(const std::string& trimmedWktUtf8, GeoCrsManager::CrsMetadata& outMetadata) const
+        {
+            const unsigned char* entry = FindEntry(trimmedWktUtf8);
+            if (entry == nullptr)
+            {
+                return false;
+            }
+
+            GeoCrsManager::CrsMetadata metadata;
+            if (!ReadString(entry + 16, metadata.uidUtf8) ||
+                !ReadString(entry + 24, metadata.canonicalWktUtf8) ||
+                !ReadString(entry + 32, metadata.lonLatArea.wktUtf8) ||
+                !ReadString(entry + 40, metadata.selfArea.wktUtf8))
+            {
+                return false;
+            }
+
+            metadata.epsgCode = static_cast<int>(LoadUInt32LE(entry + 48));
+            metadata.isValid = (LoadUInt32LE(entry + 52) & kMetadataFlagValid) != 0;
+            metadata.lonLatArea.rect = GB_Rectangle(LoadDoubleLE(entry + 56), LoadDoubleLE(entry + 64), LoadDoubleLE(entry + 72), LoadDoubleLE(entry + 80));
+            metadata.selfArea.rect = GB_Rectangle(LoadDoubleLE(entry + 88), LoadDoubleLE(entry + 96), LoadDoubleLE(entry + 104), LoadDoubleLE(entry + 112));
+
+            outMetadata = std::move(metadata);
+            return true;
+        }
+
+        // 只读取有效性标志，不复制条目中的字符串。
+        bool TryFindIsValid(const std::string& trimmedWktUtf8, bool& outIsValid) const
+        {
+            const unsigned char* entry = FindEntry(trimmedWktUtf8);
+            if (entry == nullptr)
+            {
+                return false;
+            }
+
+            outIsValid = (LoadUInt32LE(entry + 52) & kMetadataFlagValid) != 0;
+            return true;
+        }
+
+        // 逐条读出（仅在保存合并时使用）。
+        bool ReadEntry(size_t index, std::string& outKey, GeoCrsManager::CrsMetadata& outMetadata) const
+        {
+            const unsigned char* entry = GetEntry(index);
+            return ReadString(entry + 8, outKey) && TryFind(outKey, outMetadata);
+        }
+
+        ProjDbSignature signature;
+        std::uint32_t entryCount = 0;
+
+    private:
+        const unsigned char* FindEntry(const std::string& trimmedWktUtf8) const
+        {
+            const std::uint64_t keyHash = HashWktKey(trimmedWktUtf8);
+
+            // 找到第一个 hash >= keyHash 的条目，再向后逐个比较（hash 冲突时会有多个相同 hash 的条目）。
+            size_t low = 0;
+            size_t high = entryCount;
+            while (low < high)
+            {
+                const size_t mid = low + (high - low) / 2;
+                if (LoadUInt64LE(GetEntry(mid)) < keyHash)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+
+            for (size_t i = low; i < entryCount; i++)
+            {
+                const unsigned char* entry = GetEntry(i);
+                if (LoadUInt64LE(entry) != keyHash)
+                {
+                    break;
+                }
+
+                const char* keyData = nullptr;
+                size_t keyLength = 0;
+                if (!TryGetString(entry + 8, keyData, keyLength))
+                {
+                    return nullptr;
+                }
+                if (keyLength == trimmedWktUtf8.size() && std::memcmp(keyData, trimmedWktUtf8.data(), keyLength) == 0)
+                {
+                    return entry;
+                }
+            }
+
+            return nullptr;
+        }
+
+        const unsigned char* GetEntry(size_t index) const
+        {
+            return entries + index * kMetadataEntrySize;
+        }
+
+        bool TryGetString(const unsigned char* reference, const char*& outData, size_t& outLength) const
+        {
+            const std::uint64_t offset = LoadUInt32LE(reference);
+            const std::uint64_t length = LoadUInt32LE(reference + 4);
+            if (offset + length > blobSize)
+            {
+                return false;
+            }
+
+            outData = reinterpret_cast<const char*>(blob + offset);
+            outLength = static_cast<size_t>(length);
+            return true;
+        }
+
+        bool ReadString(const unsigned char* reference, std::string& outString) const
+        {
+            const char* stringData = nullptr;
+            size_t length = 0;
+            if (!TryGetString(reference, stringData, length))
+            {
+                return false;
+            }
+            outString.assign(stringData, length);
+            return true;
+        }
+
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        const unsigned char* entries = nullptr;
+        const unsigned char* blob = nullptr;
+        std::uint32_t blobSize = 0;
+
+#ifdef _WIN32
+        std::vector<unsigned char> content;
+#endif
+    };
+
+    std::shared_ptr<const MappedMetadataFile> MapMetadataFile(const std::string& pathUtf8)
+    {
+        std::shared_ptr<MappedMetadataFile> file = std::make_shared<MappedMetadataFile>();
+        if (!file->Map(pathUtf8) || !file->ValidateHeader())
+        {
+            return nullptr;
+        }
+        return file;
+    }
+
+    // 字符串区写入器：相同字符串只写一次。
+    class MetadataStringBlobWriter
+    {
+    public:
+        void Append(GB_ByteBuffer& entryBuffer, const std::string& text)
+        {
+            std::uint32_t offset = 0;
+            const auto it = offsets.find(text);
+            if (it != offsets.end())
+            {
+                offset = it->second;
+            }
+            else
+            {
+                offset = static_cast<std::uint32_t>(blob.size());
+                blob.insert(blob.end(), text.begin(), text.end());
+                offsets.emplace(text, offset);
+            }
+
+            GB_ByteBufferIO::AppendUInt32LE(entryBuffer, offset);
+            GB_ByteBufferIO::AppendUInt32LE(entryBuffer, static_cast<std::uint32_t>(text.size()));
+        }
+
+        GB_ByteBuffer blob;
+
+    private:
+        std::unordered_map<std::string, std::uint32_t> offsets;
+    };
+
+    // 同目录下的临时文件名：带进程 id 与随机数，多个进程/线程同时写同一文件时互不覆盖对方的临时文件。
+    std::string MakeUniqueTempPathUtf8(const std::string& pathUtf8)
+    {
+        static std::mutex randomMutex;
+        static std::mt19937_64 random(static_cast<std::uint64_t>(std::random_device()()) ^
+            static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+        std::uint64_t randomValue = 0;
+        {
+            std::lock_guard<std::mutex> lock(randomMutex);
+            randomValue = random();
+        }
+
+#ifdef _WIN32
+        const unsigned long processId = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+        const unsigned long processId = static_cast<unsigned long>(getpid());
+#endif
+
+        std::ostringstream stream;
+        stream << pathUtf8 << "." << processId << "." << std::hex << randomValue << ".tmp";
+        return stream.str();
+    }
+
+    void RemoveFileUtf8(const std::string& pathUtf8)
+    {
+#ifdef _WIN32
+        DeleteFileW(GB_Utf8ToWString(pathUtf8).c_str());
+#else
+        std::remove(pathUtf8.c_str());
+#endif
+    }
+
+    bool WriteFileAtomicallyUtf8(const std::string& pathUtf8, const GB_ByteBuffer& content)
+    {
+        const std::string tempPathUtf8 = MakeUniqueTempPathUtf8(pathUtf8);
+
+#ifdef _WIN32
+        const std::wstring tempPath = GB_Utf8ToWString(tempPathUtf8);
+        std::ofstream stream(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+#else
+        std::ofstream stream(tempPathUtf8.c_str(), std::ios::binary | std::ios::trunc);
+#endif
+        if (!stream)
+        {
+            return false;
+        }
+
+        stream.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+        stream.close();
+        if (!stream)
+        {
+            RemoveFileUtf8(tempPathUtf8);
+            return false;
+        }
+
+        // 先写临时文件再替换：其它进程要么看到旧文件，要么看到完整的新文件。
+#ifdef _WIN32
+        const bool replaced = MoveFileExW(tempPath.c_str(), GB_Utf8ToWString(pathUtf8).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        const bool replaced = std::rename(tempPathUtf8.c_str(), pathUtf8.c_str()) == 0;
+#endif
+        if (!replaced)
+        {
+            RemoveFileUtf8(tempPathUtf8);
+        }
+        return replaced;
+    }
+
+    bool WriteMetadataFile(const std::string& pathUtf8, const ProjDbSignature& signature, const std::map<std::string, GeoCrsManager::CrsMetadata>& metadataByKey)
+    {
+        std::vector<std::pair<std::uint64_t, const std::pair<const std::string, GeoCrsManager::CrsMetadata>*>> sorted;
+        sorted.reserve(metadataByKey.size());
+        for (const auto& item : metadataByKey)
+        {
+            sorted.emplace_back(HashWktKey(item.first), &item);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+
+        GB_ByteBuffer entryBuffer;
+        entryBuffer.reserve(sorted.size() * kMetadataEntrySize);
+        MetadataStringBlobWriter blobWriter;
+        for (const auto& item : sorted)
+        {
+            const std::string& key = item.second->first;
+            const GeoCrsManager::CrsMetadata& metadata = item.second->second;
+
+            AppendUInt64LE(entryBuffer, item.first);
+            blobWriter.Append(entryBuffer, key);
+            blobWriter.Append(entryBuffer, metadata.uidUtf8);
+            blobWriter.Append(entryBuffer, metadata.canonicalWktUtf8);
+            blobWriter.Append(entryBuffer, metadata.lonLatArea.wktUtf8);
+            blobWriter.Append(entryBuffer, metadata.selfArea.wktUtf8);
+            GB_ByteBufferIO::AppendUInt32LE(entryBuffer, static_cast<std::uint32_t>(metadata.epsgCode));
+            GB_ByteBufferIO::AppendUInt32LE(entryBuffer, metadata.isValid ? kMetadataFlagValid : 0u);
+            AppendRectangleLE(entryBuffer, metadata.lonLatArea.rect);
+            AppendRectangleLE(entryBuffer, metadata.selfArea.rect);
+        }
+
+        const std::uint64_t blobOffset = kMetadataHeaderSize + entryBuffer.size();
+        if (blobOffset + blobWriter.blob.size() > std::numeric_limits<std::uint32_t>::max())
+        {
+            GBLOG_WARNING(GB_STR("【GeoCrsManager::SavePersistentCache】缓存文件超过 4GB，放弃写入。"));
+            return false;
+        }
+
+        GB_ByteBuffer content;
+        content.reserve(static_cast<size_t>(blobOffset) + blobWriter.blob.size());
+        content.insert(content.end(), kMetadataFileMagic, kMetadataFileMagic + sizeof(kMetadataFileMagic));
+        GB_ByteBufferIO::AppendUInt32LE(content, kMetadataFileVersion);
+        GB_ByteBufferIO::AppendUInt32LE(content, static_cast<std::uint32_t>(sorted.size()));
+        AppendUInt64LE(content, signature.pathHash);
+        AppendUInt64LE(content, signature.fileSize);
+        AppendUInt64LE(content, signature.modifiedTime);
+        GB_ByteBufferIO::AppendUInt32LE(content, signature.projVersion);
+        GB_ByteBufferIO::AppendUInt32LE(content, static_cast<std::uint32_t>(blobOffset));
+        GB_ByteBufferIO::AppendUInt32LE(content, static_cast<std::uint32_t>(blobWriter.blob.size()));
+        for (int i = 0; i < 3; i++)
+        {
+            GB_ByteBufferIO::AppendUInt32LE(content, 0);
+        }
+        content.insert(content.end(), entryBuffer.begin(), entryBuffer.end());
+        content.insert(content.end(), blobWriter.blob.begin(), blobWriter.blob.end());
+
+        return WriteFileAtomicallyUtf8(pathUtf8, content);
+    }
+
+    // 持久化缓存的状态。g_persistentFile 只在签名与当前 proj.db 一致时才非空。
+    GB_ReadWriteLock g_persistentLock;
+    std::string g_persistentPathUtf8 = "";
+    std::shared_ptr<const MappedMetadataFile> g_persistentFile;
+    std::atomic_bool g_persistentEnabled(false);
+
+    std::shared_ptr<const MappedMetadataFile> GetPersistentFile()
+    {
+        GB_ReadLockGuard guard(g_persistentLock);
+        return g_persistentFile;
+    }
+
+    // 按当前 proj.db 重新映射缓存文件；文件不存在、格式不符或 proj.db 已变化时，以空缓存继续。
+    void ReloadPersistentFileInternal(const std::string& projDbDirUtf8)
+    {
+        GB_WriteLockGuard guard(g_persistentLock);
+        g_persistentFile.reset();
+        if (g_persistentPathUtf8.empty())
+        {
+            return;
+        }
+
+        ProjDbSignature signature;
+        if (!TryGetProjDbSignature(projDbDirUtf8, signature))
+        {
+            GBLOG_WARNING(GB_STR("【GeoCrsManager】无法确定 proj.db 状态，不加载持久化缓存。"));
+            return;
+        }
+
+        if (!GB_IsFileExists(g_persistentPathUtf8))
+        {
+            return;
+        }
+
+        std::shared_ptr<const MappedMetadataFile> file = MapMetadataFile(g_persistentPathUtf8);
+        if (!file)
+        {
+            GBLOG_WARNING(GB_STR("【GeoCrsManager】持久化缓存文件无效，已忽略: ") + g_persistentPathUtf8);
+            return;
+        }
+
+        if (!(file->signature == signature))
+        {
+            GBLOG_INFO(GB_STR("【GeoCrsManager】proj.db 已变化，持久化缓存失效: ") + g_persistentPathUtf8);
+            return;
+        }
+
+        g_persistentFile = file;
+    }
+
+    // 初始化时调用：若尚未显式启用持久化缓存，则读取配置项指定的文件路径。
+    void LoadPersistentFileAtInitInternal(const std::string& projDbDirUtf8)
+    {
+        {
+            GB_WriteLockGuard guard(g_persistentLock);
+            if (g_persistentPathUtf8.empty())
+            {
+                const char* configuredPath = CPLGetConfigOption(kMetadataCacheConfigOption, nullptr);
+                if (configuredPath != nullptr)
+                {
+                    g_persistentPathUtf8 = GB_Utf8Trim(configuredPath);
+                }
+            }
+            if (g_persistentPathUtf8.empty())
+            {
+                return;
+            }
+        }
+
+        ReloadPersistentFileInternal(projDbDirUtf8);
+        g_persistentEnabled.store(true, std::memory_order_release);
+    }
+
+    // -------------------- 工具函数 --------------------
+
+    bool IsWindowsDriveRootUtf8(const std::string& dirPathUtf8)
+    {
+        return dirPathUtf8.size() == 3 &&
+            std::isalpha(static_cast<unsigned char>(dirPathUtf8[0])) &&
+            dirPathUtf8[1] == ':' &&
+            dirPathUtf8[2] == '/';
+    }
+
+    bool IsUncShareRootUtf8(const std::string& dirPathUtf8)
+    {
+        if (dirPathUtf8.rfind("//", 0) != 0)
+        {
+            return false;
+        }
+
+        // 形如：//server/share/   —— 认为是 UNC share 根目录，不允许再向上
+        const size_t firstSlash = dirPathUtf8.find('/', 2);
+        if (firstSlash == std::string::npos)
+        {
+            return true;
+        }
+
+        const size_t secondSlash = dirPathUtf8.find('/', firstSlash + 1);
+        if (secondSlash == std::string::npos)
+        {
+            return true;
+        }
+
+        const size_t thirdSlash = dirPathUtf8.find('/', secondSlash + 1);
+        return thirdSlash == std::string::npos;
+    }
+
+    bool IsRootedPathUtf8(const std::string& pathUtf8)
+    {
+        if (pathUtf8.empty())
+        {
+            return false;
+        }
+
+        // POSIX: 以 '/' 开头；UNC: 以 '//' 开头；两者都属于“有根路径”
+        if (pathUtf8[0] == '/')
+        {
+            return true;
+        }
+
+        // Windows: 盘符 "C:/" / "D:/" ...
+        // 注意："C:foo" 属于“驱动器相对路径”（相对于该驱动器的当前工作目录），这里不视为 rooted。
+        if (pathUtf8.size() >= 3 &&
+            std::isalpha(static_cast<unsigned char>(pathUtf8[0])) &&
+            pathUtf8[1] == ':' &&
+            (pathUtf8[2] == '/' || pathUtf8[2] == '\\'))
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    std::string NormalizeDirPathUtf8(const std::string& inputPathUtf8)
+    {
+        if (inputPathUtf8.empty())
+        {
+            return "";
+        }
+
+        // 使用 GB_JoinPath 做统一分隔符、消解 "."/".." 等 lexical 规范化，并强制视为“目录”路径。
+        // 右侧传入 "." 可确保返回结果末尾带 "/"（即使该目录并不存在）。
+        std::string normalized = GB_JoinPath(inputPathUtf8, ".");
+        if (!normalized.empty() && normalized.back() != '/')
+        {
+            normalized.push_back('/');
+        }
+
+        return normalized;
+    }
+
+    std::string GetParentDirectoryUtf8(const std::string& dirPathUtf8)
+    {
+        const std::string currentDir = NormalizeDirPathUtf8(dirPathUtf8);
+        if (currentDir.empty())
+        {
+            return "";
+        }
+
+        // 对于相对路径，保持“无法继续向上”的语义，避免出现 "./" -> "../" 的漂移。
+        if (!IsRootedPathUtf8(currentDir))
+        {
+            return "";
+        }
+
+        // 根目录："/" or "C:/" or "//server/share/"
+        if (currentDir == "/" || IsWindowsDriveRootUtf8(currentDir) || IsUncShareRootUtf8(currentDir))
+        {
+            return "";
+        }
+
+        const std::string parentDir = NormalizeDirPathUtf8(GB_JoinPath(currentDir, ".."));
+        if (parentDir.empty() || parentDir == currentDir)
+        {
+            return "";
+        }
+
+        return parentDir;
+    }
+
+    bool EndsWithIgnoreCaseAscii(const std::string& text, const std::string& suffix)
+    {
+        if (suffix.size() > text.size())
+        {
+            return false;
+        }
+
+        const size_t offset = text.size() - suffix.size();
+        for (size_t i = 0; i < suffix.size(); i++)
+        {
+            const unsigned char a = static_cast<unsigned char>(text[offset + i]);
+            const unsigned char b = static_cast<unsigned char>(suffix[i]);
+            if (std::tolower(a) != std::tolower(b))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string GetCurrentWorkingDirectoryUtf8()
+    {
+#ifdef _WIN32
+        DWORD requiredChars = GetCurrentDirectoryW(0, nullptr);
+        if (requiredChars == 0)
+        {
+            return "";
+        }
+
+        std::wstring buffer;
+        buffer.resize(static_cast<size_t>(requiredChars));
+        const DWORD written = GetCurrentDirectoryW(requiredChars, &buffer[0]);
+        if (written == 0)
+        {
+            return "";
+        }
+
+        // written 不包含 '\0'，但 buffer 可能包含
+        buffer.resize(static_cast<size_t>(written));
+        std::string cwdUtf8 = GB_WStringToUtf8(buffer);
+        cwdUtf8 = NormalizeDirPathUtf8(cwdUtf8);
+        return cwdUtf8;
+#else
+        char buffer[PATH_MAX + 1];
+        if (getcwd(buffer, sizeof(buffer)) == nullptr)
+        {
+            return "";
+        }
+
+        std::string cwdUtf8(buffer);
+        cwdUtf8 = NormalizeDirPathUtf8(cwdUtf8);
+        return cwdUtf8;
+#endif
+    }
+
+    std::string FindProjDatabaseDirByExistingProjPaths()
+    {
+        char** paths = OSRGetPROJSearchPaths();
+        if (paths == nullptr)
+        {
+            return "";
+        }
+
+        std::string found;
+        for (int i = 0; paths[i] != nullptr; i++)
+        {
+            const std::string dir = NormalizeDirPathUtf8(paths[i]);
+            if (dir.empty())
+            {
+                continue;
+            }
+
+            const std::string projDbPath = GB_JoinPath(dir, "proj.db");
+            if (GB_IsFileExists(projDbPath))
+            {
+                found = dir;
+                break;
+            }
+        }
+
+        CSLDestroy(paths);
+        return found;
+    }
+
+    struct ProjDbSearchNode
+    {
+        std::string dirUtf8;
+        int depth = 0;
+    };
+
+    // 有界深度/数量的“兜底”搜索：用于覆盖少数非典型目录布局，但避免递归扫描整个磁盘导致启动抖动。
+    std::string LimitedSearchProjDbUnderDirUtf8(const std::string& startDirUtf8, int maxDepth, size_t maxVisitedDirs)
+    {
+        const std::string rootDir = NormalizeDirPathUtf8(startDirUtf8);
+        if (rootDir.empty())
+        {
+            return "";
+        }
+
+        std::deque<ProjDbSearchNode> queue;
+        queue.push_back({ rootDir, 0 });
+
+        size_t visitedDirs = 0;
+
+        while (!queue.empty() && visitedDirs < maxVisitedDirs)
+        {
+            ProjDbSearchNode node = std::move(queue.front());
+            queue.pop_front();
+            ++visitedDirs;
+
+            const std::string projDbPath = GB_JoinPath(node.dirUtf8, "proj.db");
+            if (GB_IsFileExists(projDbPath))
+            {
+                return NormalizeDirPathUtf8(node.dirUtf8);
+            }
+
+            if (node.depth >= maxDepth)
+            {
+                continue;
+            }
+
+#ifdef _WIN32
+            std::wstring pattern = GB_Utf8ToWString(node.dirUtf8);
+            if (pattern.empty())
+            {
+                continue;
+            }
+
+            // Win32 枚举 API 对 '/' 通常也能工作，但为避免边缘场景（以及与 reparse point 有关的路径解析差异），
+            // 这里统一改为 "\\"。
+            for (wchar_t& ch : pattern)
+            {
+                if (ch == L'/')
+                {
+                    ch = L'\\';
+                }
+            }
+
+            if (pattern.back() != L'\\')
+            {
+                pattern.push_back(L'\\');
+            }
+            pattern += L"*";
+
+            WIN32_FIND_DATAW findData;
+            HANDLE findHandle = FindFirstFileW(pattern.c_str(), &findData);
+            if (findHandle == INVALID_HANDLE_VALUE)
+            {
+                continue;
+            }
+
+            do
+            {
+                const std::wstring entryNameW = findData.cFileName;
+                if (entryNameW == L"." || entryNameW == L"..")
+                {
+                    continue;
+                }
+
+                if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+                {
+                    continue;
+                }
+
+                // 跳过重解析点（符号链接/目录联接等），避免出现循环或跨盘扫描。
+                if ((findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+                {
+                    continue;
+                }
+
+                const std::string entryNameUtf8 = GB_WStringToUtf8(entryNameW);
+                if (entryNameUtf8.empty())
+                {
+                    continue;
+                }
+
+                const std::string childDir = NormalizeDirPathUtf8(GB_JoinPath(node.dirUtf8, entryNameUtf8 + "/"));
+                if (!childDir.empty())
+                {
+                    if (visitedDirs + queue.size() >= maxVisitedDirs)
+                    {
+                        break;
+                    }
+                    queue.push_back({ childDir, node.depth + 1 });
+                }
+            } while (FindNextFileW(findHandle, &findData));
+
+            FindClose(findHandle);
+#else
+            DIR* dir = opendir(node.dirUtf8.c_str());
+            if (dir == nullptr)
+            {
+                continue;
+            }
+
+            while (true)
+            {
+                dirent* entry = readdir(dir);
+                if (entry == nullptr)
+                {
+                    break;
+                }
+
+                const std::string entryName = entry->d_name ? entry->d_name : "";
+                if (entryName.empty() || entryName == "." || entryName == "..")
+                {
+                    continue;
+                }
+
+                const std::string childPath = GB_JoinPath(node.dirUtf8, entryName);
+
+                struct stat st;
+                if (lstat(childPath.c_str(), &st) != 0)
+                {
+                    continue;
+                }
+
+                // 跳过符号链接，避免循环与意外跨目录树。
+                if (S_ISLNK(st.st_mode))
+                {
+                    continue;
+                }
+
+                if (!S_ISDIR(st.st_mode))
+                {
+                    continue;
+                }
+
+                const std::string childDir = NormalizeDirPathUtf8(childPath);
+                if (!childDir.empty())
+                {
+                    if (visitedDirs + queue.size() >= maxVisitedDirs)
+                    {
+                        break;
+                    }
+                    queue.push_back({ childDir, node.depth + 1 });
+                }
+            }
+
+            closedir(dir);
+#endif
+        }
+
+        return "";
+    }
+
+    std::string FindProjDatabaseDirBySearching(const std::string& startDirUtf8)
+    {
+        std::string currentDir = NormalizeDirPathUtf8(startDirUtf8);
+        if (currentDir.empty())
+        {
+            return "";
+        }
+
+        // 只做“轻量探测”：在每一级目录中尝试若干常见的 PROJ 资源布局，而不是递归扫描整个子树。
+        // 典型布局示例：
+        //  - <dir>/proj.db
+        //  - <dir>/share/proj/proj.db
+        //  - <dir>/proj/proj.db
+        //  - <dir>/Library/share/proj/proj.db   (Windows/Conda 常见)
+        while (!currentDir.empty())
+        {
+            const std::string candidates[] =
+            {
+                currentDir,
+                NormalizeDirPathUtf8(GB_JoinPath(currentDir, "share/proj/")),
+                NormalizeDirPathUtf8(GB_JoinPath(currentDir, "proj/")),
+                NormalizeDirPathUtf8(GB_JoinPath(currentDir, "Library/share/proj/"))
+            };
+
+            for (const std::string& candidateDir : candidates)
+            {
+                if (candidateDir.empty())
+                {
+                    continue;
+                }
+
+                const std::string projDbPath = GB_JoinPath(candidateDir, "proj.db");
+                if (GB_IsFileExists(projDbPath))
+                {
+                    return NormalizeDirPathUtf8(candidateDir);
+                }
+            }
+
+            const std::string parent = GetParentDirectoryUtf8(currentDir);
+            if (parent.empty() || parent == currentDir)
+            {
+                break;
+            }
+
+            currentDir = parent;
+        }
+
+        // 兜底：在 startDir 下做一次有界深度搜索，覆盖少数“非典型安装布局”。
+        return LimitedSearchProjDbUnderDirUtf8(startDirUtf8, 5, 5000);
+    }
+
+    bool ApplyProjDatabaseDirectoryUtf8Internal(const std::string& projDatabaseDirUtf8)
+    {
+        const std::string dir = NormalizeDirPathUtf8(projDatabaseDirUtf8);
+        if (dir.empty())
+        {
+            return false;
+        }
+
+        const std::string projDbPath = GB_JoinPath(dir, "proj.db");
+        if (!GB_IsFileExists(projDbPath))
+        {
+            return false;
+        }
+
+        // 兼容：PROJ_DATA 是新变量名，但很多环境仍依赖 PROJ_LIB（PROJ >= 9.1 引入 PROJ_DATA，PROJ_LIB 作为兼容回退）。
+        CPLSetConfigOption("PROJ_LIB", dir.c_str());
+        CPLSetConfigOption("PROJ_DATA", dir.c_str());
+
+        const char* const paths[] = { dir.c_str(), nullptr };
+        OSRSetPROJSearchPaths(paths);
+
+        return true;
+    }
+
+    void ClearCachesInternal()
+    {
+        g_epsgCache.Clear();
+        g_wktCache.Clear();
+        g_wktValidityCache.Clear();
+        g_definitionCache.Clear();
+        g_validAreaCache.Clear();
+        g_metadataCache.Clear();
+        g_frozenEpsgCache.Clear();
+        g_frozenWktCache.Clear();
+        g_footprintCache.Clear();
+        g_canonicalCrsRegistry.Clear();
+        g_canonicalValidAreaCache.Clear();
+        g_canonicalFrozenCache.Clear();
+        g_canonicalFootprintCache.Clear();
+    }
+
+    // -------------------- 缓存内存预算 --------------------
+
+    // 总预算（字节，0 表示不限制）按固定比例分给全部可淘汰的缓存（合计 100%）。
+    // 持有 GeoCrs 的缓存（WKT、用户定义、EPSG、快照）单条最大；按 UID 合并的登记表只保存弱引用，不参与预算。
+    constexpr const char* kCacheBudgetConfigOption = "MAPWEAVER_CRS_CACHE_BUDGET_MB";
+    constexpr size_t kEpsgCacheBudgetPercent = 8;
+    constexpr size_t kWktCacheBudgetPercent = 20;
+    constexpr size_t kWktValidityCacheBudgetPercent = 4;
+    constexpr size_t kDefinitionCacheBudgetPercent = 14;
+    constexpr size_t kValidAreaCacheBudgetPercent = 6;
+    constexpr size_t kMetadataCacheBudgetPercent = 10;
+    constexpr size_t kFrozenEpsgCacheBudgetPercent = 4;
+    constexpr size_t kFrozenWktCacheBudgetPercent = 6;
+    constexpr size_t kFootprintCacheBudgetPercent = 6;
+    constexpr size_t kInternWktCacheBudgetPercent = 4;
+    constexpr size_t kCanonicalValidAreaCacheBudgetPercent = 4;
+    constexpr size_t kCanonicalFrozenCacheBudgetPercent = 6;
+    constexpr size_t kCanonicalFootprintCacheBudgetPercent = 8;
+
+    std::atomic<size_t> g_cacheMemoryBudget(0);
+
+    size_t GetBudgetShare(size_t totalBytes, size_t percent)
+    {
+        return totalBytes / 100 * percent + totalBytes % 100 * percent / 100;
+    }
+
+    void ApplyCacheMemoryBudgetInternal(size_t totalBytes)
+    {
+        g_cacheMemoryBudget.store(totalBytes, std::memory_order_relaxed);
+        g_epsgCache.SetByteBudget(GetBudgetShare(totalBytes, kEpsgCacheBudgetPercent));
+        g_wktCache.SetByteBudget(GetBudgetShare(totalBytes, kWktCacheBudgetPercent));
+        g_wktValidityCache.SetByteBudget(GetBudgetShare(totalBytes, kWktValidityCacheBudgetPercent));
+        g_definitionCache.SetByteBudget(GetBudgetShare(totalBytes, kDefinitionCacheBudgetPercent));
+        g_validAreaCache.SetByteBudget(GetBudgetShare(totalBytes, kValidAreaCacheBudgetPercent));
+        g_metadataCache.SetByteBudget(GetBudgetShare(totalBytes, kMetadataCacheBudgetPercent));
+        g_frozenEpsgCache.SetByteBudget(GetBudgetShare(totalBytes, kFrozenEpsgCacheBudgetPercent));
+        g_frozenWktCache.SetByteBudget(GetBudgetShare(totalBytes, kFrozenWktCacheBudgetPercent));
+        g_footprintCache.SetByteBudget(GetBudgetShare(totalBytes, kFootprintCacheBudgetPercent));
+        g_internWktCache.SetByteBudget(GetBudgetShare(totalBytes, kInternWktCacheBudgetPercent));
+        g_canonicalValidAreaCache.SetByteBudget(GetBudgetShare(totalBytes, kCanonicalValidAreaCacheBudgetPercent));
+        g_canonicalFrozenCache.SetByteBudget(GetBudgetShare(totalBytes, kCanonicalFrozenCacheBudgetPercent));
+        g_canonicalFootprintCache.SetByteBudget(GetBudgetShare(totalBytes, kCanonicalFootprintCacheBudgetPercent));
+    }
+
+    void AddMemoryGauge(GeoCrsManager::CacheMemoryGauge& total, const GeoCrsManager::CacheMemoryGauge& gauge)
+    {
+        total.entryCount += gauge.entryCount;
+        total.approximateBytes += gauge.approximateBytes;
+        total.pinnedBytes += gauge.pinnedBytes;
+        total.budgetBytes += gauge.budgetBytes;
+        total.evictionCount += gauge.evictionCount;
+        total.localViewEntryCount += gauge.localViewEntryCount;
+        total.localViewBytes += gauge.localViewBytes;
+    }
+
+    // 自动初始化时读取配置项；已通过 SetCacheMemoryBudget() 设置过预算时不覆盖。
+    void LoadCacheMemoryBudgetAtInitInternal()
+    {
+        if (g_cacheMemoryBudget.load(std::memory_order_relaxed) != 0)
+        {
+            return;
+        }
+
+        const char* configuredValue = CPLGetConfigOption(kCacheBudgetConfigOption, nullptr);
+        if (configuredValue == nullptr)
+        {
+            return;
+        }
+
+        const std::string text = GB_Utf8Trim(configuredValue);
+        char* end = nullptr;
+        const unsigned long long megabytes = std::strtoull(text.c_str(), &end, 10);
+        if (text.empty() || end == nullptr || *end != '\0' || megabytes == 0 || megabytes > std::numeric_limits<size_t>::max() / (1024 * 1024))
+        {
+            GBLOG_WARNING(GB_STR("【GeoCrsManager::EnsureInitializedInternal】忽略无效的缓存预算配置: ") + text);
+            return;
+        }
+
+        ApplyCacheMemoryBudgetInternal(static_cast<size_t>(megabytes) * 1024 * 1024);
+    }
+
+    GeoCrsManager::CrsMetadata ComputeCrsMetadata(const std::shared_ptr<const GeoCrs>& crs)
+    {
+        GeoCrsManager::CrsMetadata metadata;
+        metadata.lonLatArea = GeoBoundingBox::Invalid;
+        metadata.selfArea = GeoBoundingBox::Invalid;
+        if (!crs || !crs->IsValid())
+        {
+            return metadata;
+        }
+
+        metadata.isValid = true;
+        metadata.uidUtf8 = crs->GetUidUtf8();
+        metadata.epsgCode = std::max(0, crs->TryGetEpsgCode(true));
+        metadata.canonicalWktUtf8 = crs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+        metadata.lonLatArea = crs->GetValidAreaLonLat();
+        metadata.selfArea = crs->GetValidArea();
+        return metadata;
+    }
+
+    // 元数据查找顺序：内存缓存 -> 持久化文件（零解析） -> 解析 WKT 并完整计算。
+    std::shared_ptr<const GeoCrsManager::CrsMetadata> GetCrsMetadataInternal(const std::string& trimmedWktUtf8)
+    {
+        return g_metadataCache.GetOrCompute(trimmedWktUtf8, [&trimmedWktUtf8]() -> std::shared_ptr<const GeoCrsManager::CrsMetadata> {
+            const std::shared_ptr<const MappedMetadataFile> file = GetPersistentFile();
+            GeoCrsManager::CrsMetadata metadata;
+            if (file && file->TryFind(trimmedWktUtf8, metadata))
+            {
+                return std::make_shared<GeoCrsManager::CrsMetadata>(std::move(metadata));
+            }
+
+            const std::shared_ptr<const GeoCrs> crs = GeoCrsManager::GetFromWktCached(trimmedWktUtf8);
+            return std::make_shared<GeoCrsManager::CrsMetadata>(ComputeCrsMetadata(crs));
+        });
+    }
+
+    // 把新解析出的 CRS 换成同 UID 的共享实例（若已有）。
+    // 与已有实例不相等（GeoCrs::operator==，按内容比较；改动过参数但保留权威码的 WKT 与原坐标系 UID 相同）时不合并，仍返回 crs 本身。
+    std::shared_ptr<const GeoCrs> CanonicalizeCrsInternal(const std::shared_ptr<const GeoCrs>& crs)
+    {
+        if (!crs || !crs->IsValid())
+        {
+            return crs;
+        }
+
+        const std::string uid = crs->GetUidUtf8();
+        if (uid.empty())
+        {
+            return crs;
+        }
+
+        const std::shared_ptr<const GeoCrs> canonical = g_canonicalCrsRegistry.GetOrInsert(uid, crs);
+        if (canonical == crs || !canonical || *canonical != *crs)
+        {
+            return crs;
+        }
+        return canonical;
+    }
+
+    // 由 UID 与内容哈希拼出第二级缓存 key；内容哈希无效时返回空串。
+    std::string BuildCanonicalKeyInternal(const GeoCrs& crs, const std::string& uid)
+    {
+        const GeoCrs::Uid128 contentHash = crs.GetContentHash128();
+        if (uid.empty() || !contentHash.IsValid())
+        {
+            return "";
+        }
+
+        char buffer[40] = { 0 };
+        std::snprintf(buffer, sizeof(buffer), "|%016llx%016llx", static_cast<unsigned long long>(contentHash.high), static_cast<unsigned long long>(contentHash.low));
+        return uid + buffer;
+    }
+
+    // 输入字符串（已裁剪）对应的第二级缓存 key："<UID>|<规范实例的 128 位内容哈希>"；
+    // 无效或未被合并的 CRS 返回空串，此时调用方不应使用第二级缓存。
+    // EPSG UID 只取自根 AUTHORITY，改动过内容但保留权威码的 WKT 与原坐标系 UID 相同，因此：
+    // - 只有解析结果确实是登记表中的共享实例时才返回 key；
+    // - key 中带内容哈希：登记表只保存弱引用，原坐标系被淘汰后改动过的 WKT 可能登记为同一 UID 的新实例，
+    //   而按 UID 的第二级条目仍可能留存，内容哈希保证它不会取到原坐标系的结果。
+    std::string GetCanonicalKeyInternal(const std::string& trimmedWktUtf8)
+    {
+        const std::shared_ptr<const GeoCrs> crs = GeoCrsManager::GetFromWktCached(trimmedWktUtf8);
+        if (!crs || !crs->IsValid())
+        {
+            return "";
+        }
+
+        const std::string uid = crs->GetUidUtf8();
+        if (uid.empty() || g_canonicalCrsRegistry.Find(uid) != crs)
+        {
+            return "";
+        }
+
+        return BuildCanonicalKeyInternal(*crs, uid);
+    }
+
+    int ParseEpsgCodeFromStringUtf8(const std::string& epsgCodeUtf8)
+    {
+        const std::string trimmed = GB_Utf8Trim(epsgCodeUtf8);
+        if (trimmed.empty())
+        {
+            return 0;
+        }
+
+        // 允许："EPSG:4326" / "epsg:4326" / "4326"。
+        std::string codePart = trimmed;
+        if (trimmed.size() >= 5)
+        {
+            const char e0 = static_cast<char>(std::tolower(static_cast<unsigned char>(trimmed[0])));
+            const char e1 = static_cast<char>(std::tolower(static_cast<unsigned char>(trimmed[1])));
+            const char e2 = static_cast<char>(std::tolower(static_cast<unsigned char>(trimmed[2])));
+            const char e3 = static_cast<char>(std::tolower(static_cast<unsigned char>(trimmed[3])));
+            if (e0 == 'e' && e1 == 'p' && e2 == 's' && e3 == 'g')
+            {
+                const size_t colonPos = trimmed.find(':');
+                if (colonPos != std::string::npos)
+                {
+                    codePart = GB_Utf8Trim(trimmed.substr(colonPos + 1));
+                }
+                else
+                {
+                    return 0;
+                }
+            }
+        }
+
+        if (codePart.empty())
+        {
+            return 0;
+        }
+
+        // 纯数字检查
+        for (const char ch : codePart)
+        {
+            if (ch < '0' || ch > '9')
+            {
+                return 0;
+            }
+        }
+
+        errno = 0;
+        char* endPtr = nullptr;
+        const long long value = std::strtoll(codePart.c_str(), &endPtr, 10);
+        if (endPtr == nullptr || endPtr == codePart.c_str() || *endPtr != '\0')
+        {
+            return 0;
+        }
+        if (errno == ERANGE)
+        {
+            return 0;
+        }
+        if (value <= 0 || value > static_cast<long long>(std::numeric_limits<int>::max()))
+        {
+            return 0;
+        }
+
+        return static_cast<int>(value);
+    }
+
+    // -------------------- 由 proj.db 预生成的表 --------------------
+
+    // EPSG 有效范围表与 EPSG 指纹索引共用同一种文件头（全部小端序，48 字节）：
+    //  magic(8) | version(u32) | recordCount(u32) | proj.db 路径哈希(u64) | proj.db 大小(u64) | proj.db 修改时间(u64)
+    //  | PROJ 版本(u32) | 保留(u32)
+    // 其后紧跟 recordCount 条定长记录。proj.db 签名不符的文件整体失效。
+    constexpr size_t kProjDbTableHeaderSize = 48;
+
+    void AppendProjDbTableHeader(GB_ByteBuffer& content, const char (&magic)[8], std::uint32_t version, std::uint32_t recordCount, const ProjDbSignature& signature)
+    {
+        content.insert(content.end(), magic, magic + sizeof(magic));
+        GB_ByteBufferIO::AppendUInt32LE(content, version);
+        GB_ByteBufferIO::AppendUInt32LE(content, recordCount);
+        AppendUInt64LE(content, signature.pathHash);
+        AppendUInt64LE(content, signature.fileSize);
+        AppendUInt64LE(content, signature.modifiedTime);
+        GB_ByteBufferIO::AppendUInt32LE(content, signature.projVersion);
+        GB_ByteBufferIO::AppendUInt32LE(content, 0);
+    }
+
+    bool ReadUInt64LE(const GB_ByteBuffer& buffer, size_t& offset, std::uint64_t& outValue)
+    {
+        std::uint32_t low = 0;
+        std::uint32_t high = 0;
+        if (!GB_ByteBufferIO::ReadUInt32LE(buffer, offset, low) || !GB_ByteBufferIO::ReadUInt32LE(buffer, offset, high))
+        {
+            return false;
+        }
+        outValue = static_cast<std::uint64_t>(low) | (static_cast<std::uint64_t>(high) << 32);
+        return true;
+    }
+
+    // 校验文件头；成功时 outOffset 指向第一条记录，且保证 recordCount 条记录都在 content 范围内。
+    bool ReadProjDbTableHeader(const GB_ByteBuffer& content, const char (&magic)[8], std::uint32_t expectedVersion, size_t recordSize,
+        const ProjDbSignature& expectedSignature, size_t& outOffset, std::uint32_t& outRecordCount)
+    {
+        if (content.size() < kProjDbTableHeaderSize || std::memcmp(content.data(), magic, sizeof(magic)) != 0)
+        {
+            return false;
+        }
+
+        size_t offset = sizeof(magic);
+        std::uint32_t version = 0;
+        std::uint32_t recordCount = 0;
+        ProjDbSignature signature;
+        std::uint32_t reserved = 0;
+        if (!GB_ByteBufferIO::ReadUInt32LE(content, offset, version) || version != expectedVersion ||
+            !GB_ByteBufferIO::ReadUInt32LE(content, offset, recordCount) ||
+            !ReadUInt64LE(content, offset, signature.pathHash) ||
+            !ReadUInt64LE(content, offset, signature.fileSize) ||
+            !ReadUInt64LE(content, offset, signature.modifiedTime) ||
+            !GB_ByteBufferIO::ReadUInt32LE(content, offset, signature.projVersion) ||
+            !GB_ByteBufferIO::ReadUInt32LE(content, offset, reserved))
+        {
+            return false;
+        }
+        if (!(signature == expectedSignature))
+        {
+            return false;
+        }
+        if (kProjDbTableHeaderSize + static_cast<std::uint64_t>(recordCount) * recordSize > content.size())
+        {
+            return false;
+        }
+
+        outOffset = offset;
+        outRecordCount = recordCount;
+        return true;
+    }
+
+    // -------------------- EPSG 有效范围表 --------------------
+
+    // 记录（72 字节，按 EPSG code 升序）：epsgCode(u32) | flags(u32) | lonLatRect(4 * f64) | selfRect(4 * f64)
+    // 矩形均按传统 GIS 轴序（X=经度/Easting）保存，权威轴序的交换由 GeoCrs 在查表后完成。
+    // 版本 2：没有 area of use 的条目也按实时计算记录（版本 1 把它们一律记为无效，与实时路径不一致）。
+    const char kEpsgAreaTableMagic[8] = { 'M', 'W', 'E', 'P', 'S', 'G', 'V', 'A' };
+    constexpr std::uint32_t kEpsgAreaTableVersion = 2;
+    constexpr size_t kEpsgAreaTableRecordSize = 72;
+    constexpr std::uint32_t kEpsgAreaFlagLonLat = 1u;
+    constexpr std::uint32_t kEpsgAreaFlagSelf = 2u;
+
+    const char* const kEpsgAreaTableConfigOption = "MAPWEAVER_EPSG_VALID_AREA_TABLE";
+
+    using EpsgValidAreaTable = std::unordered_map<int, GeoCrsManager::EpsgValidArea>;
+
+    GB_ReadWriteLock g_epsgAreaTableLock;
+    std::string g_epsgAreaTablePathUtf8 = "";
+    std::shared_ptr<const EpsgValidAreaTable> g_epsgAreaTable;
+
+    bool ReadFileUtf8(const std::string& pathUtf8, GB_ByteBuffer& outContent)
+    {
+#ifdef _WIN32
+        std::ifstream stream(GB_Utf8ToWString(pathUtf8).c_str(), std::ios::binary);
+#else
+        std::ifstream stream(pathUtf8.c_str(), std::ios::binary);
+#endif
+        if (!stream)
+        {
+            return false;
+        }
+
+        stream.seekg(0, std::ios::end);
+        const std::streamoff size = stream.tellg();
+        if (size <= 0)
+        {
+            return false;
+        }
+        stream.seekg(0, std::ios::beg);
+
+        outContent.resize(static_cast<size_t>(size));
+        stream.read(reinterpret_cast<char*>(outContent.data()), static_cast<std::streamsize>(size));
+        return static_cast<bool>(stream);
+    }
+
+    bool ReadRectangleLE(const GB_ByteBuffer& buffer, size_t& offset, GB_Rectangle& outRect)
+    {
+        double minX = 0;
+        double minY = 0;
+        double maxX = 0;
+        double maxY = 0;
+        if (!GB_ByteBufferIO::ReadDoubleLE(buffer, offset, minX) || !GB_ByteBufferIO::ReadDoubleLE(buffer, offset, minY) ||
+            !GB_ByteBufferIO::ReadDoubleLE(buffer, offset, maxX) || !GB_ByteBufferIO::ReadDoubleLE(buffer, offset, maxY))
+        {
+            return false;
+        }
+        outRect = GB_Rectangle(minX, minY, maxX, maxY);
+        return true;
+    }
+
+    // 读取并校验范围表；proj.db 签名不符时返回 nullptr。
+    std::shared_ptr<const EpsgValidAreaTable> LoadEpsgAreaTableFile(const std::string& pathUtf8, const ProjDbSignature& expectedSignature)
+    {
+        GB_ByteBuffer content;
+        size_t offset = 0;
+        std::uint32_t recordCount = 0;
+        if (!ReadFileUtf8(pathUtf8, content) ||
+            !ReadProjDbTableHeader(content, kEpsgAreaTableMagic, kEpsgAreaTableVersion, kEpsgAreaTableRecordSize, expectedSignature, offset, recordCount))
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<EpsgValidAreaTable> table = std::make_shared<EpsgValidAreaTable>();
+        table->reserve(recordCount);
+        for (std::uint32_t i = 0; i < recordCount; i++)
+        {
+            std::uint32_t epsgCode = 0;
+            std::uint32_t flags = 0;
+            GeoCrsManager::EpsgValidArea area;
+            if (!GB_ByteBufferIO::ReadUInt32LE(content, offset, epsgCode) ||
+                !GB_ByteBufferIO::ReadUInt32LE(content, offset, flags) ||
+                !ReadRectangleLE(content, offset, area.lonLatRect) ||
+                !ReadRectangleLE(content, offset, area.selfRect))
+            {
+                return nullptr;
+            }
+
+            area.hasLonLatArea = (flags & kEpsgAreaFlagLonLat) != 0;
+            area.hasSelfArea = (flags & kEpsgAreaFlagSelf) != 0;
+            table->emplace(static_cast<int>(epsgCode), area);
+        }
+        return table;
+    }
+
+    bool WriteEpsgAreaTableFile(const std::string& pathUtf8, const ProjDbSignature& signature, const std::vector<std::pair<int, GeoCrsManager::EpsgValidArea>>& records)
+    {
+        GB_ByteBuffer content;
+        content.reserve(kProjDbTableHeaderSize + records.size() * kEpsgAreaTableRecordSize);
+        AppendProjDbTableHeader(content, kEpsgAreaTableMagic, kEpsgAreaTableVersion, static_cast<std::uint32_t>(records.size()), signature);
+
+        for (const auto& record : records)
+        {
+            const GeoCrsManager::EpsgValidArea& area = record.second;
+            const std::uint32_t flags = (area.hasLonLatArea ? kEpsgAreaFlagLonLat : 0u) | (area.hasSelfArea ? kEpsgAreaFlagSelf : 0u);
+            GB_ByteBufferIO::AppendUInt32LE(content, static_cast<std::uint32_t>(record.first));
+            GB_ByteBufferIO::AppendUInt32LE(content, flags);
+            AppendRectangleLE(content, area.lonLatRect);
+            AppendRectangleLE(content, area.selfRect);
+        }
+
+        return WriteFileAtomicallyUtf8(pathUtf8, content);
+    }
+
+    // 按当前 proj.db 重新加载范围表；文件不存在或已失效时卸载（GeoCrs 回退为实时计算）。
+    void ReloadEpsgAreaTableInternal(const std::string& projDbDirUtf8)
+    {
+        GB_WriteLockGuard guard(g_epsgAreaTableLock);
+        g_epsgAreaTable.reset();
+        if (g_epsgAreaTablePathUtf8.empty() || !GB_IsFileExists(g_epsgAreaTablePathUtf8))
+        {
+            return;
+        }
+
+        ProjDbSignature signature;
+        if (!TryGetProjDbSignature(projDbDirUtf8, signature))
+        {
+            return;
+        }
+
+        g_epsgAreaTable = LoadEpsgAreaTableFile(g_epsgAreaTablePathUtf8, signature);
+        if (!g_epsgAreaTable)
+        {
+            GBLOG_INFO(GB_STR("【GeoCrsManager】EPSG 有效范围表无效或 proj.db 已变化，已忽略: ") + g_epsgAreaTablePathUtf8);
+        }
+    }
+
+    void LoadEpsgAreaTableAtInitInternal(const std::string& projDbDirUtf8)
+    {
+        {
+            GB_WriteLockGuard guard(g_epsgAreaTableLock);
+            if (g_epsgAreaTablePathUtf8.empty())
+            {
+                const char* configuredPath = CPLGetConfigOption(kEpsgAreaTableConfigOption, nullptr);
+                if (configuredPath != nullptr)
+                {
+                    g_epsgAreaTablePathUtf8 = GB_Utf8Trim(configuredPath);
+                }
+            }
+            if (g_epsgAreaTablePathUtf8.empty())
+            {
+                return;
+            }
+        }
+
+        ReloadEpsgAreaTableInternal(projDbDirUtf8);
+    }
+
+    // 注册给 GeoCrs 的有效范围表钩子（见 GeoCrs::SetValidAreaTableHook）。
+    bool LookupEpsgValidAreaTableHook(int epsgCode, bool selfArea, bool& outHasArea, GB_Rectangle& outRect)
+    {
+        GeoCrsManager::EpsgValidArea area;
+        if (!GeoCrsManager::TryGetTabulatedEpsgValidArea(epsgCode, area))
+        {
+            return false;
+        }
+
+        outHasArea = selfArea ? area.hasSelfArea : area.hasLonLatArea;
+        outRect = selfArea ? area.selfRect : area.lonLatRect;
+        return true;
+    }
+
+    // 枚举 proj.db 中全部 EPSG 坐标系（地理 2D/3D 与投影），包括已废弃的 code（isDeprecated=true）。
+    struct EpsgCrsCandidate
+    {
+        int epsgCode = 0;
+        bool isDeprecated = false;
+    };
+
+    std::vector<EpsgCrsCandidate> ListEpsgCrsCandidates()
+    {
+        std::vector<EpsgCrsCandidate> candidates;
+
+        int count = 0;
+        OSRCRSInfo** infos = OSRGetCRSInfoListFromDatabase("EPSG", nullptr, &count);
+        if (infos == nullptr)
+        {
+            return candidates;
+        }
+
+        candidates.reserve(static_cast<size_t>(count));
+        for (int i = 0; i < count; i++)
+        {
+            const OSRCRSInfo* info = infos[i];
+            if (info == nullptr || info->pszCode == nullptr)
+            {
+                continue;
+            }
+            if (info->eType != OSR_CRS_TYPE_GEOGRAPHIC_2D && info->eType != OSR_CRS_TYPE_GEOGRAPHIC_3D && info->eType != OSR_CRS_TYPE_PROJECTED)
+            {
+                continue;
+            }
+
+            const int epsgCode = ParseEpsgCodeFromStringUtf8(info->pszCode);
+            if (epsgCode <= 0)
+            {
+                continue;
+            }
+
+            EpsgCrsCandidate candidate;
+            candidate.epsgCode = epsgCode;
+            candidate.isDeprecated = info->bDeprecated != 0;
+            candidates.push_back(candidate);
+        }
+
+        OSRDestroyCRSInfoList(infos);
+
+        std::sort(candidates.begin(), candidates.end(), [](const EpsgCrsCandidate& a, const EpsgCrsCandidate& b) {
+            return a.epsgCode < b.epsgCode;
+        });
+        candidates.erase(std::unique(candidates.begin(), candidates.end(), [](const EpsgCrsCandidate& a, const EpsgCrsCandidate& b) {
+            return a.epsgCode == b.epsgCode;
+        }), candidates.end());
+        return candidates;
+    }
+
+    // -------------------- EPSG 指纹索引 --------------------
+
+    // 指纹：把坐标系归一化为“类型 + 椭球 + 本初子午线 + 单位 + 投影方法 + 取整后的投影参数”，
+    // 忽略名称（ESRI 风格 WKT 的名称与 EPSG 往往不同）。不同坐标系可能得到相同指纹（例如同椭球的不同基准面），
+    // 因此索引只给出候选 code，命中后必须再用 IsSame 做精确校验。
+    // 记录（12 字节，按指纹哈希升序；同一指纹内未废弃的 code 在前，其次按 code 升序）：fingerprintHash(u64) | epsgCode(u32)
+    // 查询时按记录顺序校验候选，因此同一定义同时存在废弃与现行 code 时（如 3785 与 3857）返回现行 code。
+    const char kFingerprintIndexMagic[8] = { 'M', 'W', 'E', 'P', 'S', 'G', 'F', 'P' };
+    constexpr std::uint32_t kFingerprintIndexVersion = 2;
+    constexpr size_t kFingerprintIndexRecordSize = 12;
+
+    const char* const kFingerprintIndexConfigOption = "MAPWEAVER_EPSG_FINGERPRINT_INDEX";
+
+    using EpsgFingerprintIndex = std::unordered_map<std::uint64_t, std::vector<int>>;
+
+    GB_ReadWriteLock g_fingerprintIndexLock;
+    std::string g_fingerprintIndexPathUtf8 = "";
+    std::shared_ptr<const EpsgFingerprintIndex> g_fingerprintIndex;
+
+    void AppendRoundedValue(std::string& text, double value, double step)
+    {
+        double rounded = std::round(value / step) * step;
+        if (rounded == 0.0)
+        {
+            rounded = 0.0; // 消除 -0
+        }
+
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%.9g|", rounded);
+        text += buffer;
+    }
+
+    // 返回 0 表示无法生成指纹（仅支持地理坐标系与投影坐标系）。
+    std::uint64_t ComputeSrsFingerprint(const OGRSpatialReference& srs)
+    {
+        std::string text;
+        if (srs.IsProjected() != 0)
+        {
+            text = "P|";
+        }
+        else if (srs.IsGeographic() != 0)
+        {
+            text = "G|";
+        }
+        else
+        {
+            return 0;
+        }
+
+        OGRErr err = OGRERR_NONE;
+        const double semiMajor = srs.GetSemiMajor(&err);
+        if (err != OGRERR_NONE)
+        {
+            return 0;
+        }
+        const double inverseFlattening = srs.GetInvFlattening(&err);
+        if (err != OGRERR_NONE)
+        {
+            return 0;
+        }
+
+        AppendRoundedValue(text, semiMajor, 1e-3);
+        AppendRoundedValue(text, inverseFlattening, 1e-6);
+        AppendRoundedValue(text, srs.GetPrimeMeridian(), 1e-7);
+        AppendRoundedValue(text, srs.GetAngularUnits(), 1e-12);
+
+        if (srs.IsProjected() != 0)
+        {
+            AppendRoundedValue(text, srs.GetLinearUnits(), 1e-9);
+
+            const char* method = srs.GetAttrValue("PROJECTION");
+            if (method == nullptr)
+            {
+                return 0;
+            }
+            text += GB_Utf8ToUpper(method);
+            text += "|";
+
+            // GetNormProjParm 已把角度归一化为度、长度归一化为米；未出现的参数按 0 处理。
+            static const char* const angularParameters[] =
+            {
+                SRS_PP_CENTRAL_MERIDIAN, SRS_PP_LATITUDE_OF_ORIGIN, SRS_PP_STANDARD_PARALLEL_1, SRS_PP_STANDARD_PARALLEL_2,
+                SRS_PP_LONGITUDE_OF_CENTER, SRS_PP_LATITUDE_OF_CENTER, SRS_PP_AZIMUTH, SRS_PP_RECTIFIED_GRID_ANGLE
+            };
+            static const char* const linearParameters[] = { SRS_PP_FALSE_EASTING, SRS_PP_FALSE_NORTHING };
+
+            for (const char* name : angularParameters)
+            {
+                AppendRoundedValue(text, srs.GetNormProjParm(name, 0.0), 1e-7);
+            }
+            for (const char* name : linearParameters)
+            {
+                AppendRoundedValue(text, srs.GetNormProjParm(name, 0.0), 1e-3);
+            }
+            AppendRoundedValue(text, srs.GetNormProjParm(SRS_PP_SCALE_FACTOR, 1.0), 1e-10);
+        }
+
+        const std::uint64_t hash = HashBytesFnv1a64(text.data(), text.size());
+        return hash != 0 ? hash : 1;
+    }
+
+    std::shared_ptr<const EpsgFingerprintIndex> LoadFingerprintIndexFile(const std::string& pathUtf8, const ProjDbSignature& expectedSignature)
+    {
+        GB_ByteBuffer content;
+        size_t offset = 0;
+        std::uint32_t recordCount = 0;
+        if (!ReadFileUtf8(pathUtf8, content) ||
+            !ReadProjDbTableHeader(content, kFingerprintIndexMagic, kFingerprintIndexVersion, kFingerprintIndexRecordSize, expectedSignature, offset, recordCount))
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<EpsgFingerprintIndex> index = std::make_shared<EpsgFingerprintIndex>();
+        index->reserve(recordCount);
+        for (std::uint32_t i = 0; i < recordCount; i++)
+        {
+            std::uint64_t fingerprint = 0;
+            std::uint32_t epsgCode = 0;
+            if (!ReadUInt64LE(content, offset, fingerprint) || !GB_ByteBufferIO::ReadUInt32LE(content, offset, epsgCode))
+            {
+                return nullptr;
+            }
+            (*index)[fingerprint].push_back(static_cast<int>(epsgCode));
+        }
+        return index;
+    }
+
+    struct FingerprintRecord
+    {
+        std::uint64_t fingerprint = 0;
+        bool isDeprecated = false;
+        int epsgCode = 0;
+
+        bool operator<(const FingerprintRecord& other) const
+        {
+            return std::tie(fingerprint, isDeprecated, epsgCode) < std::tie(other.fingerprint, other.isDeprecated, other.epsgCode);
+        }
+    };
+
+    bool WriteFingerprintIndexFile(const std::string& pathUtf8, const ProjDbSignature& signature, const std::vector<FingerprintRecord>& records)
+    {
+        GB_ByteBuffer content;
+        content.reserve(kProjDbTableHeaderSize + records.size() * kFingerprintIndexRecordSize);
+        AppendProjDbTableHeader(content, kFingerprintIndexMagic, kFingerprintIndexVersion, static_cast<std::uint32_t>(records.size()), signature);
+        for (const FingerprintRecord& record : records)
+        {
+            AppendUInt64LE(content, record.fingerprint);
+            GB_ByteBufferIO::AppendUInt32LE(content, static_cast<std::uint32_t>(record.epsgCode));
+        }
+        return WriteFileAtomicallyUtf8(pathUtf8, content);
+    }
+
+    // 指纹索引每次重新加载（包括切换 proj.db）时递增，线程私有的候选坐标系缓存据此失效。
+    std::atomic<std::uint64_t> g_fingerprintIndexGeneration(0);
+
+    void ReloadFingerprintIndexInternal(const std::string& projDbDirUtf8)
+    {
+        GB_WriteLockGuard guard(g_fingerprintIndexLock);
+        g_fingerprintIndex.reset();
+        g_fingerprintIndexGeneration.fetch_add(1, std::memory_order_acq_rel);
+        if (g_fingerprintIndexPathUtf8.empty() || !GB_IsFileExists(g_fingerprintIndexPathUtf8))
+        {
+            return;
+        }
+
+        ProjDbSignature signature;
+        if (!TryGetProjDbSignature(projDbDirUtf8, signature))
+        {
+            return;
+        }
+
+        g_fingerprintIndex = LoadFingerprintIndexFile(g_fingerprintIndexPathUtf8, signature);
+        if (!g_fingerprintIndex)
+        {
+            GBLOG_INFO(GB_STR("【GeoCrsManager】EPSG 指纹索引无效或 proj.db 已变化，已忽略: ") + g_fingerprintIndexPathUtf8);
+        }
+    }
+
+    void LoadFingerprintIndexAtInitInternal(const std::string& projDbDirUtf8)
+    {
+        {
+            GB_WriteLockGuard guard(g_fingerprintIndexLock);
+            if (g_fingerprintIndexPathUtf8.empty())
+            {
+                const char* configuredPath = CPLGetConfigOption(kFingerprintIndexConfigOption, nullptr);
+                if (configuredPath != nullptr)
+                {
+                    g_fingerprintIndexPathUtf8 = GB_Utf8Trim(configuredPath);
+                }
+            }
+            if (g_fingerprintIndexPathUtf8.empty())
+            {
+                return;
+            }
+        }
+
+        ReloadFingerprintIndexInternal(projDbDirUtf8);
+    }
+
+    // 校验用的候选坐标系按线程缓存：OGRSpatialReference 的 const 接口并非线程安全，不能跨线程共享同一对象。
+    // 每线程最多 kThreadLocalEpsgSrsCapacity 个，满时整体清空；指纹索引重新加载（proj.db 可能已切换）后也清空。
+    constexpr size_t kThreadLocalEpsgSrsCapacity = 64;
+
+    const OGRSpatialReference* GetThreadLocalEpsgSrs(int epsgCode)
+    {
+        struct ThreadLocalEpsgSrsCache
+        {
+            std::uint64_t generation = 0;
+            std::unordered_map<int, std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter>> srsByCode;
+        };
+        static thread_local ThreadLocalEpsgSrsCache cache;
+
+        const std::uint64_t generation = g_fingerprintIndexGeneration.load(std::memory_order_acquire);
+        std::unordered_map<int, std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter>>& srsByCode = cache.srsByCode;
+        if (cache.generation != generation || srsByCode.size() >= kThreadLocalEpsgSrsCapacity)
+        {
+            srsByCode.clear();
+            cache.generation = generation;
+        }
+
+        const auto it = srsByCode.find(epsgCode);
+        if (it != srsByCode.end())
+        {
+            return it->second.get();
+        }
+
+        std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> srs(OGRSpatialReference::FromHandle(OSRNewSpatialReference(nullptr)));
+        if (!srs || srs->importFromEPSG(epsgCode) != OGRERR_NONE)
+        {
+            srs.reset();
+        }
+
+        const OGRSpatialReference* result = srs.get();
+        srsByCode.emplace(epsgCode, std::move(srs));
+        return result;
+    }
+
+    // -------------------- 并行执行（预热 / 批量解析） --------------------
+    // 并行部分统一走 MapWeaverParallel::RunParallelItems：GDAL 为每个线程维护各自的 PROJ 上下文，
+    // 因此各线程的解析互不争用；任一条目抛出的异常在所有线程结束后传回调用线程。
+
+    // 并行预热 itemCount 个条目，逐项记录耗时。
+    template <typename WarmItem>
+    std::vector<GeoCrsManager::WarmupResult> RunWarmupItems(size_t itemCount, int threadCount, const WarmItem& warmItem)
+    {
+        std::vector<GeoCrsManager::WarmupResult> results(itemCount);
+        MapWeaverParallel::RunParallelItems(itemCount, threadCount, [&results, &warmItem](size_t index) {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            results[index].success = warmItem(index);
+            results[index].milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        });
+        return results;
+    }
+
+    // 批量获取的公共流程：去重 -> 查缓存并把未命中项登记为在途 -> 并行解析未命中项 -> 按分片一次性写入缓存。
+    // tryGetSpecial 处理不进入缓存的输入（如空 WKT），返回 true 时直接使用其结果；parse 在工作线程上调用。
+    // 未命中项在解析前已登记为在途，同时到达的 GetFromWktCached() 等单项请求会等待批量解析的结果而不是重复解析。
+    template <typename Cache, typename Key, typename TryGetSpecial, typename Parse>
+    std::vector<std::shared_ptr<const GeoCrs>> GetBatchInternal(Cache& cache, const std::vector<Key>& keys, int threadCount,
+        const TryGetSpecial& tryGetSpecial, const Parse& parse)
+    {
+        std::vector<std::shared_ptr<const GeoCrs>> results(keys.size());
+
+        std::unordered_map<Key, size_t> uniqueIndexByKey;
+        std::vector<Key> uniqueKeys;
+        std::vector<size_t> uniqueIndices(keys.size(), std::numeric_limits<size_t>::max());
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            if (tryGetSpecial(keys[i], results[i]))
+            {
+                continue;
+            }
+
+            const auto inserted = uniqueIndexByKey.emplace(keys[i], uniqueKeys.size());
+            if (inserted.second)
+            {
+                uniqueKeys.push_back(keys[i]);
+            }
+            uniqueIndices[i] = inserted.first->second;
+        }
+
+        const std::vector<std::shared_ptr<const GeoCrs>> uniqueResults = cache.GetOrComputeBatch(uniqueKeys,
+            [&uniqueKeys, threadCount, &parse](const std::vector<size_t>& missIndices, std::vector<std::shared_ptr<const GeoCrs>>& outValues) {
+                MapWeaverParallel::RunParallelItems(missIndices.size(), threadCount, [&](size_t index) {
+                    outValues[index] = parse(uniqueKeys[missIndices[index]]);
+                });
+            });
+
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            if (uniqueIndices[i] != std::numeric_limits<size_t>::max())
+            {
+                results[i] = uniqueResults[uniqueIndices[i]];
+            }
+        }
+        return results;
+    }
+
+    // 填充以 WKT 为 key 的各层缓存（解析、有效性、EPSG 识别、有效范围、足迹、快照）。
+    // 不驻留：驻留表条目永不释放，只由调用方显式驻留。
+    bool WarmupWktInternal(const std::string& wktUtf8)
+    {
+        const std::shared_ptr<const GeoCrs> crs = GeoCrsManager::GetFromWktCached(wktUtf8);
+        if (!crs || !crs->IsValid())
+        {
+            return false;
+        }
+
+        GeoBoundingBox lonLatArea;
+        GeoBoundingBox selfArea;
+        GeoCrsManager::IsWktValidCached(wktUtf8);
+        GeoCrsManager::TryGetValidAreasCached(wktUtf8, lonLatArea, selfArea);
+        GeoCrsManager::GetValidAreaFootprintCached(wktUtf8);
+        GeoCrsManager::GetFrozenFromWktCached(wktUtf8);
+        return true;
+    }
+
+    // -------------------- proj.db 位置状态文件 --------------------
+
+    // 记录“(工作目录, 程序目录) -> 找到的 proj.db 目录”，使下次启动只需检查 proj.db 是否仍存在即可跳过目录搜索。
+    // 文件为 UTF-8 文本：首行为版本标记，之后每行一条以 Tab 分隔的记录，最近使用的在前。
+    constexpr const char* kProjDbStateConfigOption = "MAPWEAVER_PROJ_DB_STATE_FILE";
+    constexpr const char* kProjDbStateFileHeader = "MWPROJDB 1";
+    constexpr size_t kProjDbStateMaxEntries = 16;
+
+    struct ProjDbStateEntry
+    {
+        std::string cwdUtf8 = "";
+        std::string exeDirUtf8 = "";
+        std::string projDbDirUtf8 = "";
+    };
+
+    bool CreateDirectoryIfMissingUtf8(const std::string& dirUtf8)
+    {
+#ifdef _WIN32
+        if (CreateDirectoryW(GB_Utf8ToWString(dirUtf8).c_str(), nullptr) != 0)
+        {
+            return true;
+        }
+        return GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+        return mkdir(dirUtf8.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+    }
+
+    // 状态文件路径：配置项 MAPWEAVER_PROJ_DB_STATE_FILE 优先（设为 NO/OFF/FALSE 时禁用），
+    // 否则为用户缓存目录（Windows：%LOCALAPPDATA%/MapWeaver；其它：$XDG_CACHE_HOME 或 ~/.cache 下的 mapweaver）。
+    std::string GetProjDbStateFilePathUtf8(bool createDirectory)
+    {
+        const char* configuredPath = CPLGetConfigOption(kProjDbStateConfigOption, nullptr);
+        if (configuredPath != nullptr)
+        {
+            const std::string trimmed = GB_Utf8Trim(configuredPath);
+            if (!trimmed.empty())
+            {
+                return CPLTestBool(trimmed.c_str()) ? trimmed : "";
+            }
+        }
+
+#ifdef _WIN32
+        const wchar_t* localAppData = _wgetenv(L"LOCALAPPDATA");
+        if (localAppData == nullptr || localAppData[0] == L'\0')
+        {
+            return "";
+        }
+        const std::string baseDir = NormalizeDirPathUtf8(GB_WStringToUtf8(localAppData));
+        const std::string stateDir = NormalizeDirPathUtf8(GB_JoinPath(baseDir, "MapWeaver"));
+#else
+        std::string baseDir;
+        const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+        if (cacheHome != nullptr && cacheHome[0] != '\0')
+        {
+            baseDir = NormalizeDirPathUtf8(cacheHome);
+        }
+        else
+        {
+            const char* home = std::getenv("HOME");
+            if (home == nullptr || home[0] == '\0')
+            {
+                return "";
+            }
+            baseDir = NormalizeDirPathUtf8(GB_JoinPath(home, ".cache"));
+        }
+        const std::string stateDir = NormalizeDirPathUtf8(GB_JoinPath(baseDir, "mapweaver"));
+#endif
+
+        if (createDirectory && (!CreateDirectoryIfMissingUtf8(baseDir) || !CreateDirectoryIfMissingUtf8(stateDir)))
+        {
+            return "";
+        }
+        return GB_JoinPath(stateDir, "proj_db_location.txt");
+    }
+
+    std::vector<ProjDbStateEntry> ReadProjDbStateFile(const std::string& pathUtf8)
+    {
+        std::vector<ProjDbStateEntry> entries;
+        GB_ByteBuffer content;
+        if (pathUtf8.empty() || !GB_IsFileExists(pathUtf8) || !ReadFileUtf8(pathUtf8, content))
+        {
+            return entries;
+        }
+
+        const std::string text(content.begin(), content.end());
+        size_t lineStart = 0;
+        bool isHeader = true;
+        while (lineStart < text.size())
+        {
+            size_t lineEnd = text.find('\n', lineStart);
+            if (lineEnd == std::string::npos)
+            {
+                lineEnd = text.size();
+            }
+            const std::string line = text.substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            if (isHeader)
+            {
+                if (line != kProjDbStateFileHeader)
+                {
+                    return entries;
+                }
+                isHeader = false;
+                continue;
+            }
+
+            const size_t firstTab = line.find('\t');
+            const size_t secondTab = (firstTab == std::string::npos) ? std::string::npos : line.find('\t', firstTab + 1);
+            if (secondTab == std::string::npos)
+            {
+                continue;
+            }
+
+            ProjDbStateEntry entry;
+            entry.cwdUtf8 = line.substr(0, firstTab);
+            entry.exeDirUtf8 = line.substr(firstTab + 1, secondTab - firstTab - 1);
+            entry.projDbDirUtf8 = line.substr(secondTab + 1);
+            entries.push_back(std::move(entry));
+        }
+        return entries;
+    }
+
+    // 命中且 proj.db 仍存在时返回记录的目录，否则返回空串。
+    std::string TryRestoreProjDbDirFromStateInternal(const std::string& cwdUtf8, const std::string& exeDirUtf8)
+    {
+        for (const ProjDbStateEntry& entry : ReadProjDbStateFile(GetProjDbStateFilePathUtf8(false)))
+        {
+            if (entry.cwdUtf8 == cwdUtf8 && entry.exeDirUtf8 == exeDirUtf8)
+            {
+                const std::string dir = NormalizeDirPathUtf8(entry.projDbDirUtf8);
+                return (!dir.empty() && GB_IsFileExists(GB_JoinPath(dir, "proj.db"))) ? dir : "";
+            }
+        }
+        return "";
+    }
+
+    void SaveProjDbDirToStateInternal(const std::string& cwdUtf8, const std::string& exeDirUtf8, const std::string& projDbDirUtf8)
+    {
+        const auto isStorable = [](const std::string& text) {
+            return text.find_first_of("\t\r\n") == std::string::npos;
+        };
+        if (projDbDirUtf8.empty() || !isStorable(cwdUtf8) || !isStorable(exeDirUtf8) || !isStorable(projDbDirUtf8))
+        {
+            return;
+        }
+
+        const std::string pathUtf8 = GetProjDbStateFilePathUtf8(true);
+        if (pathUtf8.empty())
+        {
+            return;
+        }
+
+        std::vector<ProjDbStateEntry> entries = ReadProjDbStateFile(pathUtf8);
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const ProjDbStateEntry& entry) {
+            return entry.cwdUtf8 == cwdUtf8 && entry.exeDirUtf8 == exeDirUtf8;
+        }), entries.end());
+
+        ProjDbStateEntry newEntry;
+        newEntry.cwdUtf8 = cwdUtf8;
+        newEntry.exeDirUtf8 = exeDirUtf8;
+        newEntry.projDbDirUtf8 = projDbDirUtf8;
+        entries.insert(entries.begin(), std::move(newEntry));
+        if (entries.size() > kProjDbStateMaxEntries)
+        {
+            entries.resize(kProjDbStateMaxEntries);
+        }
+
+        std::string text = std::string(kProjDbStateFileHeader) + "\n";
+        for (const ProjDbStateEntry& entry : entries)
+        {
+            text += entry.cwdUtf8 + "\t" + entry.exeDirUtf8 + "\t" + entry.projDbDirUtf8 + "\n";
+        }
+
+        if (!WriteFileAtomicallyUtf8(pathUtf8, GB_ByteBuffer(text.begin(), text.end())))
+        {
+            GBLOG_WARNING(GB_STR("【GeoCrsManager】写入 proj.db 位置状态文件失败: ") + pathUtf8);
+        }
+    }
+} // namespace
+
+bool GeoCrsManager::IsInitialized()
+{
+    return g_isInitialized.load(std::memory_order_acquire);
+}
+
+namespace
+{
+    // 后台初始化线程，只由 WaitForBackgroundInitialization() 显式回收。
+    // 对象有意不析构：静态析构在 Windows 上于 DLL_PROCESS_DETACH 中执行（持有加载器锁），
+    // 此时 join 线程可能死锁；未回收的线程不析构也就不会因可 join 的 std::thread 而 terminate。
+    struct BackgroundInitThread
+    {
+        std::mutex mutex;
+        MapWeaverParallel::ThreadGroup threads;
+    };
+
+    BackgroundInitThread& GetBackgroundInitThread()
+    {
+        static BackgroundInitThread* instance = new BackgroundInitThread();
+        return *instance;
+    }
 } // namespace
 
-bool GeoCrsManager::IsInitialized()
+bool GeoCrsManager::StartBackgroundInitialization()
+{
+    if (g_isInitialized.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    bool expected = false;
+    if (!g_backgroundInitStarted.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+    {
+        return false;
+    }
+
+    BackgroundInitThread& backgroundInit = GetBackgroundInitThread();
+    std::lock_guard<std::mutex> lock(backgroundInit.mutex);
+    const bool started = backgroundInit.threads.TryStart([]() {
+        t_isBackgroundInitThread = true;
+        EnsureInitializedInternal();
+    });
+    if (!started)
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::StartBackgroundInitialization】无法创建后台线程，将在首次调用时初始化。"));
+        g_backgroundInitStarted.store(false, std::memory_order_release);
+    }
+    return started;
+}
+
+void GeoCrsManager::WaitForBackgroundInitialization()
+{
+    if (!g_backgroundInitStarted.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    BackgroundInitThread& backgroundInit = GetBackgroundInitThread();
+    std::lock_guard<std::mutex> lock(backgroundInit.mutex);
+    backgroundInit.threads.JoinAll();
+}
+
+GeoCrsManager::InitializationStatistics GeoCrsManager::GetInitializationStatistics()
+{
+    InitializationStatistics statistics;
+    statistics.isInitialized = g_isInitialized.load(std::memory_order_acquire);
+    if (statistics.isInitialized)
+    {
+        statistics.ranInBackground = g_initInBackground.load(std::memory_order_relaxed);
+        statistics.restoredFromStateFile = g_initRestoredFromState.load(std::memory_order_relaxed);
+        statistics.milliseconds = static_cast<double>(g_initNanoseconds.load(std::memory_order_relaxed)) / 1e6;
+    }
+    return statistics;
+}
+
+std::string GeoCrsManager::GetProjDbDirectoryUtf8()
+{
+    EnsureInitializedInternal();
+
+    GB_ReadLockGuard guard(g_initLock);
+    return g_projDatabaseDirUtf8;
+}
+
+bool GeoCrsManager::SetProjDbDirectoryUtf8(const std::string& projDatabaseDirUtf8)
+{
+    const std::string trimmed = GB_Utf8Trim(projDatabaseDirUtf8);
+    if (trimmed.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::SetProjDbDirectoryUtf8】目录为空。"));
+        return false;
+    }
+
+    std::string dirCandidate = trimmed;
+    if (GB_IsFileExists(dirCandidate))
+    {
+        const std::string fileName = GB_GetFileName(dirCandidate, true);
+        std::string lowerFileName;
+        lowerFileName.reserve(fileName.size());
+        for (const char ch : fileName)
+        {
+            lowerFileName.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+        }
+        if (lowerFileName == "proj.db")
+        {
+            dirCandidate = GB_GetDirectoryPath(dirCandidate);
+        }
+    }
+
+    const std::string dir = NormalizeDirPathUtf8(dirCandidate);
+    if (dir.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::SetProjDbDirectoryUtf8】目录为空。"));
+        return false;
+    }
+
+    // PROJ 搜索路径 / 配置项属于“进程级全局状态”，
+    // 与 EnsureInitializedInternal() 同步，避免并发初始化与并发覆写。
+    {
+        GB_WriteLockGuard guard(g_initLock);
+
+        if (!ApplyProjDatabaseDirectoryUtf8Internal(dir))
+        {
+            GBLOG_WARNING(GB_STR("【GeoCrsManager::SetProjDbDirectoryUtf8】未找到 proj.db: ") + dir);
+            return false;
+        }
+
+        g_projDatabaseDirUtf8 = dir;
+        g_isInitialized.store(true, std::memory_order_release);
+    }
+
+    ClearCachesInternal();
+    ReloadPersistentFileInternal(dir);
+    ReloadEpsgAreaTableInternal(dir);
+    ReloadFingerprintIndexInternal(dir);
+
+    int major = 0;
+    int minor = 0;
+    int patch = 0;
+    OSRGetPROJVersion(&major, &minor, &patch);
+    GBLOG_INFO(GB_STR("【GeoCrsManager】已设置 PROJ 数据目录: ") + dir + GB_STR(" (PROJ版本=") +
+        std::to_string(major) + GB_STR(".") + std::to_string(minor) + GB_STR(".") + std::to_string(patch) + GB_STR(")"));
+
+    return true;
+}
+
+bool GeoCrsManager::ReinitializeBySearchingProjDb()
+{
+    const std::string cwd = GetCurrentWorkingDirectoryUtf8();
+    const std::string exeDir = GB_GetExeDirectory();
+
+    std::string found;
+
+    if (!cwd.empty())
+    {
+        found = FindProjDatabaseDirBySearching(cwd);
+    }
+    if (found.empty() && !exeDir.empty())
+    {
+        found = FindProjDatabaseDirBySearching(exeDir);
+    }
+
+    if (found.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::ReinitializeBySearchingProjDb】未找到 proj.db。"));
+        return false;
+    }
+
+    if (!SetProjDbDirectoryUtf8(found))
+    {
+        return false;
+    }
+
+    SaveProjDbDirToStateInternal(cwd, exeDir, found);
+    return true;
+}
+
+void GeoCrsManager::ClearCaches()
+{
+    ClearCachesInternal();
+}
+
+std::shared_ptr<const GeoCrs> GeoCrsManager::GetWgs84()
+{
+    return GetFromEpsgCached(4326);
+}
+
+std::shared_ptr<const GeoCrs> GeoCrsManager::GetWebMercator()
+{
+    return GetFromEpsgCached(3857);
+}
+
+std::string GeoCrsManager::EpsgCodeToWktUtf8(const std::string& epsgCodeUtf8)
+{
+    EnsureInitializedInternal();
+
+    const int epsgCode = ParseEpsgCodeFromStringUtf8(epsgCodeUtf8);
+    if (epsgCode <= 0)
+    {
+        return "";
+    }
+
+    const std::shared_ptr<const GeoCrs> crs = GetFromEpsgCached(epsgCode);
+    if (!crs || !crs->IsValid())
+    {
+        return "";
+    }
+
+    return crs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+}
+
+std::string GeoCrsManager::WktToEpsgCodeUtf8(const std::string& wktUtf8)
+{
+    EnsureInitializedInternal();
+
+    std::string trimmedStorage;
+    const std::string& trimmed = TrimForLookupUtf8(wktUtf8, trimmedStorage);
+    if (trimmed.empty())
+    {
+        return "";
+    }
+
+    if (g_persistentEnabled.load(std::memory_order_acquire))
+    {
+        const std::shared_ptr<const CrsMetadata> metadata = GetCrsMetadataInternal(trimmed);
+        return (metadata->epsgCode > 0) ? "EPSG:" + std::to_string(metadata->epsgCode) : "";
+    }
+
+    const std::shared_ptr<const GeoCrs> crs = GetFromWktCached(trimmed);
+    if (!crs || !crs->IsValid())
+    {
+        return "";
+    }
+
+    return crs->ToEpsgStringUtf8();
+}
+
+std::shared_ptr<const GeoCrs> GeoCrsManager::GetFromEpsgCached(int epsgCode)
+{
+    EnsureInitializedInternal();
+
+    if (epsgCode <= 0)
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::GetFromEpsgCached】epsgCode 非正: ") + std::to_string(epsgCode));
+        return GetEmptyCrsShared();
+    }
+
+    return g_epsgCache.GetOrCompute(epsgCode, [epsgCode]() -> std::shared_ptr<const GeoCrs> {
+        return CanonicalizeCrsInternal(std::make_shared<GeoCrs>(GeoCrs::CreateFromEpsgCode(epsgCode)));
+    });
+}
+
+std::shared_ptr<const GeoCrs> GeoCrsManager::GetFromDefinitionCached(const std::string& definitionUtf8, bool allowNetworkAccess, bool allowFileAccess)
+{
+    EnsureInitializedInternal();
+
+    const std::string trimmed = GB_Utf8Trim(definitionUtf8);
+    if (trimmed.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::GetFromDefinitionCached】definition 为空。"));
+        return GetEmptyCrsShared();
+    }
+
+    const DefinitionKey key{ trimmed, allowNetworkAccess, allowFileAccess };
+
+    return g_definitionCache.GetOrCompute(key, [&key]() -> std::shared_ptr<const GeoCrs> {
+        return CanonicalizeCrsInternal(std::make_shared<GeoCrs>(GeoCrs::CreateFromUserInput(key.definitionUtf8, key.allowNetworkAccess, key.allowFileAccess)));
+    });
+}
+
+std::shared_ptr<const FrozenGeoCrs> GeoCrsManager::GetFrozenFromEpsgCached(int epsgCode)
+{
+    EnsureInitializedInternal();
+
+    if (epsgCode <= 0)
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::GetFrozenFromEpsgCached】epsgCode 非正: ") + std::to_string(epsgCode));
+        return FrozenGeoCrs::Create(GetEmptyCrsShared());
+    }
+
+    return g_frozenEpsgCache.GetOrCompute(epsgCode, [epsgCode]() -> std::shared_ptr<const FrozenGeoCrs> {
+        return FrozenGeoCrs::Create(GetFromEpsgCached(epsgCode));
+    });
+}
+
+std::shared_ptr<const FrozenGeoCrs> GeoCrsManager::GetFrozenFromWktCached(const std::string& wktUtf8)
+{
+    EnsureInitializedInternal();
+
+    std::string trimmedStorage;
+    const std::string& trimmed = TrimForLookupUtf8(wktUtf8, trimmedStorage);
+    if (trimmed.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::GetFrozenFromWktCached】wkt 为空。"));
+        return FrozenGeoCrs::Create(GetEmptyCrsShared());
+    }
+
+    return g_frozenWktCache.GetOrCompute(trimmed, [&trimmed]() -> std::shared_ptr<const FrozenGeoCrs> {
+        const std::string canonicalKey = GetCanonicalKeyInternal(trimmed);
+        if (canonicalKey.empty())
+        {
+            return FrozenGeoCrs::Create(GetFromWktCached(trimmed));
+        }
+
+        return g_canonicalFrozenCache.GetOrCompute(canonicalKey, [&trimmed]() -> std::shared_ptr<const FrozenGeoCrs> {
+            return FrozenGeoCrs::Create(GetFromWktCached(trimmed));
+        });
+    });
+}
+
+bool GeoCrsManager::IsWktValidCached(const std::string& wktUtf8)
 {
-    return g_isInitialized.load(std::memory_order_acquire);
+    EnsureInitializedInternal();
+
+    std::string trimmedStorage;
+    const std::string& trimmed = TrimForLookupUtf8(wktUtf8, trimmedStorage);
+    if (trimmed.empty())
+    {
+        return false;
+    }
+
+    return g_wktValidityCache.GetOrCompute(trimmed, [&trimmed]() -> bool {
+        // 持久化缓存只作为现成结果使用：未命中时不为一个有效性标志计算完整元数据（EPSG 识别等）。
+        if (g_persistentEnabled.load(std::memory_order_acquire))
+        {
+            std::shared_ptr<const CrsMetadata> metadata;
+            if (g_metadataCache.TryGet(trimmed, metadata) && metadata)
+            {
+                return metadata->isValid;
+            }
+
+            const std::shared_ptr<const MappedMetadataFile> file = GetPersistentFile();
+            bool isValid = false;
+            if (file && file->TryFindIsValid(trimmed, isValid))
+            {
+                return isValid;
+            }
+        }
+
+        // 若 CRS 缓存已有，也可直接复用。
+        std::shared_ptr<const GeoCrs> cachedCrs;
+        if (g_wktCache.TryGet(trimmed, cachedCrs) && cachedCrs)
+        {
+            return cachedCrs->IsValid();
+        }
+
+        return GeoCrs::CreateFromWkt(trimmed).IsValid();
+    });
 }
 
-std::string GeoCrsManager::GetProjDbDirectoryUtf8()
+std::vector<std::shared_ptr<const GeoCrs>> GeoCrsManager::GetFromWktBatch(const std::vector<std::string>& wktsUtf8, int threadCount)
 {
     EnsureInitializedInternal();
 
-    GB_ReadLockGuard guard(g_initLock);
-    return g_projDatabaseDirUtf8;
+    std::vector<std::string> trimmedWkts;
+    trimmedWkts.reserve(wktsUtf8.size());
+    for (const std::string& wktUtf8 : wktsUtf8)
+    {
+        trimmedWkts.push_back(GB_Utf8Trim(wktUtf8));
+    }
+
+    std::vector<std::shared_ptr<const GeoCrs>> results = GetBatchInternal(g_wktCache, trimmedWkts, threadCount,
+        [](const std::string& trimmed, std::shared_ptr<const GeoCrs>& outCrs) -> bool {
+            if (!trimmed.empty())
+            {
+                return false;
+            }
+            outCrs = GetEmptyCrsShared();
+            return true;
+        },
+        [](const std::string& trimmed) -> std::shared_ptr<const GeoCrs> {
+            const std::uint64_t validityGeneration = g_wktValidityCache.GetGeneration();
+            const std::shared_ptr<const GeoCrs> crs = CanonicalizeCrsInternal(std::make_shared<GeoCrs>(GeoCrs::CreateFromWkt(trimmed)));
+            g_wktValidityCache.GetOrInsert(trimmed, crs->IsValid(), validityGeneration);
+            return crs;
+        });
+
+    GBLOG_INFO(GB_STR("【GeoCrsManager】批量解析 WKT 完成 (条目数=") + std::to_string(wktsUtf8.size()) + GB_STR(")"));
+    return results;
 }
 
-bool GeoCrsManager::SetProjDbDirectoryUtf8(const std::string& projDatabaseDirUtf8)
+std::vector<std::shared_ptr<const GeoCrs>> GeoCrsManager::GetFromEpsgBatch(const std::vector<int>& epsgCodes, int threadCount)
 {
-    const std::string trimmed = GB_Utf8Trim(projDatabaseDirUtf8);
+    EnsureInitializedInternal();
+
+    std::vector<std::shared_ptr<const GeoCrs>> results = GetBatchInternal(g_epsgCache, epsgCodes, threadCount,
+        [](int epsgCode, std::shared_ptr<const GeoCrs>& outCrs) -> bool {
+            if (epsgCode > 0)
+            {
+                return false;
+            }
+            outCrs = GetEmptyCrsShared();
+            return true;
+        },
+        [](int epsgCode) -> std::shared_ptr<const GeoCrs> {
+            return CanonicalizeCrsInternal(std::make_shared<GeoCrs>(GeoCrs::CreateFromEpsgCode(epsgCode)));
+        });
+
+    GBLOG_INFO(GB_STR("【GeoCrsManager】批量解析 EPSG 完成 (条目数=") + std::to_string(epsgCodes.size()) + GB_STR(")"));
+    return results;
+}
+
+std::shared_ptr<const GeoCrs> GeoCrsManager::GetFromWktCached(const std::string& wktUtf8)
+{
+    EnsureInitializedInternal();
+
+    std::string trimmedStorage;
+    const std::string& trimmed = TrimForLookupUtf8(wktUtf8, trimmedStorage);
     if (trimmed.empty())
     {
-        GBLOG_WARNING(GB_STR("【GeoCrsManager::SetProjDbDirectoryUtf8】目录为空。"));
-        return false;
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::GetFromWktCached】wkt 为空。"));
+        return GetEmptyCrsShared();
     }
 
-    std::string dirCandidate = trimmed;
-    if (GB_IsFileExists(dirCandidate))
+    return g_wktCache.GetOrCompute(trimmed, [&trimmed]() -> std::shared_ptr<const GeoCrs> {
+        const std::uint64_t validityGeneration = g_wktValidityCache.GetGeneration();
+        const std::shared_ptr<const GeoCrs> crs = CanonicalizeCrsInternal(std::make_shared<GeoCrs>(GeoCrs::CreateFromWkt(trimmed)));
+
+        // 也同步写入 validity cache（避免重复解析）
+        g_wktValidityCache.GetOrInsert(trimmed, crs->IsValid(), validityGeneration);
+        return crs;
+    });
+}
+
+bool GeoCrsManager::TryGetValidAreasCached(const std::string& wktUtf8, GeoBoundingBox& outLonLatArea, GeoBoundingBox& outSelfArea)
+{
+    EnsureInitializedInternal();
+
+    std::string trimmedStorage;
+    const std::string& trimmed = TrimForLookupUtf8(wktUtf8, trimmedStorage);
+    if (trimmed.empty())
     {
-        const std::string fileName = GB_GetFileName(dirCandidate, true);
-        std::string lowerFileName;
-        lowerFileName.reserve(fileName.size());
-        for (const char ch : fileName)
+        outLonLatArea = GeoBoundingBox();
+        outSelfArea = GeoBoundingBox();
+        return false;
+    }
+
+    const auto computeAreas = [&trimmed]() -> ValidAreas {
+        ValidAreas computed;
+        if (g_persistentEnabled.load(std::memory_order_acquire))
         {
-            lowerFileName.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+            // 经由元数据缓存：命中持久化文件时无需解析 WKT，未命中时计算出的完整元数据也可随后保存。
+            const std::shared_ptr<const CrsMetadata> metadata = GetCrsMetadataInternal(trimmed);
+            computed.lonLatArea = metadata->lonLatArea;
+            computed.selfArea = metadata->selfArea;
+            return computed;
         }
-        if (lowerFileName == "proj.db")
+
+        // 复用 CRS 缓存（优先），避免重复解析。
+        const std::shared_ptr<const GeoCrs> crs = GetFromWktCached(trimmed);
+        if (crs)
         {
-            dirCandidate = GB_GetDirectoryPath(dirCandidate);
+            computed.lonLatArea = crs->GetValidAreaLonLat();
+            computed.selfArea = crs->GetValidArea();
+        }
+        return computed;
+    };
+
+    const ValidAreas areas = g_validAreaCache.GetOrCompute(trimmed, [&trimmed, &computeAreas]() -> ValidAreas {
+        // 持久化时元数据本身按输入字符串缓存（命中文件时无需解析），不经第二级缓存。
+        if (g_persistentEnabled.load(std::memory_order_acquire))
+        {
+            return computeAreas();
         }
+
+        const std::string canonicalKey = GetCanonicalKeyInternal(trimmed);
+        return canonicalKey.empty() ? computeAreas() : g_canonicalValidAreaCache.GetOrCompute(canonicalKey, computeAreas);
+    });
+
+    outLonLatArea = areas.lonLatArea;
+    outSelfArea = areas.selfArea;
+    return outLonLatArea.IsValid() && outSelfArea.IsValid();
+}
+
+std::shared_ptr<const GeoCrsFootprint> GeoCrsManager::GetValidAreaFootprintCached(const std::string& wktUtf8)
+{
+    EnsureInitializedInternal();
+
+    std::string trimmedStorage;
+    const std::string& trimmed = TrimForLookupUtf8(wktUtf8, trimmedStorage);
+    if (trimmed.empty())
+    {
+        static const std::shared_ptr<const GeoCrsFootprint> emptyFootprint = std::make_shared<GeoCrsFootprint>();
+        return emptyFootprint;
     }
 
-    const std::string dir = NormalizeDirPathUtf8(dirCandidate);
-    if (dir.empty())
+    const auto computeFootprint = [&trimmed]() -> std::shared_ptr<const GeoCrsFootprint> {
+        const std::shared_ptr<const GeoCrs> crs = GetFromWktCached(trimmed);
+        return std::make_shared<GeoCrsFootprint>(crs ? crs->GetValidAreaFootprint() : GeoCrsFootprint());
+    };
+
+    return g_footprintCache.GetOrCompute(trimmed, [&trimmed, &computeFootprint]() -> std::shared_ptr<const GeoCrsFootprint> {
+        const std::string canonicalKey = GetCanonicalKeyInternal(trimmed);
+        return canonicalKey.empty() ? computeFootprint() : g_canonicalFootprintCache.GetOrCompute(canonicalKey, computeFootprint);
+    });
+}
+
+bool GeoCrsManager::TryGetValidAreasCached(std::uint32_t crsId, GeoBoundingBox& outLonLatArea, GeoBoundingBox& outSelfArea)
+{
+    EnsureInitializedInternal();
+
+    const InternedCrs* entry = GetInternedCrs(crsId);
+    if (entry == nullptr)
     {
-        GBLOG_WARNING(GB_STR("【GeoCrsManager::SetProjDbDirectoryUtf8】目录为空。"));
+        outLonLatArea = GeoBoundingBox();
+        outSelfArea = GeoBoundingBox();
         return false;
     }
 
-    // PROJ 搜索路径 / 配置项属于“进程级全局状态”，
-    // 与 EnsureInitializedInternal() 同步，避免并发初始化与并发覆写。
+    // 直接用驻留的 CRS 计算，不经按输入字符串的缓存与持久化元数据（都需要 WKT 作 key）。
+    const std::shared_ptr<const GeoCrs>& crs = entry->crs;
+    const auto computeAreas = [&crs]() -> ValidAreas {
+        ValidAreas computed;
+        computed.lonLatArea = crs->GetValidAreaLonLat();
+        computed.selfArea = crs->GetValidArea();
+        return computed;
+    };
+
+    const ValidAreas areas = entry->canonicalKey.empty() ? computeAreas() : g_canonicalValidAreaCache.GetOrCompute(entry->canonicalKey, computeAreas);
+
+    outLonLatArea = areas.lonLatArea;
+    outSelfArea = areas.selfArea;
+    return outLonLatArea.IsValid() && outSelfArea.IsValid();
+}
+
+std::shared_ptr<const GeoCrsFootprint> GeoCrsManager::GetValidAreaFootprintCached(std::uint32_t crsId)
+{
+    EnsureInitializedInternal();
+
+    const InternedCrs* entry = GetInternedCrs(crsId);
+    if (entry == nullptr)
     {
-        GB_WriteLockGuard guard(g_initLock);
+        static const std::shared_ptr<const GeoCrsFootprint> emptyFootprint = std::make_shared<GeoCrsFootprint>();
+        return emptyFootprint;
+    }
 
-        if (!ApplyProjDatabaseDirectoryUtf8Internal(dir))
+    const std::shared_ptr<const GeoCrs>& crs = entry->crs;
+    const auto computeFootprint = [&crs]() -> std::shared_ptr<const GeoCrsFootprint> {
+        return std::make_shared<GeoCrsFootprint>(crs->GetValidAreaFootprint());
+    };
+
+    return entry->canonicalKey.empty() ? computeFootprint() : g_canonicalFootprintCache.GetOrCompute(entry->canonicalKey, computeFootprint);
+}
+
+std::vector<GeoCrsManager::WarmupResult> GeoCrsManager::Warmup(const std::vector<int>& epsgCodes, int threadCount)
+{
+    EnsureInitializedInternal();
+
+    std::vector<WarmupResult> results = RunWarmupItems(epsgCodes.size(), threadCount, [&epsgCodes](size_t index) -> bool {
+        const int epsgCode = epsgCodes[index];
+        if (epsgCode <= 0)
+        {
+            return false;
+        }
+
+        const std::shared_ptr<const GeoCrs> crs = GetFromEpsgCached(epsgCode);
+        if (!crs || !crs->IsValid())
         {
-            GBLOG_WARNING(GB_STR("【GeoCrsManager::SetProjDbDirectoryUtf8】未找到 proj.db: ") + dir);
             return false;
         }
+        GetFrozenFromEpsgCached(epsgCode);
+
+        // 以规范 WKT 预热按 WKT 索引的各层：同一坐标系其它写法的第二级（按 UID）条目也随之就绪。
+        return WarmupWktInternal(crs->ExportToWktUtf8());
+    });
+
+    size_t failedCount = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (!results[i].success)
+        {
+            failedCount++;
+            GBLOG_WARNING(GB_STR("【GeoCrsManager::Warmup】预热失败: EPSG:") + std::to_string(epsgCodes[i]));
+        }
+    }
+    GBLOG_INFO(GB_STR("【GeoCrsManager】EPSG 预热完成 (条目数=") + std::to_string(results.size()) + GB_STR(", 失败=") + std::to_string(failedCount) + GB_STR(")"));
+    return results;
+}
+
+std::vector<GeoCrsManager::WarmupResult> GeoCrsManager::Warmup(const std::vector<std::string>& wktsUtf8, int threadCount)
+{
+    EnsureInitializedInternal();
+
+    std::vector<WarmupResult> results = RunWarmupItems(wktsUtf8.size(), threadCount, [&wktsUtf8](size_t index) -> bool {
+        const std::string trimmed = GB_Utf8Trim(wktsUtf8[index]);
+        return !trimmed.empty() && WarmupWktInternal(trimmed);
+    });
+
+    size_t failedCount = 0;
+    for (const WarmupResult& result : results)
+    {
+        if (!result.success)
+        {
+            failedCount++;
+        }
+    }
+    if (failedCount > 0)
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::Warmup】部分 WKT 预热失败: ") + std::to_string(failedCount) + GB_STR("/") + std::to_string(results.size()));
+    }
+    GBLOG_INFO(GB_STR("【GeoCrsManager】WKT 预热完成 (条目数=") + std::to_string(results.size()) + GB_STR(", 失败=") + std::to_string(failedCount) + GB_STR(")"));
+    return results;
+}
+
+bool GeoCrsManager::TryGetCrsMetadataCached(const std::string& wktUtf8, CrsMetadata& outMetadata)
+{
+    EnsureInitializedInternal();
+
+    std::string trimmedStorage;
+    const std::string& trimmed = TrimForLookupUtf8(wktUtf8, trimmedStorage);
+    if (trimmed.empty())
+    {
+        outMetadata = CrsMetadata();
+        return false;
+    }
+
+    outMetadata = *GetCrsMetadataInternal(trimmed);
+    return outMetadata.isValid;
+}
+
+bool GeoCrsManager::EnablePersistentCache(const std::string& cacheFilePathUtf8)
+{
+    const std::string trimmed = GB_Utf8Trim(cacheFilePathUtf8);
+    if (trimmed.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::EnablePersistentCache】缓存文件路径为空。"));
+        return false;
+    }
+
+    EnsureInitializedInternal();
+
+    {
+        GB_WriteLockGuard guard(g_persistentLock);
+        g_persistentPathUtf8 = trimmed;
+    }
+
+    ReloadPersistentFileInternal(GetProjDbDirectoryUtf8());
+    g_persistentEnabled.store(true, std::memory_order_release);
+    return true;
+}
+
+void GeoCrsManager::DisablePersistentCache()
+{
+    g_persistentEnabled.store(false, std::memory_order_release);
+
+    GB_WriteLockGuard guard(g_persistentLock);
+    g_persistentPathUtf8.clear();
+    g_persistentFile.reset();
+}
+
+bool GeoCrsManager::SavePersistentCache()
+{
+    EnsureInitializedInternal();
+
+    std::string pathUtf8;
+    {
+        GB_ReadLockGuard guard(g_persistentLock);
+        pathUtf8 = g_persistentPathUtf8;
+    }
+    if (pathUtf8.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::SavePersistentCache】未启用持久化缓存。"));
+        return false;
+    }
+
+    const std::string projDbDir = GetProjDbDirectoryUtf8();
+    ProjDbSignature signature;
+    if (!TryGetProjDbSignature(projDbDir, signature))
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::SavePersistentCache】无法确定 proj.db 状态。"));
+        return false;
+    }
+
+    // 合并：已加载文件中的条目（proj.db 未变化时） + 本进程解析过的条目（后者优先）。
+    std::map<std::string, CrsMetadata> merged;
+    std::shared_ptr<const MappedMetadataFile> file = GetPersistentFile();
+    if (file && file->signature == signature)
+    {
+        for (size_t i = 0; i < file->entryCount; i++)
+        {
+            std::string key;
+            CrsMetadata metadata;
+            if (file->ReadEntry(i, key, metadata))
+            {
+                merged.emplace(std::move(key), std::move(metadata));
+            }
+        }
+    }
+    g_metadataCache.ForEach([&merged](const std::string& key, const std::shared_ptr<const CrsMetadata>& metadata) {
+        if (metadata)
+        {
+            merged[key] = *metadata;
+        }
+    });
+
+    file.reset();
+
+    const bool saved = WriteMetadataFile(pathUtf8, signature, merged);
+    if (!saved)
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::SavePersistentCache】写入失败: ") + pathUtf8);
+    }
+
+    ReloadPersistentFileInternal(projDbDir);
+    return saved;
+}
+
+size_t GeoCrsManager::GetPersistentCacheEntryCount()
+{
+    const std::shared_ptr<const MappedMetadataFile> file = GetPersistentFile();
+    return file ? static_cast<size_t>(file->entryCount) : 0;
+}
+
+bool GeoCrsManager::BuildEpsgValidAreaTable(const std::string& tableFilePathUtf8, bool enableOpenMP)
+{
+    const std::string pathUtf8 = GB_Utf8Trim(tableFilePathUtf8);
+    if (pathUtf8.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::BuildEpsgValidAreaTable】文件路径为空。"));
+        return false;
+    }
+
+    EnsureInitializedInternal();
+
+    const std::string projDbDir = GetProjDbDirectoryUtf8();
+    ProjDbSignature signature;
+    if (!TryGetProjDbSignature(projDbDir, signature))
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::BuildEpsgValidAreaTable】无法确定 proj.db 状态。"));
+        return false;
+    }
+
+    // 先卸载旧表，保证下面的 GetValidArea() 是实时计算而不是查旧表。
+    {
+        GB_WriteLockGuard guard(g_epsgAreaTableLock);
+        g_epsgAreaTable.reset();
+    }
+
+    const std::vector<EpsgCrsCandidate> candidates = ListEpsgCrsCandidates();
+    if (candidates.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::BuildEpsgValidAreaTable】未能从 proj.db 枚举 EPSG 坐标系。"));
+        return false;
+    }
+
+    // 已废弃的 code 不入表（仍可实时计算）；其余条目（包括没有 area of use 的）均按实时计算的结果记录，
+    // 保证查表与实时路径一致（例如没有 area of use 的地理坐标系，自身范围为全球范围）。
+    std::vector<EpsgCrsCandidate> tabulatedCandidates;
+    tabulatedCandidates.reserve(candidates.size());
+    for (const EpsgCrsCandidate& candidate : candidates)
+    {
+        if (!candidate.isDeprecated)
+        {
+            tabulatedCandidates.push_back(candidate);
+        }
+    }
+
+    std::vector<std::pair<int, EpsgValidArea>> records(tabulatedCandidates.size());
+    auto computeRecord = [&](size_t index) {
+        const EpsgCrsCandidate& candidate = tabulatedCandidates[index];
+        records[index].first = candidate.epsgCode;
+
+        const GeoCrs crs = GeoCrs::CreateFromEpsgCode(candidate.epsgCode);
+        if (!crs.IsValid())
+        {
+            return;
+        }
+
+        EpsgValidArea& area = records[index].second;
+        const GeoBoundingBox lonLatArea = crs.GetValidAreaLonLat();
+        const GeoBoundingBox selfArea = crs.GetValidArea();
+        area.hasLonLatArea = lonLatArea.IsValid();
+        area.hasSelfArea = selfArea.IsValid();
+        if (area.hasLonLatArea)
+        {
+            area.lonLatRect = lonLatArea.rect;
+        }
+        if (area.hasSelfArea)
+        {
+            area.selfRect = selfArea.rect;
+        }
+    };
+
+    // 每个 CRS 互相独立（各自的 OGRSpatialReference 与坐标转换），按条目并行即可。
+    const size_t candidateCount = tabulatedCandidates.size();
+    const bool useParallel = enableOpenMP && candidateCount > 1 && candidateCount <= static_cast<size_t>(std::numeric_limits<int>::max());
+    if (useParallel)
+    {
+#pragma omp parallel for schedule(dynamic, 16)
+        for (int i = 0; i < static_cast<int>(candidateCount); i++)
+        {
+            computeRecord(static_cast<size_t>(i));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < candidateCount; i++)
+        {
+            computeRecord(i);
+        }
+    }
 
-        g_projDatabaseDirUtf8 = dir;
-        g_isInitialized.store(true, std::memory_order_release);
+    if (!WriteEpsgAreaTableFile(pathUtf8, signature, records))
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::BuildEpsgValidAreaTable】写入失败: ") + pathUtf8);
+        return false;
     }
 
-    ClearCachesInternal();
+    std::shared_ptr<EpsgValidAreaTable> table = std::make_shared<EpsgValidAreaTable>();
+    table->reserve(records.size());
+    for (const auto& record : records)
+    {
+        table->emplace(record.first, record.second);
+    }
 
-    int major = 0;
-    int minor = 0;
-    int patch = 0;
-    OSRGetPROJVersion(&major, &minor, &patch);
-    GBLOG_INFO(GB_STR("【GeoCrsManager】已设置 PROJ 数据目录: ") + dir + GB_STR(" (PROJ版本=") +
-        std::to_string(major) + GB_STR(".") + std::to_string(minor) + GB_STR(".") + std::to_string(patch) + GB_STR(")"));
+    {
+        GB_WriteLockGuard guard(g_epsgAreaTableLock);
+        g_epsgAreaTablePathUtf8 = pathUtf8;
+        g_epsgAreaTable = table;
+    }
 
+    // 已缓存的有效范围与查表结果一致，无需清空缓存。
+    GBLOG_INFO(GB_STR("【GeoCrsManager】已生成 EPSG 有效范围表: ") + pathUtf8 + GB_STR(" (条目数=") + std::to_string(records.size()) + GB_STR(")"));
     return true;
 }
 
-bool GeoCrsManager::ReinitializeBySearchingProjDb()
+bool GeoCrsManager::LoadEpsgValidAreaTable(const std::string& tableFilePathUtf8)
 {
-    const std::string cwd = GetCurrentWorkingDirectoryUtf8();
-    const std::string exeDir = GB_GetExeDirectory();
+    const std::string pathUtf8 = GB_Utf8Trim(tableFilePathUtf8);
+    if (pathUtf8.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::LoadEpsgValidAreaTable】文件路径为空。"));
+        return false;
+    }
 
-    std::string found;
+    EnsureInitializedInternal();
 
-    if (!cwd.empty())
     {
-        found = FindProjDatabaseDirBySearching(cwd);
+        GB_WriteLockGuard guard(g_epsgAreaTableLock);
+        g_epsgAreaTablePathUtf8 = pathUtf8;
     }
-    if (found.empty() && !exeDir.empty())
+
+    ReloadEpsgAreaTableInternal(GetProjDbDirectoryUtf8());
+    return GetEpsgValidAreaTableSize() > 0;
+}
+
+bool GeoCrsManager::TryGetTabulatedEpsgValidArea(int epsgCode, EpsgValidArea& outArea)
+{
+    std::shared_ptr<const EpsgValidAreaTable> table;
     {
-        found = FindProjDatabaseDirBySearching(exeDir);
+        GB_ReadLockGuard guard(g_epsgAreaTableLock);
+        table = g_epsgAreaTable;
     }
-
-    if (found.empty())
+    if (!table)
     {
-        GBLOG_WARNING(GB_STR("【GeoCrsManager::ReinitializeBySearchingProjDb】未找到 proj.db。"));
         return false;
     }
 
-    return SetProjDbDirectoryUtf8(found);
-}
-
-void GeoCrsManager::ClearCaches()
-{
-    ClearCachesInternal();
-}
+    const auto it = table->find(epsgCode);
+    if (it == table->end())
+    {
+        return false;
+    }
 
-std::shared_ptr<const GeoCrs> GeoCrsManager::GetWgs84()
-{
-    return GetFromEpsgCached(4326);
+    outArea = it->second;
+    return true;
 }
 
-std::shared_ptr<const GeoCrs> GeoCrsManager::GetWebMercator()
+size_t GeoCrsManager::GetEpsgValidAreaTableSize()
 {
-    return GetFromEpsgCached(3857);
+    GB_ReadLockGuard guard(g_epsgAreaTableLock);
+    return g_epsgAreaTable ? g_epsgAreaTable->size() : 0;
 }
 
-std::string GeoCrsManager::EpsgCodeToWktUtf8(const std::string& epsgCodeUtf8)
+bool GeoCrsManager::BuildEpsgFingerprintIndex(const std::string& indexFilePathUtf8, bool enableOpenMP)
 {
-    EnsureInitializedInternal();
-
-    const int epsgCode = ParseEpsgCodeFromStringUtf8(epsgCodeUtf8);
-    if (epsgCode <= 0)
+    const std::string pathUtf8 = GB_Utf8Trim(indexFilePathUtf8);
+    if (pathUtf8.empty())
     {
-        return "";
-    }
-
-    const std::shared_ptr<const GeoCrs> crs = GetFromEpsgCached(epsgCode);
-    if (!crs || !crs->IsValid())
-    {
-        return "";
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::BuildEpsgFingerprintIndex】文件路径为空。"));
+        return false;
     }
 
-    return crs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
-}
-
-std::string GeoCrsManager::WktToEpsgCodeUtf8(const std::string& wktUtf8)
-{
     EnsureInitializedInternal();
 
-    const std::string trimmed = GB_Utf8Trim(wktUtf8);
-    if (trimmed.empty())
+    const std::string projDbDir = GetProjDbDirectoryUtf8();
+    ProjDbSignature signature;
+    if (!TryGetProjDbSignature(projDbDir, signature))
     {
-        return "";
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::BuildEpsgFingerprintIndex】无法确定 proj.db 状态。"));
+        return false;
     }
 
-    const std::shared_ptr<const GeoCrs> crs = GetFromWktCached(trimmed);
-    if (!crs || !crs->IsValid())
+    const std::vector<EpsgCrsCandidate> candidates = ListEpsgCrsCandidates();
+    if (candidates.empty())
     {
-        return "";
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::BuildEpsgFingerprintIndex】未能从 proj.db 枚举 EPSG 坐标系。"));
+        return false;
     }
 
-    return crs->ToEpsgStringUtf8();
-}
+    // fingerprint 为 0 的条目（无法生成指纹）在写出前剔除。
+    std::vector<FingerprintRecord> records(candidates.size());
+    auto computeRecord = [&](size_t index) {
+        const int epsgCode = candidates[index].epsgCode;
+        records[index].epsgCode = epsgCode;
+        records[index].isDeprecated = candidates[index].isDeprecated;
 
-std::shared_ptr<const GeoCrs> GeoCrsManager::GetFromEpsgCached(int epsgCode)
-{
-    EnsureInitializedInternal();
+        std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter> srs(OGRSpatialReference::FromHandle(OSRNewSpatialReference(nullptr)));
+        if (srs && srs->importFromEPSG(epsgCode) == OGRERR_NONE)
+        {
+            records[index].fingerprint = ComputeSrsFingerprint(*srs);
+        }
+    };
 
-    if (epsgCode <= 0)
+    const size_t candidateCount = candidates.size();
+    const bool useParallel = enableOpenMP && candidateCount > 1 && candidateCount <= static_cast<size_t>(std::numeric_limits<int>::max());
+    if (useParallel)
     {
-        GBLOG_WARNING(GB_STR("【GeoCrsManager::GetFromEpsgCached】epsgCode 非正: ") + std::to_string(epsgCode));
-        return GetEmptyCrsShared();
+#pragma omp parallel for schedule(dynamic, 64)
+        for (int i = 0; i < static_cast<int>(candidateCount); i++)
+        {
+            computeRecord(static_cast<size_t>(i));
+        }
     }
-
+    else
     {
-        GB_ReadLockGuard readGuard(g_epsgCacheLock);
-        const auto it = g_epsgCache.find(epsgCode);
-        if (it != g_epsgCache.end())
+        for (size_t i = 0; i < candidateCount; i++)
         {
-            return it->second;
+            computeRecord(i);
         }
     }
 
-    std::shared_ptr<const GeoCrs> crs = std::make_shared<GeoCrs>(GeoCrs::CreateFromEpsgCode(epsgCode));
+    records.erase(std::remove_if(records.begin(), records.end(), [](const FingerprintRecord& record) {
+        return record.fingerprint == 0;
+    }), records.end());
+    std::sort(records.begin(), records.end());
 
+    if (!WriteFingerprintIndexFile(pathUtf8, signature, records))
     {
-        GB_WriteLockGuard writeGuard(g_epsgCacheLock);
-        const auto it = g_epsgCache.find(epsgCode);
-        if (it != g_epsgCache.end())
-        {
-            return it->second;
-        }
-        g_epsgCache.emplace(epsgCode, crs);
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::BuildEpsgFingerprintIndex】写入失败: ") + pathUtf8);
+        return false;
     }
 
-    return crs;
-}
-
-std::shared_ptr<const GeoCrs> GeoCrsManager::GetFromDefinitionCached(const std::string& definitionUtf8, bool allowNetworkAccess, bool allowFileAccess)
-{
-    EnsureInitializedInternal();
+    std::shared_ptr<EpsgFingerprintIndex> index = std::make_shared<EpsgFingerprintIndex>();
+    for (const FingerprintRecord& record : records)
+    {
+        (*index)[record.fingerprint].push_back(record.epsgCode);
+    }
 
-    const std::string trimmed = GB_Utf8Trim(definitionUtf8);
-    if (trimmed.empty())
     {
-        GBLOG_WARNING(GB_STR("【GeoCrsManager::GetFromDefinitionCached】definition 为空。"));
-        return GetEmptyCrsShared();
+        GB_WriteLockGuard guard(g_fingerprintIndexLock);
+        g_fingerprintIndexPathUtf8 = pathUtf8;
+        g_fingerprintIndex = index;
+        g_fingerprintIndexGeneration.fetch_add(1, std::memory_order_acq_rel);
     }
 
-    const DefinitionKey key{ trimmed, allowNetworkAccess, allowFileAccess };
+    GBLOG_INFO(GB_STR("【GeoCrsManager】已生成 EPSG 指纹索引: ") + pathUtf8 + GB_STR(" (条目数=") + std::to_string(records.size()) + GB_STR(")"));
+    return true;
+}
 
+bool GeoCrsManager::LoadEpsgFingerprintIndex(const std::string& indexFilePathUtf8)
+{
+    const std::string pathUtf8 = GB_Utf8Trim(indexFilePathUtf8);
+    if (pathUtf8.empty())
     {
-        GB_ReadLockGuard readGuard(g_definitionCacheLock);
-        const auto it = g_definitionCache.find(key);
-        if (it != g_definitionCache.end())
-        {
-            return it->second;
-        }
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::LoadEpsgFingerprintIndex】文件路径为空。"));
+        return false;
     }
 
-    std::shared_ptr<const GeoCrs> crs = std::make_shared<GeoCrs>(GeoCrs::CreateFromUserInput(trimmed, allowNetworkAccess, allowFileAccess));
+    EnsureInitializedInternal();
 
     {
-        GB_WriteLockGuard writeGuard(g_definitionCacheLock);
-        const auto it = g_definitionCache.find(key);
-        if (it != g_definitionCache.end())
-        {
-            return it->second;
-        }
-        g_definitionCache.emplace(key, crs);
+        GB_WriteLockGuard guard(g_fingerprintIndexLock);
+        g_fingerprintIndexPathUtf8 = pathUtf8;
     }
 
-    return crs;
+    ReloadFingerprintIndexInternal(GetProjDbDirectoryUtf8());
+    return GetEpsgFingerprintIndexSize() > 0;
 }
 
-bool GeoCrsManager::IsWktValidCached(const std::string& wktUtf8)
+int GeoCrsManager::IdentifyEpsgByFingerprint(const OGRSpatialReference& srs)
 {
-    EnsureInitializedInternal();
-
-    const std::string trimmed = GB_Utf8Trim(wktUtf8);
-    if (trimmed.empty())
+    std::shared_ptr<const EpsgFingerprintIndex> index;
     {
-        return false;
+        GB_ReadLockGuard guard(g_fingerprintIndexLock);
+        index = g_fingerprintIndex;
     }
-
+    if (!index)
     {
-        GB_ReadLockGuard readGuard(g_wktValidityCacheLock);
-        const auto it = g_wktValidityCache.find(trimmed);
-        if (it != g_wktValidityCache.end())
-        {
-            return it->second;
-        }
+        return 0;
     }
 
-    // 若 CRS 缓存已有，也可直接复用。
+    const std::uint64_t fingerprint = ComputeSrsFingerprint(srs);
+    if (fingerprint == 0)
     {
-        GB_ReadLockGuard readGuard(g_wktCacheLock);
-        const auto it = g_wktCache.find(trimmed);
-        if (it != g_wktCache.end() && it->second)
-        {
-            const bool valid = it->second->IsValid();
-            GB_WriteLockGuard writeGuard(g_wktValidityCacheLock);
-            g_wktValidityCache.emplace(trimmed, valid);
-            return valid;
-        }
+        return 0;
     }
 
-    const GeoCrs temp = GeoCrs::CreateFromWkt(trimmed);
-    const bool valid = temp.IsValid();
+    const auto it = index->find(fingerprint);
+    if (it == index->end())
+    {
+        return 0;
+    }
 
+    // 精确校验：指纹只保证参数一致，基准面等仍需 IsSame 确认。
+    const char* const isSameOptions[] = { "IGNORE_DATA_AXIS_TO_SRS_AXIS_MAPPING=YES", "CRITERION=EQUIVALENT_EXCEPT_AXIS_ORDER_GEOGCRS", nullptr };
+    for (const int epsgCode : it->second)
     {
-        GB_WriteLockGuard writeGuard(g_wktValidityCacheLock);
-        const auto it = g_wktValidityCache.find(trimmed);
-        if (it != g_wktValidityCache.end())
+        const OGRSpatialReference* candidate = GetThreadLocalEpsgSrs(epsgCode);
+        if (candidate != nullptr && srs.IsSame(candidate, isSameOptions) != 0)
         {
-            return it->second;
+            return epsgCode;
         }
-        g_wktValidityCache.emplace(trimmed, valid);
     }
+    return 0;
+}
 
-    return valid;
+size_t GeoCrsManager::GetEpsgFingerprintIndexSize()
+{
+    GB_ReadLockGuard guard(g_fingerprintIndexLock);
+    return g_fingerprintIndex ? g_fingerprintIndex->size() : 0;
 }
 
-std::shared_ptr<const GeoCrs> GeoCrsManager::GetFromWktCached(const std::string& wktUtf8)
+std::uint32_t GeoCrsManager::InternCrs(const std::shared_ptr<const GeoCrs>& crs)
 {
-    EnsureInitializedInternal();
+    if (!crs || !crs->IsValid())
+    {
+        return 0;
+    }
 
-    const std::string trimmed = GB_Utf8Trim(wktUtf8);
-    if (trimmed.empty())
+    // 以 UID 去重（再用 operator== 确认）：同一 CRS 的不同 WKT 写法得到同一个 id。
+    const std::string uid = crs->GetUidUtf8();
+    if (uid.empty())
     {
-        GBLOG_WARNING(GB_STR("【GeoCrsManager::GetFromWktCached】wkt 为空。"));
-        return GetEmptyCrsShared();
+        return 0;
     }
 
     {
-        GB_ReadLockGuard readGuard(g_wktCacheLock);
-        const auto it = g_wktCache.find(trimmed);
-        if (it != g_wktCache.end())
+        std::lock_guard<std::mutex> lock(g_internMutex);
+        const std::uint32_t existingId = FindInternedIdNoLock(uid, *crs);
+        if (existingId != 0)
         {
-            return it->second;
+            return existingId;
         }
     }
 
-    std::shared_ptr<const GeoCrs> crs = std::make_shared<GeoCrs>(GeoCrs::CreateFromWkt(trimmed));
+    // 导出 WKT 较慢，在锁外完成；并发驻留同一 CRS 时只有先拿到锁的一方分配 id。
+    std::string canonicalWktUtf8 = crs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+    std::string canonicalKey = BuildCanonicalKeyInternal(*crs, uid);
 
+    std::lock_guard<std::mutex> lock(g_internMutex);
+
+    const std::uint32_t existingId = FindInternedIdNoLock(uid, *crs);
+    if (existingId != 0)
     {
-        GB_WriteLockGuard writeGuard(g_wktCacheLock);
-        const auto it = g_wktCache.find(trimmed);
-        if (it != g_wktCache.end())
-        {
-            return it->second;
-        }
-        g_wktCache.emplace(trimmed, crs);
+        return existingId;
+    }
+
+    const size_t index = static_cast<size_t>(g_internCount.load(std::memory_order_relaxed));
+    const size_t blockIndex = index / kInternBlockSize;
+    if (blockIndex >= kInternMaxBlocks)
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager::InternCrs】驻留表已满。"));
+        return 0;
     }
 
-    // 也同步写入 validity cache（避免重复解析）
+    InternedCrs* block = g_internBlocks[blockIndex].load(std::memory_order_relaxed);
+    if (block == nullptr)
     {
-        const bool valid = crs ? crs->IsValid() : false;
-        GB_WriteLockGuard writeGuard(g_wktValidityCacheLock);
-        g_wktValidityCache.emplace(trimmed, valid);
+        g_internBlockStorage.emplace_back(new InternedCrs[kInternBlockSize]);
+        block = g_internBlockStorage.back().get();
+        g_internBlocks[blockIndex].store(block, std::memory_order_release);
     }
 
-    return crs;
+    InternedCrs& entry = block[index % kInternBlockSize];
+    entry.crs = crs;
+    entry.canonicalWktUtf8 = std::move(canonicalWktUtf8);
+    entry.canonicalKey = std::move(canonicalKey);
+
+    const std::uint32_t crsId = static_cast<std::uint32_t>(index + 1);
+    g_internCount.store(crsId, std::memory_order_release);
+    g_internIdByUid.emplace(uid, crsId);
+    return crsId;
 }
 
-bool GeoCrsManager::TryGetValidAreasCached(const std::string& wktUtf8, GeoBoundingBox& outLonLatArea, GeoBoundingBox& outSelfArea)
+std::uint32_t GeoCrsManager::InternCrs(const std::string& wktUtf8)
 {
-    EnsureInitializedInternal();
-
-    const std::string trimmed = GB_Utf8Trim(wktUtf8);
+    std::string trimmedStorage;
+    const std::string& trimmed = TrimForLookupUtf8(wktUtf8, trimmedStorage);
     if (trimmed.empty())
     {
-        outLonLatArea = GeoBoundingBox();
-        outSelfArea = GeoBoundingBox();
-        return false;
+        return 0;
     }
 
+    std::uint32_t crsId = 0;
+    if (g_internWktCache.TryGet(trimmed, crsId))
     {
-        GB_ReadLockGuard readGuard(g_validAreaCacheLock);
-        const auto it = g_validAreaCache.find(trimmed);
-        if (it != g_validAreaCache.end())
-        {
-            outLonLatArea = it->second.lonLatArea;
-            outSelfArea = it->second.selfArea;
-            return outLonLatArea.IsValid() && outSelfArea.IsValid();
-        }
+        return crsId;
     }
 
-    // 复用 CRS 缓存（优先），避免重复解析。
-    std::shared_ptr<const GeoCrs> crs;
+    crsId = InternCrs(GetFromWktCached(trimmed));
+    if (crsId != 0)
     {
-        GB_ReadLockGuard readGuard(g_wktCacheLock);
-        const auto it = g_wktCache.find(trimmed);
-        if (it != g_wktCache.end())
-        {
-            crs = it->second;
-        }
+        g_internWktCache.GetOrInsert(trimmed, crsId);
     }
+    return crsId;
+}
 
-    if (!crs)
+std::uint32_t GeoCrsManager::FindCrsId(const std::string& wktUtf8)
+{
+    std::string trimmedStorage;
+    const std::string& trimmed = TrimForLookupUtf8(wktUtf8, trimmedStorage);
+    if (trimmed.empty() || GetInternedCrsCount() == 0)
     {
-        const std::shared_ptr<const GeoCrs> created = std::make_shared<GeoCrs>(GeoCrs::CreateFromWkt(trimmed));
+        return 0;
+    }
 
-        GB_WriteLockGuard writeGuard(g_wktCacheLock);
-        const auto it = g_wktCache.find(trimmed);
-        if (it != g_wktCache.end())
-        {
-            crs = it->second;
-        }
-        else
-        {
-            crs = created;
-            g_wktCache.emplace(trimmed, crs);
-        }
+    std::uint32_t crsId = 0;
+    if (g_internWktCache.TryGet(trimmed, crsId))
+    {
+        return crsId;
     }
 
-    ValidAreas areas;
-    if (crs)
+    const std::shared_ptr<const GeoCrs> crs = GetFromWktCached(trimmed);
+    if (!crs || !crs->IsValid())
     {
-        areas.lonLatArea = crs->GetValidAreaLonLat();
-        areas.selfArea = crs->GetValidArea();
+        return 0;
     }
 
+    const std::string uid = crs->GetUidUtf8();
     {
-        GB_WriteLockGuard writeGuard(g_validAreaCacheLock);
-        const auto it = g_validAreaCache.find(trimmed);
-        if (it != g_validAreaCache.end())
+        std::lock_guard<std::mutex> lock(g_internMutex);
+        crsId = FindInternedIdNoLock(uid, *crs);
+        if (crsId == 0)
         {
-            outLonLatArea = it->second.lonLatArea;
-            outSelfArea = it->second.selfArea;
-            return outLonLatArea.IsValid() && outSelfArea.IsValid();
+            return 0;
         }
-
-        g_validAreaCache.emplace(trimmed, areas);
     }
 
-    outLonLatArea = areas.lonLatArea;
-    outSelfArea = areas.selfArea;
-    return outLonLatArea.IsValid() && outSelfArea.IsValid();
+    g_internWktCache.GetOrInsert(trimmed, crsId);
+    return crsId;
+}
+
+std::shared_ptr<const GeoCrs> GeoCrsManager::GetFromCrsId(std::uint32_t crsId)
+{
+    const InternedCrs* entry = GetInternedCrs(crsId);
+    return (entry != nullptr) ? entry->crs : nullptr;
+}
+
+const std::string& GeoCrsManager::GetCrsIdWktUtf8(std::uint32_t crsId)
+{
+    static const std::string emptyWkt = "";
+
+    const InternedCrs* entry = GetInternedCrs(crsId);
+    return (entry != nullptr) ? entry->canonicalWktUtf8 : emptyWkt;
+}
+
+size_t GeoCrsManager::GetInternedCrsCount()
+{
+    return static_cast<size_t>(g_internCount.load(std::memory_order_acquire));
 }
 
 size_t GeoCrsManager::GetCachedEpsgCount()
 {
-    GB_ReadLockGuard guard(g_epsgCacheLock);
-    return g_epsgCache.size();
+    return g_epsgCache.Size();
+}
+
+GeoCrsManager::CacheCounters GeoCrsManager::GetEpsgCacheCounters()
+{
+    return g_epsgCache.GetCounters();
 }
 
 size_t GeoCrsManager::GetCachedWktCount()
 {
-    GB_ReadLockGuard guard(g_wktCacheLock);
-    return g_wktCache.size();
+    return g_wktCache.Size();
+}
+
+GeoCrsManager::CacheCounters GeoCrsManager::GetWktCacheCounters()
+{
+    return g_wktCache.GetCounters();
 }
 
 size_t GeoCrsManager::GetCachedDefinitionCount()
 {
-    GB_ReadLockGuard guard(g_definitionCacheLock);
-    return g_definitionCache.size();
+    return g_definitionCache.Size();
+}
+
+GeoCrsManager::CacheCounters GeoCrsManager::GetDefinitionCacheCounters()
+{
+    return g_definitionCache.GetCounters();
 }
 
 size_t GeoCrsManager::GetCachedValidAreaCount()
 {
-    GB_ReadLockGuard guard(g_validAreaCacheLock);
-    return g_validAreaCache.size();
+    return g_validAreaCache.Size();
+}
+
+GeoCrsManager::CacheCounters GeoCrsManager::GetValidAreaCacheCounters()
+{
+    return g_validAreaCache.GetCounters();
+}
+
+size_t GeoCrsManager::GetCachedCanonicalCrsCount()
+{
+    return g_canonicalCrsRegistry.Size();
+}
+
+void GeoCrsManager::SetCacheMemoryBudget(size_t bytes)
+{
+    ApplyCacheMemoryBudgetInternal(bytes);
+}
+
+size_t GeoCrsManager::GetCacheMemoryBudget()
+{
+    return g_cacheMemoryBudget.load(std::memory_order_relaxed);
+}
+
+GeoCrsManager::CacheMemoryGauge GeoCrsManager::GetEpsgCacheMemoryGauge()
+{
+    return g_epsgCache.GetMemoryGauge();
+}
+
+GeoCrsManager::CacheMemoryGauge GeoCrsManager::GetWktCacheMemoryGauge()
+{
+    return g_wktCache.GetMemoryGauge();
+}
+
+GeoCrsManager::CacheMemoryGauge GeoCrsManager::GetWktValidityCacheMemoryGauge()
+{
+    return g_wktValidityCache.GetMemoryGauge();
+}
+
+GeoCrsManager::CacheMemoryGauge GeoCrsManager::GetDefinitionCacheMemoryGauge()
+{
+    return g_definitionCache.GetMemoryGauge();
+}
+
+GeoCrsManager::CacheMemoryGauge GeoCrsManager::GetValidAreaCacheMemoryGauge()
+{
+    return g_validAreaCache.GetMemoryGauge();
+}
+
+GeoCrsManager::CacheMemoryGauge GeoCrsManager::GetTotalCacheMemoryGauge()
+{
+    CacheMemoryGauge total;
+    AddMemoryGauge(total, g_epsgCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_wktCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_wktValidityCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_definitionCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_validAreaCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_metadataCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_frozenEpsgCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_frozenWktCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_footprintCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_internWktCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_canonicalValidAreaCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_canonicalFrozenCache.GetMemoryGauge());
+    AddMemoryGauge(total, g_canonicalFootprintCache.GetMemoryGauge());
+
+    const size_t registryBytes = g_canonicalCrsRegistry.GetApproximateBytes();
+    total.approximateBytes += registryBytes;
+    total.pinnedBytes += registryBytes;
+    return total;
 }
 
 void GeoCrsManager::EnsureInitializedInternal()
@@ -1034,42 +4565,64 @@ void GeoCrsManager::EnsureInitializedInternal()
         return;
     }
 
-    // 1) 如果外部已经配置了 PROJ search paths，并且其中能找到 proj.db，则直接采用
-    const std::string existingDir = FindProjDatabaseDirByExistingProjPaths();
-    if (!existingDir.empty())
-    {
-        g_projDatabaseDirUtf8 = existingDir;
-        g_isInitialized.store(true, std::memory_order_release);
-        return;
-    }
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    LoadCacheMemoryBudgetAtInitInternal();
 
-    // 2) 否则按策略自动查找
-    const std::string cwd = GetCurrentWorkingDirectoryUtf8();
-    const std::string exeDir = GB_GetExeDirectory();
+    // 1) 如果外部已经配置了 PROJ search paths，并且其中能找到 proj.db，则直接采用
+    std::string found = FindProjDatabaseDirByExistingProjPaths();
 
-    std::string found;
-    if (!cwd.empty())
-    {
-        found = FindProjDatabaseDirBySearching(cwd);
-    }
-    if (found.empty() && !exeDir.empty())
+    // 2) 否则先查状态文件（只检查记录的 proj.db 是否仍存在），未命中再按策略自动查找
+    if (found.empty())
     {
-        found = FindProjDatabaseDirBySearching(exeDir);
-    }
+        const std::string cwd = GetCurrentWorkingDirectoryUtf8();
+        const std::string exeDir = GB_GetExeDirectory();
 
-    if (!found.empty())
-    {
-        if (ApplyProjDatabaseDirectoryUtf8Internal(found))
+        found = TryRestoreProjDbDirFromStateInternal(cwd, exeDir);
+        const bool restored = !found.empty();
+        if (!restored && !cwd.empty())
         {
-            g_projDatabaseDirUtf8 = found;
-            g_isInitialized.store(true, std::memory_order_release);
-            return;
+            found = FindProjDatabaseDirBySearching(cwd);
+        }
+        if (!restored && found.empty() && !exeDir.empty())
+        {
+            found = FindProjDatabaseDirBySearching(exeDir);
+        }
+
+        if (!found.empty() && !ApplyProjDatabaseDirectoryUtf8Internal(found))
+        {
+            found.clear();
+        }
+        else if (!found.empty())
+        {
+            g_initRestoredFromState.store(restored, std::memory_order_relaxed);
+            if (!restored)
+            {
+                SaveProjDbDirToStateInternal(cwd, exeDir, found);
+            }
         }
     }
 
     // 3) 找不到也视为“初始化完成”：避免每次都进行大范围扫描。
     //    这种情况下，GeoCrs/OGR 会继续使用系统默认的 PROJ 配置（若存在）。
-    g_projDatabaseDirUtf8.clear();
+    g_projDatabaseDirUtf8 = found;
+    GeoCrs::SetValidAreaTableHook(&LookupEpsgValidAreaTableHook);
+    GeoCrs::SetEpsgIdentifyHook(&GeoCrsManager::IdentifyEpsgByFingerprint);
+    if (!found.empty())
+    {
+        LoadPersistentFileAtInitInternal(found);
+        LoadEpsgAreaTableAtInitInternal(found);
+        LoadFingerprintIndexAtInitInternal(found);
+    }
+
+    const std::uint64_t elapsedNanoseconds = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    g_initNanoseconds.store(elapsedNanoseconds, std::memory_order_relaxed);
+    g_initInBackground.store(t_isBackgroundInitThread, std::memory_order_relaxed);
     g_isInitialized.store(true, std::memory_order_release);
-    GBLOG_WARNING(GB_STR("【GeoCrsManager】未能自动定位 proj.db，将使用系统默认 PROJ 配置。"));
+
+    if (found.empty())
+    {
+        GBLOG_WARNING(GB_STR("【GeoCrsManager】未能自动定位 proj.db，将使用系统默认 PROJ 配置。"));
+        return;
+    }
+    GBLOG_INFO(GB_STR("【GeoCrsManager】初始化完成: ") + found + GB_STR(" (耗时=") + std::to_string(elapsedNanoseconds / 1000000) + GB_STR("ms)"));
 }
@@ -3,8 +3,10 @@
 #include "GeoBoundingBox.h"
 #include "GeoCrs.h"
 #include "GeoCrsManager.h"
+#include "MapWeaverParallel.h"
 
 #include "GB_Logger.h"
+#include "GB_ReadWriteLock.h"
 #include "GB_Utf8String.h"
 
 #include "Geometry/GB_Point2d.h"
@@ -19,9 +21,18 @@
 #include <memory>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <limits>
+#include <list>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -46,6 +57,9 @@ namespace
     using CoordinateTransformationPtr = std::unique_ptr<OGRCoordinateTransformation, CoordinateTransformationDeleter>;
     using OgrSrsPtr = std::unique_ptr<OGRSpatialReference, GeoCrsOgrSrsDeleter>;
 
+    // 批量转换的分块大小：既是一次 OGR Transform 调用的点数，也是 OpenMP 的调度粒度。
+    constexpr size_t kTransformChunkSize = 4096;
+
     static bool IsFinite(double value)
     {
         return std::isfinite(value);
@@ -82,14 +96,16 @@ namespace
         return normalized;
     }
 
+    // 以两侧 128 位内容哈希（GeoCrs::GetContentHash128）为 key：查找只需整数比较，无需构造/哈希字符串。
+    // 不用 UID：EPSG UID 只取自根 AUTHORITY，改动过参数但保留权威码的 WKT 会错用原坐标系的转换与规范化 WKT。
     struct TransformKey
     {
-        std::string sourceUid;
-        std::string targetUid;
+        GeoCrs::Uid128 sourceHash;
+        GeoCrs::Uid128 targetHash;
 
         bool operator==(const TransformKey& other) const
         {
-            return sourceUid == other.sourceUid && targetUid == other.targetUid;
+            return sourceHash == other.sourceHash && targetHash == other.targetHash;
         }
     };
 
@@ -97,691 +113,3245 @@ namespace
     {
         size_t operator()(const TransformKey& key) const
         {
-            const std::hash<std::string> hasher;
-            size_t hashValue = hasher(key.sourceUid);
-            hashValue ^= hasher(key.targetUid) + 0x9e3779b97f4a7c15ULL + (hashValue << 6) + (hashValue >> 2);
-            return hashValue;
+            std::uint64_t hashValue = key.sourceHash.high ^ (key.sourceHash.low * 0x9e3779b97f4a7c15ULL);
+            hashValue ^= key.targetHash.high + 0x9e3779b97f4a7c15ULL + (hashValue << 6) + (hashValue >> 2);
+            hashValue ^= key.targetHash.low * 0xff51afd7ed558ccdULL;
+            return static_cast<size_t>(hashValue ^ (hashValue >> 32));
         }
     };
 
-    struct TransformItem
-    {
-        OgrSrsPtr sourceSrs;
-        OgrSrsPtr targetSrs;
-        CoordinateTransformationPtr transform;
+    // -------------------- 快速路径：WGS84 经纬度 / WebMercator / WGS84 UTM 之间的闭式解 --------------------
+    //
+    // 这些 CRS 对占了瓦片流量的绝大部分。它们之间的转换都是同一椭球（WGS84）上的纯投影运算，
+    // 因此可以绕开 PROJ 通用管线，在 SoA 数组上直接用闭式公式计算（见 ApplyFastTransform 的核函数分派）。
+    // 精度（与 PROJ 结果之差）：
+    //  - EPSG:4326 <-> EPSG:3857：浮点舍入级（< 1e-6 m）；
+    //  - UTM（6 阶 Krüger 级数，即 PROJ etmerc 所用算法）：距中央经线 kFastUtmMaxDeltaLonDegrees 以内 < 1 mm。
+    // 超出上述定义域的点（极区、远离中央经线、非有限值等）不由快速路径处理，仍交给 PROJ，保证结果语义一致。
+    // 创建 TransformItem 时会用一组采样点将快速路径与 PROJ 的结果对比，超差则禁用快速路径。
 
-        bool sourceIsGeographic = false;
-        bool targetIsGeographic = false;
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kDegToRad = kPi / 180.0;
+    constexpr double kRadToDeg = 180.0 / kPi;
 
-        // 源 CRS 的自身有效范围（便于 bbox 求交/点的可选归一化判断）
-        GB_Rectangle sourceValidRect;
-        bool hasSourceValidRect = false;
+    constexpr double kWgs84SemiMajorAxis = 6378137.0;
+    constexpr double kWgs84InverseFlattening = 298.257223563;
 
-        std::string canonicalTargetWkt;
+    constexpr double kWebMercatorMaxLatitudeDegrees = 89.5;
+    constexpr double kFastUtmMaxDeltaLonDegrees = 30.0;
+    constexpr double kFastUtmMaxLatitudeDegrees = 84.5;
+
+    // 与 PROJ 对比时允许的最大偏差：投影坐标（米）/ 经纬度（度，约 1 mm）。
+    constexpr double kFastPathProjectedTolerance = 1e-3;
+    constexpr double kFastPathGeographicTolerance = 1e-8;
+
+    enum class FastCrsKind
+    {
+        None,
+        Wgs84LonLat,
+        WebMercator,
+        Utm
+    };
+
+    struct FastCrs
+    {
+        FastCrsKind kind = FastCrsKind::None;
+        double centralMeridianDegrees = 0.0; // 仅 UTM
+        double falseNorthing = 0.0;          // 仅 UTM（南半球 10000000）
     };
 
-    static thread_local std::unordered_map<TransformKey, TransformItem, TransformKeyHasher> g_threadTransformCache;
+    struct FastTransform
+    {
+        bool enabled = false;
+        FastCrs source;
+        FastCrs target;
+    };
 
-    static bool TryGetTransformItem(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, TransformItem*& outItem)
+    struct KruegerCoefficients
     {
-        outItem = nullptr;
+        double e = 0.0;             // 第一偏心率
+        double scaledA = 0.0;       // k0 * A（A 为子午线矩形化半径）
+        double alpha[6] = { 0.0 };  // 正算级数
+        double beta[6] = { 0.0 };   // 反算级数
+    };
 
-        const std::string trimmedSourceWkt = GB_Utf8Trim(sourceWktUtf8);
-        const std::string trimmedTargetWkt = GB_Utf8Trim(targetWktUtf8);
-        if (trimmedSourceWkt.empty() || trimmedTargetWkt.empty())
+    static const KruegerCoefficients& GetUtmKruegerCoefficients()
+    {
+        static const KruegerCoefficients coefficients = []() {
+            KruegerCoefficients c;
+            const double f = 1.0 / kWgs84InverseFlattening;
+            const double n = f / (2.0 - f);
+            const double n2 = n * n;
+            const double n3 = n2 * n;
+            const double n4 = n3 * n;
+            const double n5 = n4 * n;
+            const double n6 = n5 * n;
+
+            c.e = std::sqrt(f * (2.0 - f));
+            c.scaledA = 0.9996 * kWgs84SemiMajorAxis / (1.0 + n) * (1.0 + n2 / 4.0 + n4 / 64.0 + n6 / 256.0);
+
+            c.alpha[0] = n / 2.0 - 2.0 * n2 / 3.0 + 5.0 * n3 / 16.0 + 41.0 * n4 / 180.0 - 127.0 * n5 / 288.0 + 7891.0 * n6 / 37800.0;
+            c.alpha[1] = 13.0 * n2 / 48.0 - 3.0 * n3 / 5.0 + 557.0 * n4 / 1440.0 + 281.0 * n5 / 630.0 - 1983433.0 * n6 / 1935360.0;
+            c.alpha[2] = 61.0 * n3 / 240.0 - 103.0 * n4 / 140.0 + 15061.0 * n5 / 26880.0 + 167603.0 * n6 / 181440.0;
+            c.alpha[3] = 49561.0 * n4 / 161280.0 - 179.0 * n5 / 168.0 + 6601661.0 * n6 / 7257600.0;
+            c.alpha[4] = 34729.0 * n5 / 80640.0 - 3418889.0 * n6 / 1995840.0;
+            c.alpha[5] = 212378941.0 * n6 / 319334400.0;
+
+            c.beta[0] = n / 2.0 - 2.0 * n2 / 3.0 + 37.0 * n3 / 96.0 - n4 / 360.0 - 81.0 * n5 / 512.0 + 96199.0 * n6 / 604800.0;
+            c.beta[1] = n2 / 48.0 + n3 / 15.0 - 437.0 * n4 / 1440.0 + 46.0 * n5 / 105.0 - 1118711.0 * n6 / 3870720.0;
+            c.beta[2] = 17.0 * n3 / 480.0 - 37.0 * n4 / 840.0 - 209.0 * n5 / 4480.0 + 5569.0 * n6 / 90720.0;
+            c.beta[3] = 4397.0 * n4 / 161280.0 - 11.0 * n5 / 504.0 - 830251.0 * n6 / 7257600.0;
+            c.beta[4] = 4583.0 * n5 / 161280.0 - 108847.0 * n6 / 3991680.0;
+            c.beta[5] = 20648693.0 * n6 / 638668800.0;
+            return c;
+        }();
+        return coefficients;
+    }
+
+    static FastCrs DetectFastCrsByEpsgCode(int epsgCode)
+    {
+        FastCrs crs;
+        if (epsgCode == 4326)
         {
-            return false;
+            crs.kind = FastCrsKind::Wgs84LonLat;
         }
-
-        const std::shared_ptr<const GeoCrs> sourceCrs = GeoCrsManager::GetFromWktCached(trimmedSourceWkt);
-        const std::shared_ptr<const GeoCrs> targetCrs = GeoCrsManager::GetFromWktCached(trimmedTargetWkt);
-        if (!sourceCrs || !targetCrs || !sourceCrs->IsValid() || !targetCrs->IsValid())
+        else if (epsgCode == 3857)
         {
-            return false;
+            crs.kind = FastCrsKind::WebMercator;
         }
-
-        const std::string sourceUid = sourceCrs->GetUidUtf8();
-        const std::string targetUid = targetCrs->GetUidUtf8();
-        if (sourceUid.empty() || targetUid.empty())
+        else if ((epsgCode >= 32601 && epsgCode <= 32660) || (epsgCode >= 32701 && epsgCode <= 32760))
         {
-            return false;
+            // WGS 84 / UTM zone xxN（326xx）与 xxS（327xx）。
+            const int zone = epsgCode % 100;
+            crs.kind = FastCrsKind::Utm;
+            crs.centralMeridianDegrees = -183.0 + 6.0 * static_cast<double>(zone);
+            crs.falseNorthing = (epsgCode >= 32701) ? 10000000.0 : 0.0;
         }
+        return crs;
+    }
 
-        TransformKey key;
-        key.sourceUid = sourceUid;
-        key.targetUid = targetUid;
-
-        auto it = g_threadTransformCache.find(key);
-        if (it != g_threadTransformCache.end())
+    // 依据根节点的 EPSG 权威码识别，并确认内容确实是该 EPSG 定义（保留权威码但改过参数的 WKT 不走快速路径）。
+    static FastCrs DetectFastCrs(const GeoCrs& crs)
+    {
+        const int epsgCode = crs.TryGetEpsgCode(false, false, 0);
+        const FastCrs fastCrs = DetectFastCrsByEpsgCode(epsgCode);
+        if (fastCrs.kind == FastCrsKind::None || !crs.MatchesEpsgDefinition(epsgCode))
         {
-            outItem = &it->second;
-            return it->second.transform != nullptr;
+            return FastCrs();
         }
+        return fastCrs;
+    }
 
-        TransformItem item;
-        item.sourceIsGeographic = sourceCrs->IsGeographic();
-        item.targetIsGeographic = targetCrs->IsGeographic();
-
-        // 取源 CRS 的自身有效范围（如果可用）
+    static double DeltaLongitudeDegrees(double longitude, double centralMeridian)
+    {
+        double delta = longitude - centralMeridian;
+        if (delta > 180.0)
         {
-            GeoBoundingBox lonLatArea;
-            GeoBoundingBox selfArea;
-            GeoCrsManager::TryGetValidAreasCached(trimmedSourceWkt, lonLatArea, selfArea);
-            if (selfArea.IsValid())
-            {
-                item.sourceValidRect = selfArea.rect;
-                item.hasSourceValidRect = selfArea.rect.IsValid();
-            }
+            delta -= 360.0;
         }
-
-        // 使用目标 CRS 的规范化 WKT（WKT2_2018），确保输出 GeoBoundingBox 的 wktUtf8 稳定。
-        item.canonicalTargetWkt = targetCrs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
-        if (item.canonicalTargetWkt.empty())
+        else if (delta < -180.0)
         {
-            // 兜底：至少保留用户输入。
-            item.canonicalTargetWkt = trimmedTargetWkt;
+            delta += 360.0;
         }
+        return delta;
+    }
 
-        const OGRSpatialReference& sourceRef = sourceCrs->GetConstRef();
-        const OGRSpatialReference& targetRef = targetCrs->GetConstRef();
-
-        item.sourceSrs.reset(sourceRef.Clone());
-        item.targetSrs.reset(targetRef.Clone());
-        if (!item.sourceSrs || !item.targetSrs)
+    // 经纬度（度）-> UTM（米）。
+    static bool FastUtmForward(const FastCrs& crs, double longitude, double latitude, double& outX, double& outY)
+    {
+        const double deltaLon = DeltaLongitudeDegrees(longitude, crs.centralMeridianDegrees);
+        if (!(std::fabs(deltaLon) <= kFastUtmMaxDeltaLonDegrees) || !(std::fabs(latitude) <= kFastUtmMaxLatitudeDegrees))
         {
             return false;
         }
 
-        EnsureTraditionalGisAxisOrder(*item.sourceSrs);
-        EnsureTraditionalGisAxisOrder(*item.targetSrs);
+        const KruegerCoefficients& c = GetUtmKruegerCoefficients();
+        const double phi = latitude * kDegToRad;
+        const double lambda = deltaLon * kDegToRad;
 
-        item.transform.reset(OGRCreateCoordinateTransformation(item.sourceSrs.get(), item.targetSrs.get()));
-        if (item.transform == nullptr)
+        const double sinPhi = std::sin(phi);
+        const double t = std::sinh(std::atanh(sinPhi) - c.e * std::atanh(c.e * sinPhi));
+        const double xiPrime = std::atan2(t, std::cos(lambda));
+        const double etaPrime = std::atanh(std::sin(lambda) / std::sqrt(1.0 + t * t));
+
+        double xi = xiPrime;
+        double eta = etaPrime;
+        for (int j = 0; j < 6; j++)
         {
-            return false;
+            const double k = 2.0 * static_cast<double>(j + 1);
+            xi += c.alpha[j] * std::sin(k * xiPrime) * std::cosh(k * etaPrime);
+            eta += c.alpha[j] * std::cos(k * xiPrime) * std::sinh(k * etaPrime);
         }
 
-        auto insertResult = g_threadTransformCache.emplace(std::move(key), std::move(item));
-        outItem = &insertResult.first->second;
-        return outItem->transform != nullptr;
+        outX = 500000.0 + c.scaledA * eta;
+        outY = crs.falseNorthing + c.scaledA * xi;
+        return true;
     }
 
-    static bool TryTransformSingleXYInternal(TransformItem& item, double x, double y, double& outX, double& outY)
+    // UTM（米）-> 经纬度（度）。
+    static bool FastUtmInverse(const FastCrs& crs, double x, double y, double& outLongitude, double& outLatitude)
     {
-        outX = x;
-        outY = y;
+        const KruegerCoefficients& c = GetUtmKruegerCoefficients();
+        const double xi = (y - crs.falseNorthing) / c.scaledA;
+        const double eta = (x - 500000.0) / c.scaledA;
 
-        if (!IsFinite(x) || !IsFinite(y) || item.transform == nullptr)
+        // 远离中央经线（约 30° 以外）时级数精度下降，交给 PROJ。
+        if (!(std::fabs(eta) <= 0.6) || !(std::fabs(xi) <= kPi / 2.0))
         {
             return false;
         }
 
-        // 对 Geographic CRS 的经度做适度归一化，减少“超范围但等价”的失败。
-        double inputX = x;
-        double inputY = y;
-        if (item.sourceIsGeographic)
+        double xiPrime = xi;
+        double etaPrime = eta;
+        for (int j = 0; j < 6; j++)
         {
-            inputX = NormalizeLongitudeDegrees(inputX);
+            const double k = 2.0 * static_cast<double>(j + 1);
+            xiPrime -= c.beta[j] * std::sin(k * xi) * std::cosh(k * eta);
+            etaPrime -= c.beta[j] * std::cos(k * xi) * std::sinh(k * eta);
         }
 
-        int successFlag = FALSE;
-        double transformedX = inputX;
-        double transformedY = inputY;
-        const int overallOk = item.transform->Transform(1, &transformedX, &transformedY, nullptr, &successFlag);
+        const double sinhEtaPrime = std::sinh(etaPrime);
+        const double sinXiPrime = std::sin(xiPrime);
+        const double cosXiPrime = std::cos(xiPrime);
+        const double lambda = std::atan2(sinhEtaPrime, cosXiPrime);
 
-        if (overallOk == FALSE || successFlag == FALSE || !IsFinite(transformedX) || !IsFinite(transformedY))
+        // tau' = tan(共形纬度)；用牛顿迭代由 tau' 反解 tau = tan(phi)（Karney 2011）。
+        const double tauPrime = sinXiPrime / std::sqrt(sinhEtaPrime * sinhEtaPrime + cosXiPrime * cosXiPrime);
+        const double oneMinusE2 = 1.0 - c.e * c.e;
+        double tau = tauPrime;
+        for (int iteration = 0; iteration < 5; iteration++)
         {
-            return false;
+            const double sqrtOnePlusTau2 = std::sqrt(1.0 + tau * tau);
+            const double sigma = std::sinh(c.e * std::atanh(c.e * tau / sqrtOnePlusTau2));
+            const double tauPrimeI = tau * std::sqrt(1.0 + sigma * sigma) - sigma * sqrtOnePlusTau2;
+            const double deltaTau = (tauPrime - tauPrimeI) / std::sqrt(1.0 + tauPrimeI * tauPrimeI) *
+                (1.0 + oneMinusE2 * tau * tau) / (oneMinusE2 * sqrtOnePlusTau2);
+            tau += deltaTau;
+            if (std::fabs(deltaTau) < 1e-14)
+            {
+                break;
+            }
         }
 
-        // 若目标是 Geographic CRS，也进行经度归一化。跨日期线时，单点归一化是安全的。
-        if (item.targetIsGeographic)
+        const double latitude = std::atan(tau) * kRadToDeg;
+        const double deltaLon = lambda * kRadToDeg;
+        if (!(std::fabs(deltaLon) <= kFastUtmMaxDeltaLonDegrees) || !(std::fabs(latitude) <= kFastUtmMaxLatitudeDegrees))
         {
-            transformedX = NormalizeLongitudeDegrees(transformedX);
+            return false;
         }
 
-        outX = transformedX;
-        outY = transformedY;
+        outLongitude = NormalizeLongitudeDegrees(crs.centralMeridianDegrees + deltaLon);
+        outLatitude = latitude;
         return true;
     }
 
-    static bool TryTransformSingleXYZInternal(TransformItem& item, double x, double y, double z, double& outX, double& outY, double& outZ)
+    static bool FastToLonLat(const FastCrs& crs, double x, double y, double& outLongitude, double& outLatitude)
     {
-        outX = x;
-        outY = y;
-        outZ = z;
-
-        if (!IsFinite(x) || !IsFinite(y) || !IsFinite(z) || item.transform == nullptr)
+        switch (crs.kind)
         {
+        case FastCrsKind::Wgs84LonLat:
+            if (!(std::fabs(x) <= 180.0) || !(std::fabs(y) <= 90.0))
+            {
+                return false;
+            }
+            outLongitude = x;
+            outLatitude = y;
+            return true;
+        case FastCrsKind::WebMercator:
+            if (!(std::fabs(x) <= kPi * kWgs84SemiMajorAxis) || !IsFinite(y))
+            {
+                return false;
+            }
+            outLongitude = x / kWgs84SemiMajorAxis * kRadToDeg;
+            outLatitude = std::atan(std::sinh(y / kWgs84SemiMajorAxis)) * kRadToDeg;
+            return true;
+        case FastCrsKind::Utm:
+            return FastUtmInverse(crs, x, y, outLongitude, outLatitude);
+        default:
             return false;
         }
+    }
 
-        double inputX = x;
-        double inputY = y;
-        double inputZ = z;
-        if (item.sourceIsGeographic)
+    static bool FastFromLonLat(const FastCrs& crs, double longitude, double latitude, double& outX, double& outY)
+    {
+        switch (crs.kind)
         {
-            inputX = NormalizeLongitudeDegrees(inputX);
+        case FastCrsKind::Wgs84LonLat:
+            outX = longitude;
+            outY = latitude;
+            return true;
+        case FastCrsKind::WebMercator:
+            if (!(std::fabs(latitude) <= kWebMercatorMaxLatitudeDegrees))
+            {
+                return false;
+            }
+            outX = kWgs84SemiMajorAxis * longitude * kDegToRad;
+            outY = kWgs84SemiMajorAxis * std::atanh(std::sin(latitude * kDegToRad));
+            return true;
+        case FastCrsKind::Utm:
+            return FastUtmForward(crs, longitude, latitude, outX, outY);
+        default:
+            return false;
         }
+    }
 
-        int successFlag = FALSE;
-        const int overallOk = item.transform->Transform(1, &inputX, &inputY, &inputZ, &successFlag);
-
-        if (overallOk == FALSE || successFlag == FALSE || !IsFinite(inputX) || !IsFinite(inputY) || !IsFinite(inputZ))
+    // 经纬度 -> WebMercator 核函数：循环体没有分支与按类型的分派（先计算，再按定义域条件选择写回），
+    // 编译器可借助向量数学库（如 MSVC /O2 下的 sin/atanh 向量版本）自动向量化。
+    static size_t ApplyLonLatToWebMercatorKernel(size_t count, double* x, double* y, int* handled)
+    {
+        size_t handledCount = 0;
+        for (size_t i = 0; i < count; i++)
         {
-            return false;
+            const double longitude = x[i];
+            const double latitude = y[i];
+            const double outX = kWgs84SemiMajorAxis * longitude * kDegToRad;
+            const double outY = kWgs84SemiMajorAxis * std::atanh(std::sin(latitude * kDegToRad));
+
+            // NaN 使比较为假，因此无需单独判断有限性。
+            const bool ok = std::fabs(longitude) <= 180.0 && std::fabs(latitude) <= kWebMercatorMaxLatitudeDegrees && std::fabs(outY) <= kPi * kWgs84SemiMajorAxis * 2.0;
+            x[i] = ok ? outX : longitude;
+            y[i] = ok ? outY : latitude;
+            handled[i] = ok ? TRUE : FALSE;
+            handledCount += ok ? 1 : 0;
         }
+        return handledCount;
+    }
 
-        if (item.targetIsGeographic)
+    // WebMercator -> 经纬度核函数（无分支，说明同上）。
+    static size_t ApplyWebMercatorToLonLatKernel(size_t count, double* x, double* y, int* handled)
+    {
+        size_t handledCount = 0;
+        for (size_t i = 0; i < count; i++)
         {
-            inputX = NormalizeLongitudeDegrees(inputX);
+            const double mercatorX = x[i];
+            const double mercatorY = y[i];
+            const double longitude = mercatorX / kWgs84SemiMajorAxis * kRadToDeg;
+            const double latitude = std::atan(std::sinh(mercatorY / kWgs84SemiMajorAxis)) * kRadToDeg;
+
+            const bool ok = std::fabs(mercatorX) <= kPi * kWgs84SemiMajorAxis && std::fabs(mercatorY) <= std::numeric_limits<double>::max();
+            x[i] = ok ? longitude : mercatorX;
+            y[i] = ok ? latitude : mercatorY;
+            handled[i] = ok ? TRUE : FALSE;
+            handledCount += ok ? 1 : 0;
         }
-
-        outX = inputX;
-        outY = inputY;
-        outZ = inputZ;
-        return true;
+        return handledCount;
     }
 
-    static void AppendRectangleGridSamples(const GB_Rectangle& rect, int sampleGridCount, std::vector<double>& xs, std::vector<double>& ys)
+    // 通用标量核函数：涉及 UTM 的组合含级数与牛顿迭代（带提前退出），逐点计算。
+    static size_t ApplyScalarFastTransformKernel(const FastTransform& fast, size_t count, double* x, double* y, int* handled)
     {
-        const int count = std::max(2, sampleGridCount);
-        xs.reserve(xs.size() + static_cast<size_t>(count) * static_cast<size_t>(count));
-        ys.reserve(ys.size() + static_cast<size_t>(count) * static_cast<size_t>(count));
-
-        for (int yIndex = 0; yIndex < count; yIndex++)
+        size_t handledCount = 0;
+        for (size_t i = 0; i < count; i++)
         {
-            const double yT = (count <= 1) ? 0 : static_cast<double>(yIndex) / static_cast<double>(count - 1);
-            const double y = rect.minY + (rect.maxY - rect.minY) * yT;
-
-            for (int xIndex = 0; xIndex < count; xIndex++)
+            double longitude = 0.0;
+            double latitude = 0.0;
+            double outX = 0.0;
+            double outY = 0.0;
+            const bool ok = FastToLonLat(fast.source, x[i], y[i], longitude, latitude) &&
+                FastFromLonLat(fast.target, longitude, latitude, outX, outY) &&
+                IsFinite(outX) && IsFinite(outY);
+
+            handled[i] = ok ? TRUE : FALSE;
+            if (ok)
             {
-                const double xT = (count <= 1) ? 0 : static_cast<double>(xIndex) / static_cast<double>(count - 1);
-                const double x = rect.minX + (rect.maxX - rect.minX) * xT;
-                xs.push_back(x);
-                ys.push_back(y);
+                x[i] = outX;
+                y[i] = outY;
+                handledCount++;
             }
         }
+        return handledCount;
     }
 
-    static bool TryTransformRectangleToAabbInternal(TransformItem& item, const GB_Rectangle& sourceRect, int sampleGridCount, GB_Rectangle& outTargetRect)
+    // 对 count 个点原地执行快速路径；handled[i] 标记该点是否已由快速路径完成（未完成的点保持原值）。
+    // 按 CRS 类型组合在循环外选择核函数，循环内不再逐点分派。
+    static size_t ApplyFastTransform(const FastTransform& fast, size_t count, double* x, double* y, int* handled)
     {
-        outTargetRect = GB_Rectangle::Invalid;
-
-        if (!sourceRect.IsValid() || item.transform == nullptr)
+        if (fast.source.kind == FastCrsKind::Wgs84LonLat && fast.target.kind == FastCrsKind::WebMercator)
         {
-            return false;
+            return ApplyLonLatToWebMercatorKernel(count, x, y, handled);
         }
-
-        GB_Rectangle workingRect = sourceRect;
-
-        // 与源 CRS 的有效范围求交（更接近“部分交集”的真实语义）。
-        if (item.hasSourceValidRect && item.sourceValidRect.IsValid())
+        if (fast.source.kind == FastCrsKind::WebMercator && fast.target.kind == FastCrsKind::Wgs84LonLat)
         {
-            workingRect = workingRect.Intersected(item.sourceValidRect);
+            return ApplyWebMercatorToLonLatKernel(count, x, y, handled);
         }
+        return ApplyScalarFastTransformKernel(fast, count, x, y, handled);
+    }
 
-        // 若求交后退化/无效，则认为无法给出合理转换结果。
-        if (!workingRect.IsValid() || workingRect.Area() <= 0.0)
+    // 一个 CRS 对的“进程级原型”：源/目标 SRS、原型转换对象以及所有与线程无关的派生信息。
+    // 每个 CRS 对只创建一次（OGRCreateCoordinateTransformation 需要查询 proj.db、搜索转换路径，开销较大），
+    // 各线程再从原型 Clone() 出自己的转换对象（OGRCoordinateTransformation 非线程安全）。
+    struct TransformPrototype
+    {
+        OgrSrsPtr sourceSrs;
+        OgrSrsPtr targetSrs;
+        CoordinateTransformationPtr transform;
+
+        // 串行化对原型 transform 的 Clone()，原型本身不参与任何坐标计算。
+        mutable std::mutex cloneMutex;
+
+        bool sourceIsGeographic = false;
+        bool targetIsGeographic = false;
+
+        // 源 CRS 的自身有效范围（便于 bbox 求交/点的可选归一化判断）
+        GB_Rectangle sourceValidRect;
+        bool hasSourceValidRect = false;
+
+        std::string canonicalTargetWkt;
+
+        // 目标 CRS 的驻留 id（见 GeoCrsManager::InternCrs），源 bbox 以 id 表示坐标系时输出也以 id 表示。
+        // 只在第一次需要以 id 输出时才驻留（见 AssignTargetCrs），0 表示尚未驻留。
+        std::shared_ptr<const GeoCrs> targetCrs;
+        mutable std::atomic<std::uint32_t> targetCrsId{ 0 };
+
+        // WGS84 经纬度 / WebMercator / UTM 之间的闭式快速路径（见上方说明）。
+        FastTransform fast;
+    };
+
+    using TransformPrototypePtr = std::shared_ptr<const TransformPrototype>;
+
+    // 线程私有的转换实例。以 shared_ptr 持有：调用方拿到的引用在线程缓存淘汰该项后仍然有效。
+    struct TransformItem
+    {
+        TransformPrototypePtr prototype;
+        CoordinateTransformationPtr transform;
+    };
+
+    using TransformItemPtr = std::shared_ptr<TransformItem>;
+
+    // 一对 CRS 的解析结果（与线程无关）：WKT 裁剪、CRS 缓存查找与内容哈希计算都在这里完成，
+    // 之后各线程只需以 key 查询自己的 TransformItem。
+    struct TransformPair
+    {
+        TransformKey key;
+        std::shared_ptr<const GeoCrs> sourceCrs;
+        std::shared_ptr<const GeoCrs> targetCrs;
+        std::string trimmedSourceWkt;
+        std::string trimmedTargetWkt;
+    };
+
+    // -------------------- 缓存：进程级原型 + 线程级有界 LRU --------------------
+
+    constexpr size_t kDefaultThreadCacheCapacity = 64;
+    constexpr size_t kDefaultPrototypeCacheCapacity = 256;
+
+    // 进程级原型缓存（有界，近似 LRU）：命中只在读锁下更新条目的最近使用时刻，
+    // 插入时若已满，则在写锁下淘汰最久未使用的条目（O(容量) 扫描，只发生在需要新建原型的冷路径上）。
+    // 被淘汰的原型若仍被某个线程的 TransformItem 引用，会随其一同释放。
+    struct PrototypeCacheEntry
+    {
+        PrototypeCacheEntry(const TransformPrototypePtr& prototype, std::uint64_t lastUse) : prototype(prototype), lastUse(lastUse)
         {
-            return false;
         }
 
-        // 优先使用 TransformBounds（GDAL 3.4+）：内部会沿边界加密采样，通常比手工网格更可靠。
-        // 兼容性：若 GDAL < 3.4，则直接走下方“兜底：手工网格采样”。
-#if defined(GDAL_VERSION_NUM) && GDAL_VERSION_NUM >= 3040000
-        const int densifyPoints = std::max(2, sampleGridCount);
-        double boundsMinX = 0.0;
-        double boundsMinY = 0.0;
-        double boundsMaxX = 0.0;
-        double boundsMaxY = 0.0;
-        const int boundsOk = item.transform->TransformBounds(
-            workingRect.minX,
-            workingRect.minY,
-            workingRect.maxX,
-            workingRect.maxY,
-            &boundsMinX,
-            &boundsMinY,
-            &boundsMaxX,
-            &boundsMaxY,
-            densifyPoints);
+        TransformPrototypePtr prototype;
+        mutable std::atomic<std::uint64_t> lastUse;
+    };
 
-        if (boundsOk != FALSE && IsFinite(boundsMinX) && IsFinite(boundsMinY) && IsFinite(boundsMaxX) && IsFinite(boundsMaxY))
-        {
-            // 目标为 Geographic CRS 时：TransformBounds 用“xmax < xmin”表示跨越反经线（日期变更线）。
-            // 由于 GB_Rectangle 只能表示单段经度，这里保守返回全球经度范围。
-            if (item.targetIsGeographic&& boundsMaxX < boundsMinX)
-            {
-                boundsMinX = -180.0;
-                boundsMaxX = 180.0;
-            }
+    GB_ReadWriteLock g_prototypeCacheLock;
+    std::unordered_map<TransformKey, PrototypeCacheEntry, TransformKeyHasher> g_prototypeCache;
+    std::atomic<std::uint64_t> g_prototypeUseTick(0);
+    std::atomic<size_t> g_prototypeCacheCapacity(kDefaultPrototypeCacheCapacity);
+    std::atomic<std::uint64_t> g_prototypeEvictionCount(0);
 
-            outTargetRect.Set(boundsMinX, boundsMinY, boundsMaxX, boundsMaxY);
-            return outTargetRect.IsValid() && outTargetRect.Area() > 0.0;
-        }
-#endif
+    // ClearCaches() 时递增；各线程在下一次查询时发现代数变化，自行清空线程缓存。
+    std::atomic<std::uint64_t> g_cacheGeneration(0);
+    std::atomic<size_t> g_threadCacheCapacity(kDefaultThreadCacheCapacity);
 
-        // ---- 兜底：手工网格采样 ----
-        std::vector<double> xValues;
-        std::vector<double> yValues;
-        AppendRectangleGridSamples(workingRect, sampleGridCount, xValues, yValues);
+    std::atomic<std::uint64_t> g_prototypeCreateCount(0);
+    std::atomic<std::uint64_t> g_prototypeCreateNanoseconds(0);
 
-        const size_t numPoints = xValues.size();
-        if (numPoints == 0 || numPoints > static_cast<size_t>(std::numeric_limits<int>::max()))
+    // 线程级计数器：只由所属线程写（无竞争），GetCacheStatistics() 时汇总；线程退出时并入 g_retiredCounters。
+    struct ThreadCacheCounters
+    {
+        std::atomic<std::uint64_t> hitCount{ 0 };
+        std::atomic<std::uint64_t> missCount{ 0 };
+        std::atomic<std::uint64_t> evictionCount{ 0 };
+        std::atomic<std::uint64_t> cloneCount{ 0 };
+        std::atomic<std::uint64_t> cloneNanoseconds{ 0 };
+    };
+
+    std::mutex g_countersRegistryMutex;
+    std::vector<ThreadCacheCounters*> g_countersRegistry;
+    ThreadCacheCounters g_retiredCounters;
+
+    static void IncreaseCounter(std::atomic<std::uint64_t>& counter, std::uint64_t value = 1)
+    {
+        // 单写者：用 load + store 代替原子 RMW，避免热路径上的 lock 前缀指令。
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static std::uint64_t ElapsedNanoseconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // 线程级有界 LRU：表头为最近使用。
+    struct ThreadTransformCache
+    {
+        using EntryList = std::list<std::pair<TransformKey, TransformItemPtr>>;
+
+        EntryList entries;
+        std::unordered_map<TransformKey, EntryList::iterator, TransformKeyHasher> index;
+        std::uint64_t generation = 0;
+        ThreadCacheCounters counters;
+
+        ThreadTransformCache()
         {
-            return false;
+            generation = g_cacheGeneration.load(std::memory_order_acquire);
+            std::lock_guard<std::mutex> lock(g_countersRegistryMutex);
+            g_countersRegistry.push_back(&counters);
         }
 
-        std::vector<int> successFlags(numPoints, FALSE);
-        item.transform->Transform(static_cast<int>(numPoints), xValues.data(), yValues.data(), nullptr, successFlags.data());
+        ~ThreadTransformCache()
+        {
+            std::lock_guard<std::mutex> lock(g_countersRegistryMutex);
+            g_countersRegistry.erase(std::remove(g_countersRegistry.begin(), g_countersRegistry.end(), &counters), g_countersRegistry.end());
+            g_retiredCounters.hitCount.fetch_add(counters.hitCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            g_retiredCounters.missCount.fetch_add(counters.missCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            g_retiredCounters.evictionCount.fetch_add(counters.evictionCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            g_retiredCounters.cloneCount.fetch_add(counters.cloneCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            g_retiredCounters.cloneNanoseconds.fetch_add(counters.cloneNanoseconds.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
 
-        double minX = std::numeric_limits<double>::infinity();
-        double minY = std::numeric_limits<double>::infinity();
-        double maxX = -std::numeric_limits<double>::infinity();
-        double maxY = -std::numeric_limits<double>::infinity();
-        bool hasAnyPoint = false;
+        void Clear()
+        {
+            index.clear();
+            entries.clear();
+        }
 
-        for (size_t i = 0; i < numPoints; i++)
+        TransformItemPtr Find(const TransformKey& key)
         {
-            if (successFlags[i] == FALSE)
+            const std::uint64_t currentGeneration = g_cacheGeneration.load(std::memory_order_acquire);
+            if (generation != currentGeneration)
             {
-                continue;
+                Clear();
+                generation = currentGeneration;
             }
 
-            double x = xValues[i];
-            double y = yValues[i];
-            if (!IsFinite(x) || !IsFinite(y))
+            const auto it = index.find(key);
+            if (it == index.end())
             {
-                continue;
+                return nullptr;
             }
 
-            if (item.targetIsGeographic)
+            if (it->second != entries.begin())
             {
-                x = NormalizeLongitudeDegrees(x);
+                entries.splice(entries.begin(), entries, it->second);
             }
+            return entries.front().second;
+        }
 
-            hasAnyPoint = true;
-            minX = std::min(minX, x);
-            minY = std::min(minY, y);
-            maxX = std::max(maxX, x);
-            maxY = std::max(maxY, y);
+        void Insert(const TransformKey& key, const TransformItemPtr& item)
+        {
+            const size_t capacity = std::max<size_t>(1, g_threadCacheCapacity.load(std::memory_order_relaxed));
+            while (!entries.empty() && entries.size() >= capacity)
+            {
+                index.erase(entries.back().first);
+                entries.pop_back();
+                IncreaseCounter(counters.evictionCount);
+            }
+
+            entries.emplace_front(key, item);
+            index[key] = entries.begin();
         }
+    };
 
-        if (!hasAnyPoint)
+    static thread_local ThreadTransformCache g_threadTransformCache;
+
+    // 调用 OGR 的批量转换并保证 successFlags 可信：调用前全部置为失败；
+    // OGR 返回失败却把所有点都标为成功（未逐点填写）时，视为全部失败。
+    static bool RunOgrTransform(OGRCoordinateTransformation& transform, size_t count, double* x, double* y, double* z, double* t, int* successFlags)
+    {
+        if (count == 0)
         {
-            return false;
+            return true;
         }
 
-        if (item.targetIsGeographic)
+        std::fill(successFlags, successFlags + count, FALSE);
+        if (transform.Transform(static_cast<int>(count), x, y, z, t, successFlags))
         {
-            const double lonRange = maxX - minX;
-            if (lonRange > 180.0)
-            {
-                minX = -180.0;
-                maxX = 180.0;
-            }
+            return true;
         }
 
-        outTargetRect.Set(minX, minY, maxX, maxY);
-        return outTargetRect.IsValid() && outTargetRect.Area() > 0.0;
+        if (std::all_of(successFlags, successFlags + count, [](int flag) { return flag != FALSE; }))
+        {
+            std::fill(successFlags, successFlags + count, FALSE);
+        }
+        return false;
+    }
+
+    // 统一的批量坐标转换入口：优先走快速路径，其余点（通常极少）再交给 OGR。
+    // successFlags 必须有 count 个元素，逐点给出结果（TRUE/FALSE）；z、t（坐标历元，十进制年）可为 nullptr。
+    static void TransformCoordinatesInternal(TransformItem& item, size_t count, double* x, double* y, double* z, double* t, int* successFlags)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        const FastTransform& fast = item.prototype->fast;
+        if (!fast.enabled)
+        {
+            RunOgrTransform(*item.transform, count, x, y, z, t, successFlags);
+            return;
+        }
+
+        // 快速路径不改变 z 与 t（同一椭球上的纯投影运算，椭球高不变，与历元无关）。
+        const size_t handledCount = ApplyFastTransform(fast, count, x, y, successFlags);
+        if (handledCount == count)
+        {
+            return;
+        }
+
+        static thread_local std::vector<double> fallbackX;
+        static thread_local std::vector<double> fallbackY;
+        static thread_local std::vector<double> fallbackZ;
+        static thread_local std::vector<double> fallbackT;
+        static thread_local std::vector<int> fallbackFlags;
+        static thread_local std::vector<size_t> fallbackIndex;
+
+        fallbackX.clear();
+        fallbackY.clear();
+        fallbackZ.clear();
+        fallbackT.clear();
+        fallbackIndex.clear();
+        for (size_t i = 0; i < count; i++)
+        {
+            if (successFlags[i] != FALSE)
+            {
+                continue;
+            }
+
+            fallbackIndex.push_back(i);
+            fallbackX.push_back(x[i]);
+            fallbackY.push_back(y[i]);
+            if (z != nullptr)
+            {
+                fallbackZ.push_back(z[i]);
+            }
+            if (t != nullptr)
+            {
+                fallbackT.push_back(t[i]);
+            }
+        }
+
+        const size_t fallbackCount = fallbackIndex.size();
+        fallbackFlags.assign(fallbackCount, FALSE);
+        RunOgrTransform(*item.transform, fallbackCount, fallbackX.data(), fallbackY.data(), (z != nullptr) ? fallbackZ.data() : nullptr, (t != nullptr) ? fallbackT.data() : nullptr, fallbackFlags.data());
+
+        for (size_t i = 0; i < fallbackCount; i++)
+        {
+            const size_t index = fallbackIndex[i];
+            x[index] = fallbackX[i];
+            y[index] = fallbackY[i];
+            if (z != nullptr)
+            {
+                z[index] = fallbackZ[i];
+            }
+            if (t != nullptr)
+            {
+                t[index] = fallbackT[i];
+            }
+            successFlags[index] = fallbackFlags[i];
+        }
+    }
+
+    // 用一组覆盖定义域的采样点对比快速路径与 PROJ 的结果，全部在容差内才启用快速路径。
+    static bool ValidateFastTransform(const TransformPrototype& prototype)
+    {
+        const FastTransform& fast = prototype.fast;
+        const double centerLon = (fast.source.kind == FastCrsKind::Utm) ? fast.source.centralMeridianDegrees :
+            (fast.target.kind == FastCrsKind::Utm) ? fast.target.centralMeridianDegrees : 0.0;
+        const bool southOnly = (fast.source.kind == FastCrsKind::Utm && fast.source.falseNorthing > 0.0) ||
+            (fast.target.kind == FastCrsKind::Utm && fast.target.falseNorthing > 0.0);
+        const bool hasUtm = fast.source.kind == FastCrsKind::Utm || fast.target.kind == FastCrsKind::Utm;
+
+        const double deltaLons[] = { -3.0, -1.5, 0.0, 0.7, 2.9 };
+        const double latitudes[] = { -80.0, -45.0, -10.0, -0.5, 0.5, 10.0, 45.0, 80.0 };
+
+        std::vector<double> fastX;
+        std::vector<double> fastY;
+        for (const double deltaLon : deltaLons)
+        {
+            for (const double latitude : latitudes)
+            {
+                if (hasUtm && ((southOnly && latitude > 0.0) || (!southOnly && latitude < 0.0)))
+                {
+                    continue;
+                }
+
+                double x = 0.0;
+                double y = 0.0;
+                const double longitude = NormalizeLongitudeDegrees(centerLon + (hasUtm ? deltaLon : deltaLon * 50.0));
+                if (!FastFromLonLat(fast.source, longitude, latitude, x, y))
+                {
+                    continue;
+                }
+                fastX.push_back(x);
+                fastY.push_back(y);
+            }
+        }
+
+        const size_t count = fastX.size();
+        if (count == 0)
+        {
+            return false;
+        }
+
+        std::vector<double> projX = fastX;
+        std::vector<double> projY = fastY;
+        std::vector<int> projFlags(count, FALSE);
+        std::vector<int> fastFlags(count, FALSE);
+        if (!RunOgrTransform(*prototype.transform, count, projX.data(), projY.data(), nullptr, nullptr, projFlags.data()) ||
+            ApplyFastTransform(fast, count, fastX.data(), fastY.data(), fastFlags.data()) != count)
+        {
+            return false;
+        }
+
+        const double tolerance = prototype.targetIsGeographic ? kFastPathGeographicTolerance : kFastPathProjectedTolerance;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (projFlags[i] == FALSE)
+            {
+                return false;
+            }
+
+            double deltaX = fastX[i] - projX[i];
+            if (prototype.targetIsGeographic)
+            {
+                deltaX = NormalizeLongitudeDegrees(deltaX);
+            }
+
+            if (!(std::fabs(deltaX) <= tolerance) || !(std::fabs(fastY[i] - projY[i]) <= tolerance))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    static bool TryResolveTransformPair(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, TransformPair& outPair)
+    {
+        outPair = TransformPair();
+
+        std::string trimmedSourceWkt = GB_Utf8Trim(sourceWktUtf8);
+        std::string trimmedTargetWkt = GB_Utf8Trim(targetWktUtf8);
+        if (trimmedSourceWkt.empty() || trimmedTargetWkt.empty())
+        {
+            return false;
+        }
+
+        std::shared_ptr<const GeoCrs> sourceCrs = GeoCrsManager::GetFromWktCached(trimmedSourceWkt);
+        std::shared_ptr<const GeoCrs> targetCrs = GeoCrsManager::GetFromWktCached(trimmedTargetWkt);
+        if (!sourceCrs || !targetCrs || !sourceCrs->IsValid() || !targetCrs->IsValid())
+        {
+            return false;
+        }
+
+        const GeoCrs::Uid128 sourceHash = sourceCrs->GetContentHash128();
+        const GeoCrs::Uid128 targetHash = targetCrs->GetContentHash128();
+        if (!sourceHash.IsValid() || !targetHash.IsValid())
+        {
+            return false;
+        }
+
+        outPair.key.sourceHash = sourceHash;
+        outPair.key.targetHash = targetHash;
+        outPair.sourceCrs = std::move(sourceCrs);
+        outPair.targetCrs = std::move(targetCrs);
+        outPair.trimmedSourceWkt = std::move(trimmedSourceWkt);
+        outPair.trimmedTargetWkt = std::move(trimmedTargetWkt);
+        return true;
+    }
+
+    static TransformPrototypePtr BuildTransformPrototype(const TransformPair& pair)
+    {
+        const std::shared_ptr<const GeoCrs>& sourceCrs = pair.sourceCrs;
+        const std::shared_ptr<const GeoCrs>& targetCrs = pair.targetCrs;
+        const std::string& trimmedTargetWkt = pair.trimmedTargetWkt;
+
+        std::shared_ptr<TransformPrototype> prototype = std::make_shared<TransformPrototype>();
+        prototype->sourceIsGeographic = sourceCrs->IsGeographic();
+        prototype->targetIsGeographic = targetCrs->IsGeographic();
+
+        // 取源 CRS 的自身有效范围（如果可用）
+        {
+            GeoBoundingBox lonLatArea;
+            GeoBoundingBox selfArea;
+            GeoCrsManager::TryGetValidAreasCached(pair.trimmedSourceWkt, lonLatArea, selfArea);
+            if (selfArea.IsValid())
+            {
+                prototype->sourceValidRect = selfArea.rect;
+                prototype->hasSourceValidRect = selfArea.rect.IsValid();
+            }
+        }
+
+        // 使用目标 CRS 的规范化 WKT（WKT2_2018），确保输出 GeoBoundingBox 的 wktUtf8 稳定。
+        prototype->canonicalTargetWkt = targetCrs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+        if (prototype->canonicalTargetWkt.empty())
+        {
+            // 兜底：至少保留用户输入。
+            prototype->canonicalTargetWkt = trimmedTargetWkt;
+        }
+        prototype->targetCrs = targetCrs;
+
+        const OGRSpatialReference& sourceRef = sourceCrs->GetConstRef();
+        const OGRSpatialReference& targetRef = targetCrs->GetConstRef();
+
+        prototype->sourceSrs.reset(sourceRef.Clone());
+        prototype->targetSrs.reset(targetRef.Clone());
+        if (!prototype->sourceSrs || !prototype->targetSrs)
+        {
+            return nullptr;
+        }
+
+        EnsureTraditionalGisAxisOrder(*prototype->sourceSrs);
+        EnsureTraditionalGisAxisOrder(*prototype->targetSrs);
+
+        prototype->transform.reset(OGRCreateCoordinateTransformation(prototype->sourceSrs.get(), prototype->targetSrs.get()));
+        if (prototype->transform == nullptr)
+        {
+            return nullptr;
+        }
+
+        // 识别可走闭式快速路径的 CRS 对（依据根节点的 EPSG 权威码并校验内容，不做推断）。
+        prototype->fast.source = DetectFastCrs(*sourceCrs);
+        prototype->fast.target = DetectFastCrs(*targetCrs);
+        if (prototype->fast.source.kind != FastCrsKind::None && prototype->fast.target.kind != FastCrsKind::None)
+        {
+            prototype->fast.enabled = true;
+            if (!ValidateFastTransform(*prototype))
+            {
+                prototype->fast.enabled = false;
+                GBLOG_WARNING(GB_STR("【GeoCrsTransform】快速路径与 PROJ 结果不一致，已回退到 PROJ: ") + sourceCrs->GetUidUtf8() + GB_STR(" -> ") + targetCrs->GetUidUtf8());
+            }
+        }
+
+        return prototype;
+    }
+
+    static TransformPrototypePtr GetOrCreateTransformPrototype(const TransformPair& pair)
+    {
+        {
+            GB_ReadLockGuard readGuard(g_prototypeCacheLock);
+            const auto it = g_prototypeCache.find(pair.key);
+            if (it != g_prototypeCache.end())
+            {
+                it->second.lastUse.store(g_prototypeUseTick.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+                return it->second.prototype;
+            }
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        TransformPrototypePtr prototype = BuildTransformPrototype(pair);
+        if (prototype == nullptr)
+        {
+            return nullptr;
+        }
+        g_prototypeCreateCount.fetch_add(1, std::memory_order_relaxed);
+        g_prototypeCreateNanoseconds.fetch_add(ElapsedNanoseconds(start), std::memory_order_relaxed);
+
+        GB_WriteLockGuard writeGuard(g_prototypeCacheLock);
+        const auto it = g_prototypeCache.find(pair.key);
+        if (it != g_prototypeCache.end())
+        {
+            return it->second.prototype;
+        }
+
+        const size_t capacity = std::max<size_t>(1, g_prototypeCacheCapacity.load(std::memory_order_relaxed));
+        while (g_prototypeCache.size() >= capacity)
+        {
+            auto oldest = g_prototypeCache.begin();
+            for (auto candidate = g_prototypeCache.begin(); candidate != g_prototypeCache.end(); ++candidate)
+            {
+                if (candidate->second.lastUse.load(std::memory_order_relaxed) < oldest->second.lastUse.load(std::memory_order_relaxed))
+                {
+                    oldest = candidate;
+                }
+            }
+            g_prototypeCache.erase(oldest);
+            g_prototypeEvictionCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        g_prototypeCache.emplace(std::piecewise_construct, std::forward_as_tuple(pair.key), std::forward_as_tuple(prototype, g_prototypeUseTick.fetch_add(1, std::memory_order_relaxed)));
+        return prototype;
+    }
+
+    static bool TryGetTransformItem(const TransformPair& pair, TransformItemPtr& outItem)
+    {
+        outItem = nullptr;
+
+        if (!pair.sourceCrs || !pair.targetCrs)
+        {
+            return false;
+        }
+
+        ThreadTransformCache& cache = g_threadTransformCache;
+        TransformItemPtr cachedItem = cache.Find(pair.key);
+        if (cachedItem != nullptr)
+        {
+            IncreaseCounter(cache.counters.hitCount);
+            outItem = cachedItem;
+            return cachedItem->transform != nullptr;
+        }
+
+        IncreaseCounter(cache.counters.missCount);
+
+        const TransformItemPtr item = std::make_shared<TransformItem>();
+        item->prototype = GetOrCreateTransformPrototype(pair);
+        if (item->prototype == nullptr)
+        {
+            return false;
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#if defined(GDAL_VERSION_NUM) && GDAL_VERSION_NUM >= 3010000
+        {
+            std::lock_guard<std::mutex> lock(item->prototype->cloneMutex);
+            item->transform.reset(item->prototype->transform->Clone());
+        }
+#else
+        item->transform.reset(OGRCreateCoordinateTransformation(item->prototype->sourceSrs.get(), item->prototype->targetSrs.get()));
+#endif
+        if (item->transform == nullptr)
+        {
+            return false;
+        }
+        IncreaseCounter(cache.counters.cloneCount);
+        IncreaseCounter(cache.counters.cloneNanoseconds, ElapsedNanoseconds(start));
+
+        cache.Insert(pair.key, item);
+        outItem = item;
+        return true;
+    }
+
+    static bool TryGetTransformItem(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, TransformItemPtr& outItem)
+    {
+        outItem = nullptr;
+
+        TransformPair pair;
+        if (!TryResolveTransformPair(sourceWktUtf8, targetWktUtf8, pair))
+        {
+            return false;
+        }
+
+        return TryGetTransformItem(pair, outItem);
+    }
+
+    static bool TryTransformSingleXYInternal(TransformItem& item, double x, double y, double& outX, double& outY)
+    {
+        outX = x;
+        outY = y;
+
+        if (!IsFinite(x) || !IsFinite(y) || item.transform == nullptr)
+        {
+            return false;
+        }
+
+        // 对 Geographic CRS 的经度做适度归一化，减少“超范围但等价”的失败。
+        double inputX = x;
+        double inputY = y;
+        if (item.prototype->sourceIsGeographic)
+        {
+            inputX = NormalizeLongitudeDegrees(inputX);
+        }
+
+        int successFlag = FALSE;
+        double transformedX = inputX;
+        double transformedY = inputY;
+        TransformCoordinatesInternal(item, 1, &transformedX, &transformedY, nullptr, nullptr, &successFlag);
+
+        if (successFlag == FALSE || !IsFinite(transformedX) || !IsFinite(transformedY))
+        {
+            return false;
+        }
+
+        // 若目标是 Geographic CRS，也进行经度归一化。跨日期线时，单点归一化是安全的。
+        if (item.prototype->targetIsGeographic)
+        {
+            transformedX = NormalizeLongitudeDegrees(transformedX);
+        }
+
+        outX = transformedX;
+        outY = transformedY;
+        return true;
+    }
+
+    static bool TryTransformSingleXYZInternal(TransformItem& item, double x, double y, double z, double& outX, double& outY, double& outZ)
+    {
+        outX = x;
+        outY = y;
+        outZ = z;
+
+        if (!IsFinite(x) || !IsFinite(y) || !IsFinite(z) || item.transform == nullptr)
+        {
+            return false;
+        }
+
+        double inputX = x;
+        double inputY = y;
+        double inputZ = z;
+        if (item.prototype->sourceIsGeographic)
+        {
+            inputX = NormalizeLongitudeDegrees(inputX);
+        }
+
+        int successFlag = FALSE;
+        TransformCoordinatesInternal(item, 1, &inputX, &inputY, &inputZ, nullptr, &successFlag);
+
+        if (successFlag == FALSE || !IsFinite(inputX) || !IsFinite(inputY) || !IsFinite(inputZ))
+        {
+            return false;
+        }
+
+        if (item.prototype->targetIsGeographic)
+        {
+            inputX = NormalizeLongitudeDegrees(inputX);
+        }
+
+        outX = inputX;
+        outY = inputY;
+        outZ = inputZ;
+        return true;
+    }
+
+    static void AppendRectangleGridSamples(const GB_Rectangle& rect, int sampleGridCount, std::vector<double>& xs, std::vector<double>& ys)
+    {
+        const int count = std::max(2, sampleGridCount);
+        xs.reserve(xs.size() + static_cast<size_t>(count) * static_cast<size_t>(count));
+        ys.reserve(ys.size() + static_cast<size_t>(count) * static_cast<size_t>(count));
+
+        for (int yIndex = 0; yIndex < count; yIndex++)
+        {
+            const double yT = (count <= 1) ? 0 : static_cast<double>(yIndex) / static_cast<double>(count - 1);
+            const double y = rect.minY + (rect.maxY - rect.minY) * yT;
+
+            for (int xIndex = 0; xIndex < count; xIndex++)
+            {
+                const double xT = (count <= 1) ? 0 : static_cast<double>(xIndex) / static_cast<double>(count - 1);
+                const double x = rect.minX + (rect.maxX - rect.minX) * xT;
+                xs.push_back(x);
+                ys.push_back(y);
+            }
+        }
+    }
+
+    // 写入输出 bbox 的坐标系：useCrsId 为 true（且目标 CRS 可驻留）时只写 id，否则写规范化 WKT。
+    // 源 bbox 以 id 表示坐标系说明调用方已在使用驻留表，此时才驻留目标 CRS。
+    static void AssignTargetCrs(const TransformPrototype& prototype, bool useCrsId, GeoBoundingBox& box)
+    {
+        if (useCrsId)
+        {
+            std::uint32_t targetCrsId = prototype.targetCrsId.load(std::memory_order_acquire);
+            if (targetCrsId == 0)
+            {
+                targetCrsId = GeoCrsManager::InternCrs(prototype.targetCrs);
+                prototype.targetCrsId.store(targetCrsId, std::memory_order_release);
+            }
+
+            if (targetCrsId != 0)
+            {
+                box.wktUtf8.clear();
+                box.crsId = targetCrsId;
+                return;
+            }
+        }
+
+        box.wktUtf8 = prototype.canonicalTargetWkt;
+        box.crsId = 0;
+    }
+
+    // bbox 的源坐标系 WKT（以 id 表示时取驻留的规范化 WKT）。
+    static std::string GetTrimmedSourceWkt(const GeoBoundingBox& box)
+    {
+        return box.UsesCrsId() ? GeoCrsManager::GetCrsIdWktUtf8(box.crsId) : GB_Utf8Trim(box.wktUtf8);
+    }
+
+    // 与 GeoCrs::GetValidAreaLonLatSegments 相同的分段规则：west <= east 为 1 段；
+    // west > east 表示跨越反经线，拆成 [west, 180] 与 [-180, east] 两段（每段仍要求 west <= east）。
+    static void AppendLonLatSegments(double west, double south, double east, double north, std::vector<GB_Rectangle>& outRects)
+    {
+        if (west <= east)
+        {
+            outRects.push_back(GB_Rectangle(west, south, east, north));
+            return;
+        }
+
+        if (west <= 180.0)
+        {
+            outRects.push_back(GB_Rectangle(west, south, 180.0, north));
+        }
+        if (-180.0 <= east)
+        {
+            outRects.push_back(GB_Rectangle(-180.0, south, east, north));
+        }
+    }
+
+    // 计算 sourceRect 在目标 CRS 下的范围，以 1~2 个矩形表示：
+    // - 目标为经纬度且结果跨越反经线时返回 2 段（按 AppendLonLatSegments 规则拆分）；
+    // - 无法确定单侧跨越（例如包含极点、经度覆盖全球）时返回 1 段 [-180, 180]；
+    // - 其它情况返回 1 段。
+    static bool TryTransformRectangleToPartsInternal(TransformItem& item, const GB_Rectangle& sourceRect, int sampleGridCount, std::vector<GB_Rectangle>& outTargetRects)
+    {
+        outTargetRects.clear();
+
+        if (!sourceRect.IsValid() || item.transform == nullptr)
+        {
+            return false;
+        }
+
+        GB_Rectangle workingRect = sourceRect;
+
+        // 与源 CRS 的有效范围求交（更接近“部分交集”的真实语义）。
+        if (item.prototype->hasSourceValidRect && item.prototype->sourceValidRect.IsValid())
+        {
+            workingRect = workingRect.Intersected(item.prototype->sourceValidRect);
+        }
+
+        // 若求交后退化/无效，则认为无法给出合理转换结果。
+        if (!workingRect.IsValid() || workingRect.Area() <= 0.0)
+        {
+            return false;
+        }
+
+        // 优先使用 TransformBounds（GDAL 3.4+）：内部会沿边界加密采样，通常比手工网格更可靠。
+        // 兼容性：若 GDAL < 3.4，则直接走下方“兜底：手工网格采样”。
+#if defined(GDAL_VERSION_NUM) && GDAL_VERSION_NUM >= 3040000
+        const int densifyPoints = std::max(2, sampleGridCount);
+        double boundsMinX = 0.0;
+        double boundsMinY = 0.0;
+        double boundsMaxX = 0.0;
+        double boundsMaxY = 0.0;
+        const int boundsOk = item.transform->TransformBounds(
+            workingRect.minX,
+            workingRect.minY,
+            workingRect.maxX,
+            workingRect.maxY,
+            &boundsMinX,
+            &boundsMinY,
+            &boundsMaxX,
+            &boundsMaxY,
+            densifyPoints);
+
+        if (boundsOk != FALSE && IsFinite(boundsMinX) && IsFinite(boundsMinY) && IsFinite(boundsMaxX) && IsFinite(boundsMaxY))
+        {
+            // 目标为 Geographic CRS 时：TransformBounds 用“xmax < xmin”表示跨越反经线（日期变更线）。
+            if (item.prototype->targetIsGeographic && boundsMaxX < boundsMinX)
+            {
+                AppendLonLatSegments(boundsMinX, boundsMinY, boundsMaxX, boundsMaxY, outTargetRects);
+            }
+            else
+            {
+                outTargetRects.push_back(GB_Rectangle(boundsMinX, boundsMinY, boundsMaxX, boundsMaxY));
+            }
+            return !outTargetRects.empty();
+        }
+#endif
+
+        // ---- 兜底：手工网格采样 ----
+        std::vector<double> xValues;
+        std::vector<double> yValues;
+        AppendRectangleGridSamples(workingRect, sampleGridCount, xValues, yValues);
+
+        const size_t numPoints = xValues.size();
+        if (numPoints == 0 || numPoints > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            return false;
+        }
+
+        std::vector<int> successFlags(numPoints, FALSE);
+        RunOgrTransform(*item.transform, numPoints, xValues.data(), yValues.data(), nullptr, nullptr, successFlags.data());
+
+        double minX = std::numeric_limits<double>::infinity();
+        double minY = std::numeric_limits<double>::infinity();
+        double maxX = -std::numeric_limits<double>::infinity();
+        double maxY = -std::numeric_limits<double>::infinity();
+
+        // 经度平移到 [0, 360) 后的范围：用于识别跨越反经线的结果。
+        double shiftedMinX = std::numeric_limits<double>::infinity();
+        double shiftedMaxX = -std::numeric_limits<double>::infinity();
+        bool hasAnyPoint = false;
+
+        for (size_t i = 0; i < numPoints; i++)
+        {
+            if (successFlags[i] == FALSE)
+            {
+                continue;
+            }
+
+            double x = xValues[i];
+            double y = yValues[i];
+            if (!IsFinite(x) || !IsFinite(y))
+            {
+                continue;
+            }
+
+            if (item.prototype->targetIsGeographic)
+            {
+                x = NormalizeLongitudeDegrees(x);
+
+                const double shiftedX = (x < 0.0) ? x + 360.0 : x;
+                shiftedMinX = std::min(shiftedMinX, shiftedX);
+                shiftedMaxX = std::max(shiftedMaxX, shiftedX);
+            }
+
+            hasAnyPoint = true;
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+        }
+
+        if (!hasAnyPoint)
+        {
+            return false;
+        }
+
+        if (item.prototype->targetIsGeographic)
+        {
+            const double lonRange = maxX - minX;
+            if (lonRange > 180.0)
+            {
+                // 以 180° 经线为中心的范围明显更窄时，视为跨越反经线；否则保守返回全球经度范围。
+                if (shiftedMaxX - shiftedMinX <= 180.0)
+                {
+                    AppendLonLatSegments(NormalizeLongitudeDegrees(shiftedMinX), minY, NormalizeLongitudeDegrees(shiftedMaxX), maxY, outTargetRects);
+                    return !outTargetRects.empty();
+                }
+
+                minX = -180.0;
+                maxX = 180.0;
+            }
+        }
+
+        outTargetRects.push_back(GB_Rectangle(minX, minY, maxX, maxY));
+        return true;
+    }
+
+    static bool TryTransformRectangleToAabbInternal(TransformItem& item, const GB_Rectangle& sourceRect, int sampleGridCount, GB_Rectangle& outTargetRect)
+    {
+        outTargetRect = GB_Rectangle::Invalid;
+
+        std::vector<GB_Rectangle> parts;
+        if (!TryTransformRectangleToPartsInternal(item, sourceRect, sampleGridCount, parts))
+        {
+            return false;
+        }
+
+        // 由于 GB_Rectangle 只能表示单段经度，跨越反经线时这里保守返回全球经度范围。
+        if (parts.size() > 1)
+        {
+            double minY = parts[0].minY;
+            double maxY = parts[0].maxY;
+            for (const GB_Rectangle& part : parts)
+            {
+                minY = std::min(minY, part.minY);
+                maxY = std::max(maxY, part.maxY);
+            }
+            outTargetRect.Set(-180.0, minY, 180.0, maxY);
+        }
+        else
+        {
+            outTargetRect = parts[0];
+        }
+
+        return outTargetRect.IsValid() && outTargetRect.Area() > 0.0;
+    }
+
+    static bool TransformBoundingBoxPartsInternal(TransformItem& item, const GB_Rectangle& sourceRect, int sampleGridCount, bool useCrsId, std::vector<GeoBoundingBox>& outParts)
+    {
+        outParts.clear();
+
+        std::vector<GB_Rectangle> parts;
+        if (!TryTransformRectangleToPartsInternal(item, sourceRect, sampleGridCount, parts))
+        {
+            return false;
+        }
+
+        for (const GB_Rectangle& part : parts)
+        {
+            // 恰好落在 ±180° 上的零宽度段没有意义，丢弃。
+            if (!part.IsValid() || part.Area() <= 0.0)
+            {
+                continue;
+            }
+
+            GeoBoundingBox box;
+            AssignTargetCrs(*item.prototype, useCrsId, box);
+            box.rect = part;
+            outParts.push_back(box);
+        }
+
+        return !outParts.empty();
+    }
+
+    // outStatus 非空时为整个点数组的状态（调用方已清零），成功的点写入 1。
+    static void TransformPointsChunkInternal(
+        TransformItem& item,
+        std::vector<GB_Point2d>& points,
+        size_t baseIndex,
+        size_t count,
+        std::atomic_bool& allOk,
+        std::uint8_t* outStatus,
+        std::vector<double>& xValues,
+        std::vector<double>& yValues,
+        std::vector<int>& successFlags,
+        std::vector<size_t>& indexMap)
+    {
+        xValues.clear();
+        yValues.clear();
+        indexMap.clear();
+
+        xValues.reserve(count);
+        yValues.reserve(count);
+        indexMap.reserve(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const size_t pointIndex = baseIndex + i;
+            GB_Point2d& point = points[pointIndex];
+
+            if (!IsFinitePoint(point))
+            {
+                allOk.store(false, std::memory_order_relaxed);
+                continue;
+            }
+
+            double x = point.x;
+            const double y = point.y;
+            if (item.prototype->sourceIsGeographic)
+            {
+                x = NormalizeLongitudeDegrees(x);
+            }
+
+            indexMap.push_back(pointIndex);
+            xValues.push_back(x);
+            yValues.push_back(y);
+        }
+
+        const size_t validCount = indexMap.size();
+        if (validCount == 0)
+        {
+            return;
+        }
+
+        if (validCount > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            allOk.store(false, std::memory_order_relaxed);
+            return;
+        }
+
+        successFlags.assign(validCount, FALSE);
+
+        TransformCoordinatesInternal(item, validCount, xValues.data(), yValues.data(), nullptr, nullptr, successFlags.data());
+
+        for (size_t i = 0; i < validCount; i++)
+        {
+            if (successFlags[i] == FALSE || !IsFinite(xValues[i]) || !IsFinite(yValues[i]))
+            {
+                allOk.store(false, std::memory_order_relaxed);
+                continue;
+            }
+
+            double x = xValues[i];
+            const double y = yValues[i];
+            if (item.prototype->targetIsGeographic)
+            {
+                x = NormalizeLongitudeDegrees(x);
+            }
+
+            GB_Point2d& point = points[indexMap[i]];
+            point.Set(x, y);
+            if (!point.IsValid())
+            {
+                allOk.store(false, std::memory_order_relaxed);
+                continue;
+            }
+
+            if (outStatus != nullptr)
+            {
+                outStatus[indexMap[i]] = 1;
+            }
+        }
+    }
+
+    static bool TransformPointsInternal(const TransformPair& pair, std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP, std::uint8_t* outStatus)
+    {
+        std::atomic_bool allOk(true);
+
+        const size_t count = inOutPoints.size();
+        if (count == 0)
+        {
+            return true;
+        }
+
+        constexpr size_t chunkSize = kTransformChunkSize;
+        const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+        const bool useParallel = enableOpenMP && chunkCount <= static_cast<size_t>(std::numeric_limits<int>::max());
+
+        if (useParallel)
+        {
+#pragma omp parallel
+            {
+                TransformItemPtr threadItem;
+                if (!TryGetTransformItem(pair, threadItem) || threadItem == nullptr || threadItem->transform == nullptr)
+                {
+                    allOk.store(false, std::memory_order_relaxed);
+                }
+
+                std::vector<double> xValues;
+                std::vector<double> yValues;
+                std::vector<int> successFlags;
+                std::vector<size_t> indexMap;
+
+#pragma omp for schedule(static)
+                for (int chunkIndex = 0; chunkIndex < static_cast<int>(chunkCount); chunkIndex++)
+                {
+                    if (threadItem == nullptr || threadItem->transform == nullptr)
+                    {
+                        allOk.store(false, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    const size_t baseIndex = static_cast<size_t>(chunkIndex) * chunkSize;
+                    const size_t remaining = count - baseIndex;
+                    const size_t thisChunkCount = std::min(chunkSize, remaining);
+                    TransformPointsChunkInternal(*threadItem, inOutPoints, baseIndex, thisChunkCount, allOk, outStatus, xValues, yValues, successFlags, indexMap);
+                }
+            }
+        }
+        else
+        {
+            TransformItemPtr item;
+            if (!TryGetTransformItem(pair, item) || item == nullptr || item->transform == nullptr)
+            {
+                return false;
+            }
+
+            std::vector<double> xValues;
+            std::vector<double> yValues;
+            std::vector<int> successFlags;
+            std::vector<size_t> indexMap;
+
+            for (size_t baseIndex = 0; baseIndex < count; baseIndex += chunkSize)
+            {
+                const size_t remaining = count - baseIndex;
+                const size_t thisChunkCount = std::min(chunkSize, remaining);
+                TransformPointsChunkInternal(*item, inOutPoints, baseIndex, thisChunkCount, allOk, outStatus, xValues, yValues, successFlags, indexMap);
+            }
+        }
+
+        return allOk.load(std::memory_order_relaxed);
+    }
+
+    // 带逐点状态的 TransformPoints：pair 为 nullptr 表示 CRS 对解析失败（所有点记为失败，保持原值）。
+    static bool TransformPointsWithStatusInternal(const TransformPair* pair, std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP, std::vector<std::uint8_t>* outStatus, size_t* outInvalidCount)
+    {
+        const size_t count = inOutPoints.size();
+        const bool needStatus = outStatus != nullptr || outInvalidCount != nullptr;
+
+        std::vector<std::uint8_t> localStatus;
+        std::vector<std::uint8_t>* status = (outStatus != nullptr) ? outStatus : &localStatus;
+        if (needStatus)
+        {
+            status->assign(count, 0);
+        }
+
+        bool allOk = (count == 0);
+        if (count > 0 && pair != nullptr)
+        {
+            allOk = TransformPointsInternal(*pair, inOutPoints, enableOpenMP, needStatus ? status->data() : nullptr);
+        }
+
+        if (outInvalidCount != nullptr)
+        {
+            *outInvalidCount = static_cast<size_t>(std::count(status->begin(), status->end(), static_cast<std::uint8_t>(0)));
+        }
+
+        return allOk;
+    }
+
+    // 原地转换一段 SoA 坐标（x/y/z 分别存放，第 i 个点位于 x[i * stride]）。
+    // - stride == 1：直接把调用方数组交给 OGR 转换（不做收集/分散，也不备份原值），
+    //   失败点统一写为 HUGE_VAL（与 PROJ 的约定一致），由调用方依据 outStatus / 返回值处理。
+    // - stride > 1（例如 xyzxyz 交错存储）：先收集到 scratch 中再转换，只写回成功的点（失败点保持原值）。
+    // - outStatus 非空时，逐点写入 1（成功）/ 0（失败）。
+    // - t 为 nullptr 且 epoch > 0 时，以 epoch 作为本块所有点的坐标历元（只在 scratch 中按块展开）。
+    static bool TransformXYArraysChunkInternal(
+        TransformItem& item,
+        double* x,
+        double* y,
+        double* z,
+        double* t,
+        double epoch,
+        size_t count,
+        size_t stride,
+        std::uint8_t* outStatus,
+        std::vector<double>& scratch,
+        std::vector<int>& successFlags)
+    {
+        const bool useConstantEpoch = t == nullptr && epoch > 0.0;
+
+        // stride == 1 时只有常量历元需要展开到 scratch；stride > 1 时收集 x/y/z/t 到 scratch。
+        const bool useScratch = stride != 1;
+        const size_t arrayCount = useScratch
+            ? 2 + (z != nullptr ? 1 : 0) + (t != nullptr || useConstantEpoch ? 1 : 0)
+            : (useConstantEpoch ? 1 : 0);
+        scratch.resize(count * arrayCount);
+
+        double* xValues = x;
+        double* yValues = y;
+        double* zValues = z;
+        double* tValues = t;
+        double* nextValues = scratch.data();
+        if (useScratch)
+        {
+            xValues = nextValues;
+            nextValues += count;
+            yValues = nextValues;
+            nextValues += count;
+            if (z != nullptr)
+            {
+                zValues = nextValues;
+                nextValues += count;
+            }
+            if (t != nullptr)
+            {
+                tValues = nextValues;
+                nextValues += count;
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                xValues[i] = x[i * stride];
+                yValues[i] = y[i * stride];
+                if (z != nullptr)
+                {
+                    zValues[i] = z[i * stride];
+                }
+                if (t != nullptr)
+                {
+                    tValues[i] = t[i * stride];
+                }
+            }
+        }
+
+        if (useConstantEpoch)
+        {
+            tValues = nextValues;
+            std::fill(tValues, tValues + count, epoch);
+        }
+
+        if (item.prototype->sourceIsGeographic)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                xValues[i] = NormalizeLongitudeDegrees(xValues[i]);
+            }
+        }
+
+        successFlags.assign(count, FALSE);
+        TransformCoordinatesInternal(item, count, xValues, yValues, zValues, tValues, successFlags.data());
+
+        bool allOk = true;
+        for (size_t i = 0; i < count; i++)
+        {
+            const bool pointOk = successFlags[i] != FALSE &&
+                IsFinite(xValues[i]) &&
+                IsFinite(yValues[i]) &&
+                (zValues == nullptr || IsFinite(zValues[i]));
+
+            if (outStatus != nullptr)
+            {
+                outStatus[i] = pointOk ? 1 : 0;
+            }
+
+            if (!pointOk)
+            {
+                allOk = false;
+                if (!useScratch)
+                {
+                    x[i] = HUGE_VAL;
+                    y[i] = HUGE_VAL;
+                    if (z != nullptr)
+                    {
+                        z[i] = HUGE_VAL;
+                    }
+                }
+                continue;
+            }
+
+            if (item.prototype->targetIsGeographic)
+            {
+                xValues[i] = NormalizeLongitudeDegrees(xValues[i]);
+            }
+
+            if (useScratch)
+            {
+                x[i * stride] = xValues[i];
+                y[i * stride] = yValues[i];
+                if (zValues != nullptr)
+                {
+                    z[i * stride] = zValues[i];
+                }
+                if (t != nullptr)
+                {
+                    t[i * stride] = tValues[i];
+                }
+            }
+        }
+
+        return allOk;
+    }
+
+    static bool TransformXYArraysInternal(const TransformPair& pair, double* x, double* y, double* z, double* t, double epoch, size_t count, size_t stride, std::uint8_t* outStatus, bool enableOpenMP)
+    {
+        if (count == 0)
+        {
+            return true;
+        }
+
+        if (outStatus != nullptr)
+        {
+            std::memset(outStatus, 0, count);
+        }
+
+        if (x == nullptr || y == nullptr || stride == 0)
+        {
+            return false;
+        }
+
+        std::atomic_bool allOk(true);
+
+        constexpr size_t chunkSize = kTransformChunkSize;
+        const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+        const bool useParallel = enableOpenMP && chunkCount > 1 && chunkCount <= static_cast<size_t>(std::numeric_limits<int>::max());
+
+        if (useParallel)
+        {
+#pragma omp parallel
+            {
+                TransformItemPtr threadItem;
+                if (!TryGetTransformItem(pair, threadItem) || threadItem == nullptr || threadItem->transform == nullptr)
+                {
+                    allOk.store(false, std::memory_order_relaxed);
+                }
+
+                std::vector<double> scratch;
+                std::vector<int> successFlags;
+
+#pragma omp for schedule(static)
+                for (int chunkIndex = 0; chunkIndex < static_cast<int>(chunkCount); chunkIndex++)
+                {
+                    if (threadItem == nullptr || threadItem->transform == nullptr)
+                    {
+                        allOk.store(false, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    const size_t baseIndex = static_cast<size_t>(chunkIndex) * chunkSize;
+                    const size_t thisChunkCount = std::min(chunkSize, count - baseIndex);
+                    const size_t offset = baseIndex * stride;
+                    if (!TransformXYArraysChunkInternal(
+                        *threadItem,
+                        x + offset,
+                        y + offset,
+                        (z != nullptr) ? z + offset : nullptr,
+                        (t != nullptr) ? t + offset : nullptr,
+                        epoch,
+                        thisChunkCount,
+                        stride,
+                        (outStatus != nullptr) ? outStatus + baseIndex : nullptr,
+                        scratch,
+                        successFlags))
+                    {
+                        allOk.store(false, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+        else
+        {
+            TransformItemPtr item;
+            if (!TryGetTransformItem(pair, item) || item == nullptr || item->transform == nullptr)
+            {
+                return false;
+            }
+
+            std::vector<double> scratch;
+            std::vector<int> successFlags;
+
+            for (size_t baseIndex = 0; baseIndex < count; baseIndex += chunkSize)
+            {
+                const size_t thisChunkCount = std::min(chunkSize, count - baseIndex);
+                const size_t offset = baseIndex * stride;
+                if (!TransformXYArraysChunkInternal(
+                    *item,
+                    x + offset,
+                    y + offset,
+                    (z != nullptr) ? z + offset : nullptr,
+                    (t != nullptr) ? t + offset : nullptr,
+                    epoch,
+                    thisChunkCount,
+                    stride,
+                    (outStatus != nullptr) ? outStatus + baseIndex : nullptr,
+                    scratch,
+                    successFlags))
+                {
+                    allOk.store(false, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        return allOk.load(std::memory_order_relaxed);
+    }
+
+    static bool TransformXYZPointsInternal(const TransformPair& pair, std::vector<double>& x, std::vector<double>& y, std::vector<double>& z, std::vector<std::uint8_t>* outStatus, bool enableOpenMP, double epoch)
+    {
+        const size_t count = x.size();
+        if (outStatus != nullptr)
+        {
+            outStatus->assign(count, 0);
+        }
+
+        if (y.size() != count || z.size() != count)
+        {
+            return false;
+        }
+
+        if (count == 0)
+        {
+            return true;
+        }
+
+        return TransformXYArraysInternal(
+            pair,
+            x.data(),
+            y.data(),
+            z.data(),
+            nullptr,
+            (IsFinite(epoch) && epoch > 0.0) ? epoch : 0.0,
+            count,
+            1,
+            (outStatus != nullptr) ? outStatus->data() : nullptr,
+            enableOpenMP);
+    }
+
+    static bool TransformBoundingBoxInternal(TransformItem& item, const GB_Rectangle& sourceRect, int sampleGridCount, bool useCrsId, GeoBoundingBox& outBox)
+    {
+        outBox = GeoBoundingBox::Invalid;
+
+        GB_Rectangle targetRect;
+        if (!TryTransformRectangleToAabbInternal(item, sourceRect, sampleGridCount, targetRect))
+        {
+            return false;
+        }
+
+        GeoBoundingBox result;
+        AssignTargetCrs(*item.prototype, useCrsId, result);
+        result.rect = targetRect;
+        outBox = result;
+        return outBox.IsValid();
+    }
+
+    // -------------------- 批量 bbox：按源 CRS 分桶 --------------------
+
+    // 同一源 CRS（同一 TransformKey）下的全部 bbox 下标。
+    struct BoundingBoxBucket
+    {
+        TransformPair pair;
+        std::vector<size_t> boxIndices;
+    };
+
+    // 一个桶内连续的一段 bbox，作为共用同一 TransformItem 的工作单元（OpenMP 时按块并行）。
+    struct BoundingBoxBlock
+    {
+        size_t bucketIndex = 0;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    // 逐个 bbox 走与 TransformBoundingBox 相同的算法（TransformBounds / 网格兜底、反经线与极点处理），
+    // 只是整块共用一个 TransformItem，结果与逐个调用 TransformBoundingBox 完全一致。
+    static bool TransformBoundingBoxBlockInternal(TransformItem& item, std::vector<GeoBoundingBox>& boxes, const size_t* boxIndices, size_t boxCount, int sampleGridCount)
+    {
+        bool allOk = true;
+        for (size_t i = 0; i < boxCount; i++)
+        {
+            GeoBoundingBox& bbox = boxes[boxIndices[i]];
+
+            GB_Rectangle targetRect;
+            if (!TryTransformRectangleToAabbInternal(item, bbox.rect, sampleGridCount, targetRect))
+            {
+                bbox = GeoBoundingBox::Invalid;
+                allOk = false;
+                continue;
+            }
+
+            AssignTargetCrs(*item.prototype, bbox.UsesCrsId(), bbox);
+            bbox.rect = targetRect;
+        }
+
+        return allOk;
+    }
+
+    // -------------------- 近似（插值）转换：自适应四叉树网格 --------------------
+
+    // 四叉树节点：叶子节点保存 4 个角点的精确转换结果，查询时双线性插值。
+    // 角点顺序：0=(minX,minY) 1=(maxX,minY) 2=(minX,maxY) 3=(maxX,maxY)。
+    struct ApproxNode
+    {
+        double minX = 0;
+        double minY = 0;
+        double maxX = 0;
+        double maxY = 0;
+
+        // 4 个子节点在 nodes 中连续存放，firstChild 为第一个子节点下标；叶子为 -1。
+        int firstChild = -1;
+
+        // 叶子节点能否插值；为 false 时（采样失败、跨反经线、达到最大深度仍超差）该格内的点走精确转换。
+        bool hasValues = false;
+        double cornerX[4] = { 0, 0, 0, 0 };
+        double cornerY[4] = { 0, 0, 0, 0 };
+    };
+
+    struct ApproxGrid
+    {
+        std::vector<ApproxNode> nodes;
+        double maxError = 0;
+        size_t interpolatedCellCount = 0;
+        size_t exactCellCount = 0;
+    };
+
+    // 每个格子按 3x3 采样：4 个角点用于插值，4 个边中点 + 中心点用于估计插值误差。
+    constexpr int kApproxSamplesPerAxis = 3;
+    constexpr int kApproxSamplesPerCell = kApproxSamplesPerAxis * kApproxSamplesPerAxis;
+
+    // 四叉树节点总数上限（约 25 MB）：跨反经线或含投影奇点的格子无论多深都可能超差，
+    // 只靠 maxDepth（最多 4^16 个节点）无法约束构建开销；达到上限后剩余的待测格子直接作为精确转换叶子。
+    constexpr size_t kApproxMaxNodeCount = 1 << 18;
+
+    static void InterpolateApproxNode(const ApproxNode& node, double x, double y, double& outX, double& outY)
+    {
+        const double u = (x - node.minX) / (node.maxX - node.minX);
+        const double v = (y - node.minY) / (node.maxY - node.minY);
+        const double w0 = (1.0 - u) * (1.0 - v);
+        const double w1 = u * (1.0 - v);
+        const double w2 = (1.0 - u) * v;
+        const double w3 = u * v;
+        outX = w0 * node.cornerX[0] + w1 * node.cornerX[1] + w2 * node.cornerX[2] + w3 * node.cornerX[3];
+        outY = w0 * node.cornerY[0] + w1 * node.cornerY[1] + w2 * node.cornerY[2] + w3 * node.cornerY[3];
+    }
+
+    // 找到包含 (x, y) 的叶子节点；点不在根节点范围内时返回 nullptr。
+    static const ApproxNode* FindApproxLeaf(const std::vector<ApproxNode>& nodes, double x, double y)
+    {
+        if (nodes.empty())
+        {
+            return nullptr;
+        }
+
+        const ApproxNode* node = &nodes[0];
+        if (!(x >= node->minX && x <= node->maxX && y >= node->minY && y <= node->maxY))
+        {
+            return nullptr;
+        }
+
+        while (node->firstChild >= 0)
+        {
+            const double midX = (node->minX + node->maxX) * 0.5;
+            const double midY = (node->minY + node->maxY) * 0.5;
+            const int quadrant = (x < midX ? 0 : 1) + (y < midY ? 0 : 2);
+            node = &nodes[static_cast<size_t>(node->firstChild + quadrant)];
+        }
+        return node;
+    }
+
+    // 逐层（广度优先）构建自适应网格：同一层所有待测格子的采样点合并为一次批量转换。
+    // - 格子的误差 = 5 个检查点上“双线性插值结果”与“精确结果”之差的最大欧氏距离（目标 CRS 单位）；
+    // - 误差 <= tolerance 时成为可插值叶子；否则继续四分，直到 maxDepth；
+    // - 达到 maxDepth 仍超差（或有采样点失败）的格子标记为精确转换叶子；
+    // - 节点总数达到 kApproxMaxNodeCount 后不再四分。
+    static bool BuildApproxGrid(TransformItem& item, const GB_Rectangle& sourceRect, double tolerance, int maxDepth, ApproxGrid& outGrid)
+    {
+        outGrid = ApproxGrid();
+
+        const TransformPrototype& prototype = *item.prototype;
+
+        ApproxNode root;
+        root.minX = sourceRect.minX;
+        root.minY = sourceRect.minY;
+        root.maxX = sourceRect.maxX;
+        root.maxY = sourceRect.maxY;
+        outGrid.nodes.push_back(root);
+
+        std::vector<size_t> pending(1, 0);
+        std::vector<size_t> nextPending;
+        std::vector<double> xValues;
+        std::vector<double> yValues;
+        std::vector<int> successFlags;
+
+        for (int depth = 0; !pending.empty(); depth++)
+        {
+            const size_t sampleCount = pending.size() * kApproxSamplesPerCell;
+            xValues.resize(sampleCount);
+            yValues.resize(sampleCount);
+            successFlags.assign(sampleCount, FALSE);
+
+            for (size_t cellIndex = 0; cellIndex < pending.size(); cellIndex++)
+            {
+                const ApproxNode& node = outGrid.nodes[pending[cellIndex]];
+                for (int yIndex = 0; yIndex < kApproxSamplesPerAxis; yIndex++)
+                {
+                    const double y = node.minY + (node.maxY - node.minY) * (static_cast<double>(yIndex) / (kApproxSamplesPerAxis - 1));
+                    for (int xIndex = 0; xIndex < kApproxSamplesPerAxis; xIndex++)
+                    {
+                        double x = node.minX + (node.maxX - node.minX) * (static_cast<double>(xIndex) / (kApproxSamplesPerAxis - 1));
+                        if (prototype.sourceIsGeographic)
+                        {
+                            x = NormalizeLongitudeDegrees(x);
+                        }
+
+                        const size_t sampleIndex = cellIndex * kApproxSamplesPerCell + static_cast<size_t>(yIndex * kApproxSamplesPerAxis + xIndex);
+                        xValues[sampleIndex] = x;
+                        yValues[sampleIndex] = y;
+                    }
+                }
+            }
+
+            for (size_t begin = 0; begin < sampleCount; begin += kTransformChunkSize)
+            {
+                const size_t chunkCount = std::min(kTransformChunkSize, sampleCount - begin);
+                TransformCoordinatesInternal(item, chunkCount, xValues.data() + begin, yValues.data() + begin, nullptr, nullptr, successFlags.data() + begin);
+            }
+
+            nextPending.clear();
+            for (size_t cellIndex = 0; cellIndex < pending.size(); cellIndex++)
+            {
+                const size_t nodeIndex = pending[cellIndex];
+                const size_t sampleBase = cellIndex * kApproxSamplesPerCell;
+
+                bool allSamplesOk = true;
+                for (int i = 0; i < kApproxSamplesPerCell; i++)
+                {
+                    const size_t sampleIndex = sampleBase + static_cast<size_t>(i);
+                    if (successFlags[sampleIndex] == FALSE || !IsFinite(xValues[sampleIndex]) || !IsFinite(yValues[sampleIndex]))
+                    {
+                        allSamplesOk = false;
+                        break;
+                    }
+                    if (prototype.targetIsGeographic)
+                    {
+                        xValues[sampleIndex] = NormalizeLongitudeDegrees(xValues[sampleIndex]);
+                    }
+                }
+
+                double cellError = std::numeric_limits<double>::infinity();
+                if (allSamplesOk)
+                {
+                    ApproxNode& node = outGrid.nodes[nodeIndex];
+                    const int cornerSamples[4] = { 0, 2, 6, 8 };
+                    for (int corner = 0; corner < 4; corner++)
+                    {
+                        node.cornerX[corner] = xValues[sampleBase + static_cast<size_t>(cornerSamples[corner])];
+                        node.cornerY[corner] = yValues[sampleBase + static_cast<size_t>(cornerSamples[corner])];
+                    }
+
+                    // 检查点：边中点（1、3、5、7）与中心点（4），u/v 取 0、0.5 或 1。
+                    const int checkSamples[5] = { 1, 3, 4, 5, 7 };
+                    cellError = 0;
+                    for (int i = 0; i < 5; i++)
+                    {
+                        const int sample = checkSamples[i];
+                        const double u = static_cast<double>(sample % kApproxSamplesPerAxis) / (kApproxSamplesPerAxis - 1);
+                        const double v = static_cast<double>(sample / kApproxSamplesPerAxis) / (kApproxSamplesPerAxis - 1);
+                        double predictedX = 0;
+                        double predictedY = 0;
+                        InterpolateApproxNode(node, node.minX + (node.maxX - node.minX) * u, node.minY + (node.maxY - node.minY) * v, predictedX, predictedY);
+
+                        const double dx = predictedX - xValues[sampleBase + static_cast<size_t>(sample)];
+                        const double dy = predictedY - yValues[sampleBase + static_cast<size_t>(sample)];
+                        cellError = std::max(cellError, std::sqrt(dx * dx + dy * dy));
+                    }
+                }
+
+                if (cellError <= tolerance)
+                {
+                    outGrid.nodes[nodeIndex].hasValues = true;
+                    outGrid.maxError = std::max(outGrid.maxError, cellError);
+                    outGrid.interpolatedCellCount++;
+                    continue;
+                }
+
+                if (depth >= maxDepth || outGrid.nodes.size() + 4 > kApproxMaxNodeCount)
+                {
+                    outGrid.nodes[nodeIndex].hasValues = false;
+                    outGrid.exactCellCount++;
+                    continue;
+                }
+
+                const ApproxNode parent = outGrid.nodes[nodeIndex];
+                const double midX = (parent.minX + parent.maxX) * 0.5;
+                const double midY = (parent.minY + parent.maxY) * 0.5;
+                const size_t firstChild = outGrid.nodes.size();
+                outGrid.nodes[nodeIndex].firstChild = static_cast<int>(firstChild);
+                outGrid.nodes[nodeIndex].hasValues = false;
+
+                for (int quadrant = 0; quadrant < 4; quadrant++)
+                {
+                    ApproxNode child;
+                    child.minX = (quadrant & 1) ? midX : parent.minX;
+                    child.maxX = (quadrant & 1) ? parent.maxX : midX;
+                    child.minY = (quadrant & 2) ? midY : parent.minY;
+                    child.maxY = (quadrant & 2) ? parent.maxY : midY;
+                    outGrid.nodes.push_back(child);
+                    nextPending.push_back(firstChild + static_cast<size_t>(quadrant));
+                }
+            }
+
+            pending.swap(nextPending);
+        }
+
+        return outGrid.interpolatedCellCount > 0 || outGrid.exactCellCount > 0;
+    }
+
+}
+
+struct GeoCrsPreparedTransform::Impl
+{
+    TransformPair pair;
+};
+
+GeoCrsPreparedTransform::GeoCrsPreparedTransform() = default;
+
+bool GeoCrsPreparedTransform::IsValid() const
+{
+    return impl != nullptr;
+}
+
+bool GeoCrsPreparedTransform::TransformPoint(const GB_Point2d& sourcePoint, GB_Point2d& outPoint) const
+{
+    outPoint = sourcePoint;
+
+    if (!IsFinitePoint(sourcePoint))
+    {
+        return false;
+    }
+
+    double outX = sourcePoint.x;
+    double outY = sourcePoint.y;
+    if (!TransformXY(sourcePoint.x, sourcePoint.y, outX, outY))
+    {
+        return false;
+    }
+
+    outPoint.Set(outX, outY);
+    return outPoint.IsValid();
+}
+
+bool GeoCrsPreparedTransform::TransformPoint(GB_Point2d& inOutPoint) const
+{
+    GB_Point2d transformed;
+    if (!TransformPoint(inOutPoint, transformed))
+    {
+        return false;
+    }
+
+    inOutPoint = transformed;
+    return true;
+}
+
+bool GeoCrsPreparedTransform::TransformPoints(const std::vector<GB_Point2d>& sourcePoints, std::vector<GB_Point2d>& outPoints, bool enableOpenMP, std::vector<std::uint8_t>* outStatus, size_t* outInvalidCount) const
+{
+    outPoints = sourcePoints;
+    return TransformPoints(outPoints, enableOpenMP, outStatus, outInvalidCount);
+}
+
+bool GeoCrsPreparedTransform::TransformPoints(std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP, std::vector<std::uint8_t>* outStatus, size_t* outInvalidCount) const
+{
+    return TransformPointsWithStatusInternal((impl != nullptr) ? &impl->pair : nullptr, inOutPoints, enableOpenMP, outStatus, outInvalidCount);
+}
+
+bool GeoCrsPreparedTransform::TransformXYArrays(double* x, double* y, double* z, size_t count, size_t stride, std::uint8_t* outStatus, bool enableOpenMP) const
+{
+    if (count == 0)
+    {
+        return true;
+    }
+
+    if (impl == nullptr)
+    {
+        if (outStatus != nullptr)
+        {
+            std::memset(outStatus, 0, count);
+        }
+        return false;
+    }
+
+    return TransformXYArraysInternal(impl->pair, x, y, z, nullptr, 0.0, count, stride, outStatus, enableOpenMP);
+}
+
+bool GeoCrsPreparedTransform::TransformXY(double x, double y, double& outX, double& outY) const
+{
+    outX = x;
+    outY = y;
+
+    TransformItemPtr item;
+    if (impl == nullptr || !TryGetTransformItem(impl->pair, item) || item == nullptr)
+    {
+        return false;
+    }
+
+    return TryTransformSingleXYInternal(*item, x, y, outX, outY);
+}
+
+bool GeoCrsPreparedTransform::TransformXYZ(double x, double y, double z, double& outX, double& outY, double& outZ) const
+{
+    outX = x;
+    outY = y;
+    outZ = z;
+
+    TransformItemPtr item;
+    if (impl == nullptr || !TryGetTransformItem(impl->pair, item) || item == nullptr)
+    {
+        return false;
+    }
+
+    return TryTransformSingleXYZInternal(*item, x, y, z, outX, outY, outZ);
+}
+
+bool GeoCrsPreparedTransform::TransformXYZPoints(std::vector<double>& x, std::vector<double>& y, std::vector<double>& z, std::vector<std::uint8_t>* outStatus, bool enableOpenMP, double epoch) const
+{
+    if (impl == nullptr)
+    {
+        if (outStatus != nullptr)
+        {
+            outStatus->assign(x.size(), 0);
+        }
+        return x.empty() && y.empty() && z.empty();
+    }
+
+    return TransformXYZPointsInternal(impl->pair, x, y, z, outStatus, enableOpenMP, epoch);
+}
+
+bool GeoCrsPreparedTransform::TransformXYZTArrays(double* x, double* y, double* z, double* t, size_t count, size_t stride, std::uint8_t* outStatus, bool enableOpenMP) const
+{
+    if (count == 0)
+    {
+        return true;
+    }
+
+    if (impl == nullptr)
+    {
+        if (outStatus != nullptr)
+        {
+            std::memset(outStatus, 0, count);
+        }
+        return false;
+    }
+
+    return TransformXYArraysInternal(impl->pair, x, y, z, t, 0.0, count, stride, outStatus, enableOpenMP);
+}
+
+bool GeoCrsPreparedTransform::TransformBoundingBox(const GB_Rectangle& sourceRect, GeoBoundingBox& outBox, int sampleGridCount) const
+{
+    outBox = GeoBoundingBox::Invalid;
+
+    if (!sourceRect.IsValid())
+    {
+        return false;
+    }
+
+    TransformItemPtr item;
+    if (impl == nullptr || !TryGetTransformItem(impl->pair, item) || item == nullptr)
+    {
+        return false;
+    }
+
+    return TransformBoundingBoxInternal(*item, sourceRect, sampleGridCount, false, outBox);
+}
+
+bool GeoCrsPreparedTransform::TransformBoundingBoxParts(const GB_Rectangle& sourceRect, std::vector<GeoBoundingBox>& outParts, int sampleGridCount) const
+{
+    outParts.clear();
+
+    if (!sourceRect.IsValid())
+    {
+        return false;
+    }
+
+    TransformItemPtr item;
+    if (impl == nullptr || !TryGetTransformItem(impl->pair, item) || item == nullptr)
+    {
+        return false;
+    }
+
+    return TransformBoundingBoxPartsInternal(*item, sourceRect, sampleGridCount, false, outParts);
+}
+
+struct GeoCrsApproxTransform::Impl
+{
+    GeoCrsPreparedTransform exact;
+    ApproxGrid grid;
+    double tolerance = 0;
+    bool targetIsGeographic = false;
+};
+
+GeoCrsApproxTransform::GeoCrsApproxTransform() = default;
+
+bool GeoCrsApproxTransform::IsValid() const
+{
+    return impl != nullptr;
+}
+
+double GeoCrsApproxTransform::GetTolerance() const
+{
+    return impl == nullptr ? 0.0 : impl->tolerance;
+}
+
+double GeoCrsApproxTransform::GetMaxError() const
+{
+    return impl == nullptr ? 0.0 : impl->grid.maxError;
+}
+
+size_t GeoCrsApproxTransform::GetInterpolatedCellCount() const
+{
+    return impl == nullptr ? 0 : impl->grid.interpolatedCellCount;
+}
+
+size_t GeoCrsApproxTransform::GetExactCellCount() const
+{
+    return impl == nullptr ? 0 : impl->grid.exactCellCount;
+}
+
+bool GeoCrsApproxTransform::TransformXY(double x, double y, double& outX, double& outY) const
+{
+    outX = x;
+    outY = y;
+
+    if (impl == nullptr || !IsFinite(x) || !IsFinite(y))
+    {
+        return false;
+    }
+
+    const ApproxNode* leaf = FindApproxLeaf(impl->grid.nodes, x, y);
+    if (leaf == nullptr || !leaf->hasValues)
+    {
+        return impl->exact.TransformXY(x, y, outX, outY);
+    }
+
+    double transformedX = x;
+    double transformedY = y;
+    InterpolateApproxNode(*leaf, x, y, transformedX, transformedY);
+    if (impl->targetIsGeographic)
+    {
+        transformedX = NormalizeLongitudeDegrees(transformedX);
+    }
+
+    outX = transformedX;
+    outY = transformedY;
+    return true;
+}
+
+bool GeoCrsApproxTransform::TransformXYArrays(double* x, double* y, size_t count, std::uint8_t* outStatus, bool enableOpenMP) const
+{
+    if (count == 0)
+    {
+        return true;
+    }
+
+    if (outStatus != nullptr)
+    {
+        std::memset(outStatus, 0, count);
+    }
+
+    if (impl == nullptr || x == nullptr || y == nullptr)
+    {
+        return false;
+    }
+
+    // 1) 插值（只读访问网格，可并行）；需要精确转换的点先记为 2，随后统一批量转换。
+    std::vector<std::uint8_t> states(count, 0);
+    const std::vector<ApproxNode>& nodes = impl->grid.nodes;
+    const bool targetIsGeographic = impl->targetIsGeographic;
+
+    auto interpolateOne = [&](size_t index) {
+        const double sourceX = x[index];
+        const double sourceY = y[index];
+        if (!IsFinite(sourceX) || !IsFinite(sourceY))
+        {
+            return;
+        }
+
+        const ApproxNode* leaf = FindApproxLeaf(nodes, sourceX, sourceY);
+        if (leaf == nullptr || !leaf->hasValues)
+        {
+            states[index] = 2;
+            return;
+        }
+
+        double transformedX = sourceX;
+        double transformedY = sourceY;
+        InterpolateApproxNode(*leaf, sourceX, sourceY, transformedX, transformedY);
+        if (targetIsGeographic)
+        {
+            transformedX = NormalizeLongitudeDegrees(transformedX);
+        }
+
+        x[index] = transformedX;
+        y[index] = transformedY;
+        states[index] = 1;
+    };
+
+    const bool useParallel = enableOpenMP && count <= static_cast<size_t>(std::numeric_limits<int>::max());
+    if (useParallel)
+    {
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(count); i++)
+        {
+            interpolateOne(static_cast<size_t>(i));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            interpolateOne(i);
+        }
+    }
+
+    // 2) 网格外 / 不可插值格内的点走精确转换。
+    std::vector<size_t> exactIndices;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (states[i] == 2)
+        {
+            exactIndices.push_back(i);
+        }
+    }
+
+    if (!exactIndices.empty())
+    {
+        const size_t exactCount = exactIndices.size();
+        std::vector<double> exactX(exactCount);
+        std::vector<double> exactY(exactCount);
+        std::vector<std::uint8_t> exactStatus(exactCount, 0);
+        for (size_t i = 0; i < exactCount; i++)
+        {
+            exactX[i] = x[exactIndices[i]];
+            exactY[i] = y[exactIndices[i]];
+        }
+
+        impl->exact.TransformXYArrays(exactX.data(), exactY.data(), nullptr, exactCount, 1, exactStatus.data(), enableOpenMP);
+
+        for (size_t i = 0; i < exactCount; i++)
+        {
+            const size_t index = exactIndices[i];
+            if (exactStatus[i] == 0)
+            {
+                states[index] = 0;
+                continue;
+            }
+
+            double transformedX = exactX[i];
+            if (targetIsGeographic)
+            {
+                transformedX = NormalizeLongitudeDegrees(transformedX);
+            }
+            x[index] = transformedX;
+            y[index] = exactY[i];
+            states[index] = 1;
+        }
+    }
+
+    bool allOk = true;
+    for (size_t i = 0; i < count; i++)
+    {
+        const bool ok = states[i] == 1;
+        if (outStatus != nullptr)
+        {
+            outStatus[i] = ok ? 1 : 0;
+        }
+        allOk = allOk && ok;
+    }
+    return allOk;
+}
+
+bool GeoCrsApproxTransform::TransformPoints(std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP) const
+{
+    const size_t count = inOutPoints.size();
+    if (count == 0)
+    {
+        return true;
+    }
+
+    std::vector<double> xValues(count);
+    std::vector<double> yValues(count);
+    std::vector<std::uint8_t> status(count, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        xValues[i] = inOutPoints[i].x;
+        yValues[i] = inOutPoints[i].y;
+    }
+
+    bool allOk = TransformXYArrays(xValues.data(), yValues.data(), count, status.data(), enableOpenMP);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (status[i] == 0)
+        {
+            continue;
+        }
+
+        GB_Point2d& point = inOutPoints[i];
+        point.Set(xValues[i], yValues[i]);
+        if (!point.IsValid())
+        {
+            allOk = false;
+        }
+    }
+    return allOk;
+}
+
+GeoCrsPreparedTransform GeoCrsTransform::Prepare(const std::string& sourceWktUtf8, const std::string& targetWktUtf8)
+{
+    GeoCrsPreparedTransform prepared;
+
+    std::shared_ptr<GeoCrsPreparedTransform::Impl> impl = std::make_shared<GeoCrsPreparedTransform::Impl>();
+    if (!TryResolveTransformPair(sourceWktUtf8, targetWktUtf8, impl->pair))
+    {
+        return prepared;
+    }
+
+    // 在调用线程上预先创建一次转换，确保 IsValid() 能反映“该 CRS 对可转换”。
+    TransformItemPtr item;
+    if (!TryGetTransformItem(impl->pair, item) || item == nullptr)
+    {
+        return prepared;
+    }
+
+    prepared.impl = std::move(impl);
+    return prepared;
+}
+
+GeoCrsApproxTransform GeoCrsTransform::PrepareApprox(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const GB_Rectangle& sourceRect, double maxError, int maxDepth)
+{
+    GeoCrsApproxTransform approx;
+
+    if (!sourceRect.IsValid() || sourceRect.Area() <= 0.0 || !IsFinite(maxError) || maxError <= 0.0)
+    {
+        return approx;
+    }
+
+    GeoCrsPreparedTransform exact = Prepare(sourceWktUtf8, targetWktUtf8);
+    if (!exact.IsValid())
+    {
+        return approx;
+    }
+
+    TransformItemPtr item;
+    if (!TryGetTransformItem(exact.impl->pair, item) || item == nullptr)
+    {
+        return approx;
     }
 
-    static void TransformPointsChunkInternal(
-        TransformItem& item,
-        std::vector<GB_Point2d>& points,
-        size_t baseIndex,
-        size_t count,
-        std::atomic_bool& allOk,
-        std::vector<double>& xValues,
-        std::vector<double>& yValues,
-        std::vector<int>& successFlags,
-        std::vector<size_t>& indexMap)
+    std::shared_ptr<GeoCrsApproxTransform::Impl> impl = std::make_shared<GeoCrsApproxTransform::Impl>();
+    impl->targetIsGeographic = item->prototype->targetIsGeographic;
+    impl->tolerance = maxError;
+    if (!BuildApproxGrid(*item, sourceRect, maxError, std::max(0, std::min(maxDepth, 16)), impl->grid))
     {
-        xValues.clear();
-        yValues.clear();
-        indexMap.clear();
+        return approx;
+    }
 
-        xValues.reserve(count);
-        yValues.reserve(count);
-        indexMap.reserve(count);
+    impl->exact = std::move(exact);
+    approx.impl = std::move(impl);
+    return approx;
+}
 
-        for (size_t i = 0; i < count; i++)
+bool GeoCrsTransform::TransformPoint(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const GB_Point2d& sourcePoint, GB_Point2d& outPoint)
+{
+    outPoint = sourcePoint;
+
+    if (!IsFinitePoint(sourcePoint))
+    {
+        return false;
+    }
+
+    TransformItemPtr item;
+    if (!TryGetTransformItem(sourceWktUtf8, targetWktUtf8, item) || item == nullptr)
+    {
+        return false;
+    }
+
+    double outX = sourcePoint.x;
+    double outY = sourcePoint.y;
+    if (!TryTransformSingleXYInternal(*item, sourcePoint.x, sourcePoint.y, outX, outY))
+    {
+        return false;
+    }
+
+    outPoint.Set(outX, outY);
+    return outPoint.IsValid();
+}
+
+bool GeoCrsTransform::TransformPoint(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, GB_Point2d& inOutPoint)
+{
+    GB_Point2d transformed;
+    if (!TransformPoint(sourceWktUtf8, targetWktUtf8, inOutPoint, transformed))
+    {
+        return false;
+    }
+
+    inOutPoint = transformed;
+    return true;
+}
+
+bool GeoCrsTransform::TransformPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const std::vector<GB_Point2d>& sourcePoints, std::vector<GB_Point2d>& outPoints, bool enableOpenMP, std::vector<std::uint8_t>* outStatus, size_t* outInvalidCount)
+{
+    outPoints = sourcePoints;
+    return TransformPoints(sourceWktUtf8, targetWktUtf8, outPoints, enableOpenMP, outStatus, outInvalidCount);
+}
+
+bool GeoCrsTransform::TransformPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP, std::vector<std::uint8_t>* outStatus, size_t* outInvalidCount)
+{
+    if (inOutPoints.empty())
+    {
+        return TransformPointsWithStatusInternal(nullptr, inOutPoints, enableOpenMP, outStatus, outInvalidCount);
+    }
+
+    // 只在调用线程解析一次 CRS 对；OpenMP 各线程仅按 key 取各自的 TransformItem。
+    TransformPair pair;
+    const bool resolved = TryResolveTransformPair(sourceWktUtf8, targetWktUtf8, pair);
+    return TransformPointsWithStatusInternal(resolved ? &pair : nullptr, inOutPoints, enableOpenMP, outStatus, outInvalidCount);
+}
+
+bool GeoCrsTransform::TransformXYArrays(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double* x, double* y, double* z, size_t count, size_t stride, std::uint8_t* outStatus, bool enableOpenMP)
+{
+    if (count == 0)
+    {
+        return true;
+    }
+
+    TransformPair pair;
+    if (!TryResolveTransformPair(sourceWktUtf8, targetWktUtf8, pair))
+    {
+        if (outStatus != nullptr)
         {
-            const size_t pointIndex = baseIndex + i;
-            GB_Point2d& point = points[pointIndex];
+            std::memset(outStatus, 0, count);
+        }
+        return false;
+    }
 
-            if (!IsFinitePoint(point))
+    return TransformXYArraysInternal(pair, x, y, z, nullptr, 0.0, count, stride, outStatus, enableOpenMP);
+}
+
+bool GeoCrsTransform::TransformXY(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double x, double y, double& outX, double& outY)
+{
+    outX = x;
+    outY = y;
+
+    TransformItemPtr item;
+    if (!TryGetTransformItem(sourceWktUtf8, targetWktUtf8, item) || item == nullptr)
+    {
+        return false;
+    }
+
+    return TryTransformSingleXYInternal(*item, x, y, outX, outY);
+}
+
+bool GeoCrsTransform::TransformXYZ(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double x, double y, double z, double& outX, double& outY, double& outZ)
+{
+    outX = x;
+    outY = y;
+    outZ = z;
+
+    TransformItemPtr item;
+    if (!TryGetTransformItem(sourceWktUtf8, targetWktUtf8, item) || item == nullptr)
+    {
+        return false;
+    }
+
+    return TryTransformSingleXYZInternal(*item, x, y, z, outX, outY, outZ);
+}
+
+bool GeoCrsTransform::TransformXYZPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, std::vector<double>& x, std::vector<double>& y, std::vector<double>& z, std::vector<std::uint8_t>* outStatus, bool enableOpenMP, double epoch)
+{
+    TransformPair pair;
+    if (!TryResolveTransformPair(sourceWktUtf8, targetWktUtf8, pair))
+    {
+        if (outStatus != nullptr)
+        {
+            outStatus->assign(x.size(), 0);
+        }
+        return x.empty() && y.empty() && z.empty();
+    }
+
+    return TransformXYZPointsInternal(pair, x, y, z, outStatus, enableOpenMP, epoch);
+}
+
+bool GeoCrsTransform::TransformXYZTArrays(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double* x, double* y, double* z, double* t, size_t count, size_t stride, std::uint8_t* outStatus, bool enableOpenMP)
+{
+    if (count == 0)
+    {
+        return true;
+    }
+
+    TransformPair pair;
+    if (!TryResolveTransformPair(sourceWktUtf8, targetWktUtf8, pair))
+    {
+        if (outStatus != nullptr)
+        {
+            std::memset(outStatus, 0, count);
+        }
+        return false;
+    }
+
+    return TransformXYArraysInternal(pair, x, y, z, t, 0.0, count, stride, outStatus, enableOpenMP);
+}
+
+bool GeoCrsTransform::TransformBoundingBox(const GeoBoundingBox& sourceBox, const std::string& targetWktUtf8, GeoBoundingBox& outBox, int sampleGridCount)
+{
+    outBox = GeoBoundingBox::Invalid;
+
+    const std::string trimmedSourceWkt = GetTrimmedSourceWkt(sourceBox);
+    const std::string trimmedTargetWkt = GB_Utf8Trim(targetWktUtf8);
+    if (trimmedSourceWkt.empty() || trimmedTargetWkt.empty())
+    {
+        return false;
+    }
+
+    if (!sourceBox.IsValid() || !sourceBox.rect.IsValid())
+    {
+        return false;
+    }
+
+    TransformItemPtr item;
+    if (!TryGetTransformItem(trimmedSourceWkt, trimmedTargetWkt, item) || item == nullptr)
+    {
+        return false;
+    }
+
+    return TransformBoundingBoxInternal(*item, sourceBox.rect, sampleGridCount, sourceBox.UsesCrsId(), outBox);
+}
+
+bool GeoCrsTransform::TransformBoundingBox(GeoBoundingBox& inOutBox, const std::string& targetWktUtf8, int sampleGridCount)
+{
+    GeoBoundingBox transformed;
+    if (!TransformBoundingBox(inOutBox, targetWktUtf8, transformed, sampleGridCount))
+    {
+        return false;
+    }
+
+    inOutBox = transformed;
+    return true;
+}
+
+bool GeoCrsTransform::TransformBoundingBoxParts(const GeoBoundingBox& sourceBox, const std::string& targetWktUtf8, std::vector<GeoBoundingBox>& outParts, int sampleGridCount)
+{
+    outParts.clear();
+
+    const std::string trimmedSourceWkt = GetTrimmedSourceWkt(sourceBox);
+    const std::string trimmedTargetWkt = GB_Utf8Trim(targetWktUtf8);
+    if (trimmedSourceWkt.empty() || trimmedTargetWkt.empty())
+    {
+        return false;
+    }
+
+    if (!sourceBox.IsValid() || !sourceBox.rect.IsValid())
+    {
+        return false;
+    }
+
+    TransformItemPtr item;
+    if (!TryGetTransformItem(trimmedSourceWkt, trimmedTargetWkt, item) || item == nullptr)
+    {
+        return false;
+    }
+
+    return TransformBoundingBoxPartsInternal(*item, sourceBox.rect, sampleGridCount, sourceBox.UsesCrsId(), outParts);
+}
+
+bool GeoCrsTransform::TransformBoundingBoxes(const std::vector<GeoBoundingBox>& sourceBoxes, const std::string& targetWktUtf8, std::vector<GeoBoundingBox>& outBoxes, bool enableOpenMP, int sampleGridCount)
+{
+    outBoxes = sourceBoxes;
+    return TryTransformBoundingBoxes(outBoxes, targetWktUtf8, enableOpenMP, sampleGridCount);
+}
+
+bool GeoCrsTransform::TryTransformBoundingBoxes(std::vector<GeoBoundingBox>& inOutBoxes, const std::string& targetWktUtf8, bool enableOpenMP, int sampleGridCount)
+{
+    const std::string trimmedTargetWkt = GB_Utf8Trim(targetWktUtf8);
+    if (trimmedTargetWkt.empty())
+    {
+        return false;
+    }
+
+    const size_t count = inOutBoxes.size();
+    if (count == 0)
+    {
+        return true;
+    }
+
+    bool allOk = true;
+
+    // 1) 按源 CRS 分桶：先按 WKT 文本去重（同一 WKT 只解析一次），再按 TransformKey 合并（不同写法的同一 CRS 落入同一桶）。
+    std::vector<BoundingBoxBucket> buckets;
+    {
+        std::unordered_map<std::string, size_t> bucketIndexByWkt;
+        std::unordered_map<std::uint32_t, size_t> bucketIndexByCrsId;
+        std::unordered_map<TransformKey, size_t, TransformKeyHasher> bucketIndexByKey;
+        const size_t invalidBucketIndex = std::numeric_limits<size_t>::max();
+
+        auto resolveBucket = [&](const std::string& trimmedSourceWkt) {
+            TransformPair pair;
+            if (!TryResolveTransformPair(trimmedSourceWkt, trimmedTargetWkt, pair))
             {
-                allOk.store(false, std::memory_order_relaxed);
+                return invalidBucketIndex;
+            }
+
+            const auto keyIt = bucketIndexByKey.find(pair.key);
+            if (keyIt != bucketIndexByKey.end())
+            {
+                return keyIt->second;
+            }
+
+            const size_t bucketIndex = buckets.size();
+            bucketIndexByKey.emplace(pair.key, bucketIndex);
+            buckets.push_back(BoundingBoxBucket());
+            buckets.back().pair = std::move(pair);
+            return bucketIndex;
+        };
+
+        for (size_t i = 0; i < count; i++)
+        {
+            GeoBoundingBox& bbox = inOutBoxes[i];
+            if (!bbox.IsValid() || !bbox.rect.IsValid())
+            {
+                bbox = GeoBoundingBox::Invalid;
+                allOk = false;
                 continue;
             }
 
-            double x = point.x;
-            const double y = point.y;
-            if (item.sourceIsGeographic)
+            size_t bucketIndex = invalidBucketIndex;
+            if (bbox.UsesCrsId())
             {
-                x = NormalizeLongitudeDegrees(x);
+                // 以驻留 id 表示坐标系的 bbox：按 id 分桶，不接触 WKT 字符串。
+                const auto idIt = bucketIndexByCrsId.find(bbox.crsId);
+                if (idIt != bucketIndexByCrsId.end())
+                {
+                    bucketIndex = idIt->second;
+                }
+                else
+                {
+                    bucketIndex = resolveBucket(GeoCrsManager::GetCrsIdWktUtf8(bbox.crsId));
+                    bucketIndexByCrsId.emplace(bbox.crsId, bucketIndex);
+                }
+            }
+            else
+            {
+                std::string trimmedSourceWkt = GB_Utf8Trim(bbox.wktUtf8);
+                if (trimmedSourceWkt.empty())
+                {
+                    bbox = GeoBoundingBox::Invalid;
+                    allOk = false;
+                    continue;
+                }
+
+                const auto wktIt = bucketIndexByWkt.find(trimmedSourceWkt);
+                if (wktIt != bucketIndexByWkt.end())
+                {
+                    bucketIndex = wktIt->second;
+                }
+                else
+                {
+                    bucketIndex = resolveBucket(trimmedSourceWkt);
+                    bucketIndexByWkt.emplace(std::move(trimmedSourceWkt), bucketIndex);
+                }
             }
 
-            indexMap.push_back(pointIndex);
-            xValues.push_back(x);
-            yValues.push_back(y);
+            if (bucketIndex == invalidBucketIndex)
+            {
+                bbox = GeoBoundingBox::Invalid;
+                allOk = false;
+                continue;
+            }
+
+            buckets[bucketIndex].boxIndices.push_back(i);
         }
+    }
+
+    if (buckets.empty())
+    {
+        return allOk;
+    }
+
+    // 2) 把每个桶切成若干块：每块共用一个 TransformItem；开启 OpenMP 时保证块数足够分给各线程。
+    size_t maxBoxesPerBlock = count;
+#ifdef _OPENMP
+    if (enableOpenMP)
+    {
+        const size_t threadCount = static_cast<size_t>(std::max(1, omp_get_max_threads()));
+        maxBoxesPerBlock = std::min(maxBoxesPerBlock, std::max<size_t>(1, (count + threadCount - 1) / threadCount));
+    }
+#endif
+
+    std::vector<BoundingBoxBlock> blocks;
+    for (size_t bucketIndex = 0; bucketIndex < buckets.size(); bucketIndex++)
+    {
+        const size_t boxCount = buckets[bucketIndex].boxIndices.size();
+        for (size_t begin = 0; begin < boxCount; begin += maxBoxesPerBlock)
+        {
+            BoundingBoxBlock block;
+            block.bucketIndex = bucketIndex;
+            block.begin = begin;
+            block.end = std::min(boxCount, begin + maxBoxesPerBlock);
+            blocks.push_back(block);
+        }
+    }
+
+    // 3) 逐块转换（不同块写入不同 bbox，互不重叠）。
+    std::atomic_bool blocksOk(true);
+    auto transformBlock = [&](size_t blockIndex) {
+        const BoundingBoxBlock& block = blocks[blockIndex];
+        const BoundingBoxBucket& bucket = buckets[block.bucketIndex];
+        const size_t* boxIndices = bucket.boxIndices.data() + block.begin;
+        const size_t boxCount = block.end - block.begin;
 
-        const size_t validCount = indexMap.size();
-        if (validCount == 0)
+        TransformItemPtr item;
+        if (!TryGetTransformItem(bucket.pair, item) || item == nullptr || item->transform == nullptr)
         {
+            for (size_t i = 0; i < boxCount; i++)
+            {
+                inOutBoxes[boxIndices[i]] = GeoBoundingBox::Invalid;
+            }
+            blocksOk.store(false, std::memory_order_relaxed);
             return;
         }
 
-        if (validCount > static_cast<size_t>(std::numeric_limits<int>::max()))
+        if (!TransformBoundingBoxBlockInternal(*item, inOutBoxes, boxIndices, boxCount, sampleGridCount))
         {
-            allOk.store(false, std::memory_order_relaxed);
-            return;
+            blocksOk.store(false, std::memory_order_relaxed);
         }
+    };
 
-        successFlags.assign(validCount, FALSE);
-
-        const int overallOk = item.transform->Transform(
-            static_cast<int>(validCount),
-            xValues.data(),
-            yValues.data(),
-            nullptr,
-            successFlags.data());
-
-        if (overallOk == FALSE)
+    const size_t blockCount = blocks.size();
+    const bool useParallel = enableOpenMP && blockCount > 1 && blockCount <= static_cast<size_t>(std::numeric_limits<int>::max());
+    if (useParallel)
+    {
+#pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < static_cast<int>(blockCount); i++)
         {
-            allOk.store(false, std::memory_order_relaxed);
+            transformBlock(static_cast<size_t>(i));
         }
-
-        for (size_t i = 0; i < validCount; i++)
+    }
+    else
+    {
+        for (size_t i = 0; i < blockCount; i++)
         {
-            if (successFlags[i] == FALSE || !IsFinite(xValues[i]) || !IsFinite(yValues[i]))
-            {
-                allOk.store(false, std::memory_order_relaxed);
-                continue;
-            }
-
-            double x = xValues[i];
-            const double y = yValues[i];
-            if (item.targetIsGeographic)
-            {
-                x = NormalizeLongitudeDegrees(x);
-            }
-
-            GB_Point2d& point = points[indexMap[i]];
-            point.Set(x, y);
-            if (!point.IsValid())
-            {
-                allOk.store(false, std::memory_order_relaxed);
-            }
+            transformBlock(i);
         }
     }
+
+    return allOk && blocksOk.load(std::memory_order_relaxed);
 }
 
-bool GeoCrsTransform::TransformPoint(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const GB_Point2d& sourcePoint, GB_Point2d& outPoint)
+bool GeoCrsTransform::TransformPointStream(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const PointChunkReader& reader, const PointChunkWriter& writer, size_t chunkSize, int workerCount, StreamStatistics* outStatistics)
 {
-    outPoint = sourcePoint;
-
-    if (!IsFinitePoint(sourcePoint))
+    if (outStatistics != nullptr)
     {
-        return false;
+        *outStatistics = StreamStatistics();
     }
 
-    TransformItem* item = nullptr;
-    if (!TryGetTransformItem(sourceWktUtf8, targetWktUtf8, item) || item == nullptr)
+    if (!reader || !writer)
     {
         return false;
     }
 
-    double outX = sourcePoint.x;
-    double outY = sourcePoint.y;
-    if (!TryTransformSingleXYInternal(*item, sourcePoint.x, sourcePoint.y, outX, outY))
+    TransformPair pair;
+    if (!TryResolveTransformPair(sourceWktUtf8, targetWktUtf8, pair))
     {
         return false;
     }
 
-    outPoint.Set(outX, outY);
-    return outPoint.IsValid();
-}
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-bool GeoCrsTransform::TransformPoint(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, GB_Point2d& inOutPoint)
-{
-    GB_Point2d transformed;
-    if (!TransformPoint(sourceWktUtf8, targetWktUtf8, inOutPoint, transformed))
+    if (chunkSize == 0)
     {
-        return false;
+        chunkSize = 65536;
     }
+    workerCount = static_cast<int>(MapWeaverParallel::ResolveThreadCount(workerCount, static_cast<size_t>(std::numeric_limits<int>::max() - 2)));
 
-    inOutPoint = transformed;
-    return true;
-}
-
-bool GeoCrsTransform::TransformPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, const std::vector<GB_Point2d>& sourcePoints, std::vector<GB_Point2d>& outPoints, bool enableOpenMP)
-{
-    outPoints = sourcePoints;
-    return TransformPoints(sourceWktUtf8, targetWktUtf8, outPoints, enableOpenMP);
-}
+    // 固定数量的块缓冲区循环使用：Free -> Filled（已读取）-> Done（已转换）-> Free（已写出）。
+    enum class SlotState
+    {
+        Free,
+        Filled,
+        Done
+    };
 
-bool GeoCrsTransform::TransformPoints(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, std::vector<GB_Point2d>& inOutPoints, bool enableOpenMP)
-{
-    std::atomic_bool allOk(true);
+    struct StreamSlot
+    {
+        std::vector<GB_Point2d> points;
+        std::vector<double> xValues;
+        std::vector<double> yValues;
+        std::vector<std::uint8_t> status;
+        size_t count = 0;
+        std::uint64_t sequence = 0;
+        SlotState state = SlotState::Free;
+    };
 
-    const size_t count = inOutPoints.size();
-    if (count == 0)
+    const size_t slotCount = static_cast<size_t>(workerCount) + 2;
+    std::vector<StreamSlot> slots(slotCount);
+    for (StreamSlot& slot : slots)
     {
-        return true;
+        slot.points.resize(chunkSize);
+        slot.xValues.resize(chunkSize);
+        slot.yValues.resize(chunkSize);
+        slot.status.resize(chunkSize);
     }
 
-    constexpr size_t chunkSize = 4096;
-    const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
-    const bool useParallel = enableOpenMP && chunkCount <= static_cast<size_t>(std::numeric_limits<int>::max());
+    std::mutex mutex;
+    std::condition_variable stateChanged;
+    std::deque<size_t> filledQueue;
+    std::uint64_t readSequence = 0;
+    std::uint64_t writeSequence = 0;
+    bool readFinished = false;
+    bool aborted = false;
+    std::atomic_bool allOk(true);
+    MapWeaverParallel::FirstException firstException;
+
+    // 中止流水线：所有等待中的线程都会被唤醒并退出。
+    auto abortPipeline = [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        aborted = true;
+        allOk.store(false, std::memory_order_relaxed);
+        stateChanged.notify_all();
+    };
 
-    if (useParallel)
-    {
-#pragma omp parallel
+    // 读取线程：按顺序填充空闲块。
+    auto readChunks = [&]() {
+        try
         {
-            TransformItem* threadItem = nullptr;
-            if (!TryGetTransformItem(sourceWktUtf8, targetWktUtf8, threadItem) || threadItem == nullptr || threadItem->transform == nullptr)
+            size_t slotIndex = 0;
+            while (true)
             {
-                allOk.store(false, std::memory_order_relaxed);
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    stateChanged.wait(lock, [&]() { return aborted || slots[slotIndex].state == SlotState::Free; });
+                    if (aborted)
+                    {
+                        break;
+                    }
+                }
+
+                StreamSlot& slot = slots[slotIndex];
+                const size_t readCount = std::min(reader(slot.points.data(), chunkSize), chunkSize);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (readCount == 0)
+                {
+                    break;
+                }
+
+                slot.count = readCount;
+                slot.sequence = readSequence++;
+                slot.state = SlotState::Filled;
+                filledQueue.push_back(slotIndex);
+                stateChanged.notify_all();
+
+                slotIndex = (slotIndex + 1) % slotCount;
             }
+        }
+        catch (...)
+        {
+            firstException.Capture();
+            abortPipeline();
+        }
 
-            std::vector<double> xValues;
-            std::vector<double> yValues;
-            std::vector<int> successFlags;
-            std::vector<size_t> indexMap;
+        std::lock_guard<std::mutex> lock(mutex);
+        readFinished = true;
+        stateChanged.notify_all();
+    };
 
-#pragma omp for schedule(static)
-            for (int chunkIndex = 0; chunkIndex < static_cast<int>(chunkCount); chunkIndex++)
+    // 转换线程：取出已读取的块，原地转换。
+    auto transformSlot = [&](StreamSlot& slot) {
+        const size_t count = slot.count;
+        for (size_t i = 0; i < count; i++)
+        {
+            slot.xValues[i] = slot.points[i].x;
+            slot.yValues[i] = slot.points[i].y;
+        }
+
+        if (!TransformXYArraysInternal(pair, slot.xValues.data(), slot.yValues.data(), nullptr, nullptr, 0.0, count, 1, slot.status.data(), false))
+        {
+            allOk.store(false, std::memory_order_relaxed);
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (slot.status[i] == 0)
+            {
+                continue;
+            }
+
+            GB_Point2d& point = slot.points[i];
+            point.Set(slot.xValues[i], slot.yValues[i]);
+            if (!point.IsValid())
             {
-                if (threadItem == nullptr || threadItem->transform == nullptr)
+                slot.status[i] = 0;
+                allOk.store(false, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    auto transformChunks = [&]() {
+        try
+        {
+            while (true)
+            {
+                size_t slotIndex = 0;
                 {
-                    allOk.store(false, std::memory_order_relaxed);
-                    continue;
+                    std::unique_lock<std::mutex> lock(mutex);
+                    stateChanged.wait(lock, [&]() { return aborted || !filledQueue.empty() || readFinished; });
+                    if (aborted || filledQueue.empty())
+                    {
+                        return;
+                    }
+
+                    slotIndex = filledQueue.front();
+                    filledQueue.pop_front();
                 }
 
-                const size_t baseIndex = static_cast<size_t>(chunkIndex) * chunkSize;
-                const size_t remaining = count - baseIndex;
-                const size_t thisChunkCount = std::min(chunkSize, remaining);
-                TransformPointsChunkInternal(*threadItem, inOutPoints, baseIndex, thisChunkCount, allOk, xValues, yValues, successFlags, indexMap);
+                transformSlot(slots[slotIndex]);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                slots[slotIndex].state = SlotState::Done;
+                stateChanged.notify_all();
             }
         }
-    }
-    else
+        catch (...)
+        {
+            firstException.Capture();
+            abortPipeline();
+        }
+    };
+
+    StreamStatistics statistics;
     {
-        TransformItem* item = nullptr;
-        if (!TryGetTransformItem(sourceWktUtf8, targetWktUtf8, item) || item == nullptr || item->transform == nullptr)
+        // threads 在离开作用域时 join；在此之前必须保证已中止或已正常结束，否则等待中的线程不会退出。
+        MapWeaverParallel::ThreadGroup threads;
+        bool started = threads.TryStart(readChunks);
+        int startedWorkerCount = 0;
+        for (; started && startedWorkerCount < workerCount && threads.TryStart(transformChunks); startedWorkerCount++)
         {
-            return false;
         }
 
-        std::vector<double> xValues;
-        std::vector<double> yValues;
-        std::vector<int> successFlags;
-        std::vector<size_t> indexMap;
+        if (!started || startedWorkerCount == 0)
+        {
+            GBLOG_WARNING(GB_STR("【GeoCrsTransform::TransformPointStream】无法创建流水线线程"));
+            abortPipeline();
+        }
+
+        // 调用线程：按读取顺序写出已转换的块。
+        try
+        {
+            size_t writeSlotIndex = 0;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    stateChanged.wait(lock, [&]() {
+                        const StreamSlot& slot = slots[writeSlotIndex];
+                        const bool ready = slot.state == SlotState::Done && slot.sequence == writeSequence;
+                        return aborted || ready || (readFinished && writeSequence == readSequence);
+                    });
+
+                    if (aborted || slots[writeSlotIndex].state != SlotState::Done || slots[writeSlotIndex].sequence != writeSequence)
+                    {
+                        break;
+                    }
+                }
+
+                StreamSlot& slot = slots[writeSlotIndex];
+                const bool writeOk = writer(slot.points.data(), slot.status.data(), slot.count);
+
+                statistics.chunkCount++;
+                statistics.pointCount += slot.count;
+                for (size_t i = 0; i < slot.count; i++)
+                {
+                    if (slot.status[i] == 0)
+                    {
+                        statistics.failedCount++;
+                    }
+                }
 
-        for (size_t baseIndex = 0; baseIndex < count; baseIndex += chunkSize)
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.state = SlotState::Free;
+                writeSequence++;
+                writeSlotIndex = (writeSlotIndex + 1) % slotCount;
+                if (!writeOk)
+                {
+                    aborted = true;
+                    allOk.store(false, std::memory_order_relaxed);
+                }
+                stateChanged.notify_all();
+                if (aborted)
+                {
+                    break;
+                }
+            }
+        }
+        catch (...)
         {
-            const size_t remaining = count - baseIndex;
-            const size_t thisChunkCount = std::min(chunkSize, remaining);
-            TransformPointsChunkInternal(*item, inOutPoints, baseIndex, thisChunkCount, allOk, xValues, yValues, successFlags, indexMap);
+            firstException.Capture();
+            abortPipeline();
         }
-    }
 
-    return allOk.load(std::memory_order_relaxed);
-}
+        threads.JoinAll();
+    }
 
-bool GeoCrsTransform::TransformXY(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double x, double y, double& outX, double& outY)
-{
-    outX = x;
-    outY = y;
+    // 读取、转换或写出中抛出的第一个异常在所有线程结束后传给调用方。
+    firstException.RethrowIfAny();
 
-    TransformItem* item = nullptr;
-    if (!TryGetTransformItem(sourceWktUtf8, targetWktUtf8, item) || item == nullptr)
+    statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (outStatistics != nullptr)
     {
-        return false;
+        *outStatistics = statistics;
     }
 
-    return TryTransformSingleXYInternal(*item, x, y, outX, outY);
+    return allOk.load(std::memory_order_relaxed) && statistics.failedCount == 0;
 }
 
-bool GeoCrsTransform::TransformXYZ(const std::string& sourceWktUtf8, const std::string& targetWktUtf8, double x, double y, double z, double& outX, double& outY, double& outZ)
+std::vector<GeoCrsTransform::WarmupResult> GeoCrsTransform::Warmup(const std::vector<std::pair<std::string, std::string>>& wktPairsUtf8, int threadCount)
 {
-    outX = x;
-    outY = y;
-    outZ = z;
-
-    TransformItem* item = nullptr;
-    if (!TryGetTransformItem(sourceWktUtf8, targetWktUtf8, item) || item == nullptr)
+    const size_t pairCount = wktPairsUtf8.size();
+    std::vector<WarmupResult> results(pairCount);
+    if (pairCount == 0)
     {
-        return false;
+        return results;
     }
 
-    return TryTransformSingleXYZInternal(*item, x, y, z, outX, outY, outZ);
-}
+    MapWeaverParallel::RunParallelItems(pairCount, threadCount, [&](size_t index) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-bool GeoCrsTransform::TransformBoundingBox(const GeoBoundingBox& sourceBox, const std::string& targetWktUtf8, GeoBoundingBox& outBox, int sampleGridCount)
-{
-    outBox = GeoBoundingBox::Invalid;
+        TransformPair pair;
+        bool success = TryResolveTransformPair(wktPairsUtf8[index].first, wktPairsUtf8[index].second, pair);
+        if (success)
+        {
+            // 两端的有效范围供边界框转换使用；源端的范围在创建原型时也会用到。
+            GeoBoundingBox lonLatArea;
+            GeoBoundingBox selfArea;
+            GeoCrsManager::TryGetValidAreasCached(pair.trimmedSourceWkt, lonLatArea, selfArea);
+            GeoCrsManager::TryGetValidAreasCached(pair.trimmedTargetWkt, lonLatArea, selfArea);
 
-    const std::string trimmedSourceWkt = GB_Utf8Trim(sourceBox.wktUtf8);
-    const std::string trimmedTargetWkt = GB_Utf8Trim(targetWktUtf8);
-    if (trimmedSourceWkt.empty() || trimmedTargetWkt.empty())
-    {
-        return false;
-    }
+            const TransformPrototypePtr prototype = GetOrCreateTransformPrototype(pair);
+            success = prototype != nullptr && prototype->transform != nullptr;
+        }
 
-    if (!sourceBox.IsValid() || !sourceBox.rect.IsValid())
-    {
-        return false;
-    }
+        results[index].success = success;
+        results[index].milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    });
 
-    TransformItem* item = nullptr;
-    if (!TryGetTransformItem(trimmedSourceWkt, trimmedTargetWkt, item) || item == nullptr)
+    size_t failedCount = 0;
+    for (const WarmupResult& result : results)
     {
-        return false;
+        if (!result.success)
+        {
+            failedCount++;
+        }
     }
-
-    GB_Rectangle targetRect;
-    if (!TryTransformRectangleToAabbInternal(*item, sourceBox.rect, sampleGridCount, targetRect))
+    if (failedCount > 0)
     {
-        return false;
+        GBLOG_WARNING(GB_STR("【GeoCrsTransform::Warmup】部分 CRS 对预热失败: ") + std::to_string(failedCount) + GB_STR("/") + std::to_string(pairCount));
     }
+    return results;
+}
 
-    GeoBoundingBox result;
-    result.wktUtf8 = item->canonicalTargetWkt;
-    result.rect = targetRect;
-    outBox = result;
-    return outBox.IsValid();
+void GeoCrsTransform::SetThreadCacheCapacity(size_t capacity)
+{
+    g_threadCacheCapacity.store(std::max<size_t>(1, capacity), std::memory_order_relaxed);
 }
 
-bool GeoCrsTransform::TransformBoundingBox(GeoBoundingBox& inOutBox, const std::string& targetWktUtf8, int sampleGridCount)
+size_t GeoCrsTransform::GetThreadCacheCapacity()
 {
-    GeoBoundingBox transformed;
-    if (!TransformBoundingBox(inOutBox, targetWktUtf8, transformed, sampleGridCount))
-    {
-        return false;
-    }
+    return g_threadCacheCapacity.load(std::memory_order_relaxed);
+}
 
-    inOutBox = transformed;
-    return true;
+void GeoCrsTransform::SetPrototypeCacheCapacity(size_t capacity)
+{
+    g_prototypeCacheCapacity.store(std::max<size_t>(1, capacity), std::memory_order_relaxed);
 }
 
-bool GeoCrsTransform::TransformBoundingBoxes(const std::vector<GeoBoundingBox>& sourceBoxes, const std::string& targetWktUtf8, std::vector<GeoBoundingBox>& outBoxes, bool enableOpenMP, int sampleGridCount)
+size_t GeoCrsTransform::GetPrototypeCacheCapacity()
 {
-    outBoxes = sourceBoxes;
-    return TryTransformBoundingBoxes(outBoxes, targetWktUtf8, enableOpenMP, sampleGridCount);
+    return g_prototypeCacheCapacity.load(std::memory_order_relaxed);
 }
 
-bool GeoCrsTransform::TryTransformBoundingBoxes(std::vector<GeoBoundingBox>& inOutBoxes, const std::string& targetWktUtf8, bool enableOpenMP, int sampleGridCount)
+GeoCrsTransform::CacheStatistics GeoCrsTransform::GetCacheStatistics()
 {
-    const std::string trimmedTargetWkt = GB_Utf8Trim(targetWktUtf8);
-    if (trimmedTargetWkt.empty())
-    {
-        return false;
-    }
+    CacheStatistics statistics;
 
-    std::atomic_bool allOk(true);
-    const size_t count = inOutBoxes.size();
-    if (count == 0)
+    std::uint64_t cloneNanoseconds = 0;
     {
-        return true;
-    }
-
-    auto transformOne = [&](size_t index) {
-        GeoBoundingBox& bbox = inOutBoxes[index];
-
-        if (!bbox.IsValid() || !bbox.rect.IsValid())
-        {
-            bbox = GeoBoundingBox::Invalid;
-            allOk.store(false, std::memory_order_relaxed);
-            return;
-        }
-
-        const std::string trimmedSourceWkt = GB_Utf8Trim(bbox.wktUtf8);
-        if (trimmedSourceWkt.empty())
+        std::lock_guard<std::mutex> lock(g_countersRegistryMutex);
+
+        const auto accumulate = [&](const ThreadCacheCounters& counters) {
+            statistics.hitCount += counters.hitCount.load(std::memory_order_relaxed);
+            statistics.missCount += counters.missCount.load(std::memory_order_relaxed);
+            statistics.evictionCount += counters.evictionCount.load(std::memory_order_relaxed);
+            statistics.cloneCount += counters.cloneCount.load(std::memory_order_relaxed);
+            cloneNanoseconds += counters.cloneNanoseconds.load(std::memory_order_relaxed);
+            };
+
+        accumulate(g_retiredCounters);
+        for (const ThreadCacheCounters* counters : g_countersRegistry)
         {
-            bbox = GeoBoundingBox::Invalid;
-            allOk.store(false, std::memory_order_relaxed);
-            return;
+            accumulate(*counters);
         }
+    }
 
-        TransformItem* item = nullptr;
-        if (!TryGetTransformItem(trimmedSourceWkt, trimmedTargetWkt, item) || item == nullptr)
-        {
-            bbox = GeoBoundingBox::Invalid;
-            allOk.store(false, std::memory_order_relaxed);
-            return;
-        }
+    statistics.prototypeCreateCount = g_prototypeCreateCount.load(std::memory_order_relaxed);
+    statistics.prototypeCreateMilliseconds = static_cast<double>(g_prototypeCreateNanoseconds.load(std::memory_order_relaxed)) / 1e6;
+    statistics.cloneMilliseconds = static_cast<double>(cloneNanoseconds) / 1e6;
 
-        GB_Rectangle targetRect;
-        if (!TryTransformRectangleToAabbInternal(*item, bbox.rect, sampleGridCount, targetRect))
-        {
-            bbox = GeoBoundingBox::Invalid;
-            allOk.store(false, std::memory_order_relaxed);
-            return;
-        }
+    {
+        GB_ReadLockGuard readGuard(g_prototypeCacheLock);
+        statistics.prototypeCount = g_prototypeCache.size();
+    }
+    statistics.prototypeEvictionCount = g_prototypeEvictionCount.load(std::memory_order_relaxed);
 
-        bbox.wktUtf8 = item->canonicalTargetWkt;
-        bbox.rect = targetRect;
-    };
+    return statistics;
+}
 
-    if (enableOpenMP)
+void GeoCrsTransform::ResetCacheStatistics()
+{
+    std::lock_guard<std::mutex> lock(g_countersRegistryMutex);
+
+    // 其它线程的计数器只由其所属线程写入；这里的清零与并发写入之间可能丢失少量计数，统计用途可接受。
+    const auto reset = [](ThreadCacheCounters& counters) {
+        counters.hitCount.store(0, std::memory_order_relaxed);
+        counters.missCount.store(0, std::memory_order_relaxed);
+        counters.evictionCount.store(0, std::memory_order_relaxed);
+        counters.cloneCount.store(0, std::memory_order_relaxed);
+        counters.cloneNanoseconds.store(0, std::memory_order_relaxed);
+        };
+
+    reset(g_retiredCounters);
+    for (ThreadCacheCounters* counters : g_countersRegistry)
     {
-#pragma omp parallel for
-        for (long long i = 0; i < static_cast<long long>(count); i++)
-        {
-            transformOne(static_cast<size_t>(i));
-        }
+        reset(*counters);
     }
-    else
+
+    g_prototypeCreateCount.store(0, std::memory_order_relaxed);
+    g_prototypeCreateNanoseconds.store(0, std::memory_order_relaxed);
+    g_prototypeEvictionCount.store(0, std::memory_order_relaxed);
+}
+
+void GeoCrsTransform::ClearCaches()
+{
     {
-        for (size_t i = 0; i < count; i++)
-        {
-            transformOne(i);
-        }
+        GB_WriteLockGuard writeGuard(g_prototypeCacheLock);
+        g_prototypeCache.clear();
     }
-
-    return allOk.load(std::memory_order_relaxed);
+    g_cacheGeneration.fetch_add(1, std::memory_order_acq_rel);
 }
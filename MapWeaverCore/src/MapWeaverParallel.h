@@ -0,0 +1,147 @@
+﻿#ifndef MAP_WEAVER_PARALLEL_H
+#define MAP_WEAVER_PARALLEL_H
+
+// 库内部使用的并行工具（不对外导出）：CRS 预热 / 批量解析、转换预热与流式点转换共用。
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace MapWeaverParallel
+{
+    // 把 threadCount（<= 0 时取硬件并发数）限制到 [1, maxCount]。
+    inline size_t ResolveThreadCount(int threadCount, size_t maxCount)
+    {
+        if (threadCount <= 0)
+        {
+            threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+        return std::max<size_t>(1, std::min(maxCount, static_cast<size_t>(threadCount)));
+    }
+
+    // 记录多个线程中第一个抛出的异常；所有线程 join 之后由调用线程 RethrowIfAny() 重新抛出，
+    // 避免异常逃出线程函数触发 std::terminate。
+    class FirstException
+    {
+    public:
+        // 只能在 catch 块中调用。
+        void Capture() noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!exception)
+            {
+                exception = std::current_exception();
+                hasException.store(true, std::memory_order_release);
+            }
+        }
+
+        bool HasException() const noexcept
+        {
+            return hasException.load(std::memory_order_acquire);
+        }
+
+        void RethrowIfAny()
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+
+    private:
+        std::mutex mutex;
+        std::exception_ptr exception;
+        std::atomic_bool hasException{ false };
+    };
+
+    // 一组线程；析构时 join 全部线程，保证异常路径上不会析构可 join 的 std::thread。
+    // 线程可能阻塞等待时，调用方须先通知其退出（例如设置中止标志并唤醒条件变量），再离开作用域。
+    class ThreadGroup
+    {
+    public:
+        ThreadGroup() = default;
+        ThreadGroup(const ThreadGroup&) = delete;
+        ThreadGroup& operator=(const ThreadGroup&) = delete;
+
+        ~ThreadGroup()
+        {
+            JoinAll();
+        }
+
+        // 线程创建失败（资源不足）时返回 false，调用方可改由已有线程完成工作。
+        template <typename Func>
+        bool TryStart(Func&& func)
+        {
+            try
+            {
+                threads.emplace_back(std::forward<Func>(func));
+                return true;
+            }
+            catch (const std::system_error&)
+            {
+                return false;
+            }
+        }
+
+        void JoinAll()
+        {
+            for (std::thread& thread : threads)
+            {
+                if (thread.joinable())
+                {
+                    thread.join();
+                }
+            }
+            threads.clear();
+        }
+
+    private:
+        std::vector<std::thread> threads;
+    };
+
+    // 用 threadCount 个线程（<= 0 时取硬件并发数）并行执行 work(index)，index 取遍 [0, itemCount)；调用线程也参与处理。
+    // 任一 work 抛出异常后不再分派新的条目，等待所有线程结束后在调用线程上重新抛出第一个异常。
+    template <typename Work>
+    void RunParallelItems(size_t itemCount, int threadCount, const Work& work)
+    {
+        if (itemCount == 0)
+        {
+            return;
+        }
+
+        std::atomic<size_t> nextIndex(0);
+        FirstException firstException;
+        auto worker = [&]() {
+            try
+            {
+                for (size_t index = nextIndex.fetch_add(1); index < itemCount && !firstException.HasException(); index = nextIndex.fetch_add(1))
+                {
+                    work(index);
+                }
+            }
+            catch (...)
+            {
+                firstException.Capture();
+            }
+        };
+
+        {
+            ThreadGroup threads;
+            const size_t workerCount = ResolveThreadCount(threadCount, itemCount);
+            for (size_t i = 1; i < workerCount && threads.TryStart(worker); i++)
+            {
+            }
+            worker();
+        }
+
+        firstException.RethrowIfAny();
+    }
+}
+
+#endif
@@ -0,0 +1,83 @@
+﻿#include "TestCommon.h"
+
+#include "../MapWeaverCore/include/GeoCrsManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// 在 threadCount 个线程上各执行 iterationsPerThread 次 lookup(i)，返回每秒总查询次数。
+	template <typename Lookup>
+	double MeasureLookupsPerSecond(int threadCount, size_t iterationsPerThread, const Lookup& lookup)
+	{
+		std::atomic<int> readyCount(0);
+		std::atomic_bool started(false);
+		std::vector<std::thread> threads;
+		threads.reserve(static_cast<size_t>(threadCount));
+		for (int threadIndex = 0; threadIndex < threadCount; threadIndex++)
+		{
+			threads.emplace_back([&, threadIndex]() {
+				readyCount.fetch_add(1);
+				while (!started.load(std::memory_order_acquire))
+				{
+					std::this_thread::yield();
+				}
+				for (size_t i = 0; i < iterationsPerThread; i++)
+				{
+					lookup(static_cast<size_t>(threadIndex) + i);
+				}
+			});
+		}
+
+		while (readyCount.load() < threadCount)
+		{
+			std::this_thread::yield();
+		}
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		started.store(true, std::memory_order_release);
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return seconds > 0 ? static_cast<double>(iterationsPerThread) * threadCount / seconds : 0;
+	}
+}
+
+void RunGeoCrsManagerBenchmarks()
+{
+	const int epsgCodes[] = { 4326, 3857, 4490, 32650, 32651, 2383, 4547, 3395 };
+	std::vector<std::string> wkts;
+	for (const int epsgCode : epsgCodes)
+	{
+		wkts.push_back(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:" + std::to_string(epsgCode)));
+		GeoCrsManager::GetFromWktCached(wkts.back());
+	}
+
+	const size_t iterationsPerThread = 200000;
+	const int threadCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+	std::cout << "GeoCrsManager 缓存命中吞吐（次/秒）" << std::endl;
+	std::cout << std::setw(8) << "threads" << std::setw(18) << "GetFromWktCached" << std::setw(18) << "GetFromEpsgCached" << std::endl;
+	for (const int threadCount : threadCounts)
+	{
+		const double wktRate = MeasureLookupsPerSecond(threadCount, iterationsPerThread, [&wkts](size_t i) {
+			GeoCrsManager::GetFromWktCached(wkts[i % wkts.size()]);
+		});
+		const double epsgRate = MeasureLookupsPerSecond(threadCount, iterationsPerThread, [&epsgCodes](size_t i) {
+			GeoCrsManager::GetFromEpsgCached(epsgCodes[i % (sizeof(epsgCodes) / sizeof(epsgCodes[0]))]);
+		});
+		std::cout << std::setw(8) << threadCount << std::setw(18) << std::fixed << std::setprecision(0) << wktRate << std::setw(18) << epsgRate << std::endl;
+	}
+
+	const GeoCrsManager::CacheCounters counters = GeoCrsManager::GetWktCacheCounters();
+	std::cout << "WKT 缓存: hit=" << counters.hitCount << " miss=" << counters.missCount << " coalesced=" << counters.coalescedCount << std::endl;
+	MW_TEST_CHECK(counters.missCount <= wkts.size());
+}
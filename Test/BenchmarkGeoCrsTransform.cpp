@@ -0,0 +1,142 @@
+﻿#include "TestCommon.h"
+
+#include "../MapWeaverCore/include/GeoCrsManager.h"
+#include "../MapWeaverCore/include/GeoCrsTransform.h"
+#include "Geometry/GB_Point2d.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// 在经纬度范围内生成 count 个规则分布的点（经度/纬度）。
+	std::vector<GB_Point2d> MakeLonLatPoints(size_t count, double minLon, double maxLon, double minLat, double maxLat)
+	{
+		std::vector<GB_Point2d> points;
+		points.reserve(count);
+		const size_t columns = 2048;
+		const size_t rows = (count + columns - 1) / columns;
+		for (size_t i = 0; i < count; i++)
+		{
+			const double u = static_cast<double>(i % columns) / static_cast<double>(columns - 1);
+			const double v = static_cast<double>(i / columns) / static_cast<double>(std::max<size_t>(1, rows - 1));
+			points.push_back(GB_Point2d(minLon + (maxLon - minLon) * u, minLat + (maxLat - minLat) * v));
+		}
+		return points;
+	}
+
+	double SecondsSince(const std::chrono::steady_clock::time_point& start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	double PointsPerSecond(size_t pointCount, double seconds)
+	{
+		return seconds > 0 ? static_cast<double>(pointCount) / seconds : 0;
+	}
+
+	// 逐点调用 TransformPoint（每次按 WKT 查找转换），作为最朴素的对照。
+	double MeasureLoopedTransformPoint(const std::string& sourceWkt, const std::string& targetWkt, const std::vector<GB_Point2d>& points)
+	{
+		GB_Point2d outPoint;
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (const GB_Point2d& point : points)
+		{
+			GeoCrsTransform::TransformPoint(sourceWkt, targetWkt, point, outPoint);
+		}
+		return PointsPerSecond(points.size(), SecondsSince(start));
+	}
+
+	// 整个缓冲区一次性调用 TransformXYArrays（驻留内存与点数成正比）。
+	double MeasureArrayCall(const std::string& sourceWkt, const std::string& targetWkt, const std::vector<GB_Point2d>& points, bool enableOpenMP)
+	{
+		std::vector<double> x(points.size());
+		std::vector<double> y(points.size());
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			x[i] = points[i].x;
+			y[i] = points[i].y;
+		}
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		GeoCrsTransform::TransformXYArrays(sourceWkt, targetWkt, x.data(), y.data(), nullptr, points.size(), 1, nullptr, enableOpenMP);
+		return PointsPerSecond(points.size(), SecondsSince(start));
+	}
+
+	// 以内存中的点作为数据源走 TransformPointStream，返回流水线统计的吞吐。
+	double MeasureStream(const std::string& sourceWkt, const std::string& targetWkt, const std::vector<GB_Point2d>& points, size_t chunkSize, int workerCount)
+	{
+		size_t readPosition = 0;
+		const GeoCrsTransform::PointChunkReader reader = [&points, &readPosition](GB_Point2d* buffer, size_t capacity) -> size_t {
+			const size_t count = std::min(capacity, points.size() - readPosition);
+			std::copy(points.begin() + readPosition, points.begin() + readPosition + count, buffer);
+			readPosition += count;
+			return count;
+		};
+
+		double checksum = 0;
+		const GeoCrsTransform::PointChunkWriter writer = [&checksum](const GB_Point2d* chunk, const std::uint8_t* status, size_t count) -> bool {
+			if (count > 0 && status[0] != 0)
+			{
+				checksum += chunk[0].x;
+			}
+			return true;
+		};
+
+		GeoCrsTransform::StreamStatistics statistics;
+		GeoCrsTransform::TransformPointStream(sourceWkt, targetWkt, reader, writer, chunkSize, workerCount, &statistics);
+		MW_TEST_CHECK(statistics.pointCount == points.size());
+		MW_TEST_CHECK(checksum != 0);
+		return PointsPerSecond(static_cast<size_t>(statistics.pointCount), statistics.seconds);
+	}
+}
+
+void RunGeoCrsTransformBenchmarks()
+{
+	// 4326 -> 32650 走闭式快速路径；4326 -> 4547（CGCS2000 / 3-degree Gauss-Kruger CM 114E）走 PROJ 管线。
+	const std::string lonLatWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+	const int targetEpsgCodes[] = { 32650, 4547 };
+
+	const std::vector<GB_Point2d> points = MakeLonLatPoints(4 * 1024 * 1024, 112.5, 118.5, 20.0, 45.0);
+	const std::vector<GB_Point2d> loopPoints(points.begin(), points.begin() + 200000);
+
+	const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	const int workerCounts[] = { 1, 2, 4, 8, static_cast<int>(hardwareThreads) };
+	const size_t chunkSizes[] = { 4096, 65536, 262144 };
+
+	for (const int targetEpsgCode : targetEpsgCodes)
+	{
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:" + std::to_string(targetEpsgCode));
+		GeoCrsTransform::Warmup(std::vector<std::pair<std::string, std::string>>{ { lonLatWkt, targetWkt } }, 1);
+
+		std::cout << "EPSG:4326 -> EPSG:" << targetEpsgCode << " 点转换吞吐（点/秒，共 " << points.size() << " 点）" << std::endl;
+		std::cout << std::fixed << std::setprecision(0);
+		std::cout << "  逐点 TransformPoint:          " << MeasureLoopedTransformPoint(lonLatWkt, targetWkt, loopPoints) << std::endl;
+		std::cout << "  TransformXYArrays:            " << MeasureArrayCall(lonLatWkt, targetWkt, points, false) << std::endl;
+		std::cout << "  TransformXYArrays (OpenMP):   " << MeasureArrayCall(lonLatWkt, targetWkt, points, true) << std::endl;
+
+		std::cout << "  TransformPointStream:" << std::endl;
+		std::cout << std::setw(12) << "chunk";
+		for (const int workerCount : workerCounts)
+		{
+			std::cout << std::setw(14) << ("workers=" + std::to_string(workerCount));
+		}
+		std::cout << std::endl;
+		for (const size_t chunkSize : chunkSizes)
+		{
+			std::cout << std::setw(12) << chunkSize;
+			for (const int workerCount : workerCounts)
+			{
+				std::cout << std::setw(14) << MeasureStream(lonLatWkt, targetWkt, points, chunkSize, workerCount);
+			}
+			std::cout << std::endl;
+		}
+	}
+}
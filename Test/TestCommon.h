@@ -0,0 +1,26 @@
+﻿#ifndef MAP_WEAVER_TEST_COMMON_H
+#define MAP_WEAVER_TEST_COMMON_H
+
+// 测试断言：失败时记录日志并计数（不中断后续检查），main() 汇总后以非零退出码结束。
+void ReportTestFailure(const char* expression, const char* file, int line);
+int GetTestFailureCount();
+
+#define MW_TEST_CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			ReportTestFailure(#condition, __FILE__, __LINE__); \
+		} \
+	} while (0)
+
+// 各测试组，定义在对应的 Test*.cpp 中。
+void RunGeoCrsManagerTests();
+void RunGeoCrsFootprintTests();
+void RunGeoCrsTransformTests();
+
+// 性能测试：以 --benchmark 参数运行 Test 时执行，不计入常规测试。
+void RunGeoCrsManagerBenchmarks();
+void RunGeoCrsTransformBenchmarks();
+
+#endif
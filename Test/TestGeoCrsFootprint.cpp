@@ -0,0 +1,174 @@
+﻿#include "TestCommon.h"
+
+#include "../MapWeaverCore/include/GeoBoundingBox.h"
+#include "../MapWeaverCore/include/GeoCrsFootprint.h"
+#include "../MapWeaverCore/include/GeoCrsManager.h"
+#include "Geometry/GB_Point2d.h"
+#include "Geometry/GB_Rectangle.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+	bool RectNear(const GB_Rectangle& rect, double minX, double minY, double maxX, double maxY, double tolerance)
+	{
+		return rect.IsValid() &&
+			std::abs(rect.minX - minX) <= tolerance && std::abs(rect.minY - minY) <= tolerance &&
+			std::abs(rect.maxX - maxX) <= tolerance && std::abs(rect.maxY - maxY) <= tolerance;
+	}
+
+	// U 形（凹）环：[0,10]x[0,10] 去掉上方开口的缺口 (3,7)x(3,10]。
+	GeoCrsFootprint MakeNotchedFootprint()
+	{
+		const std::vector<GB_Point2d> ring =
+		{
+			GB_Point2d(0.0, 0.0), GB_Point2d(10.0, 0.0), GB_Point2d(10.0, 10.0), GB_Point2d(7.0, 10.0),
+			GB_Point2d(7.0, 3.0), GB_Point2d(3.0, 3.0), GB_Point2d(3.0, 10.0), GB_Point2d(0.0, 10.0)
+		};
+		return GeoCrsFootprint("", std::vector<std::vector<GB_Point2d>>(1, ring));
+	}
+
+	void TestFootprintContainsPoint()
+	{
+		const GeoCrsFootprint footprint = MakeNotchedFootprint();
+		MW_TEST_CHECK(footprint.IsValid());
+		MW_TEST_CHECK(RectNear(footprint.GetBoundingRect(), 0.0, 0.0, 10.0, 10.0, 0.0));
+
+		MW_TEST_CHECK(footprint.ContainsPoint(5.0, 1.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(1.0, 8.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(9.0, 8.0));
+
+		// 缺口内：在外包矩形内但不在足迹内。
+		MW_TEST_CHECK(!footprint.ContainsPoint(5.0, 5.0));
+		MW_TEST_CHECK(!footprint.ContainsPoint(5.0, 9.9));
+		MW_TEST_CHECK(!footprint.ContainsPoint(11.0, 5.0));
+
+		// 边界（含最大边、缺口内侧边与顶点）视为在内；缺口开口处不在边界上。
+		MW_TEST_CHECK(footprint.ContainsPoint(0.0, 5.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(10.0, 5.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(5.0, 0.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(8.0, 10.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(5.0, 3.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(7.0, 6.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(10.0, 10.0));
+		MW_TEST_CHECK(!footprint.ContainsPoint(5.0, 10.0));
+
+		MW_TEST_CHECK(!GeoCrsFootprint().ContainsPoint(0.0, 0.0));
+	}
+
+	void TestFootprintIntersectsRect()
+	{
+		const GeoCrsFootprint footprint = MakeNotchedFootprint();
+
+		MW_TEST_CHECK(footprint.IntersectsRect(GB_Rectangle(1.0, 1.0, 2.0, 2.0)));
+		MW_TEST_CHECK(!footprint.IntersectsRect(GB_Rectangle(20.0, 20.0, 30.0, 30.0)));
+		MW_TEST_CHECK(footprint.IntersectsRect(GB_Rectangle(8.0, 8.0, 12.0, 12.0)));
+		MW_TEST_CHECK(footprint.IntersectsRect(GB_Rectangle(-1.0, -1.0, 11.0, 11.0)));
+
+		// 完全落在缺口内：与外包矩形相交，但与足迹不相交。
+		MW_TEST_CHECK(!footprint.IntersectsRect(GB_Rectangle(4.0, 5.0, 6.0, 8.0)));
+
+		// 跨过缺口的窄条：四角都不在环内、环顶点也不在矩形内，只能靠边相交判断。
+		MW_TEST_CHECK(footprint.IntersectsRect(GB_Rectangle(-1.0, 5.0, 11.0, 6.0)));
+
+		MW_TEST_CHECK(!footprint.IntersectsRect(GB_Rectangle::Invalid));
+	}
+
+	void TestFootprintClipRect()
+	{
+		const GeoCrsFootprint footprint = MakeNotchedFootprint();
+
+		MW_TEST_CHECK(RectNear(footprint.ClipRect(GB_Rectangle(1.0, 1.0, 2.0, 2.0)), 1.0, 1.0, 2.0, 2.0, 0.0));
+		MW_TEST_CHECK(RectNear(footprint.ClipRect(GB_Rectangle(8.0, 8.0, 12.0, 12.0)), 8.0, 8.0, 10.0, 10.0, 0.0));
+		MW_TEST_CHECK(RectNear(footprint.ClipRect(GB_Rectangle(-5.0, -5.0, 5.0, 5.0)), 0.0, 0.0, 5.0, 5.0, 0.0));
+		MW_TEST_CHECK(RectNear(footprint.ClipRect(GB_Rectangle(-1.0, -1.0, 11.0, 11.0)), 0.0, 0.0, 10.0, 10.0, 0.0));
+
+		// 缺口内与完全在外：无交集。
+		MW_TEST_CHECK(!footprint.ClipRect(GB_Rectangle(4.0, 4.0, 6.0, 12.0)).IsValid());
+		MW_TEST_CHECK(!footprint.ClipRect(GB_Rectangle(20.0, 20.0, 30.0, 30.0)).IsValid());
+
+		// 跨缺口的窄条：交集为两段，外包矩形仍覆盖整条。
+		MW_TEST_CHECK(RectNear(footprint.ClipRect(GB_Rectangle(-1.0, 5.0, 11.0, 6.0)), 0.0, 5.0, 10.0, 6.0, 0.0));
+	}
+
+	// 跨日期变更线的两个环：[170,180]x[-10,10] 与 [-180,-170]x[-10,10]。
+	void TestFootprintTwoRings()
+	{
+		std::vector<std::vector<GB_Point2d>> rings(2);
+		rings[0] = { GB_Point2d(170.0, -10.0), GB_Point2d(180.0, -10.0), GB_Point2d(180.0, 10.0), GB_Point2d(170.0, 10.0) };
+		rings[1] = { GB_Point2d(-180.0, -10.0), GB_Point2d(-170.0, -10.0), GB_Point2d(-170.0, 10.0), GB_Point2d(-180.0, 10.0) };
+		const GeoCrsFootprint footprint("", rings);
+
+		MW_TEST_CHECK(footprint.GetRings().size() == 2);
+		MW_TEST_CHECK(footprint.ContainsPoint(175.0, 0.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(-175.0, 0.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(180.0, 0.0));
+		MW_TEST_CHECK(footprint.ContainsPoint(-180.0, 0.0));
+		MW_TEST_CHECK(!footprint.ContainsPoint(0.0, 0.0));
+
+		MW_TEST_CHECK(!footprint.IntersectsRect(GB_Rectangle(-10.0, -5.0, 10.0, 5.0)));
+		MW_TEST_CHECK(footprint.IntersectsRect(GB_Rectangle(-175.0, -5.0, -165.0, 5.0)));
+
+		MW_TEST_CHECK(RectNear(footprint.ClipRect(GB_Rectangle(160.0, -20.0, 200.0, 20.0)), 170.0, -10.0, 180.0, 10.0, 0.0));
+		MW_TEST_CHECK(RectNear(footprint.ClipRect(GB_Rectangle(-200.0, -5.0, -175.0, 5.0)), -180.0, -5.0, -175.0, 5.0, 0.0));
+		MW_TEST_CHECK(!footprint.ClipRect(GB_Rectangle(-10.0, -5.0, 10.0, 5.0)).IsValid());
+	}
+
+	// 真实坐标系：EPSG:4167（NZGD2000）的有效范围约为 160.6°E ~ 171.2°W，足迹按日期变更线拆成两个环。
+	void TestFootprintAntimeridianCrs()
+	{
+		const std::shared_ptr<const GeoCrsFootprint> footprint = GeoCrsManager::GetValidAreaFootprintCached(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4167"));
+		MW_TEST_CHECK(footprint && footprint->IsValid());
+		if (!footprint || !footprint->IsValid())
+		{
+			return;
+		}
+
+		MW_TEST_CHECK(footprint->GetRings().size() == 2);
+		MW_TEST_CHECK(footprint->ContainsPoint(174.8, -41.3));
+		MW_TEST_CHECK(footprint->ContainsPoint(-176.5, -44.0));
+		MW_TEST_CHECK(!footprint->ContainsPoint(0.0, -40.0));
+		MW_TEST_CHECK(!footprint->ContainsPoint(-100.0, -40.0));
+	}
+
+	// GeoBoundingBox 的足迹辅助函数。EPSG:32650（UTM 50N）的足迹在高纬度收窄，
+	// 外包矩形的左上角不在足迹内。
+	void TestBoundingBoxFootprintHelpers()
+	{
+		const std::string utmWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:32650");
+
+		const GeoBoundingBox insideBox(utmWkt, GB_Rectangle(400000.0, 3000000.0, 600000.0, 3500000.0));
+		MW_TEST_CHECK(insideBox.IntersectsCrsValidFootprint());
+
+		const GeoBoundingBox cornerBox(utmWkt, GB_Rectangle(170000.0, 9000000.0, 200000.0, 9100000.0));
+		MW_TEST_CHECK(cornerBox.ClampedRectToCrsValidArea().rect.IsValid());
+		MW_TEST_CHECK(!cornerBox.IntersectsCrsValidFootprint());
+
+		GeoBoundingBox clampedCornerBox = cornerBox;
+		MW_TEST_CHECK(!clampedCornerBox.ClampRectToCrsValidFootprint());
+		MW_TEST_CHECK(!clampedCornerBox.rect.IsValid());
+
+		const GeoBoundingBox farBox(utmWkt, GB_Rectangle(-5000000.0, -5000000.0, -4000000.0, -4000000.0));
+		MW_TEST_CHECK(!farBox.IntersectsCrsValidFootprint());
+
+		// 跨过足迹西边界：左边收紧到北纬 9°~18° 间足迹的最西点（约 171 km），其余三边不变。
+		GeoBoundingBox straddlingBox(utmWkt, GB_Rectangle(100000.0, 1000000.0, 600000.0, 2000000.0));
+		MW_TEST_CHECK(straddlingBox.ClampRectToCrsValidFootprint());
+		MW_TEST_CHECK(straddlingBox.rect.minX > 150000.0 && straddlingBox.rect.minX < 200000.0);
+		MW_TEST_CHECK(std::abs(straddlingBox.rect.maxX - 600000.0) < 1e-6);
+		MW_TEST_CHECK(std::abs(straddlingBox.rect.minY - 1000000.0) < 1e-6 && std::abs(straddlingBox.rect.maxY - 2000000.0) < 1e-6);
+	}
+}
+
+void RunGeoCrsFootprintTests()
+{
+	TestFootprintContainsPoint();
+	TestFootprintIntersectsRect();
+	TestFootprintClipRect();
+	TestFootprintTwoRings();
+	TestFootprintAntimeridianCrs();
+	TestBoundingBoxFootprintHelpers();
+}
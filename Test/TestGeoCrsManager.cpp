@@ -0,0 +1,822 @@
+﻿#include "TestCommon.h"
+
+#include "../MapWeaverCore/include/GeoBoundingBox.h"
+#include "../MapWeaverCore/include/GeoCrs.h"
+#include "../MapWeaverCore/include/GeoCrsFootprint.h"
+#include "../MapWeaverCore/include/GeoCrsManager.h"
+#include "../MapWeaverCore/include/GeoCrsTransform.h"
+
+#include <ogr_spatialref.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// 在新线程上查询：新线程的私有视图为空，结果只取决于全局表中是否还有该条目。
+	bool IsEpsgCachedGlobally(int epsgCode)
+	{
+		const std::uint64_t missCountBefore = GeoCrsManager::GetEpsgCacheCounters().missCount;
+		std::thread([epsgCode]() { GeoCrsManager::GetFromEpsgCached(epsgCode); }).join();
+		return GeoCrsManager::GetEpsgCacheCounters().missCount == missCountBefore;
+	}
+
+	std::vector<int> GetFloodEpsgCodes()
+	{
+		std::vector<int> codes;
+		for (int code = 32601; code <= 32660; code++)
+		{
+			codes.push_back(code);
+		}
+		for (int code = 32701; code <= 32760; code++)
+		{
+			codes.push_back(code);
+		}
+		for (int code = 4491; code <= 4554; code++)
+		{
+			codes.push_back(code);
+		}
+		for (int code = 2327; code <= 2442; code++)
+		{
+			codes.push_back(code);
+		}
+		return codes;
+	}
+
+	// 后台初始化只能显式启动，且可以等待线程结束；初始化完成后不再启动。
+	void TestBackgroundInitialization()
+	{
+		const bool started = GeoCrsManager::StartBackgroundInitialization();
+		GeoCrsManager::WaitForBackgroundInitialization();
+		MW_TEST_CHECK(GeoCrsManager::IsInitialized());
+		MW_TEST_CHECK(!started || GeoCrsManager::GetInitializationStatistics().ranInBackground);
+		MW_TEST_CHECK(!GeoCrsManager::StartBackgroundInitialization());
+		GeoCrsManager::WaitForBackgroundInitialization();
+	}
+
+	// 内存预算：只访问一次的条目先被淘汰，反复访问的条目与内置的 4326 / 3857 保留；占用不超出预算。
+	void TestCacheBudgetSlruEviction()
+	{
+		GeoCrsManager::ClearCaches();
+		const size_t originalBudget = GeoCrsManager::GetCacheMemoryBudget();
+		GeoCrsManager::SetCacheMemoryBudget(32 * 1024 * 1024);
+
+		const int hotCode = 3395;
+		GeoCrsManager::GetFromEpsgCached(4326);
+		GeoCrsManager::GetFromEpsgCached(3857);
+		GeoCrsManager::GetFromEpsgCached(hotCode);
+
+		const std::uint64_t evictionCountBefore = GeoCrsManager::GetEpsgCacheMemoryGauge().evictionCount;
+		const std::vector<int> floodCodes = GetFloodEpsgCodes();
+		for (const int code : floodCodes)
+		{
+			GeoCrsManager::GetFromEpsgCached(code);
+			GeoCrsManager::GetFromEpsgCached(hotCode);
+		}
+
+		const GeoCrsManager::CacheMemoryGauge gauge = GeoCrsManager::GetEpsgCacheMemoryGauge();
+		MW_TEST_CHECK(gauge.budgetBytes > 0);
+		MW_TEST_CHECK(gauge.evictionCount > evictionCountBefore);
+		MW_TEST_CHECK(gauge.approximateBytes - gauge.pinnedBytes <= gauge.budgetBytes);
+		MW_TEST_CHECK(gauge.pinnedBytes > 0);
+		MW_TEST_CHECK(gauge.entryCount < floodCodes.size());
+		MW_TEST_CHECK(gauge.localViewEntryCount > 0 && gauge.localViewBytes > 0);
+
+		MW_TEST_CHECK(IsEpsgCachedGlobally(4326));
+		MW_TEST_CHECK(IsEpsgCachedGlobally(3857));
+		MW_TEST_CHECK(IsEpsgCachedGlobally(hotCode));
+		MW_TEST_CHECK(!IsEpsgCachedGlobally(floodCodes.front()));
+
+		const GeoCrsManager::CacheMemoryGauge totalGauge = GeoCrsManager::GetTotalCacheMemoryGauge();
+		MW_TEST_CHECK(totalGauge.budgetBytes <= GeoCrsManager::GetCacheMemoryBudget());
+		MW_TEST_CHECK(totalGauge.approximateBytes >= gauge.approximateBytes);
+
+		GeoCrsManager::SetCacheMemoryBudget(originalBudget);
+		GeoCrsManager::ClearCaches();
+	}
+
+	// 收紧预算时立即淘汰到预算内；预算为 0 时不淘汰。
+	void TestCacheBudgetShrink()
+	{
+		GeoCrsManager::ClearCaches();
+		const size_t originalBudget = GeoCrsManager::GetCacheMemoryBudget();
+		GeoCrsManager::SetCacheMemoryBudget(0);
+
+		const std::vector<int> floodCodes = GetFloodEpsgCodes();
+		for (size_t i = 0; i < 64 && i < floodCodes.size(); i++)
+		{
+			GeoCrsManager::GetFromEpsgCached(floodCodes[i]);
+		}
+		const GeoCrsManager::CacheMemoryGauge unlimitedGauge = GeoCrsManager::GetEpsgCacheMemoryGauge();
+		MW_TEST_CHECK(unlimitedGauge.budgetBytes == 0);
+		MW_TEST_CHECK(unlimitedGauge.entryCount >= 64);
+
+		GeoCrsManager::SetCacheMemoryBudget(8 * 1024 * 1024);
+		const GeoCrsManager::CacheMemoryGauge shrunkGauge = GeoCrsManager::GetEpsgCacheMemoryGauge();
+		MW_TEST_CHECK(shrunkGauge.approximateBytes - shrunkGauge.pinnedBytes <= shrunkGauge.budgetBytes);
+		MW_TEST_CHECK(shrunkGauge.entryCount < unlimitedGauge.entryCount);
+
+		GeoCrsManager::SetCacheMemoryBudget(originalBudget);
+		GeoCrsManager::ClearCaches();
+	}
+
+	// 驻留 id：只有显式 InternCrs 才分配；同一 CRS 的不同写法得到同一 id；查询、比较与预热不会驻留。
+	void TestInternCrsIds()
+	{
+		const std::shared_ptr<const GeoCrs> crs = GeoCrsManager::GetFromEpsgCached(2193);
+		MW_TEST_CHECK(crs != nullptr && crs->IsValid());
+		const std::string wkt2 = crs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+		const std::string wkt1 = crs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt1Gdal, false);
+
+		const size_t internCountBefore = GeoCrsManager::GetInternedCrsCount();
+		const GeoBoundingBox wktBox(wkt2, GB_Rectangle(1000000.0, 4700000.0, 2000000.0, 6200000.0));
+		const GeoBoundingBox otherWktBox(wkt1, wktBox.rect);
+		MW_TEST_CHECK(wktBox.GetCrsId() == 0);
+		MW_TEST_CHECK(wktBox == otherWktBox);
+		MW_TEST_CHECK(GeoCrsManager::FindCrsId(wkt1) == 0);
+		GeoCrsManager::Warmup(std::vector<std::string>{ wkt2 }, 1);
+		MW_TEST_CHECK(GeoCrsManager::GetInternedCrsCount() == internCountBefore);
+
+		const std::uint32_t crsId = GeoCrsManager::InternCrs(wkt2);
+		MW_TEST_CHECK(crsId != 0);
+		MW_TEST_CHECK(GeoCrsManager::GetInternedCrsCount() == internCountBefore + 1);
+		MW_TEST_CHECK(GeoCrsManager::InternCrs(wkt1) == crsId);
+		MW_TEST_CHECK(GeoCrsManager::InternCrs(crs) == crsId);
+		MW_TEST_CHECK(GeoCrsManager::FindCrsId(wkt1) == crsId);
+		MW_TEST_CHECK(wktBox.GetCrsId() == crsId);
+		MW_TEST_CHECK(GeoCrsManager::GetInternedCrsCount() == internCountBefore + 1);
+
+		const std::shared_ptr<const GeoCrs> internedCrs = GeoCrsManager::GetFromCrsId(crsId);
+		MW_TEST_CHECK(internedCrs != nullptr && *internedCrs == *crs);
+		MW_TEST_CHECK(GeoCrsManager::GetCrsIdWktUtf8(crsId) == wkt2);
+
+		// ClearCaches() 不会使 id 失效。
+		GeoCrsManager::ClearCaches();
+		MW_TEST_CHECK(GeoCrsManager::GetFromCrsId(crsId) != nullptr);
+		MW_TEST_CHECK(GeoCrsManager::FindCrsId(wkt2) == crsId);
+
+		const GeoBoundingBox idBox(crsId, wktBox.rect);
+		MW_TEST_CHECK(idBox == wktBox);
+		MW_TEST_CHECK(idBox.GetWktUtf8() == wkt2);
+		MW_TEST_CHECK(&idBox.GetWktUtf8() == &GeoCrsManager::GetCrsIdWktUtf8(crsId));
+
+		// 以 id 表示时按 id 取有效范围与足迹，不经按 WKT 的缓存，结果与以 WKT 表示时一致。
+		GeoCrsManager::ClearCaches();
+		GeoBoundingBox clampedIdBox(crsId, GB_Rectangle(-1.0e7, -1.0e7, 1.0e7, 1.0e7));
+		MW_TEST_CHECK(clampedIdBox.IntersectsCrsValidFootprint());
+		MW_TEST_CHECK(clampedIdBox.ClampRectToCrsValidArea());
+		MW_TEST_CHECK(GeoCrsManager::GetCachedWktCount() == 0);
+		GeoBoundingBox clampedWktBox(wkt2, GB_Rectangle(-1.0e7, -1.0e7, 1.0e7, 1.0e7));
+		MW_TEST_CHECK(clampedWktBox.ClampRectToCrsValidArea());
+		MW_TEST_CHECK(clampedIdBox.rect == clampedWktBox.rect);
+		MW_TEST_CHECK(GeoCrsManager::GetValidAreaFootprintCached(crsId)->IsValid());
+		MW_TEST_CHECK(GeoCrsManager::GetValidAreaFootprintCached(crsId).get() == GeoCrsManager::GetValidAreaFootprintCached(crsId).get());
+
+		GeoBoundingBox invalidLonLatArea;
+		GeoBoundingBox invalidSelfArea;
+		MW_TEST_CHECK(!GeoCrsManager::TryGetValidAreasCached(0u, invalidLonLatArea, invalidSelfArea));
+		MW_TEST_CHECK(!GeoCrsManager::GetValidAreaFootprintCached(0u)->IsValid());
+
+		MW_TEST_CHECK(GeoCrsManager::InternCrs(std::string()) == 0);
+		MW_TEST_CHECK(GeoCrsManager::InternCrs(std::string("not a crs")) == 0);
+		MW_TEST_CHECK(GeoCrsManager::GetFromCrsId(0) == nullptr);
+		MW_TEST_CHECK(GeoCrsManager::GetCrsIdWktUtf8(0).empty());
+	}
+
+	// 持久化元数据缓存：保存后重新加载得到相同的元数据；在文件已加载时再次保存可以替换文件；
+	// 只查询有效性的 WKT 不会写入文件。
+	void TestPersistentCacheRoundTrip()
+	{
+		const std::string cachePath = "MapWeaverTest_CrsMetadata.cache";
+		std::remove(cachePath.c_str());
+		GeoCrsManager::ClearCaches();
+
+		MW_TEST_CHECK(GeoCrsManager::EnablePersistentCache(cachePath));
+		MW_TEST_CHECK(GeoCrsManager::GetPersistentCacheEntryCount() == 0);
+
+		const std::string wkt = GeoCrsManager::GetFromEpsgCached(2193)->ExportToWktUtf8(GeoCrs::WktFormat::Wkt1Gdal, false);
+		GeoCrsManager::CrsMetadata saved;
+		MW_TEST_CHECK(GeoCrsManager::TryGetCrsMetadataCached(wkt, saved));
+		MW_TEST_CHECK(saved.epsgCode == 2193);
+		MW_TEST_CHECK(GeoCrsManager::SavePersistentCache());
+		const size_t savedEntryCount = GeoCrsManager::GetPersistentCacheEntryCount();
+		MW_TEST_CHECK(savedEntryCount >= 1);
+
+		GeoCrsManager::ClearCaches();
+		GeoCrsManager::CrsMetadata loaded;
+		MW_TEST_CHECK(GeoCrsManager::TryGetCrsMetadataCached(wkt, loaded));
+		MW_TEST_CHECK(loaded.isValid == saved.isValid);
+		MW_TEST_CHECK(loaded.epsgCode == saved.epsgCode);
+		MW_TEST_CHECK(loaded.uidUtf8 == saved.uidUtf8);
+		MW_TEST_CHECK(loaded.canonicalWktUtf8 == saved.canonicalWktUtf8);
+		MW_TEST_CHECK(loaded.lonLatArea == saved.lonLatArea);
+		MW_TEST_CHECK(loaded.selfArea == saved.selfArea);
+		MW_TEST_CHECK(GeoCrsManager::IsWktValidCached(wkt));
+
+		const std::string validityOnlyWkt = GeoCrsManager::GetFromEpsgCached(2135)->ExportToWktUtf8(GeoCrs::WktFormat::Wkt1Gdal, false);
+		MW_TEST_CHECK(GeoCrsManager::IsWktValidCached(validityOnlyWkt));
+		MW_TEST_CHECK(GeoCrsManager::SavePersistentCache());
+		MW_TEST_CHECK(GeoCrsManager::GetPersistentCacheEntryCount() == savedEntryCount);
+
+		GeoCrsManager::DisablePersistentCache();
+		GeoCrsManager::ClearCaches();
+		std::remove(cachePath.c_str());
+	}
+
+	// EPSG 指纹索引：现行 code 优先于定义相同的已废弃 code；去掉权威码的 WKT 也能识别。
+	void TestFingerprintPrefersCurrentCodes()
+	{
+		const std::string indexPath = "MapWeaverTest_EpsgFingerprint.index";
+		std::remove(indexPath.c_str());
+		MW_TEST_CHECK(GeoCrsManager::BuildEpsgFingerprintIndex(indexPath));
+		MW_TEST_CHECK(GeoCrsManager::GetEpsgFingerprintIndexSize() > 0);
+
+		for (const int epsgCode : { 4326, 3857, 32650 })
+		{
+			const std::shared_ptr<const GeoCrs> crs = GeoCrsManager::GetFromEpsgCached(epsgCode);
+			MW_TEST_CHECK(GeoCrsManager::IdentifyEpsgByFingerprint(crs->GetConstRef()) == epsgCode);
+		}
+
+		for (const int epsgCode : { 4326, 32650 })
+		{
+			const std::shared_ptr<const GeoCrs> crs = GeoCrsManager::GetFromEpsgCached(epsgCode);
+			OGRSpatialReference withoutAuthority;
+			withoutAuthority.SetFromUserInput(crs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt1Esri, false).c_str());
+			MW_TEST_CHECK(GeoCrsManager::IdentifyEpsgByFingerprint(withoutAuthority) == epsgCode);
+		}
+
+		MW_TEST_CHECK(GeoCrsManager::LoadEpsgFingerprintIndex(indexPath));
+		MW_TEST_CHECK(GeoCrsManager::IdentifyEpsgByFingerprint(GeoCrsManager::GetFromEpsgCached(3857)->GetConstRef()) == 3857);
+		std::remove(indexPath.c_str());
+	}
+
+	// 修改横轴墨卡托 WKT2 的中央经线（from -> to），保留根权威码；未找到该参数时返回空串。
+	std::string EditCentralMeridian(const std::string& wktUtf8, const std::string& fromDegrees, const std::string& toDegrees)
+	{
+		const std::string centralMeridian = "\"Longitude of natural origin\"," + fromDegrees + ",";
+		const size_t position = wktUtf8.find(centralMeridian);
+		if (position == std::string::npos)
+		{
+			return "";
+		}
+
+		std::string editedWkt = wktUtf8;
+		editedWkt.replace(position, centralMeridian.size(), "\"Longitude of natural origin\"," + toDegrees + ",");
+		return editedWkt;
+	}
+
+	// EPSG:32650 的中央经线由 117 改为 120。
+	std::string EditUtm50CentralMeridian(const std::string& wktUtf8)
+	{
+		return EditCentralMeridian(wktUtf8, "117", "120");
+	}
+
+	// 改动过参数但保留根权威码的 WKT：UID 与原坐标系相同，但不相等，不与原坐标系合并、不共享有效范围与驻留 id。
+	void TestEditedWktKeepsOwnIdentity()
+	{
+		GeoCrsManager::ClearCaches();
+		const std::shared_ptr<const GeoCrs> epsgCrs = GeoCrsManager::GetFromEpsgCached(32650);
+		MW_TEST_CHECK(epsgCrs != nullptr && epsgCrs->IsValid());
+
+		const std::string originalWkt = epsgCrs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+		const std::string editedWkt = EditUtm50CentralMeridian(originalWkt);
+		MW_TEST_CHECK(!editedWkt.empty());
+		if (editedWkt.empty())
+		{
+			return;
+		}
+
+		const std::shared_ptr<const GeoCrs> originalCrs = GeoCrsManager::GetFromWktCached(originalWkt);
+		const std::shared_ptr<const GeoCrs> editedCrs = GeoCrsManager::GetFromWktCached(editedWkt);
+		MW_TEST_CHECK(originalCrs != nullptr && originalCrs->IsValid());
+		MW_TEST_CHECK(editedCrs != nullptr && editedCrs->IsValid());
+		MW_TEST_CHECK(originalCrs->GetUidUtf8() == "EPSG:32650");
+		MW_TEST_CHECK(editedCrs->GetUidUtf8() == originalCrs->GetUidUtf8());
+		MW_TEST_CHECK(*editedCrs != *originalCrs);
+		MW_TEST_CHECK(*editedCrs != *epsgCrs);
+		MW_TEST_CHECK(editedCrs != originalCrs);
+
+		GeoBoundingBox originalLonLatArea;
+		GeoBoundingBox originalSelfArea;
+		GeoBoundingBox editedLonLatArea;
+		GeoBoundingBox editedSelfArea;
+		MW_TEST_CHECK(GeoCrsManager::TryGetValidAreasCached(originalWkt, originalLonLatArea, originalSelfArea));
+		MW_TEST_CHECK(GeoCrsManager::TryGetValidAreasCached(editedWkt, editedLonLatArea, editedSelfArea));
+		MW_TEST_CHECK(editedSelfArea.rect.minX != originalSelfArea.rect.minX);
+		MW_TEST_CHECK(editedSelfArea.rect.minX == editedCrs->GetValidArea().rect.minX);
+
+		const std::uint32_t originalId = GeoCrsManager::InternCrs(originalWkt);
+		const std::uint32_t editedId = GeoCrsManager::InternCrs(editedWkt);
+		MW_TEST_CHECK(originalId != 0 && editedId != 0);
+		MW_TEST_CHECK(originalId != editedId);
+		MW_TEST_CHECK(GeoCrsManager::FindCrsId(editedWkt) == editedId);
+	}
+
+	// 只给 EPSG:32650 返回哨兵值的有效范围表，用于区分查表与实时计算。
+	bool LookupSentinelValidArea(int epsgCode, bool selfArea, bool& outHasArea, GB_Rectangle& outRect)
+	{
+		if (epsgCode != 32650)
+		{
+			return false;
+		}
+
+		outHasArea = true;
+		outRect = selfArea ? GB_Rectangle(1.0, 2.0, 3.0, 4.0) : GB_Rectangle(110.0, 10.0, 111.0, 11.0);
+		return true;
+	}
+
+	// 有效范围表按内容校验 EPSG 权威码：不依赖指纹索引，同一定义的其它写法命中，改动过参数的 WKT 不命中。
+	void TestValidAreaTableChecksContent()
+	{
+		const GeoCrs::ValidAreaTableHook previousTableHook = GeoCrs::GetValidAreaTableHook();
+		const GeoCrs::EpsgIdentifyHook previousIdentifyHook = GeoCrs::GetEpsgIdentifyHook();
+		GeoCrs::SetValidAreaTableHook(&LookupSentinelValidArea);
+		GeoCrs::SetEpsgIdentifyHook(nullptr);
+
+		const GeoCrs epsgCrs = GeoCrs::CreateFromEpsgCode(32650);
+		MW_TEST_CHECK(epsgCrs.GetValidArea().rect.minX == 1.0);
+		MW_TEST_CHECK(epsgCrs.GetValidAreaLonLat().rect.minX == 110.0);
+
+		const GeoCrs wkt1Crs = GeoCrs::CreateFromWkt(epsgCrs.ExportToWktUtf8(GeoCrs::WktFormat::Wkt1Gdal, false));
+		MW_TEST_CHECK(wkt1Crs.GetUidUtf8() == "EPSG:32650");
+		MW_TEST_CHECK(wkt1Crs.GetValidArea().rect.minX == 1.0);
+
+		const GeoCrs editedCrs = GeoCrs::CreateFromWkt(EditUtm50CentralMeridian(epsgCrs.ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false)));
+		MW_TEST_CHECK(editedCrs.GetUidUtf8() == "EPSG:32650");
+		MW_TEST_CHECK(editedCrs.GetValidArea().IsValid() && editedCrs.GetValidArea().rect.minX != 1.0);
+		MW_TEST_CHECK(editedCrs.GetValidAreaLonLat().IsValid() && editedCrs.GetValidAreaLonLat().rect.minX != 110.0);
+
+		GeoCrs::SetValidAreaTableHook(previousTableHook);
+		GeoCrs::SetEpsgIdentifyHook(previousIdentifyHook);
+	}
+
+	// 原坐标系被淘汰（登记表中的弱引用失效）后，改动过参数但保留权威码的 WKT 登记为同一 UID 的新实例：
+	// 按 UID 留存的第二级条目（有效范围、足迹、快照）不能被它取到。
+	// 用 EPSG:32633：前面的测试已驻留 EPSG:32650，驻留表会让它永远不被淘汰。
+	void TestCanonicalCachesAfterEviction()
+	{
+		GeoCrsManager::ClearCaches();
+		const size_t originalBudget = GeoCrsManager::GetCacheMemoryBudget();
+		GeoCrsManager::SetCacheMemoryBudget(8 * 1024 * 1024);
+
+		const std::string originalWkt = GeoCrs::CreateFromEpsgCode(32633).ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+		const std::string editedWkt = EditCentralMeridian(originalWkt, "15", "18");
+		MW_TEST_CHECK(!editedWkt.empty());
+		if (editedWkt.empty())
+		{
+			GeoCrsManager::SetCacheMemoryBudget(originalBudget);
+			return;
+		}
+
+		// 在临时线程上计算原坐标系的结果：线程退出后其私有视图不再引用原坐标系。
+		GB_Rectangle originalSelfRect;
+		GB_Rectangle originalFootprintRect;
+		std::thread([&]() {
+			GeoBoundingBox lonLatArea;
+			GeoBoundingBox selfArea;
+			GeoCrsManager::TryGetValidAreasCached(originalWkt, lonLatArea, selfArea);
+			originalSelfRect = selfArea.rect;
+			originalFootprintRect = GeoCrsManager::GetValidAreaFootprintCached(originalWkt)->GetBoundingRect();
+		}).join();
+		MW_TEST_CHECK(originalSelfRect.IsValid() && originalFootprintRect.IsValid());
+
+		// 用其它 WKT 挤出原坐标系的一级缓存条目。
+		const std::uint64_t evictionCountBefore = GeoCrsManager::GetWktCacheMemoryGauge().evictionCount;
+		for (const int code : GetFloodEpsgCodes())
+		{
+			if (code != 32633)
+			{
+				GeoCrsManager::GetFromWktCached(GeoCrs::CreateFromEpsgCode(code).ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false));
+			}
+		}
+		MW_TEST_CHECK(GeoCrsManager::GetWktCacheMemoryGauge().evictionCount > evictionCountBefore);
+
+		const std::shared_ptr<const GeoCrs> editedCrs = GeoCrsManager::GetFromWktCached(editedWkt);
+		MW_TEST_CHECK(editedCrs != nullptr && editedCrs->GetUidUtf8() == "EPSG:32633");
+
+		GeoBoundingBox editedLonLatArea;
+		GeoBoundingBox editedSelfArea;
+		GeoCrsManager::TryGetValidAreasCached(editedWkt, editedLonLatArea, editedSelfArea);
+		MW_TEST_CHECK(editedSelfArea.rect.minX == editedCrs->GetValidArea().rect.minX);
+		MW_TEST_CHECK(editedSelfArea.rect.minX != originalSelfRect.minX);
+
+		const GB_Rectangle editedFootprintRect = GeoCrsManager::GetValidAreaFootprintCached(editedWkt)->GetBoundingRect();
+		MW_TEST_CHECK(editedFootprintRect.minX == editedCrs->GetValidAreaFootprint().GetBoundingRect().minX);
+		MW_TEST_CHECK(editedFootprintRect.minX != originalFootprintRect.minX);
+
+		const std::shared_ptr<const FrozenGeoCrs> editedFrozen = GeoCrsManager::GetFrozenFromWktCached(editedWkt);
+		MW_TEST_CHECK(editedFrozen->GetCrs() == editedCrs);
+		MW_TEST_CHECK(editedFrozen->GetWktUtf8() == editedCrs->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false));
+
+		GeoCrsManager::SetCacheMemoryBudget(originalBudget);
+		GeoCrsManager::ClearCaches();
+	}
+
+	// 并发未命中合并：N 个线程同时请求同一个未缓存的 WKT，只解析一次，其余线程等待（或命中）同一结果。
+	void TestConcurrentMissesBuildOnce()
+	{
+		GeoCrsManager::ClearCaches();
+		const std::string wkt = EditCentralMeridian(GeoCrs::CreateFromEpsgCode(32633).ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false), "15", "16");
+		MW_TEST_CHECK(!wkt.empty());
+
+		const int threadCount = 8;
+		std::vector<std::shared_ptr<const GeoCrs>> results(threadCount);
+		std::atomic<int> readyCount(0);
+		const GeoCrsManager::CacheCounters countersBefore = GeoCrsManager::GetWktCacheCounters();
+
+		std::vector<std::thread> threads;
+		for (int threadIndex = 0; threadIndex < threadCount; threadIndex++)
+		{
+			threads.push_back(std::thread([&wkt, &results, &readyCount, threadIndex, threadCount]() {
+				// 所有线程就绪后同时发起请求，尽量让未命中重叠。
+				readyCount.fetch_add(1);
+				while (readyCount.load() < threadCount)
+				{
+					std::this_thread::yield();
+				}
+				results[threadIndex] = GeoCrsManager::GetFromWktCached(wkt);
+			}));
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		const GeoCrsManager::CacheCounters countersAfter = GeoCrsManager::GetWktCacheCounters();
+		MW_TEST_CHECK(countersAfter.missCount - countersBefore.missCount == 1);
+		MW_TEST_CHECK((countersAfter.hitCount - countersBefore.hitCount) + (countersAfter.coalescedCount - countersBefore.coalescedCount) == static_cast<std::uint64_t>(threadCount - 1));
+		for (const std::shared_ptr<const GeoCrs>& result : results)
+		{
+			MW_TEST_CHECK(result && result->IsValid() && result.get() == results[0].get());
+		}
+	}
+
+	// 批量获取：结果与逐个调用相同（同一对象），重复项与同一坐标系的不同写法返回同一实例。
+	void TestBatchMatchesSingleCalls()
+	{
+		GeoCrsManager::ClearCaches();
+
+		const std::vector<int> epsgCodes = { 4326, 32650, 2193, 4326, -1, 3857, 32650, 0 };
+		const std::vector<std::shared_ptr<const GeoCrs>> epsgResults = GeoCrsManager::GetFromEpsgBatch(epsgCodes, 4);
+		MW_TEST_CHECK(epsgResults.size() == epsgCodes.size());
+		for (size_t i = 0; i < epsgResults.size() && i < epsgCodes.size(); i++)
+		{
+			MW_TEST_CHECK(epsgResults[i] && epsgResults[i].get() == GeoCrsManager::GetFromEpsgCached(epsgCodes[i]).get());
+			MW_TEST_CHECK(epsgResults[i] && epsgResults[i]->IsValid() == (epsgCodes[i] > 0));
+		}
+		MW_TEST_CHECK(epsgResults.size() == epsgCodes.size() && epsgResults[0].get() == epsgResults[3].get() && epsgResults[1].get() == epsgResults[6].get());
+
+		GeoCrsManager::ClearCaches();
+
+		const GeoCrs utm = GeoCrs::CreateFromEpsgCode(32650);
+		const std::string utmWkt2 = utm.ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+		const std::string utmWkt1 = utm.ExportToWktUtf8(GeoCrs::WktFormat::Wkt1Gdal, false);
+		const std::string editedWkt = EditUtm50CentralMeridian(utmWkt2);
+		const std::string lonLatWkt1 = GeoCrs::CreateFromEpsgCode(4326).ExportToWktUtf8(GeoCrs::WktFormat::Wkt1Gdal, false);
+		const std::vector<std::string> wkts = { utmWkt2, utmWkt1, editedWkt, "", utmWkt2, lonLatWkt1, editedWkt };
+		const std::vector<std::shared_ptr<const GeoCrs>> wktResults = GeoCrsManager::GetFromWktBatch(wkts, 4);
+		MW_TEST_CHECK(wktResults.size() == wkts.size());
+		if (wktResults.size() != wkts.size())
+		{
+			return;
+		}
+
+		for (size_t i = 0; i < wkts.size(); i++)
+		{
+			MW_TEST_CHECK(wktResults[i] && wktResults[i].get() == GeoCrsManager::GetFromWktCached(wkts[i]).get());
+		}
+		MW_TEST_CHECK(wktResults[0].get() == wktResults[4].get());
+		MW_TEST_CHECK(wktResults[0].get() == wktResults[1].get());
+		MW_TEST_CHECK(wktResults[2].get() == wktResults[6].get() && wktResults[2].get() != wktResults[0].get());
+		MW_TEST_CHECK(wktResults[3] && !wktResults[3]->IsValid());
+		MW_TEST_CHECK(wktResults[5].get() == GeoCrsManager::GetFromEpsgCached(4326).get());
+	}
+
+	// 不可变快照：同一坐标系的快照在调用方之间共享；只读访问返回的引用在快照生存期内不变，
+	// ClearCaches() 后旧快照仍可用且内容不变，多线程并发读取结果一致。
+	void TestFrozenSnapshotsSharedAndImmutable()
+	{
+		static_assert(std::is_same<decltype(GeoCrsManager::GetFrozenFromEpsgCached(0)), std::shared_ptr<const FrozenGeoCrs>>::value,
+			"frozen snapshots are handed out as shared read-only objects");
+
+		GeoCrsManager::ClearCaches();
+		const std::shared_ptr<const FrozenGeoCrs> frozen = GeoCrsManager::GetFrozenFromEpsgCached(32650);
+		MW_TEST_CHECK(frozen && frozen->IsValid() && !frozen->IsEmpty());
+		if (!frozen || !frozen->IsValid())
+		{
+			return;
+		}
+
+		MW_TEST_CHECK(GeoCrsManager::GetFrozenFromEpsgCached(32650).get() == frozen.get());
+		MW_TEST_CHECK(GeoCrsManager::GetFrozenFromWktCached(frozen->GetWktUtf8()).get() == frozen.get());
+		MW_TEST_CHECK(frozen->GetCrs().get() == GeoCrsManager::GetFromEpsgCached(32650).get());
+
+		const std::string& wkt = frozen->GetWktUtf8();
+		const std::string& uid = frozen->GetUidUtf8();
+		MW_TEST_CHECK(&frozen->GetWktUtf8() == &wkt && &frozen->GetUidUtf8() == &uid);
+		MW_TEST_CHECK(wkt == frozen->GetCrs()->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false));
+		MW_TEST_CHECK(uid == frozen->GetCrs()->GetUidUtf8());
+		MW_TEST_CHECK(frozen->GetEpsgCode() == 32650 && frozen->GetEpsgStringUtf8() == "EPSG:32650");
+		MW_TEST_CHECK(frozen->IsProjected() && !frozen->IsGeographic());
+
+		const std::string wktCopy = wkt;
+		const std::string uidCopy = uid;
+		const std::string nameCopy = frozen->GetNameUtf8();
+		const int threadCount = 8;
+		std::vector<int> mismatchCounts(threadCount, 0);
+		std::vector<std::thread> threads;
+		for (int threadIndex = 0; threadIndex < threadCount; threadIndex++)
+		{
+			threads.push_back(std::thread([&, threadIndex]() {
+				for (int i = 0; i < 1000; i++)
+				{
+					if (frozen->GetWktUtf8() != wktCopy || frozen->GetUidUtf8() != uidCopy || frozen->GetNameUtf8() != nameCopy || frozen->GetEpsgCode() != 32650)
+					{
+						mismatchCounts[threadIndex]++;
+					}
+				}
+			}));
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		for (const int mismatchCount : mismatchCounts)
+		{
+			MW_TEST_CHECK(mismatchCount == 0);
+		}
+
+		GeoCrsManager::ClearCaches();
+		MW_TEST_CHECK(frozen->GetWktUtf8() == wktCopy && frozen->GetUidUtf8() == uidCopy && frozen->GetCrs() && frozen->GetCrs()->IsValid());
+		const std::shared_ptr<const FrozenGeoCrs> rebuilt = GeoCrsManager::GetFrozenFromEpsgCached(32650);
+		MW_TEST_CHECK(rebuilt && rebuilt->GetWktUtf8() == wktCopy && rebuilt->GetUidUtf8() == uidCopy);
+	}
+
+	// 预热：之后在新线程上（私有视图为空）的首次请求全部命中全局缓存，转换只从已有原型 Clone()。
+	void TestWarmupPopulatesCaches()
+	{
+		GeoCrsManager::ClearCaches();
+		GeoCrsTransform::ClearCaches();
+
+		const std::vector<int> epsgCodes = { 32651, 2193 };
+		const std::vector<GeoCrsManager::WarmupResult> results = GeoCrsManager::Warmup(epsgCodes, 2);
+		MW_TEST_CHECK(results.size() == epsgCodes.size());
+		for (const GeoCrsManager::WarmupResult& result : results)
+		{
+			MW_TEST_CHECK(result.success);
+		}
+		MW_TEST_CHECK(!GeoCrsManager::Warmup(std::vector<int>{ -1 })[0].success);
+
+		std::vector<std::string> canonicalWkts;
+		for (const int epsgCode : epsgCodes)
+		{
+			canonicalWkts.push_back(GeoCrs::CreateFromEpsgCode(epsgCode).ExportToWktUtf8());
+		}
+
+		const std::string lonLatWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		std::vector<std::pair<std::string, std::string>> pairs;
+		for (const std::string& wkt : canonicalWkts)
+		{
+			pairs.push_back(std::make_pair(lonLatWkt, wkt));
+		}
+		const std::vector<GeoCrsTransform::WarmupResult> transformResults = GeoCrsTransform::Warmup(pairs, 2);
+		MW_TEST_CHECK(transformResults.size() == pairs.size());
+		for (const GeoCrsTransform::WarmupResult& result : transformResults)
+		{
+			MW_TEST_CHECK(result.success);
+		}
+
+		const GeoCrsManager::CacheCounters epsgBefore = GeoCrsManager::GetEpsgCacheCounters();
+		const GeoCrsManager::CacheCounters wktBefore = GeoCrsManager::GetWktCacheCounters();
+		const GeoCrsManager::CacheCounters validAreaBefore = GeoCrsManager::GetValidAreaCacheCounters();
+		GeoCrsTransform::ResetCacheStatistics();
+
+		std::thread([&]() {
+			for (size_t i = 0; i < epsgCodes.size(); i++)
+			{
+				GeoCrsManager::GetFromEpsgCached(epsgCodes[i]);
+				GeoCrsManager::GetFromWktCached(canonicalWkts[i]);
+				GeoBoundingBox lonLatArea;
+				GeoBoundingBox selfArea;
+				GeoCrsManager::TryGetValidAreasCached(canonicalWkts[i], lonLatArea, selfArea);
+
+				double x = 0.0;
+				double y = 0.0;
+				GeoCrsTransform::TransformXY(lonLatWkt, canonicalWkts[i], 120.0, -40.0, x, y);
+			}
+		}).join();
+
+		const GeoCrsManager::CacheCounters epsgAfter = GeoCrsManager::GetEpsgCacheCounters();
+		const GeoCrsManager::CacheCounters wktAfter = GeoCrsManager::GetWktCacheCounters();
+		const GeoCrsManager::CacheCounters validAreaAfter = GeoCrsManager::GetValidAreaCacheCounters();
+		MW_TEST_CHECK(epsgAfter.missCount == epsgBefore.missCount && epsgAfter.hitCount >= epsgBefore.hitCount + epsgCodes.size());
+		MW_TEST_CHECK(wktAfter.missCount == wktBefore.missCount && wktAfter.hitCount >= wktBefore.hitCount + epsgCodes.size());
+		MW_TEST_CHECK(validAreaAfter.missCount == validAreaBefore.missCount && validAreaAfter.hitCount >= validAreaBefore.hitCount + epsgCodes.size());
+
+		const GeoCrsTransform::CacheStatistics transformStatistics = GeoCrsTransform::GetCacheStatistics();
+		MW_TEST_CHECK(transformStatistics.prototypeCreateCount == 0);
+		MW_TEST_CHECK(transformStatistics.cloneCount == epsgCodes.size());
+	}
+
+	int GetUtmZone(const GeoCrs& crs)
+	{
+		int isNorth = 0;
+		return crs.GetConstRef().GetUTMZone(&isNorth);
+	}
+
+	// 写时复制：副本在修改前与原对象共享内部对象，修改副本不影响原对象。
+	void TestCopyOnWriteIsolation()
+	{
+		const GeoCrs original = GeoCrs::CreateFromEpsgCode(32650);
+		const std::string originalWkt = original.ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+
+		GeoCrs copy = original;
+		MW_TEST_CHECK(&copy.GetConstRef() == &original.GetConstRef());
+		MW_TEST_CHECK(copy == original);
+
+		MW_TEST_CHECK(copy.SetFromEpsgCode(4326));
+		MW_TEST_CHECK(&copy.GetConstRef() != &original.GetConstRef());
+		MW_TEST_CHECK(copy.TryGetEpsgCode() == 4326);
+		MW_TEST_CHECK(original.TryGetEpsgCode() == 32650);
+		MW_TEST_CHECK(original.ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false) == originalWkt);
+
+		GeoCrs axisCopy;
+		axisCopy = original;
+		axisCopy.SetTraditionalGisAxisOrder(false);
+		MW_TEST_CHECK(&axisCopy.GetConstRef() != &original.GetConstRef());
+		MW_TEST_CHECK(original.GetConstRef().GetAxisMappingStrategy() == OAMS_TRADITIONAL_GIS_ORDER);
+		MW_TEST_CHECK(!(axisCopy == original));
+	}
+
+	// GetRef() 借出可写引用：借出前先与共享的副本分离；借出后的对象再被拷贝时深拷贝，经引用的修改不影响副本。
+	void TestCopyOnWriteExposure()
+	{
+		const GeoCrs original = GeoCrs::CreateFromEpsgCode(32650);
+		GeoCrs exposed = original;
+
+		OGRSpatialReference& exposedRef = exposed.GetRef();
+		MW_TEST_CHECK(&exposedRef != &original.GetConstRef());
+		exposedRef.SetUTM(51, TRUE);
+		MW_TEST_CHECK(GetUtmZone(exposed) == 51);
+		MW_TEST_CHECK(GetUtmZone(original) == 50);
+
+		const GeoCrs copyAfterExposure = exposed;
+		MW_TEST_CHECK(&copyAfterExposure.GetConstRef() != &exposedRef);
+		exposedRef.SetUTM(52, TRUE);
+		MW_TEST_CHECK(GetUtmZone(exposed) == 52);
+		MW_TEST_CHECK(GetUtmZone(copyAfterExposure) == 51);
+
+		// SetFrom* 换成全新的内部对象并清除“已借出”状态，之后的拷贝恢复为共享。
+		MW_TEST_CHECK(exposed.SetFromEpsgCode(32650));
+		const GeoCrs sharedAgain = exposed;
+		MW_TEST_CHECK(&sharedAgain.GetConstRef() == &exposed.GetConstRef());
+	}
+
+	// 多个线程同时拷贝同一个共享对象并修改各自的副本：原对象与其它线程的副本都不受影响。
+	void TestCopyOnWriteConcurrentCopies()
+	{
+		const GeoCrs source = GeoCrs::CreateFromEpsgCode(32650);
+		const std::string sourceUid = source.GetUidUtf8();
+		const int threadCount = 8;
+		const int iterationCount = 50;
+
+		std::vector<int> mismatchCounts(threadCount, 0);
+		std::vector<std::thread> threads;
+		for (int threadIndex = 0; threadIndex < threadCount; threadIndex++)
+		{
+			threads.push_back(std::thread([&source, &sourceUid, &mismatchCounts, threadIndex, iterationCount]() {
+				const int zone = 40 + threadIndex;
+				for (int i = 0; i < iterationCount; i++)
+				{
+					GeoCrs copy = source;
+					if (i % 2 == 0)
+					{
+						copy.SetFromEpsgCode(32600 + zone);
+					}
+					else
+					{
+						copy.GetRef().SetUTM(zone, TRUE);
+					}
+
+					// 原对象只经 GeoCrs 的 const 接口读取（内部加锁）；副本已独占内部对象，可直接读取 OGR 对象。
+					if (GetUtmZone(copy) != zone || source.TryGetEpsgCode() != 32650 || source.GetUidUtf8() != sourceUid)
+					{
+						mismatchCounts[threadIndex]++;
+					}
+				}
+			}));
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (const int mismatchCount : mismatchCounts)
+		{
+			MW_TEST_CHECK(mismatchCount == 0);
+		}
+		MW_TEST_CHECK(GetUtmZone(source) == 50 && source.GetUidUtf8() == sourceUid);
+	}
+
+	// 一组 code 的查表结果与关闭查表钩子后实时计算的结果逐位一致。
+	void CheckValidAreaTableMatchesLive(const std::vector<int>& epsgCodes)
+	{
+		const GeoCrs::ValidAreaTableHook tableHook = GeoCrs::GetValidAreaTableHook();
+		for (const int epsgCode : epsgCodes)
+		{
+			GeoCrsManager::EpsgValidArea tabulated;
+			MW_TEST_CHECK(GeoCrsManager::TryGetTabulatedEpsgValidArea(epsgCode, tabulated));
+
+			GeoCrs::SetValidAreaTableHook(nullptr);
+			const GeoCrs liveCrs = GeoCrs::CreateFromEpsgCode(epsgCode);
+			const GeoBoundingBox liveLonLatArea = liveCrs.GetValidAreaLonLat();
+			const GeoBoundingBox liveSelfArea = liveCrs.GetValidArea();
+			GeoCrs::SetValidAreaTableHook(tableHook);
+
+			MW_TEST_CHECK(tabulated.hasLonLatArea == liveLonLatArea.IsValid());
+			MW_TEST_CHECK(tabulated.hasSelfArea == liveSelfArea.IsValid());
+			MW_TEST_CHECK(!tabulated.hasLonLatArea || tabulated.lonLatRect == liveLonLatArea.rect);
+			MW_TEST_CHECK(!tabulated.hasSelfArea || tabulated.selfRect == liveSelfArea.rect);
+
+			// 走查表路径的 GetValidArea() 与实时结果相同。
+			const GeoCrs tabulatedCrs = GeoCrs::CreateFromEpsgCode(epsgCode);
+			MW_TEST_CHECK(tabulatedCrs.GetValidAreaLonLat().rect == liveLonLatArea.rect);
+			MW_TEST_CHECK(tabulatedCrs.GetValidArea().rect == liveSelfArea.rect);
+		}
+	}
+
+	// EPSG 有效范围表：生成 -> 保存 -> 重新加载后与实时计算一致；proj.db 签名不符的文件被拒绝（并卸载当前表）。
+	void TestValidAreaTableRoundTrip()
+	{
+		const std::string tablePath = "MapWeaverTest_EpsgValidArea.table";
+		const std::string staleTablePath = "MapWeaverTest_EpsgValidArea_Stale.table";
+		std::remove(tablePath.c_str());
+		std::remove(staleTablePath.c_str());
+
+		// 覆盖地理 2D/3D、投影、跨反经线（4167）与极区（3413）的坐标系。
+		const std::vector<int> epsgCodes = { 4326, 4979, 3857, 32650, 2193, 4167, 3413 };
+
+		MW_TEST_CHECK(GeoCrsManager::BuildEpsgValidAreaTable(tablePath));
+		MW_TEST_CHECK(GeoCrsManager::GetEpsgValidAreaTableSize() > 0);
+		CheckValidAreaTableMatchesLive(epsgCodes);
+
+		const size_t builtSize = GeoCrsManager::GetEpsgValidAreaTableSize();
+		MW_TEST_CHECK(GeoCrsManager::LoadEpsgValidAreaTable(tablePath));
+		MW_TEST_CHECK(GeoCrsManager::GetEpsgValidAreaTableSize() == builtSize);
+		CheckValidAreaTableMatchesLive(epsgCodes);
+
+		// 改写文件头中记录的 proj.db 文件大小（偏移 24 的 u64），模拟 proj.db 已变化。
+		std::vector<char> content;
+		{
+			std::ifstream input(tablePath.c_str(), std::ios::binary);
+			content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+		}
+		MW_TEST_CHECK(content.size() > 48);
+		if (content.size() > 48)
+		{
+			content[24] = static_cast<char>(content[24] ^ 0x5A);
+			{
+				std::ofstream output(staleTablePath.c_str(), std::ios::binary | std::ios::trunc);
+				output.write(content.data(), static_cast<std::streamsize>(content.size()));
+			}
+
+			MW_TEST_CHECK(!GeoCrsManager::LoadEpsgValidAreaTable(staleTablePath));
+			MW_TEST_CHECK(GeoCrsManager::GetEpsgValidAreaTableSize() == 0);
+			GeoCrsManager::EpsgValidArea area;
+			MW_TEST_CHECK(!GeoCrsManager::TryGetTabulatedEpsgValidArea(4326, area));
+		}
+
+		std::remove(tablePath.c_str());
+		std::remove(staleTablePath.c_str());
+	}
+}
+
+void RunGeoCrsManagerTests()
+{
+	TestBackgroundInitialization();
+	TestCacheBudgetSlruEviction();
+	TestCacheBudgetShrink();
+	TestInternCrsIds();
+	TestPersistentCacheRoundTrip();
+	TestFingerprintPrefersCurrentCodes();
+	TestEditedWktKeepsOwnIdentity();
+	TestValidAreaTableChecksContent();
+	TestCanonicalCachesAfterEviction();
+	TestValidAreaTableRoundTrip();
+	TestCopyOnWriteIsolation();
+	TestCopyOnWriteExposure();
+	TestCopyOnWriteConcurrentCopies();
+	TestConcurrentMissesBuildOnce();
+	TestBatchMatchesSingleCalls();
+	TestFrozenSnapshotsSharedAndImmutable();
+	TestWarmupPopulatesCaches();
+}
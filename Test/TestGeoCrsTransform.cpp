@@ -0,0 +1,614 @@
+﻿#include "TestCommon.h"
+
+#include "../MapWeaverCore/include/GeoBoundingBox.h"
+#include "../MapWeaverCore/include/GeoCrsManager.h"
+#include "../MapWeaverCore/include/GeoCrsTransform.h"
+#include "Geometry/GB_Point2d.h"
+#include "Geometry/GB_Rectangle.h"
+
+#include <ogr_spatialref.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct OgrTransformDeleter
+	{
+		void operator()(OGRCoordinateTransformation* transform) const
+		{
+			OCTDestroyCoordinateTransformation(transform);
+		}
+	};
+
+	// 直接用 OGR（不经 GeoCrsTransform 的快速路径与缓存）转换，作为对照结果。
+	bool TransformWithOgr(int sourceEpsg, int targetEpsg, std::vector<double>& x, std::vector<double>& y)
+	{
+		OGRSpatialReference sourceSrs;
+		OGRSpatialReference targetSrs;
+		if (sourceSrs.importFromEPSG(sourceEpsg) != OGRERR_NONE || targetSrs.importFromEPSG(targetEpsg) != OGRERR_NONE)
+		{
+			return false;
+		}
+		sourceSrs.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+		targetSrs.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+
+		std::unique_ptr<OGRCoordinateTransformation, OgrTransformDeleter> transform(OGRCreateCoordinateTransformation(&sourceSrs, &targetSrs));
+		if (!transform)
+		{
+			return false;
+		}
+
+		std::vector<int> successFlags(x.size(), FALSE);
+		return transform->Transform(static_cast<int>(x.size()), x.data(), y.data(), nullptr, successFlags.data()) != FALSE;
+	}
+
+	// 在经纬度网格上生成点，再（必要时）用 OGR 转到源 CRS，得到源 CRS 下的测试输入。
+	bool MakeSourcePoints(int sourceEpsg, double minLon, double maxLon, double minLat, double maxLat, std::vector<double>& x, std::vector<double>& y)
+	{
+		x.clear();
+		y.clear();
+		const int steps = 24;
+		for (int i = 0; i <= steps; i++)
+		{
+			for (int j = 0; j <= steps; j++)
+			{
+				x.push_back(minLon + (maxLon - minLon) * i / steps);
+				y.push_back(minLat + (maxLat - minLat) * j / steps);
+			}
+		}
+		return sourceEpsg == 4326 || TransformWithOgr(4326, sourceEpsg, x, y);
+	}
+
+	void CheckFastPathAgainstOgr(int sourceEpsg, int targetEpsg, double minLon, double maxLon, double minLat, double maxLat)
+	{
+		std::vector<double> x;
+		std::vector<double> y;
+		MW_TEST_CHECK(MakeSourcePoints(sourceEpsg, minLon, maxLon, minLat, maxLat, x, y));
+
+		std::vector<double> expectedX = x;
+		std::vector<double> expectedY = y;
+		MW_TEST_CHECK(TransformWithOgr(sourceEpsg, targetEpsg, expectedX, expectedY));
+
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:" + std::to_string(sourceEpsg));
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:" + std::to_string(targetEpsg));
+		std::vector<std::uint8_t> status(x.size(), 0);
+		MW_TEST_CHECK(GeoCrsTransform::TransformXYArrays(sourceWkt, targetWkt, x.data(), y.data(), nullptr, x.size(), 1, status.data()));
+
+		// 与 GeoCrsTransform 内部校验快速路径时使用的容差一致：投影坐标 1 mm，经纬度 1e-8 度。
+		const double tolerance = (targetEpsg == 4326) ? 1e-8 : 1e-3;
+		for (size_t i = 0; i < x.size(); i++)
+		{
+			MW_TEST_CHECK(status[i] == 1);
+			MW_TEST_CHECK(std::fabs(x[i] - expectedX[i]) <= tolerance);
+			MW_TEST_CHECK(std::fabs(y[i] - expectedY[i]) <= tolerance);
+		}
+	}
+
+	void TestFastPathAgainstOgr()
+	{
+		CheckFastPathAgainstOgr(4326, 3857, -179.0, 179.0, -85.0, 85.0);
+		CheckFastPathAgainstOgr(3857, 4326, -179.0, 179.0, -85.0, 85.0);
+		CheckFastPathAgainstOgr(4326, 32650, 114.0, 120.0, 0.0, 80.0);
+		CheckFastPathAgainstOgr(32650, 4326, 114.0, 120.0, 0.0, 80.0);
+		CheckFastPathAgainstOgr(32750, 3857, 114.0, 120.0, -80.0, -1.0);
+		CheckFastPathAgainstOgr(3857, 32650, 116.0, 118.0, 10.0, 60.0);
+	}
+
+	// 定义域外的点（WebMercator 极区）交给 PROJ：stride == 1 时失败点写为 HUGE_VAL，成功点为有限值。
+	void TestFastPathOutOfDomain()
+	{
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3857");
+		std::vector<double> x = { 10.0, 10.0, 200.0 };
+		std::vector<double> y = { 89.9, 90.0, std::nan("") };
+		std::vector<std::uint8_t> status(x.size(), 0);
+		GeoCrsTransform::TransformXYArrays(sourceWkt, targetWkt, x.data(), y.data(), nullptr, x.size(), 1, status.data());
+
+		MW_TEST_CHECK(status[2] == 0);
+		MW_TEST_CHECK(x[2] == HUGE_VAL && y[2] == HUGE_VAL);
+		for (size_t i = 0; i < 2; i++)
+		{
+			if (status[i] == 0)
+			{
+				MW_TEST_CHECK(x[i] == HUGE_VAL && y[i] == HUGE_VAL);
+			}
+			else
+			{
+				MW_TEST_CHECK(std::isfinite(x[i]) && std::isfinite(y[i]));
+			}
+		}
+	}
+
+	// stride > 1（交错存储）与 stride == 1 的结果一致；逐点状态标出失败点，
+	// 交错存储时失败点保持原值，stride == 1 时失败点写为 HUGE_VAL。
+	void TestXYArraysStrideAndStatus()
+	{
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3857");
+		const std::vector<double> lon = { 117.0, 10.0, -120.0, 200.0, 0.0 };
+		const std::vector<double> lat = { 30.0, std::nan(""), 45.0, 10.0, -60.0 };
+		const std::vector<std::uint8_t> expectedStatus = { 1, 0, 1, 1, 1 };
+		const size_t count = lon.size();
+
+		std::vector<double> x = lon;
+		std::vector<double> y = lat;
+		std::vector<std::uint8_t> status(count, 2);
+		MW_TEST_CHECK(!GeoCrsTransform::TransformXYArrays(sourceWkt, targetWkt, x.data(), y.data(), nullptr, count, 1, status.data()));
+		MW_TEST_CHECK(status == expectedStatus);
+		MW_TEST_CHECK(x[1] == HUGE_VAL && y[1] == HUGE_VAL);
+
+		// xyzxyz 交错存储：z 由 2D 投影原样保留。
+		const size_t stride = 3;
+		std::vector<double> interleaved(count * stride);
+		for (size_t i = 0; i < count; i++)
+		{
+			interleaved[i * stride] = lon[i];
+			interleaved[i * stride + 1] = lat[i];
+			interleaved[i * stride + 2] = 100.0 + static_cast<double>(i);
+		}
+		std::vector<std::uint8_t> interleavedStatus(count, 2);
+		MW_TEST_CHECK(!GeoCrsTransform::TransformXYArrays(sourceWkt, targetWkt, interleaved.data(), interleaved.data() + 1, interleaved.data() + 2, count, stride, interleavedStatus.data()));
+		MW_TEST_CHECK(interleavedStatus == expectedStatus);
+		for (size_t i = 0; i < count; i++)
+		{
+			const double* point = interleaved.data() + i * stride;
+			if (expectedStatus[i] == 0)
+			{
+				MW_TEST_CHECK(point[0] == lon[i] && std::isnan(point[1]) && point[2] == 100.0 + static_cast<double>(i));
+				continue;
+			}
+			MW_TEST_CHECK(std::fabs(point[0] - x[i]) <= 1e-6 && std::fabs(point[1] - y[i]) <= 1e-6);
+			MW_TEST_CHECK(std::fabs(point[2] - (100.0 + static_cast<double>(i))) <= 1e-6);
+		}
+
+		// 仅 x/y 两列交错（stride == 2，z 为 nullptr），全部成功时返回 true。
+		std::vector<double> pairs = { 117.0, 30.0, -120.0, 45.0 };
+		std::vector<std::uint8_t> pairStatus(2, 0);
+		MW_TEST_CHECK(GeoCrsTransform::TransformXYArrays(sourceWkt, targetWkt, pairs.data(), pairs.data() + 1, nullptr, 2, 2, pairStatus.data()));
+		MW_TEST_CHECK(pairStatus[0] == 1 && pairStatus[1] == 1);
+		MW_TEST_CHECK(std::fabs(pairs[0] - x[0]) <= 1e-6 && std::fabs(pairs[3] - y[2]) <= 1e-6);
+	}
+
+	// 逐点状态：成功/失败混合的输入上，outInvalidCount 等于 outStatus 中 0 的个数，失败点保持原值。
+	void TestPointStatusAndInvalidCount()
+	{
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3857");
+		std::vector<GB_Point2d> sourcePoints;
+		sourcePoints.push_back(GB_Point2d(117.0, 30.0));
+		sourcePoints.push_back(GB_Point2d(10.0, std::nan("")));
+		sourcePoints.push_back(GB_Point2d(-120.0, 45.0));
+		sourcePoints.push_back(GB_Point2d(std::numeric_limits<double>::infinity(), 10.0));
+		sourcePoints.push_back(GB_Point2d(0.0, 95.0));
+		sourcePoints.push_back(GB_Point2d(200.0, -60.0));
+
+		std::vector<GB_Point2d> outPoints;
+		std::vector<std::uint8_t> status;
+		size_t invalidCount = 0;
+		MW_TEST_CHECK(!GeoCrsTransform::TransformPoints(sourceWkt, targetWkt, sourcePoints, outPoints, false, &status, &invalidCount));
+		MW_TEST_CHECK(status.size() == sourcePoints.size() && outPoints.size() == sourcePoints.size());
+		if (status.size() != sourcePoints.size() || outPoints.size() != sourcePoints.size())
+		{
+			return;
+		}
+
+		const size_t zeroCount = static_cast<size_t>(std::count(status.begin(), status.end(), static_cast<std::uint8_t>(0)));
+		MW_TEST_CHECK(invalidCount == zeroCount);
+		MW_TEST_CHECK(zeroCount >= 2 && zeroCount < sourcePoints.size());
+		MW_TEST_CHECK(status[0] == 1 && status[1] == 0 && status[2] == 1 && status[3] == 0 && status[5] == 1);
+		for (size_t i = 0; i < sourcePoints.size(); i++)
+		{
+			if (status[i] == 0)
+			{
+				MW_TEST_CHECK(outPoints[i].x == sourcePoints[i].x || (std::isnan(outPoints[i].x) && std::isnan(sourcePoints[i].x)));
+				MW_TEST_CHECK(outPoints[i].y == sourcePoints[i].y || (std::isnan(outPoints[i].y) && std::isnan(sourcePoints[i].y)));
+			}
+			else
+			{
+				MW_TEST_CHECK(std::isfinite(outPoints[i].x) && std::isfinite(outPoints[i].y));
+			}
+		}
+
+		// 只要求计数、原地版本、并行版本与预解析句柄得到相同的计数与状态。
+		size_t countOnly = 0;
+		std::vector<GB_Point2d> countOnlyPoints;
+		GeoCrsTransform::TransformPoints(sourceWkt, targetWkt, sourcePoints, countOnlyPoints, false, nullptr, &countOnly);
+		MW_TEST_CHECK(countOnly == zeroCount);
+
+		std::vector<GB_Point2d> inOutPoints = sourcePoints;
+		std::vector<std::uint8_t> inOutStatus;
+		size_t inOutInvalidCount = 0;
+		GeoCrsTransform::TransformPoints(sourceWkt, targetWkt, inOutPoints, true, &inOutStatus, &inOutInvalidCount);
+		MW_TEST_CHECK(inOutStatus == status && inOutInvalidCount == zeroCount);
+
+		const GeoCrsPreparedTransform prepared = GeoCrsTransform::Prepare(sourceWkt, targetWkt);
+		std::vector<std::uint8_t> preparedStatus;
+		size_t preparedInvalidCount = 0;
+		std::vector<GB_Point2d> preparedPoints;
+		MW_TEST_CHECK(prepared.IsValid());
+		MW_TEST_CHECK(!prepared.TransformPoints(sourcePoints, preparedPoints, false, &preparedStatus, &preparedInvalidCount));
+		MW_TEST_CHECK(preparedStatus == status && preparedInvalidCount == zeroCount);
+	}
+
+	// 预解析句柄：结果与未预解析的调用一致；ClearCaches() 清空原型与线程缓存后句柄仍可用，结果不变。
+	void TestPreparedMatchesUnprepared()
+	{
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:32650");
+		const GeoCrsPreparedTransform prepared = GeoCrsTransform::Prepare(sourceWkt, targetWkt);
+		MW_TEST_CHECK(prepared.IsValid());
+		MW_TEST_CHECK(!GeoCrsTransform::Prepare(sourceWkt, "").IsValid());
+
+		const std::vector<GB_Point2d> sourcePoints = { GB_Point2d(117.0, 30.0), GB_Point2d(114.5, 5.0), GB_Point2d(119.9, 60.0) };
+		const GB_Rectangle sourceRect(115.0, 20.0, 119.0, 40.0);
+
+		for (int round = 0; round < 2; round++)
+		{
+			if (round == 1)
+			{
+				GeoCrsTransform::ClearCaches();
+				GeoCrsManager::ClearCaches();
+			}
+
+			std::vector<GB_Point2d> preparedPoints;
+			std::vector<GB_Point2d> expectedPoints;
+			MW_TEST_CHECK(prepared.TransformPoints(sourcePoints, preparedPoints));
+			MW_TEST_CHECK(GeoCrsTransform::TransformPoints(sourceWkt, targetWkt, sourcePoints, expectedPoints));
+			MW_TEST_CHECK(preparedPoints.size() == expectedPoints.size());
+			for (size_t i = 0; i < preparedPoints.size() && i < expectedPoints.size(); i++)
+			{
+				MW_TEST_CHECK(preparedPoints[i].x == expectedPoints[i].x && preparedPoints[i].y == expectedPoints[i].y);
+			}
+
+			double preparedX = 0.0;
+			double preparedY = 0.0;
+			double expectedX = 0.0;
+			double expectedY = 0.0;
+			MW_TEST_CHECK(prepared.TransformXY(117.0, 30.0, preparedX, preparedY));
+			MW_TEST_CHECK(GeoCrsTransform::TransformXY(sourceWkt, targetWkt, 117.0, 30.0, expectedX, expectedY));
+			MW_TEST_CHECK(preparedX == expectedX && preparedY == expectedY);
+
+			GeoBoundingBox preparedBox;
+			GeoBoundingBox expectedBox;
+			MW_TEST_CHECK(prepared.TransformBoundingBox(sourceRect, preparedBox));
+			MW_TEST_CHECK(GeoCrsTransform::TransformBoundingBox(GeoBoundingBox(sourceWkt, sourceRect), targetWkt, expectedBox));
+			MW_TEST_CHECK(preparedBox.rect.minX == expectedBox.rect.minX && preparedBox.rect.minY == expectedBox.rect.minY &&
+				preparedBox.rect.maxX == expectedBox.rect.maxX && preparedBox.rect.maxY == expectedBox.rect.maxY);
+		}
+	}
+
+	// 三维：EPSG:4979（WGS 84 三维经纬度）-> EPSG:4978（地心坐标），椭球高参与转换。
+	void TestXYZTransforms()
+	{
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4979");
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4978");
+		const double semiMajorAxis = 6378137.0;
+		const double semiMinorAxis = 6356752.314245;
+
+		double outX = 0.0;
+		double outY = 0.0;
+		double outZ = 0.0;
+		MW_TEST_CHECK(GeoCrsTransform::TransformXYZ(sourceWkt, targetWkt, 0.0, 0.0, 100.0, outX, outY, outZ));
+		MW_TEST_CHECK(std::fabs(outX - (semiMajorAxis + 100.0)) <= 1e-3 && std::fabs(outY) <= 1e-3 && std::fabs(outZ) <= 1e-3);
+
+		std::vector<double> x = { 0.0, 90.0, 0.0 };
+		std::vector<double> y = { 0.0, 0.0, 90.0 };
+		std::vector<double> z = { 100.0, 0.0, 250.0 };
+		std::vector<std::uint8_t> status;
+		MW_TEST_CHECK(GeoCrsTransform::TransformXYZPoints(sourceWkt, targetWkt, x, y, z, &status));
+		MW_TEST_CHECK(status.size() == 3 && status[0] == 1 && status[1] == 1 && status[2] == 1);
+		MW_TEST_CHECK(std::fabs(x[0] - (semiMajorAxis + 100.0)) <= 1e-3);
+		MW_TEST_CHECK(std::fabs(y[1] - semiMajorAxis) <= 1e-3);
+		MW_TEST_CHECK(std::fabs(z[2] - (semiMinorAxis + 250.0)) <= 1e-3);
+
+		// XYZT 接口，t 为 nullptr 且交错存储：与上面的结果一致。
+		std::vector<double> interleaved = { 0.0, 0.0, 100.0, 90.0, 0.0, 0.0, 0.0, 90.0, 250.0 };
+		MW_TEST_CHECK(GeoCrsTransform::TransformXYZTArrays(sourceWkt, targetWkt, interleaved.data(), interleaved.data() + 1, interleaved.data() + 2, nullptr, 3, 3));
+		for (size_t i = 0; i < 3; i++)
+		{
+			MW_TEST_CHECK(std::fabs(interleaved[i * 3] - x[i]) <= 1e-6);
+			MW_TEST_CHECK(std::fabs(interleaved[i * 3 + 1] - y[i]) <= 1e-6);
+			MW_TEST_CHECK(std::fabs(interleaved[i * 3 + 2] - z[i]) <= 1e-6);
+		}
+	}
+
+	// 坐标历元：EPSG:7912（ITRF2014）-> EPSG:7843（GDA2020）为随时间变化的转换。
+	// t 为 nullptr 时 epoch 作用于所有点，结果与逐点传入相同的 t 一致；不同历元的结果不同。
+	void TestConstantEpochApplied()
+	{
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:7912");
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:7843");
+		const std::vector<double> lon = { 133.0, 150.0 };
+		const std::vector<double> lat = { -25.0, -33.0 };
+		const std::vector<double> height = { 0.0, 50.0 };
+
+		std::vector<double> x2000 = lon;
+		std::vector<double> y2000 = lat;
+		std::vector<double> z2000 = height;
+		MW_TEST_CHECK(GeoCrsTransform::TransformXYZPoints(sourceWkt, targetWkt, x2000, y2000, z2000, nullptr, false, 2000.0));
+
+		std::vector<double> x2020 = lon;
+		std::vector<double> y2020 = lat;
+		std::vector<double> z2020 = height;
+		MW_TEST_CHECK(GeoCrsTransform::TransformXYZPoints(sourceWkt, targetWkt, x2020, y2020, z2020, nullptr, false, 2020.0));
+
+		std::vector<double> x = lon;
+		std::vector<double> y = lat;
+		std::vector<double> z = height;
+		std::vector<double> t(lon.size(), 2020.0);
+		MW_TEST_CHECK(GeoCrsTransform::TransformXYZTArrays(sourceWkt, targetWkt, x.data(), y.data(), z.data(), t.data(), lon.size()));
+
+		for (size_t i = 0; i < lon.size(); i++)
+		{
+			MW_TEST_CHECK(std::fabs(x2020[i] - x[i]) <= 1e-12 && std::fabs(y2020[i] - y[i]) <= 1e-12 && std::fabs(z2020[i] - z[i]) <= 1e-9);
+
+			// 澳洲板块约 7 cm/年，20 年约 1.4 m（约 1e-5 度）。
+			MW_TEST_CHECK(std::fabs(x2020[i] - x2000[i]) > 1e-6 || std::fabs(y2020[i] - y2000[i]) > 1e-6);
+		}
+	}
+
+	// 进程级原型缓存有界：超出容量时淘汰最久未使用的原型，被淘汰的 CRS 对再次使用时重新创建。
+	void TestPrototypeCacheCapacity()
+	{
+		const size_t originalCapacity = GeoCrsTransform::GetPrototypeCacheCapacity();
+		GeoCrsTransform::ClearCaches();
+		GeoCrsTransform::ResetCacheStatistics();
+		GeoCrsTransform::SetPrototypeCacheCapacity(2);
+
+		const std::string wgs84Wkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		const int targetCodes[] = { 3857, 32650, 32651, 4490 };
+		for (const int targetCode : targetCodes)
+		{
+			double x = 117.0;
+			double y = 30.0;
+			MW_TEST_CHECK(GeoCrsTransform::TransformXY(wgs84Wkt, GeoCrsManager::EpsgCodeToWktUtf8("EPSG:" + std::to_string(targetCode)), x, y, x, y));
+		}
+
+		const GeoCrsTransform::CacheStatistics statistics = GeoCrsTransform::GetCacheStatistics();
+		MW_TEST_CHECK(statistics.prototypeCount <= 2);
+		MW_TEST_CHECK(statistics.prototypeEvictionCount >= 2);
+
+		GeoCrsTransform::SetPrototypeCacheCapacity(originalCapacity);
+		GeoCrsTransform::ClearCaches();
+	}
+
+	// 近似转换：格子内任意点的插值误差应与容差同量级（容差只在每格的 5 个检查点上保证，内部点允许略超）。
+	void TestApproxGridErrorBound()
+	{
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:32650");
+		const GB_Rectangle sourceRect(114.0, 20.0, 120.0, 40.0);
+		const double tolerance = 0.05;
+
+		MW_TEST_CHECK(!GeoCrsTransform::PrepareApprox(sourceWkt, targetWkt, sourceRect, 0.0).IsValid());
+
+		const GeoCrsApproxTransform approx = GeoCrsTransform::PrepareApprox(sourceWkt, targetWkt, sourceRect, tolerance, 12);
+		MW_TEST_CHECK(approx.IsValid());
+		if (!approx.IsValid())
+		{
+			return;
+		}
+		MW_TEST_CHECK(approx.GetMaxError() <= approx.GetTolerance());
+		MW_TEST_CHECK(approx.GetInterpolatedCellCount() > 0);
+
+		const GeoCrsPreparedTransform exact = GeoCrsTransform::Prepare(sourceWkt, targetWkt);
+		const int steps = 37;
+		for (int i = 0; i <= steps; i++)
+		{
+			for (int j = 0; j <= steps; j++)
+			{
+				const double x = sourceRect.minX + (sourceRect.maxX - sourceRect.minX) * i / steps;
+				const double y = sourceRect.minY + (sourceRect.maxY - sourceRect.minY) * j / steps;
+				double approxX = 0;
+				double approxY = 0;
+				double exactX = 0;
+				double exactY = 0;
+				MW_TEST_CHECK(approx.TransformXY(x, y, approxX, approxY));
+				MW_TEST_CHECK(exact.TransformXY(x, y, exactX, exactY));
+				MW_TEST_CHECK(std::hypot(approxX - exactX, approxY - exactY) <= tolerance * 2.0);
+			}
+		}
+	}
+
+	// 跨反经线的格子在任何深度都超差：节点总数必须受上限约束，而不是一路四分到最大深度。
+	void TestApproxGridNodeCap()
+	{
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3832");
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		const GB_Rectangle sourceRect(-4000000.0, -4000000.0, 8000000.0, 4000000.0);
+
+		const GeoCrsApproxTransform approx = GeoCrsTransform::PrepareApprox(sourceWkt, targetWkt, sourceRect, 1e-9, 16);
+		MW_TEST_CHECK(approx.IsValid());
+		MW_TEST_CHECK(approx.GetInterpolatedCellCount() + approx.GetExactCellCount() <= (static_cast<size_t>(1) << 18));
+	}
+
+	// 跨反经线：TransformBoundingBoxParts 返回 [west, 180] 与 [-180, east] 两段，TransformBoundingBox 保守返回整圈经度。
+	void TestAntimeridianSplit()
+	{
+		// EPSG:3832 的中央经线为 150°E，x ∈ [2e6, 5e6] 约对应经度 168°E ~ 165°W。
+		const GeoBoundingBox sourceBox(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3832"), GB_Rectangle(2000000.0, -1000000.0, 5000000.0, 1000000.0));
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+
+		std::vector<GeoBoundingBox> parts;
+		MW_TEST_CHECK(GeoCrsTransform::TransformBoundingBoxParts(sourceBox, targetWkt, parts));
+		MW_TEST_CHECK(parts.size() == 2);
+		if (parts.size() == 2)
+		{
+			MW_TEST_CHECK(parts[0].rect.minX > 160.0 && parts[0].rect.maxX == 180.0);
+			MW_TEST_CHECK(parts[1].rect.minX == -180.0 && parts[1].rect.maxX < -160.0);
+			MW_TEST_CHECK(parts[0].rect.minY == parts[1].rect.minY && parts[0].rect.maxY == parts[1].rect.maxY);
+		}
+
+		GeoBoundingBox box;
+		MW_TEST_CHECK(GeoCrsTransform::TransformBoundingBox(sourceBox, targetWkt, box));
+		MW_TEST_CHECK(box.rect.minX == -180.0 && box.rect.maxX == 180.0);
+
+		// 不跨反经线时只返回 1 段，且与 TransformBoundingBox 一致。
+		const GeoBoundingBox plainBox(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3832"), GB_Rectangle(-1000000.0, -1000000.0, 1000000.0, 1000000.0));
+		MW_TEST_CHECK(GeoCrsTransform::TransformBoundingBoxParts(plainBox, targetWkt, parts));
+		MW_TEST_CHECK(GeoCrsTransform::TransformBoundingBox(plainBox, targetWkt, box));
+		MW_TEST_CHECK(parts.size() == 1 && parts[0].rect.minX == box.rect.minX && parts[0].rect.maxX == box.rect.maxX);
+	}
+
+	// 批量 bbox 与逐个 TransformBoundingBox 的结果逐位一致（含跨反经线、包含极点与退化的 bbox）。
+	void TestBoundingBoxBatchMatchesSingle()
+	{
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		std::vector<GeoBoundingBox> sourceBoxes;
+		sourceBoxes.push_back(GeoBoundingBox(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3857"), GB_Rectangle(12000000.0, 2000000.0, 13000000.0, 3000000.0)));
+		sourceBoxes.push_back(GeoBoundingBox(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:32650"), GB_Rectangle(400000.0, 3000000.0, 600000.0, 3500000.0)));
+		sourceBoxes.push_back(GeoBoundingBox(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3832"), GB_Rectangle(2000000.0, -1000000.0, 5000000.0, 1000000.0)));
+		sourceBoxes.push_back(GeoBoundingBox(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3413"), GB_Rectangle(-1000000.0, -1000000.0, 1000000.0, 1000000.0)));
+		sourceBoxes.push_back(GeoBoundingBox(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3857"), GB_Rectangle(13000000.0, 3000000.0, 13000000.0, 3500000.0)));
+		sourceBoxes.push_back(GeoBoundingBox(GeoCrsManager::EpsgCodeToWktUtf8("EPSG:32650"), GB_Rectangle(500000.0, 1000000.0, 700000.0, 1500000.0)));
+
+		bool expectedAllOk = true;
+		std::vector<GeoBoundingBox> expectedBoxes(sourceBoxes.size());
+		for (size_t i = 0; i < sourceBoxes.size(); i++)
+		{
+			if (!GeoCrsTransform::TransformBoundingBox(sourceBoxes[i], targetWkt, expectedBoxes[i]))
+			{
+				expectedAllOk = false;
+			}
+		}
+		MW_TEST_CHECK(!expectedAllOk && !expectedBoxes[4].IsValid());
+
+		// 跨反经线：保守返回全球经度；包含北极：纬度上界到达极点附近。
+		MW_TEST_CHECK(expectedBoxes[2].rect.minX == -180.0 && expectedBoxes[2].rect.maxX == 180.0);
+		MW_TEST_CHECK(expectedBoxes[3].rect.minX == -180.0 && expectedBoxes[3].rect.maxX == 180.0 && expectedBoxes[3].rect.maxY > 89.0);
+
+		for (int enableOpenMP = 0; enableOpenMP < 2; enableOpenMP++)
+		{
+			std::vector<GeoBoundingBox> batchBoxes;
+			MW_TEST_CHECK(GeoCrsTransform::TransformBoundingBoxes(sourceBoxes, targetWkt, batchBoxes, enableOpenMP != 0) == expectedAllOk);
+			MW_TEST_CHECK(batchBoxes.size() == sourceBoxes.size());
+			for (size_t i = 0; i < batchBoxes.size() && i < expectedBoxes.size(); i++)
+			{
+				MW_TEST_CHECK(batchBoxes[i].IsValid() == expectedBoxes[i].IsValid());
+				if (expectedBoxes[i].IsValid())
+				{
+					const GB_Rectangle& batchRect = batchBoxes[i].rect;
+					const GB_Rectangle& singleRect = expectedBoxes[i].rect;
+					MW_TEST_CHECK(batchRect.minX == singleRect.minX && batchRect.minY == singleRect.minY &&
+						batchRect.maxX == singleRect.maxX && batchRect.maxY == singleRect.maxY);
+					MW_TEST_CHECK(batchBoxes[i].wktUtf8 == expectedBoxes[i].wktUtf8);
+				}
+			}
+		}
+	}
+
+	// 流式转换：reader / writer 抛出的异常在内部线程结束后传回调用线程，而不是终止进程。
+	void TestPointStreamPropagatesExceptions()
+	{
+		const std::string sourceWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:4326");
+		const std::string targetWkt = GeoCrsManager::EpsgCodeToWktUtf8("EPSG:3857");
+		const size_t chunkSize = 16;
+
+		size_t readChunkCount = 0;
+		auto reader = [&readChunkCount, chunkSize](GB_Point2d* buffer, size_t capacity) -> size_t {
+			if (readChunkCount == 4)
+			{
+				return 0;
+			}
+			readChunkCount++;
+			for (size_t i = 0; i < capacity && i < chunkSize; i++)
+			{
+				buffer[i].Set(117.0, 30.0);
+			}
+			return chunkSize;
+		};
+		auto writer = [](const GB_Point2d*, const std::uint8_t*, size_t) { return true; };
+
+		GeoCrsTransform::StreamStatistics statistics;
+		MW_TEST_CHECK(GeoCrsTransform::TransformPointStream(sourceWkt, targetWkt, reader, writer, chunkSize, 2, &statistics));
+		MW_TEST_CHECK(statistics.pointCount == 4 * chunkSize && statistics.failedCount == 0);
+
+		bool readerExceptionCaught = false;
+		try
+		{
+			GeoCrsTransform::TransformPointStream(sourceWkt, targetWkt, [](GB_Point2d*, size_t) -> size_t { throw std::runtime_error("reader"); }, writer, chunkSize, 2);
+		}
+		catch (const std::runtime_error&)
+		{
+			readerExceptionCaught = true;
+		}
+		MW_TEST_CHECK(readerExceptionCaught);
+
+		bool writerExceptionCaught = false;
+		readChunkCount = 0;
+		try
+		{
+			GeoCrsTransform::TransformPointStream(sourceWkt, targetWkt, reader, [](const GB_Point2d*, const std::uint8_t*, size_t) -> bool { throw std::runtime_error("writer"); }, chunkSize, 2);
+		}
+		catch (const std::runtime_error&)
+		{
+			writerExceptionCaught = true;
+		}
+		MW_TEST_CHECK(writerExceptionCaught);
+	}
+
+	// 改动过中央经线但保留根权威码 EPSG:32650 的目标：不复用原坐标系的转换原型、规范化 WKT 与快速路径。
+	void TestEditedWktDoesNotReuseTransform()
+	{
+		const std::string lonLatWkt = GeoCrsManager::GetWgs84()->ExportToWktUtf8();
+		const std::string originalWkt = GeoCrsManager::GetFromEpsgCached(32650)->ExportToWktUtf8(GeoCrs::WktFormat::Wkt2_2018, false);
+		const std::string centralMeridian = "\"Longitude of natural origin\",117,";
+		const size_t position = originalWkt.find(centralMeridian);
+		MW_TEST_CHECK(position != std::string::npos);
+		if (position == std::string::npos)
+		{
+			return;
+		}
+
+		std::string editedWkt = originalWkt;
+		editedWkt.replace(position, centralMeridian.size(), "\"Longitude of natural origin\",120,");
+
+		// 先用原坐标系建立原型，再转换到改动后的坐标系：各自落在自己的中央经线上。
+		GB_Point2d originalPoint;
+		MW_TEST_CHECK(GeoCrsTransform::TransformPoint(lonLatWkt, originalWkt, GB_Point2d(117.0, 30.0), originalPoint));
+		MW_TEST_CHECK(std::fabs(originalPoint.x - 500000.0) < 1e-3);
+
+		const size_t prototypeCountBefore = GeoCrsTransform::GetCacheStatistics().prototypeCount;
+		GB_Point2d editedPoint;
+		MW_TEST_CHECK(GeoCrsTransform::TransformPoint(lonLatWkt, editedWkt, GB_Point2d(120.0, 30.0), editedPoint));
+		MW_TEST_CHECK(std::fabs(editedPoint.x - 500000.0) < 1e-3);
+		MW_TEST_CHECK(std::fabs(editedPoint.y - originalPoint.y) < 1e-3);
+		MW_TEST_CHECK(GeoCrsTransform::GetCacheStatistics().prototypeCount == prototypeCountBefore + 1);
+
+		// 数组接口同样按改动后的中央经线计算：(117, 30) 位于其以西约 290 km；若误按 EPSG:32650 计算会落在 500000 附近。
+		std::vector<double> x(1, 117.0);
+		std::vector<double> y(1, 30.0);
+		MW_TEST_CHECK(GeoCrsTransform::TransformXYArrays(lonLatWkt, editedWkt, x.data(), y.data(), nullptr, 1));
+		MW_TEST_CHECK(x[0] < 300000.0);
+
+		const GeoBoundingBox sourceBox(lonLatWkt, GB_Rectangle(119.0, 29.0, 121.0, 31.0));
+		GeoBoundingBox editedBox;
+		MW_TEST_CHECK(GeoCrsTransform::TransformBoundingBox(sourceBox, editedWkt, editedBox));
+		MW_TEST_CHECK(editedBox.GetWktUtf8().find(",120,") != std::string::npos);
+	}
+}
+
+void RunGeoCrsTransformTests()
+{
+	TestFastPathAgainstOgr();
+	TestFastPathOutOfDomain();
+	TestXYArraysStrideAndStatus();
+	TestPointStatusAndInvalidCount();
+	TestPreparedMatchesUnprepared();
+	TestXYZTransforms();
+	TestConstantEpochApplied();
+	TestPrototypeCacheCapacity();
+	TestApproxGridErrorBound();
+	TestApproxGridNodeCap();
+	TestAntimeridianSplit();
+	TestBoundingBoxBatchMatchesSingle();
+	TestPointStreamPropagatesExceptions();
+	TestEditedWktDoesNotReuseTransform();
+}
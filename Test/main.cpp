@@ -2,7 +2,25 @@
 #include "../MapWeaverCore/include/GeoBoundingBox.h"
 #include "../MapWeaverCore/include/GeoCrsTransform.h"
 #include "../GlobalBase/GB_Logger.h"
+#include "TestCommon.h"
 #include <iostream>
+#include <string>
+
+namespace
+{
+	int g_testFailureCount = 0;
+}
+
+void ReportTestFailure(const char* expression, const char* file, int line)
+{
+	g_testFailureCount++;
+	GBLOG_ERROR(GB_STR("检查失败: ") + std::string(expression) + GB_STR(" (") + std::string(file) + GB_STR(":") + std::to_string(line) + GB_STR(")"));
+}
+
+int GetTestFailureCount()
+{
+	return g_testFailureCount;
+}
 
 int main(int argc, char* argv[])
 {
@@ -31,6 +49,23 @@ int main(int argc, char* argv[])
 	}
 
 	std::cout << bbox3857.SerializeToString() << std::endl;
+
+	if (argc > 1 && std::string(argv[1]) == "--benchmark")
+	{
+		RunGeoCrsManagerBenchmarks();
+		RunGeoCrsTransformBenchmarks();
+		return GetTestFailureCount() > 0 ? 1 : 0;
+	}
+
+	RunGeoCrsManagerTests();
+	RunGeoCrsFootprintTests();
+	RunGeoCrsTransformTests();
+
+	if (GetTestFailureCount() > 0)
+	{
+		GBLOG_ERROR(GB_STR("测试失败项数: ") + std::to_string(GetTestFailureCount()));
+		return 1;
+	}
 	return 0;
 }
 